@@ -27,13 +27,58 @@ typedef struct
 {
     uint16_t sum1;
     uint16_t sum2;
+    uint8_t *buffer;
+    uint32_t buffer_size;
+    uint32_t buffer_len;
+    uint32_t run_min;
 } adler32_ctx;
 
+/* Size of an exported state, see adler32_export_state() */
+#define ADLER32_STATE_SIZE 16
+
+/* Largest rolling window, so its exact sums fit in 32 bits */
+#define ADLER32_ROLLING_MAX_WINDOW NMAX
+/* Multiplier hashing checksums to the bits of a signature filter */
+#define ADLER32_ROLLING_HASH       0x9E3779B1U
+
+typedef struct
+{
+    uint32_t sum1;
+    uint32_t sum2;
+    uint32_t window;
+} adler32_rolling_ctx;
+
 AARU_EXPORT adler32_ctx *AARU_CALL adler32_init();
 AARU_EXPORT int AARU_CALL          adler32_update(adler32_ctx *ctx, const uint8_t *data, uint32_t len);
+AARU_EXPORT int AARU_CALL          adler32_update64(adler32_ctx *ctx, const uint8_t *data, uint64_t len);
+AARU_EXPORT int AARU_CALL          adler32_set_buffered(adler32_ctx *ctx, uint32_t size);
+AARU_EXPORT int AARU_CALL          adler32_set_run_detection(adler32_ctx *ctx, uint32_t min_length);
+AARU_EXPORT int AARU_CALL          adler32_update_run(adler32_ctx *ctx, uint8_t value, uint64_t count);
+AARU_EXPORT uint32_t AARU_CALL     adler32_combine(uint32_t adler1, uint32_t adler2, uint64_t len2);
+AARU_EXPORT int AARU_CALL          adler32_update_parallel(adler32_ctx *ctx, const uint8_t *data, uint64_t len,
+                                                           uint32_t threads);
 AARU_EXPORT int AARU_CALL          adler32_final(adler32_ctx *ctx, uint32_t *checksum);
+AARU_EXPORT int AARU_CALL          adler32_export_state(adler32_ctx *ctx, uint8_t *buffer, uint32_t len);
+AARU_EXPORT adler32_ctx *AARU_CALL adler32_import_state(const uint8_t *buffer, uint32_t len);
+AARU_EXPORT adler32_ctx *AARU_CALL adler32_clone(const adler32_ctx *ctx);
 AARU_EXPORT void AARU_CALL         adler32_free(adler32_ctx *ctx);
 AARU_EXPORT void AARU_CALL         adler32_slicing(uint16_t *sum1, uint16_t *sum2, const uint8_t *data, long len);
+AARU_EXPORT void AARU_CALL         adler32_swar(uint16_t *sum1, uint16_t *sum2, const uint8_t *data, long len);
+
+AARU_EXPORT adler32_rolling_ctx *AARU_CALL adler32_rolling_init(const uint8_t *data, uint32_t window);
+AARU_EXPORT int AARU_CALL                  adler32_rolling_roll(adler32_rolling_ctx *ctx, uint8_t out, uint8_t in);
+AARU_EXPORT int AARU_CALL                  adler32_rolling_checksum(adler32_rolling_ctx *ctx, uint32_t *checksum);
+AARU_EXPORT void AARU_CALL                 adler32_rolling_free(adler32_rolling_ctx *ctx);
+AARU_EXPORT int AARU_CALL                  adler32_rolling_values(const uint8_t *data, uint64_t len, uint32_t window,
+                                                                  uint32_t *values);
+AARU_EXPORT int AARU_CALL                  adler32_rolling_scan(const uint8_t *data, uint64_t len, uint32_t window,
+                                                                const uint32_t *signatures, uint32_t count,
+                                                                uint64_t *offsets, uint32_t max);
+AARU_EXPORT void AARU_CALL                 adler32_rolling_scalar(uint32_t *sum1, uint32_t *sum2, const uint8_t *data,
+                                                                  uint32_t window, uint32_t *values, uint32_t count);
+AARU_EXPORT uint32_t AARU_CALL             adler32_rolling_filter_scalar(const uint32_t *values, uint32_t count,
+                                                                         const uint32_t *filter, uint32_t bits,
+                                                                         uint32_t *candidates);
 
 #if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
     defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
@@ -41,12 +86,23 @@ AARU_EXPORT void AARU_CALL         adler32_slicing(uint16_t *sum1, uint16_t *sum
 AARU_EXPORT TARGET_WITH_SSSE3 void AARU_CALL adler32_ssse3(uint16_t *sum1, uint16_t *sum2, const uint8_t *data,
                                                            long len);
 AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL adler32_avx2(uint16_t *sum1, uint16_t *sum2, const uint8_t *data, long len);
+AARU_EXPORT TARGET_WITH_AVX512_VNNI void AARU_CALL adler32_avx512_vnni(uint16_t *sum1, uint16_t *sum2,
+                                                                       const uint8_t *data, long len);
+AARU_EXPORT TARGET_WITH_AVX_VNNI void AARU_CALL adler32_avx_vnni(uint16_t *sum1, uint16_t *sum2,
+                                                                 const uint8_t *data, long len);
+AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL adler32_rolling_avx2(uint32_t *sum1, uint32_t *sum2, const uint8_t *data,
+                                                                 uint32_t window, uint32_t *values, uint32_t count);
+AARU_EXPORT TARGET_WITH_AVX2 uint32_t AARU_CALL adler32_rolling_filter_avx2(const uint32_t *values, uint32_t count,
+                                                                            const uint32_t *filter, uint32_t bits,
+                                                                            uint32_t *candidates);
 
 #endif
 
 #if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
 
 AARU_EXPORT void AARU_CALL adler32_neon(uint16_t *sum1, uint16_t *sum2, const uint8_t *data, uint32_t len);
+AARU_EXPORT void AARU_CALL adler32_rolling_neon(uint32_t *sum1, uint32_t *sum2, const uint8_t *data, uint32_t window,
+                                                uint32_t *values, uint32_t count);
 
 #endif
 
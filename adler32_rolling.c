@@ -0,0 +1,397 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Rolling Adler-32 over a window of W bytes, as used by rsync to find known blocks at any
+ * offset of new data.
+ *
+ * A window keeps its exact sums, sum1 = x[0] + ... + x[W-1] and sum2 = W * x[0] + ... + 1 *
+ * x[W-1], and its checksum is the one adler32_update() gives for the same W bytes,
+ * (sum2 + W) % 65521 << 16 | (sum1 + 1) % 65521. Sliding the window one byte, from out to in,
+ * is then
+ *
+ *     sum1' = sum1 - out + in
+ *     sum2' = sum2 - W * out + sum1'
+ *
+ * and the sums never leave 32 bits for windows up to ADLER32_ROLLING_MAX_WINDOW, so the
+ * modulo is only taken when a checksum is needed.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "library.h"
+#include "adler32.h"
+#include "simd.h"
+
+/* Number of checksums adler32_rolling_scan() computes before probing them */
+#define ADLER32_ROLLING_SCAN_BLOCK 1024
+/* Most checksums given to a kernel at once */
+#define ADLER32_ROLLING_MAX_COUNT  (1U << 30)
+/* Bounds of the bits of the signature filter of adler32_rolling_scan() */
+#define ADLER32_ROLLING_MIN_BITS   16
+#define ADLER32_ROLLING_MAX_BITS   24
+
+typedef void(AARU_CALL *adler32_rolling_kernel)(uint32_t *sum1, uint32_t *sum2, const uint8_t *data, uint32_t window,
+                                                uint32_t *values, uint32_t count);
+typedef uint32_t(AARU_CALL *adler32_rolling_filter_kernel)(const uint32_t *values, uint32_t count,
+                                                           const uint32_t *filter, uint32_t bits, uint32_t *candidates);
+
+/* Checksum of a window from its exact sums */
+FORCE_INLINE uint32_t adler32_rolling_value(uint32_t sum1, uint32_t sum2, uint32_t window)
+{
+    return (sum2 + window) % ADLER_MODULE << 16 | (sum1 + 1) % ADLER_MODULE;
+}
+
+/* Bit of the signature filter of a checksum */
+FORCE_INLINE uint32_t adler32_rolling_hash(uint32_t value, uint32_t bits)
+{
+    return value * ADLER32_ROLLING_HASH >> (32 - bits);
+}
+
+/**
+ * @brief Calculates the exact sums of a window.
+ *
+ * @param data Pointer to the window.
+ * @param window Length of the window.
+ * @param sum1 Receives the sum of the bytes.
+ * @param sum2 Receives the sum of the bytes weighted by their distance to the end of the window.
+ */
+static void adler32_rolling_sums(const uint8_t *data, uint32_t window, uint32_t *sum1, uint32_t *sum2)
+{
+    uint32_t s1 = 0;
+    uint32_t s2 = 0;
+    uint32_t i;
+
+    for(i = 0; i < window; i++) s2 += (s1 += data[i]);
+
+    *sum1 = s1;
+    *sum2 = s2;
+}
+
+/**
+ * @brief Chooses the best available kernel to slide a rolling Adler-32 window.
+ *
+ * @return Kernel to use.
+ */
+static adler32_rolling_kernel adler32_rolling_select(void)
+{
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)) && !defined(__MINGW32__))
+    if(have_neon()) return adler32_rolling_neon;
+#endif
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+    if(have_avx2()) return adler32_rolling_avx2;
+#endif
+
+    return adler32_rolling_scalar;
+}
+
+/**
+ * @brief Chooses the best available kernel to probe checksums against a signature filter.
+ *
+ * @return Kernel to use.
+ */
+static adler32_rolling_filter_kernel adler32_rolling_select_filter(void)
+{
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+    if(have_avx2()) return adler32_rolling_filter_avx2;
+#endif
+
+    return adler32_rolling_filter_scalar;
+}
+
+/**
+ * @brief Looks for a checksum in a sorted array of signatures.
+ *
+ * @param signatures Signatures, sorted in ascending order.
+ * @param count Number of signatures.
+ * @param value Checksum to look for.
+ *
+ * @return 1 if the checksum is one of the signatures, 0 otherwise.
+ */
+static int adler32_rolling_find(const uint32_t *signatures, uint32_t count, uint32_t value)
+{
+    uint32_t low = 0, high = count, middle;
+
+    while(low < high)
+    {
+        middle = low + (high - low) / 2;
+
+        if(signatures[middle] < value)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low < count && signatures[low] == value;
+}
+
+/**
+ * @brief Initializes a rolling Adler-32 window.
+ *
+ * @param data Pointer to the first window.
+ * @param window Length of the window, from 1 to ADLER32_ROLLING_MAX_WINDOW bytes.
+ *
+ * @return Pointer to a structure containing the window state, or NULL on error.
+ */
+AARU_EXPORT adler32_rolling_ctx *AARU_CALL adler32_rolling_init(const uint8_t *data, uint32_t window)
+{
+    adler32_rolling_ctx *ctx;
+
+    if(!data || !window || window > ADLER32_ROLLING_MAX_WINDOW) return NULL;
+
+    ctx = (adler32_rolling_ctx *)malloc(sizeof(adler32_rolling_ctx));
+
+    if(!ctx) return NULL;
+
+    adler32_rolling_sums(data, window, &ctx->sum1, &ctx->sum2);
+    ctx->window = window;
+
+    return ctx;
+}
+
+/**
+ * @brief Slides a rolling Adler-32 window one byte forward.
+ *
+ * @param ctx Pointer to the rolling Adler-32 context structure.
+ * @param out Byte leaving the window, the first one of it.
+ * @param in Byte entering the window, the one after its end.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL adler32_rolling_roll(adler32_rolling_ctx *ctx, uint8_t out, uint8_t in)
+{
+    if(!ctx) return -1;
+
+    ctx->sum1 = ctx->sum1 - out + in;
+    ctx->sum2 = ctx->sum2 - ctx->window * out + ctx->sum1;
+
+    return 0;
+}
+
+/**
+ * @brief Gets the Adler-32 checksum of the current window.
+ *
+ * The checksum is identical to the one of adler32_update() with the bytes of the window.
+ *
+ * @param ctx Pointer to the rolling Adler-32 context structure.
+ * @param checksum Pointer to a 32-bit unsigned integer to store the checksum value.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL adler32_rolling_checksum(adler32_rolling_ctx *ctx, uint32_t *checksum)
+{
+    if(!ctx || !checksum) return -1;
+
+    *checksum = adler32_rolling_value(ctx->sum1, ctx->sum2, ctx->window);
+
+    return 0;
+}
+
+/**
+ * @brief Frees the resources allocated for a rolling Adler-32 window.
+ *
+ * @param ctx The rolling Adler-32 context structure, to be freed.
+ */
+AARU_EXPORT void AARU_CALL adler32_rolling_free(adler32_rolling_ctx *ctx)
+{
+    if(!ctx) return;
+
+    free(ctx);
+}
+
+/**
+ * @brief Calculates the Adler-32 checksum of the window at every offset of a buffer.
+ *
+ * @param data Pointer to the data buffer.
+ * @param len Length of the data buffer, at least one window.
+ * @param window Length of the window, from 1 to ADLER32_ROLLING_MAX_WINDOW bytes.
+ * @param values Receives the len - window + 1 checksums, the one of the window at each offset.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL adler32_rolling_values(const uint8_t *data, uint64_t len, uint32_t window, uint32_t *values)
+{
+    adler32_rolling_kernel kernel;
+    uint32_t               sum1, sum2, count;
+
+    if(!data || !values || !window || window > ADLER32_ROLLING_MAX_WINDOW || len < window) return -1;
+
+    kernel = adler32_rolling_select();
+
+    adler32_rolling_sums(data, window, &sum1, &sum2);
+    *values++ = adler32_rolling_value(sum1, sum2, window);
+
+    /* Every other offset slides the window one byte further */
+    for(len -= window; len; len -= count)
+    {
+        count = len > ADLER32_ROLLING_MAX_COUNT ? ADLER32_ROLLING_MAX_COUNT : (uint32_t)len;
+
+        kernel(&sum1, &sum2, data, window, values, count);
+        data += count;
+        values += count;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Finds the offsets of a buffer where the window matches known block signatures.
+ *
+ * The checksum of the window at every offset is probed against the signatures, as rsync does
+ * to find blocks of a reference that moved in new data. A bit filter built from the signatures
+ * discards most offsets without searching them. Matches only mean the Adler-32 checksums are
+ * equal, so the caller should confirm them with a stronger hash.
+ *
+ * @param data Pointer to the data buffer.
+ * @param len Length of the data buffer.
+ * @param window Length of the window and of the blocks, from 1 to ADLER32_ROLLING_MAX_WINDOW bytes.
+ * @param signatures Adler-32 checksums of the known blocks, sorted in ascending order.
+ * @param count Number of signatures.
+ * @param offsets Receives the offsets of the matching windows, in ascending order.
+ * @param max Maximum number of offsets to find. If it is reached, the scan can be resumed after
+ * the last offset found.
+ *
+ * @returns Number of offsets found, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL adler32_rolling_scan(const uint8_t *data, uint64_t len, uint32_t window,
+                                               const uint32_t *signatures, uint32_t count, uint64_t *offsets,
+                                               uint32_t max)
+{
+    adler32_rolling_kernel        kernel;
+    adler32_rolling_filter_kernel probe;
+    uint32_t                      values[ADLER32_ROLLING_SCAN_BLOCK];
+    uint32_t                      candidates[ADLER32_ROLLING_SCAN_BLOCK];
+    uint32_t                     *filter;
+    uint64_t                      offset = 0;
+    uint32_t                      sum1, sum2, bits, hash, n, found_here, i;
+    uint32_t                      found = 0;
+
+    if(!data || !signatures || !offsets || !window || window > ADLER32_ROLLING_MAX_WINDOW) return -1;
+
+    for(i = 1; i < count; i++)
+        if(signatures[i] < signatures[i - 1]) return -1;
+
+    if(len < window || !count || !max) return 0;
+
+    /* About 8 bits per signature, so a random checksum rarely needs to be searched */
+    bits = ADLER32_ROLLING_MIN_BITS;
+
+    while(bits < ADLER32_ROLLING_MAX_BITS && 1U << bits < (uint64_t)count * 8) bits++;
+
+    filter = (uint32_t *)calloc(1U << bits >> 5, sizeof(uint32_t));
+
+    if(!filter) return -1;
+
+    for(i = 0; i < count; i++)
+    {
+        hash = adler32_rolling_hash(signatures[i], bits);
+        filter[hash >> 5] |= 1U << (hash & 31);
+    }
+
+    kernel = adler32_rolling_select();
+    probe  = adler32_rolling_select_filter();
+
+    adler32_rolling_sums(data, window, &sum1, &sum2);
+    values[0] = adler32_rolling_value(sum1, sum2, window);
+    n         = 1;
+    len -= window;
+
+    for(;;)
+    {
+        found_here = probe(values, n, filter, bits, candidates);
+
+        for(i = 0; i < found_here && found < max; i++)
+            if(adler32_rolling_find(signatures, count, values[candidates[i]]))
+                offsets[found++] = offset + candidates[i];
+
+        if(found == max || !len) break;
+
+        offset += n;
+        n = len > ADLER32_ROLLING_SCAN_BLOCK ? ADLER32_ROLLING_SCAN_BLOCK : (uint32_t)len;
+
+        kernel(&sum1, &sum2, data, window, values, n);
+        data += n;
+        len -= n;
+    }
+
+    free(filter);
+
+    return (int)found;
+}
+
+/**
+ * @brief Slides a rolling Adler-32 window over a buffer without SIMD instructions.
+ *
+ * @param sum1 Exact first sum of the window at the start of the buffer, updated to the one of
+ * the last window.
+ * @param sum2 Exact second sum of the window at the start of the buffer, updated to the one of
+ * the last window.
+ * @param data Pointer to the data buffer, at least count + window bytes long.
+ * @param window Length of the window.
+ * @param values Receives the checksums of the windows at offsets 1 to count.
+ * @param count Number of bytes to slide the window.
+ */
+AARU_EXPORT void AARU_CALL adler32_rolling_scalar(uint32_t *sum1, uint32_t *sum2, const uint8_t *data, uint32_t window,
+                                                  uint32_t *values, uint32_t count)
+{
+    uint32_t s1 = *sum1;
+    uint32_t s2 = *sum2;
+    uint32_t i;
+
+    for(i = 0; i < count; i++)
+    {
+        s1        = s1 - data[i] + data[i + window];
+        s2        = s2 - window * data[i] + s1;
+        values[i] = adler32_rolling_value(s1, s2, window);
+    }
+
+    *sum1 = s1;
+    *sum2 = s2;
+}
+
+/**
+ * @brief Probes checksums against a signature filter without SIMD instructions.
+ *
+ * @param values Checksums.
+ * @param count Number of checksums.
+ * @param filter Filter of 2^bits bits, bit n being bit n % 32 of word n / 32.
+ * @param bits Number of bits of the filter's indexes.
+ * @param candidates Receives the indexes of the checksums whose bit is set.
+ *
+ * @return Number of indexes written to candidates.
+ */
+AARU_EXPORT uint32_t AARU_CALL adler32_rolling_filter_scalar(const uint32_t *values, uint32_t count,
+                                                             const uint32_t *filter, uint32_t bits,
+                                                             uint32_t *candidates)
+{
+    uint32_t found = 0;
+    uint32_t hash, i;
+
+    for(i = 0; i < count; i++)
+    {
+        hash = adler32_rolling_hash(values[i], bits);
+
+        if(filter[hash >> 5] >> (hash & 31) & 1) candidates[found++] = i;
+    }
+
+    return found;
+}
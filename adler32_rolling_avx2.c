@@ -0,0 +1,197 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "library.h"
+#include "adler32.h"
+#include "simd.h"
+
+/**
+ * @brief Inclusive prefix sum of eight 32-bit lanes.
+ *
+ * @param v Values.
+ *
+ * @return Each lane with the sum of it and all the lanes before it.
+ */
+TARGET_WITH_AVX2 static inline __m256i adler32_rolling_prefix_avx2(__m256i v)
+{
+    v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+    v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+
+    /* Carry the last lane of the low half into the high one */
+    return _mm256_add_epi32(v, _mm256_shuffle_epi32(_mm256_permute2x128_si256(v, v, 0x08), 0xFF));
+}
+
+/**
+ * @brief Reduces eight 32-bit lanes modulo ADLER_MODULE.
+ *
+ * As 65536 is 15 modulo ADLER_MODULE, the high half of each lane is folded into the low one
+ * twice, leaving a value below twice the modulus.
+ *
+ * @param v Values.
+ *
+ * @return Values modulo ADLER_MODULE.
+ */
+TARGET_WITH_AVX2 static inline __m256i adler32_rolling_mod_avx2(__m256i v)
+{
+    const __m256i mask = _mm256_set1_epi32(0xFFFF);
+    __m256i       high;
+
+    high = _mm256_srli_epi32(v, 16);
+    v    = _mm256_add_epi32(_mm256_and_si256(v, mask), _mm256_sub_epi32(_mm256_slli_epi32(high, 4), high));
+    high = _mm256_srli_epi32(v, 16);
+    v    = _mm256_add_epi32(_mm256_and_si256(v, mask), _mm256_sub_epi32(_mm256_slli_epi32(high, 4), high));
+
+    /* Below the modulus the subtraction wraps to a larger value */
+    return _mm256_min_epu32(v, _mm256_sub_epi32(v, _mm256_set1_epi32(ADLER_MODULE)));
+}
+
+/**
+ * @brief Slides a rolling Adler-32 window over a buffer using AVX2 instructions.
+ *
+ * Eight offsets are computed at once. Prefix sums of the bytes entering and leaving the
+ * window give the changes of both sums over the eight offsets, and only need the sums of the
+ * previous offsets to be added, so consecutive groups do not wait for each other.
+ *
+ * @param sum1 Exact first sum of the window at the start of the buffer, updated to the one of
+ * the last window.
+ * @param sum2 Exact second sum of the window at the start of the buffer, updated to the one of
+ * the last window.
+ * @param data Pointer to the data buffer, at least count + window bytes long.
+ * @param window Length of the window.
+ * @param values Receives the checksums of the windows at offsets 1 to count.
+ * @param count Number of bytes to slide the window.
+ */
+AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL adler32_rolling_avx2(uint32_t *sum1, uint32_t *sum2, const uint8_t *data,
+                                                                 uint32_t window, uint32_t *values, uint32_t count)
+{
+    uint32_t s1 = *sum1;
+    uint32_t s2 = *sum2;
+    uint32_t i  = 0;
+
+    if(count >= 8)
+    {
+        const __m256i v_window = _mm256_set1_epi32((int)window);
+        const __m256i v_one    = _mm256_set1_epi32(1);
+        const __m256i v_last   = _mm256_set1_epi32(7);
+        const __m256i v_index  = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 8);
+        __m256i       v_s1     = _mm256_set1_epi32((int)s1);
+        __m256i       v_s2     = _mm256_set1_epi32((int)s2);
+        __m256i       out, in, p1, p2, s1s, s2s;
+
+        for(; i + 8 <= count; i += 8)
+        {
+            out = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(data + i)));
+            in  = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(data + i + window)));
+
+            /*
+             * Changes of the first sum, and of the second one besides adding the first sum
+             * of the previous offsets once per offset.
+             */
+            p1 = adler32_rolling_prefix_avx2(_mm256_sub_epi32(in, out));
+            p2 = adler32_rolling_prefix_avx2(_mm256_sub_epi32(p1, _mm256_mullo_epi32(out, v_window)));
+
+            s1s = _mm256_add_epi32(v_s1, p1);
+            s2s = _mm256_add_epi32(_mm256_add_epi32(v_s2, p2), _mm256_mullo_epi32(v_s1, v_index));
+
+            s1s = adler32_rolling_mod_avx2(_mm256_add_epi32(s1s, v_one));
+            s2s = adler32_rolling_mod_avx2(_mm256_add_epi32(s2s, v_window));
+
+            _mm256_storeu_si256((__m256i *)(values + i), _mm256_or_si256(_mm256_slli_epi32(s2s, 16), s1s));
+
+            v_s2 = _mm256_add_epi32(_mm256_add_epi32(v_s2, _mm256_slli_epi32(v_s1, 3)),
+                                    _mm256_permutevar8x32_epi32(p2, v_last));
+            v_s1 = _mm256_add_epi32(v_s1, _mm256_permutevar8x32_epi32(p1, v_last));
+        }
+
+        s1 = (uint32_t)_mm256_cvtsi256_si32(v_s1);
+        s2 = (uint32_t)_mm256_cvtsi256_si32(v_s2);
+    }
+
+    /*
+     * Handle leftover offsets.
+     */
+    for(; i < count; i++)
+    {
+        s1        = s1 - data[i] + data[i + window];
+        s2        = s2 - window * data[i] + s1;
+        values[i] = (s2 + window) % ADLER_MODULE << 16 | (s1 + 1) % ADLER_MODULE;
+    }
+
+    *sum1 = s1;
+    *sum2 = s2;
+}
+
+/**
+ * @brief Probes checksums against a signature filter using AVX2 instructions.
+ *
+ * Eight checksums are hashed at once, and their words of the filter gathered together.
+ *
+ * @param values Checksums.
+ * @param count Number of checksums.
+ * @param filter Filter of 2^bits bits, bit n being bit n % 32 of word n / 32.
+ * @param bits Number of bits of the filter's indexes.
+ * @param candidates Receives the indexes of the checksums whose bit is set.
+ *
+ * @return Number of indexes written to candidates.
+ */
+AARU_EXPORT TARGET_WITH_AVX2 uint32_t AARU_CALL adler32_rolling_filter_avx2(const uint32_t *values, uint32_t count,
+                                                                            const uint32_t *filter, uint32_t bits,
+                                                                            uint32_t *candidates)
+{
+    const __m256i v_hash  = _mm256_set1_epi32((int)ADLER32_ROLLING_HASH);
+    const __m256i v_31    = _mm256_set1_epi32(31);
+    const __m128i v_shift = _mm_cvtsi32_si128((int)(32 - bits));
+    uint32_t      found   = 0;
+    uint32_t      i, j, mask, hash;
+    __m256i       v_bit, v_word;
+
+    for(i = 0; i + 8 <= count; i += 8)
+    {
+        v_bit  = _mm256_srl_epi32(_mm256_mullo_epi32(_mm256_loadu_si256((const __m256i *)(values + i)), v_hash),
+                                  v_shift);
+        v_word = _mm256_i32gather_epi32((const int *)filter, _mm256_srli_epi32(v_bit, 5), 4);
+
+        /* Move each bit of the filter to the top of its lane */
+        v_word = _mm256_sllv_epi32(v_word, _mm256_sub_epi32(v_31, _mm256_and_si256(v_bit, v_31)));
+        mask   = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(v_word));
+
+        /* Most checksums hit no bit, so the whole group is usually skipped */
+        for(j = 0; mask; j++, mask >>= 1)
+            if(mask & 1) candidates[found++] = i + j;
+    }
+
+    /*
+     * Handle leftover checksums.
+     */
+    for(; i < count; i++)
+    {
+        hash = values[i] * ADLER32_ROLLING_HASH >> (32 - bits);
+
+        if(filter[hash >> 5] >> (hash & 31) & 1) candidates[found++] = i;
+    }
+
+    return found;
+}
+
+#endif
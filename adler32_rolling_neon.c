@@ -0,0 +1,144 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)))
+
+#include <arm_neon.h>
+#include <stdint.h>
+
+#include "library.h"
+#include "adler32.h"
+#include "simd.h"
+
+/**
+ * @brief Inclusive prefix sum of four 32-bit lanes.
+ *
+ * @param v Values.
+ *
+ * @return Each lane with the sum of it and all the lanes before it.
+ */
+TARGET_WITH_NEON static inline uint32x4_t adler32_rolling_prefix_neon(uint32x4_t v)
+{
+    const uint32x4_t zero = vdupq_n_u32(0);
+
+    v = vaddq_u32(v, vextq_u32(zero, v, 3));
+
+    return vaddq_u32(v, vextq_u32(zero, v, 2));
+}
+
+/**
+ * @brief Reduces four 32-bit lanes modulo ADLER_MODULE.
+ *
+ * As 65536 is 15 modulo ADLER_MODULE, the high half of each lane is folded into the low one
+ * twice, leaving a value below twice the modulus.
+ *
+ * @param v Values.
+ *
+ * @return Values modulo ADLER_MODULE.
+ */
+TARGET_WITH_NEON static inline uint32x4_t adler32_rolling_mod_neon(uint32x4_t v)
+{
+    const uint32x4_t mask = vdupq_n_u32(0xFFFF);
+    uint32x4_t       high;
+
+    high = vshrq_n_u32(v, 16);
+    v    = vaddq_u32(vandq_u32(v, mask), vsubq_u32(vshlq_n_u32(high, 4), high));
+    high = vshrq_n_u32(v, 16);
+    v    = vaddq_u32(vandq_u32(v, mask), vsubq_u32(vshlq_n_u32(high, 4), high));
+
+    /* Below the modulus the subtraction wraps to a larger value */
+    return vminq_u32(v, vsubq_u32(v, vdupq_n_u32(ADLER_MODULE)));
+}
+
+/**
+ * @brief Slides a rolling Adler-32 window over a buffer using NEON instructions.
+ *
+ * Eight offsets are computed at once, in two halves. The bytes leaving and entering the
+ * window give the change of the first sum at each offset, which a prefix sum turns into the
+ * first sums, and those give the changes of the second sum in turn.
+ *
+ * @param sum1 Exact first sum of the window at the start of the buffer, updated to the one of
+ * the last window.
+ * @param sum2 Exact second sum of the window at the start of the buffer, updated to the one of
+ * the last window.
+ * @param data Pointer to the data buffer, at least count + window bytes long.
+ * @param window Length of the window.
+ * @param values Receives the checksums of the windows at offsets 1 to count.
+ * @param count Number of bytes to slide the window.
+ */
+TARGET_WITH_NEON void adler32_rolling_neon(uint32_t *sum1, uint32_t *sum2, const uint8_t *data, uint32_t window,
+                                           uint32_t *values, uint32_t count)
+{
+    uint32_t s1 = *sum1;
+    uint32_t s2 = *sum2;
+    uint32_t i  = 0;
+
+    if(count >= 8)
+    {
+        const uint32x4_t v_window = vdupq_n_u32(window);
+        const uint32x4_t v_one    = vdupq_n_u32(1);
+        uint32x4_t       v_s1     = vdupq_n_u32(s1);
+        uint32x4_t       v_s2     = vdupq_n_u32(s2);
+        uint32x4_t       s1_low, s1_high, s2_low, s2_high;
+
+        for(; i + 8 <= count; i += 8)
+        {
+            const uint16x8_t out = vmovl_u8(vld1_u8(data + i));
+            const uint16x8_t in  = vmovl_u8(vld1_u8(data + i + window));
+
+            s1_low  = vaddq_u32(v_s1, adler32_rolling_prefix_neon(vsubl_u16(vget_low_u16(in), vget_low_u16(out))));
+            s1_high = vaddq_u32(vdupq_n_u32(vgetq_lane_u32(s1_low, 3)),
+                                adler32_rolling_prefix_neon(vsubl_u16(vget_high_u16(in), vget_high_u16(out))));
+
+            /* The window is at most ADLER32_ROLLING_MAX_WINDOW, so it fits a 16-bit multiplier */
+            s2_low  = vaddq_u32(v_s2, adler32_rolling_prefix_neon(
+                                         vsubq_u32(s1_low, vmull_n_u16(vget_low_u16(out), (uint16_t)window))));
+            s2_high = vaddq_u32(vdupq_n_u32(vgetq_lane_u32(s2_low, 3)),
+                                adler32_rolling_prefix_neon(
+                                    vsubq_u32(s1_high, vmull_n_u16(vget_high_u16(out), (uint16_t)window))));
+
+            vst1q_u32(values + i, vorrq_u32(vshlq_n_u32(adler32_rolling_mod_neon(vaddq_u32(s2_low, v_window)), 16),
+                                            adler32_rolling_mod_neon(vaddq_u32(s1_low, v_one))));
+            vst1q_u32(values + i + 4,
+                      vorrq_u32(vshlq_n_u32(adler32_rolling_mod_neon(vaddq_u32(s2_high, v_window)), 16),
+                                adler32_rolling_mod_neon(vaddq_u32(s1_high, v_one))));
+
+            /* The next offsets start from the last one */
+            v_s1 = vdupq_n_u32(vgetq_lane_u32(s1_high, 3));
+            v_s2 = vdupq_n_u32(vgetq_lane_u32(s2_high, 3));
+        }
+
+        s1 = vgetq_lane_u32(v_s1, 0);
+        s2 = vgetq_lane_u32(v_s2, 0);
+    }
+
+    /*
+     * Handle leftover offsets.
+     */
+    for(; i < count; i++)
+    {
+        s1        = s1 - data[i] + data[i + window];
+        s2        = s2 - window * data[i] + s1;
+        values[i] = (s2 + window) % ADLER_MODULE << 16 | (s1 + 1) % ADLER_MODULE;
+    }
+
+    *sum1 = s1;
+    *sum2 = s2;
+}
+
+#endif
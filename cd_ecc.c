@@ -0,0 +1,568 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * P and Q parity of the CD-ROM sectors, as defined in ECMA-130.
+ *
+ * The 2064 bytes from the header to the intermediate field are seen as 1032 16-bit words, in
+ * 24 rows of 43. Each byte column of that matrix is a Reed-Solomon codeword over GF(2^8) with
+ * two P parity bytes, and each byte diagonal of the matrix with the P parity under it is a
+ * codeword with two Q parity bytes. A codeword c_0...c_n-1 with its parity is valid when
+ * sum(c_k) and sum(c_k * a^(n-1-k)) are both zero, a being the generator of the field.
+ *
+ * Mode 2 sectors compute it with their header taken as zero. Mode 2 Form 2 sectors have none.
+ *
+ * With two parity bytes a codeword can have a single wrong byte corrected, and alternating the
+ * P and Q codewords corrects many bytes more, as each byte belongs to one of each.
+ *
+ * The SIMD kernels take a sector per lane, as every sector has the same codewords, after
+ * transposing them so a vector holds the same byte of all the sectors.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "library.h"
+#include "cd_ecc.h"
+#include "cd_edc.h"
+#include "simd.h"
+
+/**
+ * @brief Multiplies a byte by the generator of the field.
+ *
+ * @param x Byte to multiply.
+ *
+ * @return The product.
+ */
+static uint8_t cd_ecc_double(uint8_t x) { return (uint8_t)(x << 1) ^ (x & 0x80 ? CD_ECC_POLY : 0); }
+
+/**
+ * @brief Adds the bytes of a codeword to its two sums.
+ *
+ * @param area ECC area of the sector, starting at its header.
+ * @param index Position of the first byte of the codeword in the area.
+ * @param step Distance between consecutive bytes of the codeword.
+ * @param size Size of the area the positions wrap around.
+ * @param length Number of bytes to add.
+ * @param a Weighted sum, multiplied by the generator after each byte.
+ * @param b Plain sum.
+ */
+static void cd_ecc_sums(const uint8_t *area, uint32_t index, uint32_t step, uint32_t size, uint32_t length,
+                        uint8_t *a, uint8_t *b)
+{
+    while(length--)
+    {
+        *a = cd_ecc_double(*a ^ area[index]);
+        *b ^= area[index];
+
+        index += step;
+
+        if(index >= size) index -= size;
+    }
+}
+
+/**
+ * @brief Computes the P and Q parity of the ECC area of a sector.
+ *
+ * @param area ECC area of the sector, with room for its P and Q parity, that receives them.
+ */
+static void cd_ecc_parity(uint8_t *area)
+{
+    uint8_t  a, b, p;
+    uint32_t i;
+
+    for(i = 0; i < CD_ECC_P_COUNT; i++)
+    {
+        a = b = 0;
+        cd_ecc_sums(area, i, CD_ECC_P_COUNT, CD_ECC_DATA, CD_ECC_P_LENGTH, &a, &b);
+
+        /* Solves the two sums of the codeword with its parity bytes being zero */
+        a = cd_ecc_double(a) ^ b;
+        p = cd_ecc_div3_lo[a & 0x0F] ^ cd_ecc_div3_hi[a >> 4];
+
+        area[CD_ECC_DATA + i]                  = p;
+        area[CD_ECC_DATA + CD_ECC_P_COUNT + i] = p ^ b;
+    }
+
+    for(i = 0; i < CD_ECC_Q_COUNT; i++)
+    {
+        a = b = 0;
+        cd_ecc_sums(area, i / 2 * CD_ECC_P_COUNT + i % 2, CD_ECC_P_COUNT + 2, CD_ECC_Q_AREA, CD_ECC_Q_LENGTH, &a, &b);
+
+        a = cd_ecc_double(a) ^ b;
+        p = cd_ecc_div3_lo[a & 0x0F] ^ cd_ecc_div3_hi[a >> 4];
+
+        area[CD_ECC_Q_AREA + i]                  = p;
+        area[CD_ECC_Q_AREA + CD_ECC_Q_COUNT + i] = p ^ b;
+    }
+}
+
+/**
+ * @brief Tells if the P and Q parity of the ECC area of a sector are correct.
+ *
+ * @param area ECC area of the sector, with its P and Q parity.
+ *
+ * @return Non-zero if all the codewords are valid.
+ */
+static int cd_ecc_check(const uint8_t *area)
+{
+    uint8_t  a, b;
+    uint8_t  error = 0;
+    uint32_t i;
+
+    /* The P parity bytes continue the columns */
+    for(i = 0; i < CD_ECC_P_COUNT; i++)
+    {
+        a = b = 0;
+        cd_ecc_sums(area, i, CD_ECC_P_COUNT, CD_ECC_Q_AREA, CD_ECC_P_LENGTH + 2, &a, &b);
+        error |= a | b;
+    }
+
+    for(i = 0; i < CD_ECC_Q_COUNT; i++)
+    {
+        a = b = 0;
+        cd_ecc_sums(area, i / 2 * CD_ECC_P_COUNT + i % 2, CD_ECC_P_COUNT + 2, CD_ECC_Q_AREA, CD_ECC_Q_LENGTH, &a, &b);
+        cd_ecc_sums(area, CD_ECC_Q_AREA + i, CD_ECC_Q_COUNT, CD_ECC_SIZE, 2, &a, &b);
+        error |= a | b;
+    }
+
+    return error == 0;
+}
+
+/**
+ * @brief Locates and fixes a single wrong byte of a codeword from its two syndromes.
+ *
+ * With two syndromes Berlekamp-Massey gives an error locator of degree one, 1 + (a / b)x, so a
+ * codeword can have one wrong byte fixed. The Chien search looks for the position whose power of
+ * the generator times b gives a, and the Forney algorithm reduces to b being the error value.
+ *
+ * @param area ECC area of the sector, with its P and Q parity.
+ * @param positions Receives the positions of the bytes of the codeword in the area.
+ * @param length Number of bytes of the codeword, with its parity.
+ * @param a Weighted syndrome of the codeword.
+ * @param b Plain syndrome of the codeword.
+ *
+ * @return 1 if a byte was fixed, 0 if the codeword was valid, -1 if it has more than one wrong byte.
+ */
+static int cd_ecc_fix(uint8_t *area, const uint32_t *positions, uint32_t length, uint8_t a, uint8_t b)
+{
+    uint8_t  t = b;
+    uint32_t k;
+
+    if(!a && !b) return 0;
+
+    if(!a || !b) return -1;
+
+    /* The byte at position length - k is weighted by the generator to the power of k */
+    for(k = 1; k <= length; k++)
+    {
+        t = cd_ecc_double(t);
+
+        if(t != a) continue;
+
+        area[positions[length - k]] ^= b;
+
+        return 1;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Runs a correction pass over the P codewords of the ECC area of a sector.
+ *
+ * The P codewords are the columns of the area, so each of its rows adds a byte to all of them and
+ * the syndromes are computed across the codewords at once.
+ *
+ * @param area ECC area of the sector, with its P and Q parity.
+ * @param failed Receives the number of codewords with more than one wrong byte.
+ *
+ * @return Number of bytes fixed.
+ */
+static uint32_t cd_ecc_correct_p(uint8_t *area, uint32_t *failed)
+{
+    uint8_t  a[CD_ECC_P_COUNT];
+    uint8_t  b[CD_ECC_P_COUNT];
+    uint32_t positions[CD_ECC_P_LENGTH + 2];
+    uint32_t fixed = 0;
+    uint32_t i, row;
+    int      ret;
+
+    memset(a, 0, sizeof(a));
+    memset(b, 0, sizeof(b));
+
+    for(row = 0; row < CD_ECC_P_LENGTH + 2; row++)
+        for(i = 0; i < CD_ECC_P_COUNT; i++)
+        {
+            a[i] = cd_ecc_double(a[i] ^ area[row * CD_ECC_P_COUNT + i]);
+            b[i] ^= area[row * CD_ECC_P_COUNT + i];
+        }
+
+    for(i = 0; i < CD_ECC_P_COUNT; i++)
+    {
+        if(!a[i] && !b[i]) continue;
+
+        for(row = 0; row < CD_ECC_P_LENGTH + 2; row++) positions[row] = row * CD_ECC_P_COUNT + i;
+
+        ret = cd_ecc_fix(area, positions, CD_ECC_P_LENGTH + 2, a[i], b[i]);
+
+        if(ret < 0)
+            (*failed)++;
+        else
+            fixed += ret;
+    }
+
+    return fixed;
+}
+
+/**
+ * @brief Runs a correction pass over the Q codewords of the ECC area of a sector.
+ *
+ * @param area ECC area of the sector, with its P and Q parity.
+ * @param failed Receives the number of codewords with more than one wrong byte.
+ *
+ * @return Number of bytes fixed.
+ */
+static uint32_t cd_ecc_correct_q(uint8_t *area, uint32_t *failed)
+{
+    uint32_t positions[CD_ECC_Q_LENGTH + 2];
+    uint32_t fixed = 0;
+    uint32_t i, k, index;
+    uint8_t  a, b;
+    int      ret;
+
+    for(i = 0; i < CD_ECC_Q_COUNT; i++)
+    {
+        a = b = 0;
+        cd_ecc_sums(area, i / 2 * CD_ECC_P_COUNT + i % 2, CD_ECC_P_COUNT + 2, CD_ECC_Q_AREA, CD_ECC_Q_LENGTH, &a, &b);
+        cd_ecc_sums(area, CD_ECC_Q_AREA + i, CD_ECC_Q_COUNT, CD_ECC_SIZE, 2, &a, &b);
+
+        if(!a && !b) continue;
+
+        index = i / 2 * CD_ECC_P_COUNT + i % 2;
+
+        for(k = 0; k < CD_ECC_Q_LENGTH; k++)
+        {
+            positions[k] = index;
+            index += CD_ECC_P_COUNT + 2;
+
+            if(index >= CD_ECC_Q_AREA) index -= CD_ECC_Q_AREA;
+        }
+
+        positions[CD_ECC_Q_LENGTH]     = CD_ECC_Q_AREA + i;
+        positions[CD_ECC_Q_LENGTH + 1] = CD_ECC_Q_AREA + CD_ECC_Q_COUNT + i;
+
+        ret = cd_ecc_fix(area, positions, CD_ECC_Q_LENGTH + 2, a, b);
+
+        if(ret < 0)
+            (*failed)++;
+        else
+            fixed += ret;
+    }
+
+    return fixed;
+}
+
+/**
+ * @brief Corrects the ECC area of a sector with alternating P and Q passes.
+ *
+ * A byte a P codeword cannot fix may be the only wrong one of its Q codeword, and the other way
+ * around, so the passes are repeated while they fix something.
+ *
+ * @param area ECC area of the sector, with its P and Q parity, that receives the corrected bytes.
+ *
+ * @return Non-zero if all the codewords are valid after the correction.
+ */
+static int cd_ecc_correct_area(uint8_t *area)
+{
+    uint32_t failed, fixed;
+    uint32_t pass;
+
+    for(pass = 0; pass < CD_ECC_PASSES; pass++)
+    {
+        failed = 0;
+        fixed  = cd_ecc_correct_p(area, &failed);
+        fixed += cd_ecc_correct_q(area, &failed);
+
+        if(!failed) return cd_ecc_check(area);
+
+        if(!fixed) return 0;
+    }
+
+    return cd_ecc_check(area);
+}
+
+/**
+ * @brief Tells if a sector has P and Q parity.
+ *
+ * @param sector Pointer to the sector.
+ * @param mode Layout of the sectors, one of the CD_EDC_MODE values.
+ *
+ * @return Non-zero if the sector has P and Q parity.
+ */
+static int cd_ecc_has_parity(const uint8_t *sector, uint32_t mode)
+{
+    return mode != CD_EDC_MODE2 || !(sector[CD_SUBMODE_OFFSET] & CD_SUBMODE_FORM2);
+}
+
+/**
+ * @brief Gets which sectors of a run of them have P and Q parity.
+ *
+ * @param sectors Pointer to the sectors.
+ * @param count Number of sectors, up to CD_ECC_MAX_LANES.
+ * @param mode Layout of the sectors, one of the CD_EDC_MODE values.
+ *
+ * @return A bit per sector, set if it has P and Q parity.
+ */
+static uint32_t cd_ecc_lanes(const uint8_t *sectors, uint32_t count, uint32_t mode)
+{
+    uint32_t lanes = 0;
+    uint32_t i;
+
+    for(i = 0; i < count; i++)
+        if(cd_ecc_has_parity(sectors + (size_t)i * CD_SECTOR_SIZE, mode)) lanes |= 1U << i;
+
+    return lanes;
+}
+
+/**
+ * @brief Copies the ECC area of a sector, with its header cleared if needed.
+ *
+ * @param area Receives the ECC area.
+ * @param sector Pointer to the sector.
+ * @param size Number of bytes to copy.
+ * @param zero_header Non-zero to clear the header, as Mode 2 does.
+ */
+static void cd_ecc_area(uint8_t *area, const uint8_t *sector, uint32_t size, int zero_header)
+{
+    memcpy(area, sector + CD_ECC_OFFSET, size);
+
+    if(zero_header) memset(area, 0, 4);
+}
+
+/**
+ * @brief Computes and stores the P and Q parity of many raw sectors at once.
+ *
+ * @param sectors Pointer to count consecutive sectors of CD_SECTOR_SIZE bytes.
+ * @param count Number of sectors.
+ * @param mode Layout of the sectors: CD_EDC_MODE1, CD_EDC_MODE2_FORM1 or CD_EDC_MODE2, the last one
+ * leaving the Form 2 sectors untouched.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL cd_ecc_generate_many(uint8_t *sectors, uint32_t count, uint32_t mode)
+{
+    uint8_t  area[CD_ECC_SIZE];
+    uint8_t *scratch     = NULL;
+    uint32_t i           = 0;
+    int      zero_header = mode != CD_EDC_MODE1;
+
+    if(!sectors || (mode != CD_EDC_MODE1 && mode != CD_EDC_MODE2_FORM1 && mode != CD_EDC_MODE2)) return -1;
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+    if(count >= 16 && have_ssse3())
+    {
+        scratch = (uint8_t *)malloc(CD_SECTOR_SIZE * CD_ECC_MAX_LANES);
+
+        if(!scratch) return -1;
+
+        if(have_avx2())
+            for(; count - i >= 32; i += 32)
+                cd_ecc_generate_avx2(sectors + (size_t)i * CD_SECTOR_SIZE,
+                                     cd_ecc_lanes(sectors + (size_t)i * CD_SECTOR_SIZE, 32, mode), zero_header,
+                                     scratch);
+
+        for(; count - i >= 16; i += 16)
+            cd_ecc_generate_ssse3(sectors + (size_t)i * CD_SECTOR_SIZE,
+                                  cd_ecc_lanes(sectors + (size_t)i * CD_SECTOR_SIZE, 16, mode), zero_header, scratch);
+    }
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+    if(count >= 16 && have_neon())
+    {
+        scratch = (uint8_t *)malloc(CD_SECTOR_SIZE * CD_ECC_MAX_LANES);
+
+        if(!scratch) return -1;
+
+        for(; count - i >= 16; i += 16)
+            cd_ecc_generate_neon(sectors + (size_t)i * CD_SECTOR_SIZE,
+                                 cd_ecc_lanes(sectors + (size_t)i * CD_SECTOR_SIZE, 16, mode), zero_header, scratch);
+    }
+#endif
+
+    free(scratch);
+
+    for(; i < count; i++)
+    {
+        uint8_t *sector = sectors + (size_t)i * CD_SECTOR_SIZE;
+
+        if(!cd_ecc_has_parity(sector, mode)) continue;
+
+        cd_ecc_area(area, sector, CD_ECC_DATA, zero_header);
+        cd_ecc_parity(area);
+        memcpy(sector + CD_ECC_P_OFFSET, area + CD_ECC_DATA, CD_ECC_P_SIZE + CD_ECC_Q_SIZE);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Checks the P and Q parity of many raw sectors at once.
+ *
+ * @param sectors Pointer to count consecutive sectors of CD_SECTOR_SIZE bytes.
+ * @param count Number of sectors.
+ * @param mode Layout of the sectors: CD_EDC_MODE1, CD_EDC_MODE2_FORM1 or CD_EDC_MODE2, the last one
+ * passing the Form 2 sectors, that have no parity.
+ * @param bitmap Receives a bit per sector, set if its parity is correct, with room for (count + 63) / 64 words.
+ *
+ * @returns Number of sectors with a wrong parity, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL cd_ecc_verify_many(const uint8_t *sectors, uint32_t count, uint32_t mode, uint64_t *bitmap)
+{
+    uint8_t  area[CD_ECC_SIZE];
+    uint8_t *scratch     = NULL;
+    uint32_t i           = 0;
+    uint32_t j, n, pass;
+    int      zero_header = mode != CD_EDC_MODE1;
+    int      failed      = 0;
+
+    if(!sectors || !bitmap || (mode != CD_EDC_MODE1 && mode != CD_EDC_MODE2_FORM1 && mode != CD_EDC_MODE2))
+        return -1;
+
+    memset(bitmap, 0, (count + 63) / 64 * sizeof(uint64_t));
+
+    while(i < count)
+    {
+        const uint8_t *sector = sectors + (size_t)i * CD_SECTOR_SIZE;
+
+        n    = 1;
+        pass = 0;
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+        if(count - i >= 16 && have_ssse3())
+        {
+            if(!scratch) scratch = (uint8_t *)malloc(CD_SECTOR_SIZE * CD_ECC_MAX_LANES);
+
+            if(!scratch) return -1;
+
+            if(count - i >= 32 && have_avx2())
+            {
+                n    = 32;
+                pass = cd_ecc_verify_avx2(sector, zero_header, scratch);
+            }
+            else
+            {
+                n    = 16;
+                pass = cd_ecc_verify_ssse3(sector, zero_header, scratch);
+            }
+        }
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+        if(count - i >= 16 && have_neon())
+        {
+            if(!scratch) scratch = (uint8_t *)malloc(CD_SECTOR_SIZE * CD_ECC_MAX_LANES);
+
+            if(!scratch) return -1;
+
+            n    = 16;
+            pass = cd_ecc_verify_neon(sector, zero_header, scratch);
+        }
+#endif
+
+        if(n == 1)
+        {
+            cd_ecc_area(area, sector, CD_ECC_SIZE, zero_header);
+            pass = cd_ecc_check(area);
+        }
+
+        /* Sectors without parity have nothing to fail */
+        pass |= ~cd_ecc_lanes(sector, n, mode);
+
+        for(j = 0; j < n; j++, i++)
+        {
+            if(pass >> j & 1)
+                bitmap[i / 64] |= 1ULL << (i % 64);
+            else
+                failed++;
+        }
+    }
+
+    free(scratch);
+
+    return failed;
+}
+
+/**
+ * @brief Corrects the P and Q parity errors of many raw sectors at once.
+ *
+ * The parity of all the sectors is checked first with cd_ecc_verify_many, so valid sectors only
+ * cost their syndromes. The others are corrected byte by byte and left untouched if they still
+ * have errors afterwards. Their EDC should be checked again after the correction.
+ *
+ * @param sectors Pointer to count consecutive sectors of CD_SECTOR_SIZE bytes.
+ * @param count Number of sectors.
+ * @param mode Layout of the sectors: CD_EDC_MODE1, CD_EDC_MODE2_FORM1 or CD_EDC_MODE2, the last one
+ * passing the Form 2 sectors, that have no parity.
+ * @param corrected Receives, for each sector, the number of bytes corrected in it.
+ * @param bitmap Receives a bit per sector, set if its parity is correct after the correction, with room for
+ * (count + 63) / 64 words.
+ *
+ * @returns Number of sectors that could not be corrected, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL cd_ecc_correct_many(uint8_t *sectors, uint32_t count, uint32_t mode, uint32_t *corrected,
+                                              uint64_t *bitmap)
+{
+    uint8_t  area[CD_ECC_SIZE];
+    uint32_t i, j;
+    int      zero_header = mode != CD_EDC_MODE1;
+    int      failed      = cd_ecc_verify_many(sectors, count, mode, bitmap);
+
+    if(failed < 0 || !corrected) return -1;
+
+    memset(corrected, 0, count * sizeof(uint32_t));
+
+    for(i = 0; i < count && failed; i++)
+    {
+        uint8_t *sector = sectors + (size_t)i * CD_SECTOR_SIZE;
+
+        if(bitmap[i / 64] >> (i % 64) & 1) continue;
+
+        cd_ecc_area(area, sector, CD_ECC_SIZE, zero_header);
+
+        if(!cd_ecc_correct_area(area)) continue;
+
+        /* A Mode 2 header is not covered by the parity, so it is not corrected */
+        for(j = zero_header ? 4 : 0; j < CD_ECC_SIZE; j++)
+        {
+            if(sector[CD_ECC_OFFSET + j] == area[j]) continue;
+
+            sector[CD_ECC_OFFSET + j] = area[j];
+            corrected[i]++;
+        }
+
+        bitmap[i / 64] |= 1ULL << (i % 64);
+        failed--;
+    }
+
+    return failed;
+}
@@ -0,0 +1,88 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AARU_CHECKSUMS_NATIVE_CD_ECC_H
+#define AARU_CHECKSUMS_NATIVE_CD_ECC_H
+
+/* Start of the area protected by the ECC, after the sync pattern */
+#define CD_ECC_OFFSET   12
+/* Bytes protected by the P parity: header, user data, EDC and the intermediate field */
+#define CD_ECC_DATA     2064
+#define CD_ECC_P_OFFSET 2076
+#define CD_ECC_P_SIZE   172
+#define CD_ECC_Q_OFFSET 2248
+#define CD_ECC_Q_SIZE   104
+/* Bytes covered by the Q parity, the ECC area without it */
+#define CD_ECC_Q_AREA   2236
+/* ECC area with its parity, up to the end of the sector */
+#define CD_ECC_SIZE     2340
+
+/* Codewords of the P parity, 86 columns of 24 data bytes */
+#define CD_ECC_P_COUNT  86
+#define CD_ECC_P_LENGTH 24
+/* Codewords of the Q parity, 52 diagonals of 43 bytes of data and P parity */
+#define CD_ECC_Q_COUNT  52
+#define CD_ECC_Q_LENGTH 43
+
+/* Most P and Q correction passes over a sector */
+#define CD_ECC_PASSES 8
+
+/* Most sectors a SIMD kernel takes at once */
+#define CD_ECC_MAX_LANES 32
+
+/* The polynomial of the field, x^8 + x^4 + x^3 + x^2 + 1, without its x^8 term */
+#define CD_ECC_POLY 0x1D
+
+/*
+ * Multiplication by 1 / (1 + a) in GF(2^8), split in the products of the low nibbles and of
+ * the high nibbles of a byte, so a PSHUFB or TBL instruction does 16 multiplications at once.
+ */
+static const uint8_t ALIGNED_(16) cd_ecc_div3_lo[16] = {0x00, 0xF4, 0xF5, 0x01, 0xF7, 0x03, 0x02, 0xF6,
+                                                        0xF3, 0x07, 0x06, 0xF2, 0x04, 0xF0, 0xF1, 0x05};
+static const uint8_t ALIGNED_(16) cd_ecc_div3_hi[16] = {0x00, 0xFB, 0xEB, 0x10, 0xCB, 0x30, 0x20, 0xDB,
+                                                        0x8B, 0x70, 0x60, 0x9B, 0x40, 0xBB, 0xAB, 0x50};
+
+AARU_EXPORT int AARU_CALL cd_ecc_generate_many(uint8_t *sectors, uint32_t count, uint32_t mode);
+AARU_EXPORT int AARU_CALL cd_ecc_verify_many(const uint8_t *sectors, uint32_t count, uint32_t mode, uint64_t *bitmap);
+AARU_EXPORT int AARU_CALL cd_ecc_correct_many(uint8_t *sectors, uint32_t count, uint32_t mode, uint32_t *corrected,
+                                              uint64_t *bitmap);
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+AARU_EXPORT TARGET_WITH_SSSE3 void AARU_CALL     cd_ecc_generate_ssse3(uint8_t *sectors, uint32_t lanes,
+                                                                   int zero_header, uint8_t *scratch);
+AARU_EXPORT TARGET_WITH_SSSE3 uint32_t AARU_CALL cd_ecc_verify_ssse3(const uint8_t *sectors, int zero_header,
+                                                                     uint8_t *scratch);
+AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL      cd_ecc_generate_avx2(uint8_t *sectors, uint32_t lanes,
+                                                                 int zero_header, uint8_t *scratch);
+AARU_EXPORT TARGET_WITH_AVX2 uint32_t AARU_CALL  cd_ecc_verify_avx2(const uint8_t *sectors, int zero_header,
+                                                                   uint8_t *scratch);
+
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+
+AARU_EXPORT TARGET_WITH_NEON void AARU_CALL     cd_ecc_generate_neon(uint8_t *sectors, uint32_t lanes, int zero_header,
+                                                                 uint8_t *scratch);
+AARU_EXPORT TARGET_WITH_NEON uint32_t AARU_CALL cd_ecc_verify_neon(const uint8_t *sectors, int zero_header,
+                                                                   uint8_t *scratch);
+
+#endif
+
+#endif  // AARU_CHECKSUMS_NATIVE_CD_ECC_H
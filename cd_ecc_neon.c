@@ -0,0 +1,289 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)))
+
+#include <arm_neon.h>
+#include <stdint.h>
+
+#include "library.h"
+#include "cd_ecc.h"
+#include "cd_edc.h"
+#include "simd.h"
+
+/**
+ * @brief Multiplies 16 bytes by the generator of the field.
+ *
+ * @param x Bytes to multiply.
+ *
+ * @return The products.
+ */
+TARGET_WITH_NEON static inline uint8x16_t cd_ecc_double_neon(uint8x16_t x)
+{
+    /* Bytes with their high bit set, that are reduced by the polynomial after the shift */
+    const uint8x16_t carry = vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(x), 7));
+
+    return veorq_u8(vshlq_n_u8(x, 1), vandq_u8(carry, vdupq_n_u8(CD_ECC_POLY)));
+}
+
+/**
+ * @brief Looks up 16 bytes in a table of 16 entries.
+ *
+ * @param table The table.
+ * @param x Indexes, below 16.
+ *
+ * @return Table entries.
+ */
+TARGET_WITH_NEON static inline uint8x16_t cd_ecc_lookup_neon(const uint8_t *table, uint8x16_t x)
+{
+#if defined(__aarch64__) || defined(_M_ARM64)
+    return vqtbl1q_u8(vld1q_u8(table), x);
+#else
+    uint8x8x2_t t = {{vld1_u8(table), vld1_u8(table + 8)}};
+
+    return vcombine_u8(vtbl2_u8(t, vget_low_u8(x)), vtbl2_u8(t, vget_high_u8(x)));
+#endif
+}
+
+/**
+ * @brief Divides 16 bytes by one plus the generator of the field, a nibble at a time.
+ *
+ * @param x Bytes to divide.
+ *
+ * @return The quotients.
+ */
+TARGET_WITH_NEON static inline uint8x16_t cd_ecc_div3_neon(uint8x16_t x)
+{
+    return veorq_u8(cd_ecc_lookup_neon(cd_ecc_div3_lo, vandq_u8(x, vdupq_n_u8(0x0F))),
+                    cd_ecc_lookup_neon(cd_ecc_div3_hi, vshrq_n_u8(x, 4)));
+}
+
+/**
+ * @brief Adds the bytes of a codeword of 16 sectors to its two sums.
+ *
+ * @param area ECC area of the transposed sectors.
+ * @param index Position of the first byte of the codeword in the area.
+ * @param step Distance between consecutive bytes of the codeword.
+ * @param size Size of the area the positions wrap around.
+ * @param length Number of bytes to add.
+ * @param a Weighted sums, multiplied by the generator after each byte.
+ * @param b Plain sums.
+ */
+TARGET_WITH_NEON static inline void cd_ecc_sums_neon(const uint8_t *area, uint32_t index, uint32_t step, uint32_t size,
+                                                     uint32_t length, uint8x16_t *a, uint8x16_t *b)
+{
+    uint8x16_t x;
+
+    while(length--)
+    {
+        x  = vld1q_u8(area + index * 16);
+        *a = cd_ecc_double_neon(veorq_u8(*a, x));
+        *b = veorq_u8(*b, x);
+
+        index += step;
+
+        if(index >= size) index -= size;
+    }
+}
+
+/**
+ * @brief Interleaves row i with row i + 8 of 16 rows, for i from 0 to 7.
+ *
+ * @param r Rows to interleave.
+ * @param t Receives the interleaved rows.
+ */
+TARGET_WITH_NEON static inline void cd_ecc_interleave_neon(const uint8x16_t *r, uint8x16_t *t)
+{
+    uint8x16x2_t z;
+
+    z     = vzipq_u8(r[0], r[8]);
+    t[0]  = z.val[0];
+    t[1]  = z.val[1];
+    z     = vzipq_u8(r[1], r[9]);
+    t[2]  = z.val[0];
+    t[3]  = z.val[1];
+    z     = vzipq_u8(r[2], r[10]);
+    t[4]  = z.val[0];
+    t[5]  = z.val[1];
+    z     = vzipq_u8(r[3], r[11]);
+    t[6]  = z.val[0];
+    t[7]  = z.val[1];
+    z     = vzipq_u8(r[4], r[12]);
+    t[8]  = z.val[0];
+    t[9]  = z.val[1];
+    z     = vzipq_u8(r[5], r[13]);
+    t[10] = z.val[0];
+    t[11] = z.val[1];
+    z     = vzipq_u8(r[6], r[14]);
+    t[12] = z.val[0];
+    t[13] = z.val[1];
+    z     = vzipq_u8(r[7], r[15]);
+    t[14] = z.val[0];
+    t[15] = z.val[1];
+}
+
+/**
+ * @brief Transposes 16 rows of 16 bytes.
+ *
+ * Interleaving row i with row i + 8 rotates by one the 8 bits that give the row and column of
+ * every byte, so four rounds swap the row with the column.
+ *
+ * @param r Rows to transpose.
+ */
+TARGET_WITH_NEON static inline void cd_ecc_transpose_neon(uint8x16_t *r)
+{
+    uint8x16_t t[16];
+
+    cd_ecc_interleave_neon(r, t);
+    cd_ecc_interleave_neon(t, r);
+    cd_ecc_interleave_neon(r, t);
+    cd_ecc_interleave_neon(t, r);
+}
+
+/**
+ * @brief Transposes the bytes from first to last of 16 sectors, so a row holds a byte of each.
+ *
+ * @param scratch Receives the transposed sectors, a row of 16 bytes per byte of a sector.
+ * @param sectors Pointer to the sectors.
+ * @param first First byte, a multiple of 16.
+ * @param last Byte after the last one, a multiple of 16.
+ * @param zero_header Non-zero to clear the header, as Mode 2 does.
+ */
+TARGET_WITH_NEON static void cd_ecc_load_neon(uint8_t *scratch, const uint8_t *sectors, uint32_t first, uint32_t last,
+                                              int zero_header)
+{
+    uint8x16_t r[16];
+    uint32_t   row;
+    int        i;
+
+    for(row = first; row < last; row += 16)
+    {
+        for(i = 0; i < 16; i++) r[i] = vld1q_u8(sectors + i * CD_SECTOR_SIZE + row);
+
+        cd_ecc_transpose_neon(r);
+
+        for(i = 0; i < 16; i++) vst1q_u8(scratch + (row + i) * 16, r[i]);
+    }
+
+    if(!zero_header) return;
+
+    for(i = 0; i < 4; i++) vst1q_u8(scratch + (CD_ECC_OFFSET + i) * 16, vdupq_n_u8(0));
+}
+
+/**
+ * @brief Calculate the P and Q parity of 16 sectors using NEON instructions.
+ *
+ * Every codeword is summed for all the sectors at once, and its parity bytes are solved from
+ * the sums with a TBL multiplication.
+ *
+ * @param sectors Pointer to 16 consecutive sectors.
+ * @param lanes A bit per sector, set to store its parity.
+ * @param zero_header Non-zero to compute the parity with the header cleared, as Mode 2 does.
+ * @param scratch Working memory of CD_SECTOR_SIZE * 16 bytes.
+ */
+AARU_EXPORT TARGET_WITH_NEON void AARU_CALL cd_ecc_generate_neon(uint8_t *sectors, uint32_t lanes, int zero_header,
+                                                                 uint8_t *scratch)
+{
+    uint8_t   *area = scratch + CD_ECC_OFFSET * 16;
+    uint8x16_t a, b, p, r[16];
+    uint32_t   i, row;
+
+    cd_ecc_load_neon(scratch, sectors, 0, CD_ECC_P_OFFSET + 4, zero_header);
+
+    for(i = 0; i < CD_ECC_P_COUNT; i++)
+    {
+        a = b = vdupq_n_u8(0);
+        cd_ecc_sums_neon(area, i, CD_ECC_P_COUNT, CD_ECC_DATA, CD_ECC_P_LENGTH, &a, &b);
+
+        p = cd_ecc_div3_neon(veorq_u8(cd_ecc_double_neon(a), b));
+
+        vst1q_u8(area + (CD_ECC_DATA + i) * 16, p);
+        vst1q_u8(area + (CD_ECC_DATA + CD_ECC_P_COUNT + i) * 16, veorq_u8(p, b));
+    }
+
+    for(i = 0; i < CD_ECC_Q_COUNT; i++)
+    {
+        a = b = vdupq_n_u8(0);
+        cd_ecc_sums_neon(area, i / 2 * CD_ECC_P_COUNT + i % 2, CD_ECC_P_COUNT + 2, CD_ECC_Q_AREA, CD_ECC_Q_LENGTH, &a,
+                         &b);
+
+        p = cd_ecc_div3_neon(veorq_u8(cd_ecc_double_neon(a), b));
+
+        vst1q_u8(area + (CD_ECC_Q_AREA + i) * 16, p);
+        vst1q_u8(area + (CD_ECC_Q_AREA + CD_ECC_Q_COUNT + i) * 16, veorq_u8(p, b));
+    }
+
+    /* The rows before the parity in the first block hold the bytes read from the sectors */
+    for(row = CD_ECC_P_OFFSET & ~15U; row < CD_SECTOR_SIZE; row += 16)
+    {
+        for(i = 0; i < 16; i++) r[i] = vld1q_u8(scratch + (row + i) * 16);
+
+        cd_ecc_transpose_neon(r);
+
+        for(i = 0; i < 16; i++)
+            if(lanes >> i & 1) vst1q_u8(sectors + i * CD_SECTOR_SIZE + row, r[i]);
+    }
+}
+
+/**
+ * @brief Check the P and Q parity of 16 sectors using NEON instructions.
+ *
+ * @param sectors Pointer to 16 consecutive sectors.
+ * @param zero_header Non-zero to check the parity with the header cleared, as Mode 2 does.
+ * @param scratch Working memory of CD_SECTOR_SIZE * 16 bytes.
+ *
+ * @return A bit per sector, set if all its codewords are valid.
+ */
+AARU_EXPORT TARGET_WITH_NEON uint32_t AARU_CALL cd_ecc_verify_neon(const uint8_t *sectors, int zero_header,
+                                                                   uint8_t *scratch)
+{
+    const uint8_t *area  = scratch + CD_ECC_OFFSET * 16;
+    uint8x16_t     error = vdupq_n_u8(0);
+    uint8x16_t     a, b;
+    uint8_t        errors[16];
+    uint32_t       i;
+    uint32_t       pass = 0;
+
+    cd_ecc_load_neon(scratch, sectors, 0, CD_SECTOR_SIZE, zero_header);
+
+    /* The P parity bytes continue the columns */
+    for(i = 0; i < CD_ECC_P_COUNT; i++)
+    {
+        a = b = vdupq_n_u8(0);
+        cd_ecc_sums_neon(area, i, CD_ECC_P_COUNT, CD_ECC_SIZE, CD_ECC_P_LENGTH + 2, &a, &b);
+        error = vorrq_u8(error, vorrq_u8(a, b));
+    }
+
+    for(i = 0; i < CD_ECC_Q_COUNT; i++)
+    {
+        a = b = vdupq_n_u8(0);
+        cd_ecc_sums_neon(area, i / 2 * CD_ECC_P_COUNT + i % 2, CD_ECC_P_COUNT + 2, CD_ECC_Q_AREA, CD_ECC_Q_LENGTH, &a,
+                         &b);
+        cd_ecc_sums_neon(area, CD_ECC_Q_AREA + i, CD_ECC_Q_COUNT, CD_ECC_SIZE, 2, &a, &b);
+        error = vorrq_u8(error, vorrq_u8(a, b));
+    }
+
+    vst1q_u8(errors, error);
+
+    for(i = 0; i < 16; i++)
+        if(!errors[i]) pass |= 1U << i;
+
+    return pass;
+}
+
+#endif
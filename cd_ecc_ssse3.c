@@ -0,0 +1,258 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+#include <stdint.h>
+#include <tmmintrin.h>
+
+#include "library.h"
+#include "cd_ecc.h"
+#include "cd_edc.h"
+#include "simd.h"
+
+/**
+ * @brief Multiplies 16 bytes by the generator of the field.
+ *
+ * @param x Bytes to multiply.
+ *
+ * @return The products.
+ */
+TARGET_WITH_SSSE3 static inline __m128i cd_ecc_double_ssse3(__m128i x)
+{
+    /* Bytes with their high bit set, that are reduced by the polynomial after the shift */
+    const __m128i carry = _mm_cmpgt_epi8(_mm_setzero_si128(), x);
+
+    return _mm_xor_si128(_mm_add_epi8(x, x), _mm_and_si128(carry, _mm_set1_epi8(CD_ECC_POLY)));
+}
+
+/**
+ * @brief Divides 16 bytes by one plus the generator of the field, a nibble at a time.
+ *
+ * @param x Bytes to divide.
+ *
+ * @return The quotients.
+ */
+TARGET_WITH_SSSE3 static inline __m128i cd_ecc_div3_ssse3(__m128i x)
+{
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i lo     = _mm_shuffle_epi8(_mm_load_si128((const __m128i *)cd_ecc_div3_lo), _mm_and_si128(x, nibble));
+    const __m128i hi =
+        _mm_shuffle_epi8(_mm_load_si128((const __m128i *)cd_ecc_div3_hi), _mm_and_si128(_mm_srli_epi16(x, 4), nibble));
+
+    return _mm_xor_si128(lo, hi);
+}
+
+/**
+ * @brief Adds the bytes of a codeword of 16 sectors to its two sums.
+ *
+ * @param area ECC area of the transposed sectors.
+ * @param index Position of the first byte of the codeword in the area.
+ * @param step Distance between consecutive bytes of the codeword.
+ * @param size Size of the area the positions wrap around.
+ * @param length Number of bytes to add.
+ * @param a Weighted sums, multiplied by the generator after each byte.
+ * @param b Plain sums.
+ */
+TARGET_WITH_SSSE3 static inline void cd_ecc_sums_ssse3(const uint8_t *area, uint32_t index, uint32_t step,
+                                                       uint32_t size, uint32_t length, __m128i *a, __m128i *b)
+{
+    __m128i x;
+
+    while(length--)
+    {
+        x  = _mm_loadu_si128((const __m128i *)(area + index * 16));
+        *a = cd_ecc_double_ssse3(_mm_xor_si128(*a, x));
+        *b = _mm_xor_si128(*b, x);
+
+        index += step;
+
+        if(index >= size) index -= size;
+    }
+}
+
+/**
+ * @brief Interleaves row i with row i + 8 of 16 rows, for i from 0 to 7.
+ *
+ * @param r Rows to interleave.
+ * @param t Receives the interleaved rows.
+ */
+TARGET_WITH_SSSE3 static inline void cd_ecc_interleave_ssse3(const __m128i *r, __m128i *t)
+{
+    t[0]  = _mm_unpacklo_epi8(r[0], r[8]);
+    t[1]  = _mm_unpackhi_epi8(r[0], r[8]);
+    t[2]  = _mm_unpacklo_epi8(r[1], r[9]);
+    t[3]  = _mm_unpackhi_epi8(r[1], r[9]);
+    t[4]  = _mm_unpacklo_epi8(r[2], r[10]);
+    t[5]  = _mm_unpackhi_epi8(r[2], r[10]);
+    t[6]  = _mm_unpacklo_epi8(r[3], r[11]);
+    t[7]  = _mm_unpackhi_epi8(r[3], r[11]);
+    t[8]  = _mm_unpacklo_epi8(r[4], r[12]);
+    t[9]  = _mm_unpackhi_epi8(r[4], r[12]);
+    t[10] = _mm_unpacklo_epi8(r[5], r[13]);
+    t[11] = _mm_unpackhi_epi8(r[5], r[13]);
+    t[12] = _mm_unpacklo_epi8(r[6], r[14]);
+    t[13] = _mm_unpackhi_epi8(r[6], r[14]);
+    t[14] = _mm_unpacklo_epi8(r[7], r[15]);
+    t[15] = _mm_unpackhi_epi8(r[7], r[15]);
+}
+
+/**
+ * @brief Transposes 16 rows of 16 bytes.
+ *
+ * Interleaving row i with row i + 8 rotates by one the 8 bits that give the row and column of
+ * every byte, so four rounds swap the row with the column.
+ *
+ * @param r Rows to transpose.
+ */
+TARGET_WITH_SSSE3 static inline void cd_ecc_transpose_ssse3(__m128i *r)
+{
+    __m128i t[16];
+
+    cd_ecc_interleave_ssse3(r, t);
+    cd_ecc_interleave_ssse3(t, r);
+    cd_ecc_interleave_ssse3(r, t);
+    cd_ecc_interleave_ssse3(t, r);
+}
+
+/**
+ * @brief Transposes the bytes from first to last of 16 sectors, so a row holds a byte of each.
+ *
+ * @param scratch Receives the transposed sectors, a row of 16 bytes per byte of a sector.
+ * @param sectors Pointer to the sectors.
+ * @param first First byte, a multiple of 16.
+ * @param last Byte after the last one, a multiple of 16.
+ * @param zero_header Non-zero to clear the header, as Mode 2 does.
+ */
+TARGET_WITH_SSSE3 static void cd_ecc_load_ssse3(uint8_t *scratch, const uint8_t *sectors, uint32_t first,
+                                                uint32_t last, int zero_header)
+{
+    __m128i  r[16];
+    uint32_t row;
+    int      i;
+
+    for(row = first; row < last; row += 16)
+    {
+        for(i = 0; i < 16; i++) r[i] = _mm_loadu_si128((const __m128i *)(sectors + i * CD_SECTOR_SIZE + row));
+
+        cd_ecc_transpose_ssse3(r);
+
+        for(i = 0; i < 16; i++) _mm_storeu_si128((__m128i *)(scratch + (row + i) * 16), r[i]);
+    }
+
+    if(!zero_header) return;
+
+    for(i = 0; i < 4; i++) _mm_storeu_si128((__m128i *)(scratch + (CD_ECC_OFFSET + i) * 16), _mm_setzero_si128());
+}
+
+/**
+ * @brief Calculate the P and Q parity of 16 sectors using SSSE3 instructions.
+ *
+ * Every codeword is summed for all the sectors at once, and its parity bytes are solved from
+ * the sums with a PSHUFB multiplication.
+ *
+ * @param sectors Pointer to 16 consecutive sectors.
+ * @param lanes A bit per sector, set to store its parity.
+ * @param zero_header Non-zero to compute the parity with the header cleared, as Mode 2 does.
+ * @param scratch Working memory of CD_SECTOR_SIZE * 16 bytes.
+ */
+AARU_EXPORT TARGET_WITH_SSSE3 void AARU_CALL cd_ecc_generate_ssse3(uint8_t *sectors, uint32_t lanes, int zero_header,
+                                                                   uint8_t *scratch)
+{
+    uint8_t *area = scratch + CD_ECC_OFFSET * 16;
+    __m128i  a, b, p, r[16];
+    uint32_t i, row;
+
+    cd_ecc_load_ssse3(scratch, sectors, 0, CD_ECC_P_OFFSET + 4, zero_header);
+
+    for(i = 0; i < CD_ECC_P_COUNT; i++)
+    {
+        a = b = _mm_setzero_si128();
+        cd_ecc_sums_ssse3(area, i, CD_ECC_P_COUNT, CD_ECC_DATA, CD_ECC_P_LENGTH, &a, &b);
+
+        p = cd_ecc_div3_ssse3(_mm_xor_si128(cd_ecc_double_ssse3(a), b));
+
+        _mm_storeu_si128((__m128i *)(area + (CD_ECC_DATA + i) * 16), p);
+        _mm_storeu_si128((__m128i *)(area + (CD_ECC_DATA + CD_ECC_P_COUNT + i) * 16), _mm_xor_si128(p, b));
+    }
+
+    for(i = 0; i < CD_ECC_Q_COUNT; i++)
+    {
+        a = b = _mm_setzero_si128();
+        cd_ecc_sums_ssse3(area, i / 2 * CD_ECC_P_COUNT + i % 2, CD_ECC_P_COUNT + 2, CD_ECC_Q_AREA, CD_ECC_Q_LENGTH, &a,
+                          &b);
+
+        p = cd_ecc_div3_ssse3(_mm_xor_si128(cd_ecc_double_ssse3(a), b));
+
+        _mm_storeu_si128((__m128i *)(area + (CD_ECC_Q_AREA + i) * 16), p);
+        _mm_storeu_si128((__m128i *)(area + (CD_ECC_Q_AREA + CD_ECC_Q_COUNT + i) * 16), _mm_xor_si128(p, b));
+    }
+
+    /* The rows before the parity in the first block hold the bytes read from the sectors */
+    for(row = CD_ECC_P_OFFSET & ~15U; row < CD_SECTOR_SIZE; row += 16)
+    {
+        for(i = 0; i < 16; i++) r[i] = _mm_loadu_si128((const __m128i *)(scratch + (row + i) * 16));
+
+        cd_ecc_transpose_ssse3(r);
+
+        for(i = 0; i < 16; i++)
+            if(lanes >> i & 1) _mm_storeu_si128((__m128i *)(sectors + i * CD_SECTOR_SIZE + row), r[i]);
+    }
+}
+
+/**
+ * @brief Check the P and Q parity of 16 sectors using SSSE3 instructions.
+ *
+ * @param sectors Pointer to 16 consecutive sectors.
+ * @param zero_header Non-zero to check the parity with the header cleared, as Mode 2 does.
+ * @param scratch Working memory of CD_SECTOR_SIZE * 16 bytes.
+ *
+ * @return A bit per sector, set if all its codewords are valid.
+ */
+AARU_EXPORT TARGET_WITH_SSSE3 uint32_t AARU_CALL cd_ecc_verify_ssse3(const uint8_t *sectors, int zero_header,
+                                                                     uint8_t *scratch)
+{
+    const uint8_t *area  = scratch + CD_ECC_OFFSET * 16;
+    __m128i        error = _mm_setzero_si128();
+    __m128i        a, b;
+    uint32_t       i;
+
+    cd_ecc_load_ssse3(scratch, sectors, 0, CD_SECTOR_SIZE, zero_header);
+
+    /* The P parity bytes continue the columns */
+    for(i = 0; i < CD_ECC_P_COUNT; i++)
+    {
+        a = b = _mm_setzero_si128();
+        cd_ecc_sums_ssse3(area, i, CD_ECC_P_COUNT, CD_ECC_SIZE, CD_ECC_P_LENGTH + 2, &a, &b);
+        error = _mm_or_si128(error, _mm_or_si128(a, b));
+    }
+
+    for(i = 0; i < CD_ECC_Q_COUNT; i++)
+    {
+        a = b = _mm_setzero_si128();
+        cd_ecc_sums_ssse3(area, i / 2 * CD_ECC_P_COUNT + i % 2, CD_ECC_P_COUNT + 2, CD_ECC_Q_AREA, CD_ECC_Q_LENGTH, &a,
+                          &b);
+        cd_ecc_sums_ssse3(area, CD_ECC_Q_AREA + i, CD_ECC_Q_COUNT, CD_ECC_SIZE, 2, &a, &b);
+        error = _mm_or_si128(error, _mm_or_si128(a, b));
+    }
+
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128()));
+}
+
+#endif
@@ -0,0 +1,367 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * EDC of the CD-ROM sectors, as defined in ECMA-130.
+ *
+ * The EDC is a CRC-32 with the polynomial x^32 + x^31 + x^16 + x^15 + x^4 + x^3 + x + 1, bit
+ * reflected, starting from zero and with no final inversion. It is stored little-endian after
+ * the bytes it protects.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "library.h"
+#include "cd_edc.h"
+#include "simd.h"
+
+static const uint32_t cd_edc_table[8][256] = {
+    {0x00000000, 0x90910101, 0x91210201, 0x01B00300, 0x92410401, 0x02D00500, 0x03600600, 0x93F10701, 0x94810801,
+     0x04100900, 0x05A00A00, 0x95310B01, 0x06C00C00, 0x96510D01, 0x97E10E01, 0x07700F00, 0x99011001, 0x09901100,
+     0x08201200, 0x98B11301, 0x0B401400, 0x9BD11501, 0x9A611601, 0x0AF01700, 0x0D801800, 0x9D111901, 0x9CA11A01,
+     0x0C301B00, 0x9FC11C01, 0x0F501D00, 0x0EE01E00, 0x9E711F01, 0x82012001, 0x12902100, 0x13202200, 0x83B12301,
+     0x10402400, 0x80D12501, 0x81612601, 0x11F02700, 0x16802800, 0x86112901, 0x87A12A01, 0x17302B00, 0x84C12C01,
+     0x14502D00, 0x15E02E00, 0x85712F01, 0x1B003000, 0x8B913101, 0x8A213201, 0x1AB03300, 0x89413401, 0x19D03500,
+     0x18603600, 0x88F13701, 0x8F813801, 0x1F103900, 0x1EA03A00, 0x8E313B01, 0x1DC03C00, 0x8D513D01, 0x8CE13E01,
+     0x1C703F00, 0xB4014001, 0x24904100, 0x25204200, 0xB5B14301, 0x26404400, 0xB6D14501, 0xB7614601, 0x27F04700,
+     0x20804800, 0xB0114901, 0xB1A14A01, 0x21304B00, 0xB2C14C01, 0x22504D00, 0x23E04E00, 0xB3714F01, 0x2D005000,
+     0xBD915101, 0xBC215201, 0x2CB05300, 0xBF415401, 0x2FD05500, 0x2E605600, 0xBEF15701, 0xB9815801, 0x29105900,
+     0x28A05A00, 0xB8315B01, 0x2BC05C00, 0xBB515D01, 0xBAE15E01, 0x2A705F00, 0x36006000, 0xA6916101, 0xA7216201,
+     0x37B06300, 0xA4416401, 0x34D06500, 0x35606600, 0xA5F16701, 0xA2816801, 0x32106900, 0x33A06A00, 0xA3316B01,
+     0x30C06C00, 0xA0516D01, 0xA1E16E01, 0x31706F00, 0xAF017001, 0x3F907100, 0x3E207200, 0xAEB17301, 0x3D407400,
+     0xADD17501, 0xAC617601, 0x3CF07700, 0x3B807800, 0xAB117901, 0xAAA17A01, 0x3A307B00, 0xA9C17C01, 0x39507D00,
+     0x38E07E00, 0xA8717F01, 0xD8018001, 0x48908100, 0x49208200, 0xD9B18301, 0x4A408400, 0xDAD18501, 0xDB618601,
+     0x4BF08700, 0x4C808800, 0xDC118901, 0xDDA18A01, 0x4D308B00, 0xDEC18C01, 0x4E508D00, 0x4FE08E00, 0xDF718F01,
+     0x41009000, 0xD1919101, 0xD0219201, 0x40B09300, 0xD3419401, 0x43D09500, 0x42609600, 0xD2F19701, 0xD5819801,
+     0x45109900, 0x44A09A00, 0xD4319B01, 0x47C09C00, 0xD7519D01, 0xD6E19E01, 0x46709F00, 0x5A00A000, 0xCA91A101,
+     0xCB21A201, 0x5BB0A300, 0xC841A401, 0x58D0A500, 0x5960A600, 0xC9F1A701, 0xCE81A801, 0x5E10A900, 0x5FA0AA00,
+     0xCF31AB01, 0x5CC0AC00, 0xCC51AD01, 0xCDE1AE01, 0x5D70AF00, 0xC301B001, 0x5390B100, 0x5220B200, 0xC2B1B301,
+     0x5140B400, 0xC1D1B501, 0xC061B601, 0x50F0B700, 0x5780B800, 0xC711B901, 0xC6A1BA01, 0x5630BB00, 0xC5C1BC01,
+     0x5550BD00, 0x54E0BE00, 0xC471BF01, 0x6C00C000, 0xFC91C101, 0xFD21C201, 0x6DB0C300, 0xFE41C401, 0x6ED0C500,
+     0x6F60C600, 0xFFF1C701, 0xF881C801, 0x6810C900, 0x69A0CA00, 0xF931CB01, 0x6AC0CC00, 0xFA51CD01, 0xFBE1CE01,
+     0x6B70CF00, 0xF501D001, 0x6590D100, 0x6420D200, 0xF4B1D301, 0x6740D400, 0xF7D1D501, 0xF661D601, 0x66F0D700,
+     0x6180D800, 0xF111D901, 0xF0A1DA01, 0x6030DB00, 0xF3C1DC01, 0x6350DD00, 0x62E0DE00, 0xF271DF01, 0xEE01E001,
+     0x7E90E100, 0x7F20E200, 0xEFB1E301, 0x7C40E400, 0xECD1E501, 0xED61E601, 0x7DF0E700, 0x7A80E800, 0xEA11E901,
+     0xEBA1EA01, 0x7B30EB00, 0xE8C1EC01, 0x7850ED00, 0x79E0EE00, 0xE971EF01, 0x7700F000, 0xE791F101, 0xE621F201,
+     0x76B0F300, 0xE541F401, 0x75D0F500, 0x7460F600, 0xE4F1F701, 0xE381F801, 0x7310F900, 0x72A0FA00, 0xE231FB01,
+     0x71C0FC00, 0xE151FD01, 0xE0E1FE01, 0x7070FF00},
+    {0x00000000, 0x90019000, 0x90002003, 0x0001B003, 0x90034005, 0x0002D005, 0x00036006, 0x9002F006, 0x90058009,
+     0x00041009, 0x0005A00A, 0x9004300A, 0x0006C00C, 0x9007500C, 0x9006E00F, 0x0007700F, 0x90080011, 0x00099011,
+     0x00082012, 0x9009B012, 0x000B4014, 0x900AD014, 0x900B6017, 0x000AF017, 0x000D8018, 0x900C1018, 0x900DA01B,
+     0x000C301B, 0x900EC01D, 0x000F501D, 0x000EE01E, 0x900F701E, 0x90130021, 0x00129021, 0x00132022, 0x9012B022,
+     0x00104024, 0x9011D024, 0x90106027, 0x0011F027, 0x00168028, 0x90171028, 0x9016A02B, 0x0017302B, 0x9015C02D,
+     0x0014502D, 0x0015E02E, 0x9014702E, 0x001B0030, 0x901A9030, 0x901B2033, 0x001AB033, 0x90184035, 0x0019D035,
+     0x00186036, 0x9019F036, 0x901E8039, 0x001F1039, 0x001EA03A, 0x901F303A, 0x001DC03C, 0x901C503C, 0x901DE03F,
+     0x001C703F, 0x90250041, 0x00249041, 0x00252042, 0x9024B042, 0x00264044, 0x9027D044, 0x90266047, 0x0027F047,
+     0x00208048, 0x90211048, 0x9020A04B, 0x0021304B, 0x9023C04D, 0x0022504D, 0x0023E04E, 0x9022704E, 0x002D0050,
+     0x902C9050, 0x902D2053, 0x002CB053, 0x902E4055, 0x002FD055, 0x002E6056, 0x902FF056, 0x90288059, 0x00291059,
+     0x0028A05A, 0x9029305A, 0x002BC05C, 0x902A505C, 0x902BE05F, 0x002A705F, 0x00360060, 0x90379060, 0x90362063,
+     0x0037B063, 0x90354065, 0x0034D065, 0x00356066, 0x9034F066, 0x90338069, 0x00321069, 0x0033A06A, 0x9032306A,
+     0x0030C06C, 0x9031506C, 0x9030E06F, 0x0031706F, 0x903E0071, 0x003F9071, 0x003E2072, 0x903FB072, 0x003D4074,
+     0x903CD074, 0x903D6077, 0x003CF077, 0x003B8078, 0x903A1078, 0x903BA07B, 0x003A307B, 0x9038C07D, 0x0039507D,
+     0x0038E07E, 0x9039707E, 0x90490081, 0x00489081, 0x00492082, 0x9048B082, 0x004A4084, 0x904BD084, 0x904A6087,
+     0x004BF087, 0x004C8088, 0x904D1088, 0x904CA08B, 0x004D308B, 0x904FC08D, 0x004E508D, 0x004FE08E, 0x904E708E,
+     0x00410090, 0x90409090, 0x90412093, 0x0040B093, 0x90424095, 0x0043D095, 0x00426096, 0x9043F096, 0x90448099,
+     0x00451099, 0x0044A09A, 0x9045309A, 0x0047C09C, 0x9046509C, 0x9047E09F, 0x0046709F, 0x005A00A0, 0x905B90A0,
+     0x905A20A3, 0x005BB0A3, 0x905940A5, 0x0058D0A5, 0x005960A6, 0x9058F0A6, 0x905F80A9, 0x005E10A9, 0x005FA0AA,
+     0x905E30AA, 0x005CC0AC, 0x905D50AC, 0x905CE0AF, 0x005D70AF, 0x905200B1, 0x005390B1, 0x005220B2, 0x9053B0B2,
+     0x005140B4, 0x9050D0B4, 0x905160B7, 0x0050F0B7, 0x005780B8, 0x905610B8, 0x9057A0BB, 0x005630BB, 0x9054C0BD,
+     0x005550BD, 0x0054E0BE, 0x905570BE, 0x006C00C0, 0x906D90C0, 0x906C20C3, 0x006DB0C3, 0x906F40C5, 0x006ED0C5,
+     0x006F60C6, 0x906EF0C6, 0x906980C9, 0x006810C9, 0x0069A0CA, 0x906830CA, 0x006AC0CC, 0x906B50CC, 0x906AE0CF,
+     0x006B70CF, 0x906400D1, 0x006590D1, 0x006420D2, 0x9065B0D2, 0x006740D4, 0x9066D0D4, 0x906760D7, 0x0066F0D7,
+     0x006180D8, 0x906010D8, 0x9061A0DB, 0x006030DB, 0x9062C0DD, 0x006350DD, 0x0062E0DE, 0x906370DE, 0x907F00E1,
+     0x007E90E1, 0x007F20E2, 0x907EB0E2, 0x007C40E4, 0x907DD0E4, 0x907C60E7, 0x007DF0E7, 0x007A80E8, 0x907B10E8,
+     0x907AA0EB, 0x007B30EB, 0x9079C0ED, 0x007850ED, 0x0079E0EE, 0x907870EE, 0x007700F0, 0x907690F0, 0x907720F3,
+     0x0076B0F3, 0x907440F5, 0x0075D0F5, 0x007460F6, 0x9075F0F6, 0x907280F9, 0x007310F9, 0x0072A0FA, 0x907330FA,
+     0x0071C0FC, 0x907050FC, 0x9071E0FF, 0x007070FF},
+    {0x00000000, 0x00900190, 0x01200320, 0x01B002B0, 0x02400640, 0x02D007D0, 0x03600560, 0x03F004F0, 0x04800C80,
+     0x04100D10, 0x05A00FA0, 0x05300E30, 0x06C00AC0, 0x06500B50, 0x07E009E0, 0x07700870, 0x09001900, 0x09901890,
+     0x08201A20, 0x08B01BB0, 0x0B401F40, 0x0BD01ED0, 0x0A601C60, 0x0AF01DF0, 0x0D801580, 0x0D101410, 0x0CA016A0,
+     0x0C301730, 0x0FC013C0, 0x0F501250, 0x0EE010E0, 0x0E701170, 0x12003200, 0x12903390, 0x13203120, 0x13B030B0,
+     0x10403440, 0x10D035D0, 0x11603760, 0x11F036F0, 0x16803E80, 0x16103F10, 0x17A03DA0, 0x17303C30, 0x14C038C0,
+     0x14503950, 0x15E03BE0, 0x15703A70, 0x1B002B00, 0x1B902A90, 0x1A202820, 0x1AB029B0, 0x19402D40, 0x19D02CD0,
+     0x18602E60, 0x18F02FF0, 0x1F802780, 0x1F102610, 0x1EA024A0, 0x1E302530, 0x1DC021C0, 0x1D502050, 0x1CE022E0,
+     0x1C702370, 0x24006400, 0x24906590, 0x25206720, 0x25B066B0, 0x26406240, 0x26D063D0, 0x27606160, 0x27F060F0,
+     0x20806880, 0x20106910, 0x21A06BA0, 0x21306A30, 0x22C06EC0, 0x22506F50, 0x23E06DE0, 0x23706C70, 0x2D007D00,
+     0x2D907C90, 0x2C207E20, 0x2CB07FB0, 0x2F407B40, 0x2FD07AD0, 0x2E607860, 0x2EF079F0, 0x29807180, 0x29107010,
+     0x28A072A0, 0x28307330, 0x2BC077C0, 0x2B507650, 0x2AE074E0, 0x2A707570, 0x36005600, 0x36905790, 0x37205520,
+     0x37B054B0, 0x34405040, 0x34D051D0, 0x35605360, 0x35F052F0, 0x32805A80, 0x32105B10, 0x33A059A0, 0x33305830,
+     0x30C05CC0, 0x30505D50, 0x31E05FE0, 0x31705E70, 0x3F004F00, 0x3F904E90, 0x3E204C20, 0x3EB04DB0, 0x3D404940,
+     0x3DD048D0, 0x3C604A60, 0x3CF04BF0, 0x3B804380, 0x3B104210, 0x3AA040A0, 0x3A304130, 0x39C045C0, 0x39504450,
+     0x38E046E0, 0x38704770, 0x4800C800, 0x4890C990, 0x4920CB20, 0x49B0CAB0, 0x4A40CE40, 0x4AD0CFD0, 0x4B60CD60,
+     0x4BF0CCF0, 0x4C80C480, 0x4C10C510, 0x4DA0C7A0, 0x4D30C630, 0x4EC0C2C0, 0x4E50C350, 0x4FE0C1E0, 0x4F70C070,
+     0x4100D100, 0x4190D090, 0x4020D220, 0x40B0D3B0, 0x4340D740, 0x43D0D6D0, 0x4260D460, 0x42F0D5F0, 0x4580DD80,
+     0x4510DC10, 0x44A0DEA0, 0x4430DF30, 0x47C0DBC0, 0x4750DA50, 0x46E0D8E0, 0x4670D970, 0x5A00FA00, 0x5A90FB90,
+     0x5B20F920, 0x5BB0F8B0, 0x5840FC40, 0x58D0FDD0, 0x5960FF60, 0x59F0FEF0, 0x5E80F680, 0x5E10F710, 0x5FA0F5A0,
+     0x5F30F430, 0x5CC0F0C0, 0x5C50F150, 0x5DE0F3E0, 0x5D70F270, 0x5300E300, 0x5390E290, 0x5220E020, 0x52B0E1B0,
+     0x5140E540, 0x51D0E4D0, 0x5060E660, 0x50F0E7F0, 0x5780EF80, 0x5710EE10, 0x56A0ECA0, 0x5630ED30, 0x55C0E9C0,
+     0x5550E850, 0x54E0EAE0, 0x5470EB70, 0x6C00AC00, 0x6C90AD90, 0x6D20AF20, 0x6DB0AEB0, 0x6E40AA40, 0x6ED0ABD0,
+     0x6F60A960, 0x6FF0A8F0, 0x6880A080, 0x6810A110, 0x69A0A3A0, 0x6930A230, 0x6AC0A6C0, 0x6A50A750, 0x6BE0A5E0,
+     0x6B70A470, 0x6500B500, 0x6590B490, 0x6420B620, 0x64B0B7B0, 0x6740B340, 0x67D0B2D0, 0x6660B060, 0x66F0B1F0,
+     0x6180B980, 0x6110B810, 0x60A0BAA0, 0x6030BB30, 0x63C0BFC0, 0x6350BE50, 0x62E0BCE0, 0x6270BD70, 0x7E009E00,
+     0x7E909F90, 0x7F209D20, 0x7FB09CB0, 0x7C409840, 0x7CD099D0, 0x7D609B60, 0x7DF09AF0, 0x7A809280, 0x7A109310,
+     0x7BA091A0, 0x7B309030, 0x78C094C0, 0x78509550, 0x79E097E0, 0x79709670, 0x77008700, 0x77908690, 0x76208420,
+     0x76B085B0, 0x75408140, 0x75D080D0, 0x74608260, 0x74F083F0, 0x73808B80, 0x73108A10, 0x72A088A0, 0x72308930,
+     0x71C08DC0, 0x71508C50, 0x70E08EE0, 0x70708F70},
+    {0x00000000, 0x41000001, 0x82000002, 0xC3000003, 0xB4030007, 0xF5030006, 0x36030005, 0x77030004, 0xD805000D,
+     0x9905000C, 0x5A05000F, 0x1B05000E, 0x6C06000A, 0x2D06000B, 0xEE060008, 0xAF060009, 0x00090019, 0x41090018,
+     0x8209001B, 0xC309001A, 0xB40A001E, 0xF50A001F, 0x360A001C, 0x770A001D, 0xD80C0014, 0x990C0015, 0x5A0C0016,
+     0x1B0C0017, 0x6C0F0013, 0x2D0F0012, 0xEE0F0011, 0xAF0F0010, 0x00120032, 0x41120033, 0x82120030, 0xC3120031,
+     0xB4110035, 0xF5110034, 0x36110037, 0x77110036, 0xD817003F, 0x9917003E, 0x5A17003D, 0x1B17003C, 0x6C140038,
+     0x2D140039, 0xEE14003A, 0xAF14003B, 0x001B002B, 0x411B002A, 0x821B0029, 0xC31B0028, 0xB418002C, 0xF518002D,
+     0x3618002E, 0x7718002F, 0xD81E0026, 0x991E0027, 0x5A1E0024, 0x1B1E0025, 0x6C1D0021, 0x2D1D0020, 0xEE1D0023,
+     0xAF1D0022, 0x00240064, 0x41240065, 0x82240066, 0xC3240067, 0xB4270063, 0xF5270062, 0x36270061, 0x77270060,
+     0xD8210069, 0x99210068, 0x5A21006B, 0x1B21006A, 0x6C22006E, 0x2D22006F, 0xEE22006C, 0xAF22006D, 0x002D007D,
+     0x412D007C, 0x822D007F, 0xC32D007E, 0xB42E007A, 0xF52E007B, 0x362E0078, 0x772E0079, 0xD8280070, 0x99280071,
+     0x5A280072, 0x1B280073, 0x6C2B0077, 0x2D2B0076, 0xEE2B0075, 0xAF2B0074, 0x00360056, 0x41360057, 0x82360054,
+     0xC3360055, 0xB4350051, 0xF5350050, 0x36350053, 0x77350052, 0xD833005B, 0x9933005A, 0x5A330059, 0x1B330058,
+     0x6C30005C, 0x2D30005D, 0xEE30005E, 0xAF30005F, 0x003F004F, 0x413F004E, 0x823F004D, 0xC33F004C, 0xB43C0048,
+     0xF53C0049, 0x363C004A, 0x773C004B, 0xD83A0042, 0x993A0043, 0x5A3A0040, 0x1B3A0041, 0x6C390045, 0x2D390044,
+     0xEE390047, 0xAF390046, 0x004800C8, 0x414800C9, 0x824800CA, 0xC34800CB, 0xB44B00CF, 0xF54B00CE, 0x364B00CD,
+     0x774B00CC, 0xD84D00C5, 0x994D00C4, 0x5A4D00C7, 0x1B4D00C6, 0x6C4E00C2, 0x2D4E00C3, 0xEE4E00C0, 0xAF4E00C1,
+     0x004100D1, 0x414100D0, 0x824100D3, 0xC34100D2, 0xB44200D6, 0xF54200D7, 0x364200D4, 0x774200D5, 0xD84400DC,
+     0x994400DD, 0x5A4400DE, 0x1B4400DF, 0x6C4700DB, 0x2D4700DA, 0xEE4700D9, 0xAF4700D8, 0x005A00FA, 0x415A00FB,
+     0x825A00F8, 0xC35A00F9, 0xB45900FD, 0xF55900FC, 0x365900FF, 0x775900FE, 0xD85F00F7, 0x995F00F6, 0x5A5F00F5,
+     0x1B5F00F4, 0x6C5C00F0, 0x2D5C00F1, 0xEE5C00F2, 0xAF5C00F3, 0x005300E3, 0x415300E2, 0x825300E1, 0xC35300E0,
+     0xB45000E4, 0xF55000E5, 0x365000E6, 0x775000E7, 0xD85600EE, 0x995600EF, 0x5A5600EC, 0x1B5600ED, 0x6C5500E9,
+     0x2D5500E8, 0xEE5500EB, 0xAF5500EA, 0x006C00AC, 0x416C00AD, 0x826C00AE, 0xC36C00AF, 0xB46F00AB, 0xF56F00AA,
+     0x366F00A9, 0x776F00A8, 0xD86900A1, 0x996900A0, 0x5A6900A3, 0x1B6900A2, 0x6C6A00A6, 0x2D6A00A7, 0xEE6A00A4,
+     0xAF6A00A5, 0x006500B5, 0x416500B4, 0x826500B7, 0xC36500B6, 0xB46600B2, 0xF56600B3, 0x366600B0, 0x776600B1,
+     0xD86000B8, 0x996000B9, 0x5A6000BA, 0x1B6000BB, 0x6C6300BF, 0x2D6300BE, 0xEE6300BD, 0xAF6300BC, 0x007E009E,
+     0x417E009F, 0x827E009C, 0xC37E009D, 0xB47D0099, 0xF57D0098, 0x367D009B, 0x777D009A, 0xD87B0093, 0x997B0092,
+     0x5A7B0091, 0x1B7B0090, 0x6C780094, 0x2D780095, 0xEE780096, 0xAF780097, 0x00770087, 0x41770086, 0x82770085,
+     0xC3770084, 0xB4740080, 0xF5740081, 0x36740082, 0x77740083, 0xD872008A, 0x9972008B, 0x5A720088, 0x1B720089,
+     0x6C71008D, 0x2D71008C, 0xEE71008F, 0xAF71008E},
+    {0x00000000, 0x90D00101, 0x91A30201, 0x01730300, 0x93450401, 0x03950500, 0x02E60600, 0x92360701, 0x96890801,
+     0x06590900, 0x072A0A00, 0x97FA0B01, 0x05CC0C00, 0x951C0D01, 0x946F0E01, 0x04BF0F00, 0x9D111001, 0x0DC11100,
+     0x0CB21200, 0x9C621301, 0x0E541400, 0x9E841501, 0x9FF71601, 0x0F271700, 0x0B981800, 0x9B481901, 0x9A3B1A01,
+     0x0AEB1B00, 0x98DD1C01, 0x080D1D00, 0x097E1E00, 0x99AE1F01, 0x8A212001, 0x1AF12100, 0x1B822200, 0x8B522301,
+     0x19642400, 0x89B42501, 0x88C72601, 0x18172700, 0x1CA82800, 0x8C782901, 0x8D0B2A01, 0x1DDB2B00, 0x8FED2C01,
+     0x1F3D2D00, 0x1E4E2E00, 0x8E9E2F01, 0x17303000, 0x87E03101, 0x86933201, 0x16433300, 0x84753401, 0x14A53500,
+     0x15D63600, 0x85063701, 0x81B93801, 0x11693900, 0x101A3A00, 0x80CA3B01, 0x12FC3C00, 0x822C3D01, 0x835F3E01,
+     0x138F3F00, 0xA4414001, 0x34914100, 0x35E24200, 0xA5324301, 0x37044400, 0xA7D44501, 0xA6A74601, 0x36774700,
+     0x32C84800, 0xA2184901, 0xA36B4A01, 0x33BB4B00, 0xA18D4C01, 0x315D4D00, 0x302E4E00, 0xA0FE4F01, 0x39505000,
+     0xA9805101, 0xA8F35201, 0x38235300, 0xAA155401, 0x3AC55500, 0x3BB65600, 0xAB665701, 0xAFD95801, 0x3F095900,
+     0x3E7A5A00, 0xAEAA5B01, 0x3C9C5C00, 0xAC4C5D01, 0xAD3F5E01, 0x3DEF5F00, 0x2E606000, 0xBEB06101, 0xBFC36201,
+     0x2F136300, 0xBD256401, 0x2DF56500, 0x2C866600, 0xBC566701, 0xB8E96801, 0x28396900, 0x294A6A00, 0xB99A6B01,
+     0x2BAC6C00, 0xBB7C6D01, 0xBA0F6E01, 0x2ADF6F00, 0xB3717001, 0x23A17100, 0x22D27200, 0xB2027301, 0x20347400,
+     0xB0E47501, 0xB1977601, 0x21477700, 0x25F87800, 0xB5287901, 0xB45B7A01, 0x248B7B00, 0xB6BD7C01, 0x266D7D00,
+     0x271E7E00, 0xB7CE7F01, 0xF8818001, 0x68518100, 0x69228200, 0xF9F28301, 0x6BC48400, 0xFB148501, 0xFA678601,
+     0x6AB78700, 0x6E088800, 0xFED88901, 0xFFAB8A01, 0x6F7B8B00, 0xFD4D8C01, 0x6D9D8D00, 0x6CEE8E00, 0xFC3E8F01,
+     0x65909000, 0xF5409101, 0xF4339201, 0x64E39300, 0xF6D59401, 0x66059500, 0x67769600, 0xF7A69701, 0xF3199801,
+     0x63C99900, 0x62BA9A00, 0xF26A9B01, 0x605C9C00, 0xF08C9D01, 0xF1FF9E01, 0x612F9F00, 0x72A0A000, 0xE270A101,
+     0xE303A201, 0x73D3A300, 0xE1E5A401, 0x7135A500, 0x7046A600, 0xE096A701, 0xE429A801, 0x74F9A900, 0x758AAA00,
+     0xE55AAB01, 0x776CAC00, 0xE7BCAD01, 0xE6CFAE01, 0x761FAF00, 0xEFB1B001, 0x7F61B100, 0x7E12B200, 0xEEC2B301,
+     0x7CF4B400, 0xEC24B501, 0xED57B601, 0x7D87B700, 0x7938B800, 0xE9E8B901, 0xE89BBA01, 0x784BBB00, 0xEA7DBC01,
+     0x7AADBD00, 0x7BDEBE00, 0xEB0EBF01, 0x5CC0C000, 0xCC10C101, 0xCD63C201, 0x5DB3C300, 0xCF85C401, 0x5F55C500,
+     0x5E26C600, 0xCEF6C701, 0xCA49C801, 0x5A99C900, 0x5BEACA00, 0xCB3ACB01, 0x590CCC00, 0xC9DCCD01, 0xC8AFCE01,
+     0x587FCF00, 0xC1D1D001, 0x5101D100, 0x5072D200, 0xC0A2D301, 0x5294D400, 0xC244D501, 0xC337D601, 0x53E7D700,
+     0x5758D800, 0xC788D901, 0xC6FBDA01, 0x562BDB00, 0xC41DDC01, 0x54CDDD00, 0x55BEDE00, 0xC56EDF01, 0xD6E1E001,
+     0x4631E100, 0x4742E200, 0xD792E301, 0x45A4E400, 0xD574E501, 0xD407E601, 0x44D7E700, 0x4068E800, 0xD0B8E901,
+     0xD1CBEA01, 0x411BEB00, 0xD32DEC01, 0x43FDED00, 0x428EEE00, 0xD25EEF01, 0x4BF0F000, 0xDB20F101, 0xDA53F201,
+     0x4A83F300, 0xD8B5F401, 0x4865F500, 0x4916F600, 0xD9C6F701, 0xDD79F801, 0x4DA9F900, 0x4CDAFA00, 0xDC0AFB01,
+     0x4E3CFC00, 0xDEECFD01, 0xDF9FFE01, 0x4F4FFF00},
+    {0x00000000, 0x9001D100, 0x9000A203, 0x00017303, 0x90024405, 0x00039505, 0x0002E606, 0x90033706, 0x90078809,
+     0x00065909, 0x00072A0A, 0x9006FB0A, 0x0005CC0C, 0x90041D0C, 0x90056E0F, 0x0004BF0F, 0x900C1011, 0x000DC111,
+     0x000CB212, 0x900D6312, 0x000E5414, 0x900F8514, 0x900EF617, 0x000F2717, 0x000B9818, 0x900A4918, 0x900B3A1B,
+     0x000AEB1B, 0x9009DC1D, 0x00080D1D, 0x00097E1E, 0x9008AF1E, 0x901B2021, 0x001AF121, 0x001B8222, 0x901A5322,
+     0x00196424, 0x9018B524, 0x9019C627, 0x00181727, 0x001CA828, 0x901D7928, 0x901C0A2B, 0x001DDB2B, 0x901EEC2D,
+     0x001F3D2D, 0x001E4E2E, 0x901F9F2E, 0x00173030, 0x9016E130, 0x90179233, 0x00164333, 0x90157435, 0x0014A535,
+     0x0015D636, 0x90140736, 0x9010B839, 0x00116939, 0x00101A3A, 0x9011CB3A, 0x0012FC3C, 0x90132D3C, 0x90125E3F,
+     0x00138F3F, 0x90354041, 0x00349141, 0x0035E242, 0x90343342, 0x00370444, 0x9036D544, 0x9037A647, 0x00367747,
+     0x0032C848, 0x90331948, 0x90326A4B, 0x0033BB4B, 0x90308C4D, 0x00315D4D, 0x00302E4E, 0x9031FF4E, 0x00395050,
+     0x90388150, 0x9039F253, 0x00382353, 0x903B1455, 0x003AC555, 0x003BB656, 0x903A6756, 0x903ED859, 0x003F0959,
+     0x003E7A5A, 0x903FAB5A, 0x003C9C5C, 0x903D4D5C, 0x903C3E5F, 0x003DEF5F, 0x002E6060, 0x902FB160, 0x902EC263,
+     0x002F1363, 0x902C2465, 0x002DF565, 0x002C8666, 0x902D5766, 0x9029E869, 0x00283969, 0x00294A6A, 0x90289B6A,
+     0x002BAC6C, 0x902A7D6C, 0x902B0E6F, 0x002ADF6F, 0x90227071, 0x0023A171, 0x0022D272, 0x90230372, 0x00203474,
+     0x9021E574, 0x90209677, 0x00214777, 0x0025F878, 0x90242978, 0x90255A7B, 0x00248B7B, 0x9027BC7D, 0x00266D7D,
+     0x00271E7E, 0x9026CF7E, 0x90698081, 0x00685181, 0x00692282, 0x9068F382, 0x006BC484, 0x906A1584, 0x906B6687,
+     0x006AB787, 0x006E0888, 0x906FD988, 0x906EAA8B, 0x006F7B8B, 0x906C4C8D, 0x006D9D8D, 0x006CEE8E, 0x906D3F8E,
+     0x00659090, 0x90644190, 0x90653293, 0x0064E393, 0x9067D495, 0x00660595, 0x00677696, 0x9066A796, 0x90621899,
+     0x0063C999, 0x0062BA9A, 0x90636B9A, 0x00605C9C, 0x90618D9C, 0x9060FE9F, 0x00612F9F, 0x0072A0A0, 0x907371A0,
+     0x907202A3, 0x0073D3A3, 0x9070E4A5, 0x007135A5, 0x007046A6, 0x907197A6, 0x907528A9, 0x0074F9A9, 0x00758AAA,
+     0x90745BAA, 0x00776CAC, 0x9076BDAC, 0x9077CEAF, 0x00761FAF, 0x907EB0B1, 0x007F61B1, 0x007E12B2, 0x907FC3B2,
+     0x007CF4B4, 0x907D25B4, 0x907C56B7, 0x007D87B7, 0x007938B8, 0x9078E9B8, 0x90799ABB, 0x00784BBB, 0x907B7CBD,
+     0x007AADBD, 0x007BDEBE, 0x907A0FBE, 0x005CC0C0, 0x905D11C0, 0x905C62C3, 0x005DB3C3, 0x905E84C5, 0x005F55C5,
+     0x005E26C6, 0x905FF7C6, 0x905B48C9, 0x005A99C9, 0x005BEACA, 0x905A3BCA, 0x00590CCC, 0x9058DDCC, 0x9059AECF,
+     0x00587FCF, 0x9050D0D1, 0x005101D1, 0x005072D2, 0x9051A3D2, 0x005294D4, 0x905345D4, 0x905236D7, 0x0053E7D7,
+     0x005758D8, 0x905689D8, 0x9057FADB, 0x00562BDB, 0x90551CDD, 0x0054CDDD, 0x0055BEDE, 0x90546FDE, 0x9047E0E1,
+     0x004631E1, 0x004742E2, 0x904693E2, 0x0045A4E4, 0x904475E4, 0x904506E7, 0x0044D7E7, 0x004068E8, 0x9041B9E8,
+     0x9040CAEB, 0x00411BEB, 0x90422CED, 0x0043FDED, 0x00428EEE, 0x90435FEE, 0x004BF0F0, 0x904A21F0, 0x904B52F3,
+     0x004A83F3, 0x9049B4F5, 0x004865F5, 0x004916F6, 0x9048C7F6, 0x904C78F9, 0x004DA9F9, 0x004CDAFA, 0x904D0BFA,
+     0x004E3CFC, 0x904FEDFC, 0x904E9EFF, 0x004F4FFF},
+    {0x00000000, 0x009001D1, 0x012003A2, 0x01B00273, 0x02400744, 0x02D00695, 0x036004E6, 0x03F00537, 0x04800E88,
+     0x04100F59, 0x05A00D2A, 0x05300CFB, 0x06C009CC, 0x0650081D, 0x07E00A6E, 0x07700BBF, 0x09001D10, 0x09901CC1,
+     0x08201EB2, 0x08B01F63, 0x0B401A54, 0x0BD01B85, 0x0A6019F6, 0x0AF01827, 0x0D801398, 0x0D101249, 0x0CA0103A,
+     0x0C3011EB, 0x0FC014DC, 0x0F50150D, 0x0EE0177E, 0x0E7016AF, 0x12003A20, 0x12903BF1, 0x13203982, 0x13B03853,
+     0x10403D64, 0x10D03CB5, 0x11603EC6, 0x11F03F17, 0x168034A8, 0x16103579, 0x17A0370A, 0x173036DB, 0x14C033EC,
+     0x1450323D, 0x15E0304E, 0x1570319F, 0x1B002730, 0x1B9026E1, 0x1A202492, 0x1AB02543, 0x19402074, 0x19D021A5,
+     0x186023D6, 0x18F02207, 0x1F8029B8, 0x1F102869, 0x1EA02A1A, 0x1E302BCB, 0x1DC02EFC, 0x1D502F2D, 0x1CE02D5E,
+     0x1C702C8F, 0x24007440, 0x24907591, 0x252077E2, 0x25B07633, 0x26407304, 0x26D072D5, 0x276070A6, 0x27F07177,
+     0x20807AC8, 0x20107B19, 0x21A0796A, 0x213078BB, 0x22C07D8C, 0x22507C5D, 0x23E07E2E, 0x23707FFF, 0x2D006950,
+     0x2D906881, 0x2C206AF2, 0x2CB06B23, 0x2F406E14, 0x2FD06FC5, 0x2E606DB6, 0x2EF06C67, 0x298067D8, 0x29106609,
+     0x28A0647A, 0x283065AB, 0x2BC0609C, 0x2B50614D, 0x2AE0633E, 0x2A7062EF, 0x36004E60, 0x36904FB1, 0x37204DC2,
+     0x37B04C13, 0x34404924, 0x34D048F5, 0x35604A86, 0x35F04B57, 0x328040E8, 0x32104139, 0x33A0434A, 0x3330429B,
+     0x30C047AC, 0x3050467D, 0x31E0440E, 0x317045DF, 0x3F005370, 0x3F9052A1, 0x3E2050D2, 0x3EB05103, 0x3D405434,
+     0x3DD055E5, 0x3C605796, 0x3CF05647, 0x3B805DF8, 0x3B105C29, 0x3AA05E5A, 0x3A305F8B, 0x39C05ABC, 0x39505B6D,
+     0x38E0591E, 0x387058CF, 0x4800E880, 0x4890E951, 0x4920EB22, 0x49B0EAF3, 0x4A40EFC4, 0x4AD0EE15, 0x4B60EC66,
+     0x4BF0EDB7, 0x4C80E608, 0x4C10E7D9, 0x4DA0E5AA, 0x4D30E47B, 0x4EC0E14C, 0x4E50E09D, 0x4FE0E2EE, 0x4F70E33F,
+     0x4100F590, 0x4190F441, 0x4020F632, 0x40B0F7E3, 0x4340F2D4, 0x43D0F305, 0x4260F176, 0x42F0F0A7, 0x4580FB18,
+     0x4510FAC9, 0x44A0F8BA, 0x4430F96B, 0x47C0FC5C, 0x4750FD8D, 0x46E0FFFE, 0x4670FE2F, 0x5A00D2A0, 0x5A90D371,
+     0x5B20D102, 0x5BB0D0D3, 0x5840D5E4, 0x58D0D435, 0x5960D646, 0x59F0D797, 0x5E80DC28, 0x5E10DDF9, 0x5FA0DF8A,
+     0x5F30DE5B, 0x5CC0DB6C, 0x5C50DABD, 0x5DE0D8CE, 0x5D70D91F, 0x5300CFB0, 0x5390CE61, 0x5220CC12, 0x52B0CDC3,
+     0x5140C8F4, 0x51D0C925, 0x5060CB56, 0x50F0CA87, 0x5780C138, 0x5710C0E9, 0x56A0C29A, 0x5630C34B, 0x55C0C67C,
+     0x5550C7AD, 0x54E0C5DE, 0x5470C40F, 0x6C009CC0, 0x6C909D11, 0x6D209F62, 0x6DB09EB3, 0x6E409B84, 0x6ED09A55,
+     0x6F609826, 0x6FF099F7, 0x68809248, 0x68109399, 0x69A091EA, 0x6930903B, 0x6AC0950C, 0x6A5094DD, 0x6BE096AE,
+     0x6B70977F, 0x650081D0, 0x65908001, 0x64208272, 0x64B083A3, 0x67408694, 0x67D08745, 0x66608536, 0x66F084E7,
+     0x61808F58, 0x61108E89, 0x60A08CFA, 0x60308D2B, 0x63C0881C, 0x635089CD, 0x62E08BBE, 0x62708A6F, 0x7E00A6E0,
+     0x7E90A731, 0x7F20A542, 0x7FB0A493, 0x7C40A1A4, 0x7CD0A075, 0x7D60A206, 0x7DF0A3D7, 0x7A80A868, 0x7A10A9B9,
+     0x7BA0ABCA, 0x7B30AA1B, 0x78C0AF2C, 0x7850AEFD, 0x79E0AC8E, 0x7970AD5F, 0x7700BBF0, 0x7790BA21, 0x7620B852,
+     0x76B0B983, 0x7540BCB4, 0x75D0BD65, 0x7460BF16, 0x74F0BEC7, 0x7380B578, 0x7310B4A9, 0x72A0B6DA, 0x7230B70B,
+     0x71C0B23C, 0x7150B3ED, 0x70E0B19E, 0x7070B04F},
+    {0x00000000, 0x65904101, 0xCB208202, 0xAEB0C303, 0x26420407, 0x43D24506, 0xED628605, 0x88F2C704, 0x4C84080E,
+     0x2914490F, 0x87A48A0C, 0xE234CB0D, 0x6AC60C09, 0x0F564D08, 0xA1E68E0B, 0xC476CF0A, 0x9908101C, 0xFC98511D,
+     0x5228921E, 0x37B8D31F, 0xBF4A141B, 0xDADA551A, 0x746A9619, 0x11FAD718, 0xD58C1812, 0xB01C5913, 0x1EAC9A10,
+     0x7B3CDB11, 0xF3CE1C15, 0x965E5D14, 0x38EE9E17, 0x5D7EDF16, 0x8213203B, 0xE783613A, 0x4933A239, 0x2CA3E338,
+     0xA451243C, 0xC1C1653D, 0x6F71A63E, 0x0AE1E73F, 0xCE972835, 0xAB076934, 0x05B7AA37, 0x6027EB36, 0xE8D52C32,
+     0x8D456D33, 0x23F5AE30, 0x4665EF31, 0x1B1B3027, 0x7E8B7126, 0xD03BB225, 0xB5ABF324, 0x3D593420, 0x58C97521,
+     0xF679B622, 0x93E9F723, 0x579F3829, 0x320F7928, 0x9CBFBA2B, 0xF92FFB2A, 0x71DD3C2E, 0x144D7D2F, 0xBAFDBE2C,
+     0xDF6DFF2D, 0xB4254075, 0xD1B50174, 0x7F05C277, 0x1A958376, 0x92674472, 0xF7F70573, 0x5947C670, 0x3CD78771,
+     0xF8A1487B, 0x9D31097A, 0x3381CA79, 0x56118B78, 0xDEE34C7C, 0xBB730D7D, 0x15C3CE7E, 0x70538F7F, 0x2D2D5069,
+     0x48BD1168, 0xE60DD26B, 0x839D936A, 0x0B6F546E, 0x6EFF156F, 0xC04FD66C, 0xA5DF976D, 0x61A95867, 0x04391966,
+     0xAA89DA65, 0xCF199B64, 0x47EB5C60, 0x227B1D61, 0x8CCBDE62, 0xE95B9F63, 0x3636604E, 0x53A6214F, 0xFD16E24C,
+     0x9886A34D, 0x10746449, 0x75E42548, 0xDB54E64B, 0xBEC4A74A, 0x7AB26840, 0x1F222941, 0xB192EA42, 0xD402AB43,
+     0x5CF06C47, 0x39602D46, 0x97D0EE45, 0xF240AF44, 0xAF3E7052, 0xCAAE3153, 0x641EF250, 0x018EB351, 0x897C7455,
+     0xECEC3554, 0x425CF657, 0x27CCB756, 0xE3BA785C, 0x862A395D, 0x289AFA5E, 0x4D0ABB5F, 0xC5F87C5B, 0xA0683D5A,
+     0x0ED8FE59, 0x6B48BF58, 0xD84980E9, 0xBDD9C1E8, 0x136902EB, 0x76F943EA, 0xFE0B84EE, 0x9B9BC5EF, 0x352B06EC,
+     0x50BB47ED, 0x94CD88E7, 0xF15DC9E6, 0x5FED0AE5, 0x3A7D4BE4, 0xB28F8CE0, 0xD71FCDE1, 0x79AF0EE2, 0x1C3F4FE3,
+     0x414190F5, 0x24D1D1F4, 0x8A6112F7, 0xEFF153F6, 0x670394F2, 0x0293D5F3, 0xAC2316F0, 0xC9B357F1, 0x0DC598FB,
+     0x6855D9FA, 0xC6E51AF9, 0xA3755BF8, 0x2B879CFC, 0x4E17DDFD, 0xE0A71EFE, 0x85375FFF, 0x5A5AA0D2, 0x3FCAE1D3,
+     0x917A22D0, 0xF4EA63D1, 0x7C18A4D5, 0x1988E5D4, 0xB73826D7, 0xD2A867D6, 0x16DEA8DC, 0x734EE9DD, 0xDDFE2ADE,
+     0xB86E6BDF, 0x309CACDB, 0x550CEDDA, 0xFBBC2ED9, 0x9E2C6FD8, 0xC352B0CE, 0xA6C2F1CF, 0x087232CC, 0x6DE273CD,
+     0xE510B4C9, 0x8080F5C8, 0x2E3036CB, 0x4BA077CA, 0x8FD6B8C0, 0xEA46F9C1, 0x44F63AC2, 0x21667BC3, 0xA994BCC7,
+     0xCC04FDC6, 0x62B43EC5, 0x07247FC4, 0x6C6CC09C, 0x09FC819D, 0xA74C429E, 0xC2DC039F, 0x4A2EC49B, 0x2FBE859A,
+     0x810E4699, 0xE49E0798, 0x20E8C892, 0x45788993, 0xEBC84A90, 0x8E580B91, 0x06AACC95, 0x633A8D94, 0xCD8A4E97,
+     0xA81A0F96, 0xF564D080, 0x90F49181, 0x3E445282, 0x5BD41383, 0xD326D487, 0xB6B69586, 0x18065685, 0x7D961784,
+     0xB9E0D88E, 0xDC70998F, 0x72C05A8C, 0x17501B8D, 0x9FA2DC89, 0xFA329D88, 0x54825E8B, 0x31121F8A, 0xEE7FE0A7,
+     0x8BEFA1A6, 0x255F62A5, 0x40CF23A4, 0xC83DE4A0, 0xADADA5A1, 0x031D66A2, 0x668D27A3, 0xA2FBE8A9, 0xC76BA9A8,
+     0x69DB6AAB, 0x0C4B2BAA, 0x84B9ECAE, 0xE129ADAF, 0x4F996EAC, 0x2A092FAD, 0x7777F0BB, 0x12E7B1BA, 0xBC5772B9,
+     0xD9C733B8, 0x5135F4BC, 0x34A5B5BD, 0x9A1576BE, 0xFF8537BF, 0x3BF3F8B5, 0x5E63B9B4, 0xF0D37AB7, 0x95433BB6,
+     0x1DB1FCB2, 0x7821BDB3, 0xD6917EB0, 0xB3013FB1},
+};
+
+/**
+ * @brief Computes the CD-ROM EDC using slicing-by-8 algorithm.
+ *
+ * @param edc A pointer to the previous EDC value, and where the updated value gets stored.
+ * @param data The pointer to the data buffer.
+ * @param len The length of the data in bytes.
+ */
+AARU_EXPORT void AARU_CALL cd_edc_slicing(uint32_t *edc, const uint8_t *data, long len)
+{
+    uint32_t c = *edc;
+    uint32_t one, two;
+
+    while(len >= 8)
+    {
+        one = c ^ ((uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24);
+        two = (uint32_t)data[4] | (uint32_t)data[5] << 8 | (uint32_t)data[6] << 16 | (uint32_t)data[7] << 24;
+
+        c = cd_edc_table[7][one & 0xFF] ^ cd_edc_table[6][(one >> 8) & 0xFF] ^ cd_edc_table[5][(one >> 16) & 0xFF] ^
+            cd_edc_table[4][one >> 24] ^ cd_edc_table[3][two & 0xFF] ^ cd_edc_table[2][(two >> 8) & 0xFF] ^
+            cd_edc_table[1][(two >> 16) & 0xFF] ^ cd_edc_table[0][two >> 24];
+
+        data += 8;
+        len -= 8;
+    }
+
+    while(len-- > 0) c = (c >> 8) ^ cd_edc_table[0][(c ^ *data++) & 0xFF];
+
+    *edc = c;
+}
+
+/**
+ * @brief Computes the CD-ROM EDC of a buffer with the best available kernel.
+ *
+ * @param edc The EDC of the data before this buffer, or 0 to start a new one.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ *
+ * @return The EDC of the data.
+ */
+AARU_EXPORT uint32_t AARU_CALL cd_edc_compute(uint32_t edc, const uint8_t *data, uint32_t len)
+{
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+    if(have_clmul()) return cd_edc_clmul(edc, data, len);
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+    if(have_neon()) return cd_edc_vmull(edc, data, len);
+#endif
+
+    cd_edc_slicing(&edc, data, len);
+
+    return edc;
+}
+
+/**
+ * @brief Checks the EDC of many raw sectors at once.
+ *
+ * @param sectors Pointer to count consecutive sectors of CD_SECTOR_SIZE bytes.
+ * @param count Number of sectors.
+ * @param mode Layout of the sectors, one of the CD_EDC_MODE values.
+ * @param bitmap Receives a bit per sector, set if its EDC is correct, with room for (count + 63) / 64 words.
+ *
+ * @returns Number of sectors with a wrong EDC, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL cd_edc_verify_many(const uint8_t *sectors, uint32_t count, uint32_t mode,
+                                             uint64_t *bitmap)
+{
+    const uint8_t *sector;
+    uint32_t       i, form, offset, len, stored;
+    int            failed = 0;
+
+    if(!sectors || !bitmap || mode < CD_EDC_MODE1 || mode > CD_EDC_MODE2) return -1;
+
+    memset(bitmap, 0, (count + 63) / 64 * sizeof(uint64_t));
+
+    for(i = 0; i < count; i++)
+    {
+        sector = sectors + (size_t)i * CD_SECTOR_SIZE;
+        form   = mode;
+
+        if(mode == CD_EDC_MODE2)
+            form = sector[CD_SUBMODE_OFFSET] & CD_SUBMODE_FORM2 ? CD_EDC_MODE2_FORM2 : CD_EDC_MODE2_FORM1;
+
+        offset = form == CD_EDC_MODE1 ? 0 : 16;
+        len    = form == CD_EDC_MODE1 ? 2064 : form == CD_EDC_MODE2_FORM1 ? 2056 : 2332;
+
+        stored = (uint32_t)sector[offset + len] | (uint32_t)sector[offset + len + 1] << 8 |
+                 (uint32_t)sector[offset + len + 2] << 16 | (uint32_t)sector[offset + len + 3] << 24;
+
+        /* Form 2 sectors can leave the EDC out, zeroing it */
+        if((form == CD_EDC_MODE2_FORM2 && stored == 0) || cd_edc_compute(0, sector + offset, len) == stored)
+            bitmap[i / 64] |= 1ULL << (i % 64);
+        else
+            failed++;
+    }
+
+    return failed;
+}
@@ -0,0 +1,63 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AARU_CHECKSUMS_NATIVE_CD_EDC_H
+#define AARU_CHECKSUMS_NATIVE_CD_EDC_H
+
+/* Size of a raw CD-ROM sector, with sync, header and error correction */
+#define CD_SECTOR_SIZE 2352
+
+/* Sector layouts of cd_edc_verify_many() */
+#define CD_EDC_MODE1       1 /* EDC of bytes 0 to 2063, stored at 2064 */
+#define CD_EDC_MODE2_FORM1 2 /* EDC of bytes 16 to 2071, stored at 2072 */
+#define CD_EDC_MODE2_FORM2 3 /* EDC of bytes 16 to 2347, stored at 2348, or zero if not computed */
+#define CD_EDC_MODE2       4 /* Mode 2 Form 1 or Form 2, as told by the submode byte of each sector */
+
+/* Submode byte of the Mode 2 subheader, and its Form 2 flag */
+#define CD_SUBMODE_OFFSET 18
+#define CD_SUBMODE_FORM2  0x20
+
+/*
+ * Folding constants of the CLMUL and PMULL kernels, in the bit reflected form of crc32_clmul().
+ * Folding 16 bytes forward by D bits multiplies their first 8 bytes by x^(D+32) mod P and their
+ * last 8 bytes by x^(D-32) mod P, each one stored as bitReflect32(k) << 1.
+ */
+static const uint64_t ALIGNED_(16) cd_edc_k512[2] = {0x00000001F8931102, 0x000000012E7928A2};
+static const uint64_t ALIGNED_(16) cd_edc_k384[2] = {0x00000001517F91C2, 0x0000000086ACF0C0};
+static const uint64_t ALIGNED_(16) cd_edc_k256[2] = {0x00000000BD01C000, 0x00000001F75A6182};
+static const uint64_t ALIGNED_(16) cd_edc_k128[2] = {0x000000006C90C100, 0x00000001D5934102};
+
+AARU_EXPORT uint32_t AARU_CALL cd_edc_compute(uint32_t edc, const uint8_t *data, uint32_t len);
+AARU_EXPORT int AARU_CALL      cd_edc_verify_many(const uint8_t *sectors, uint32_t count, uint32_t mode,
+                                                  uint64_t *bitmap);
+AARU_EXPORT void AARU_CALL     cd_edc_slicing(uint32_t *edc, const uint8_t *data, long len);
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+AARU_EXPORT TARGET_WITH_CLMUL uint32_t AARU_CALL cd_edc_clmul(uint32_t edc, const uint8_t *data, long len);
+
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+
+AARU_EXPORT TARGET_WITH_NEON uint32_t AARU_CALL cd_edc_vmull(uint32_t edc, const uint8_t *data, long len);
+
+#endif
+
+#endif  // AARU_CHECKSUMS_NATIVE_CD_EDC_H
@@ -0,0 +1,109 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+#include <inttypes.h>
+#include <smmintrin.h>
+#include <wmmintrin.h>
+
+#include "library.h"
+#include "cd_edc.h"
+
+TARGET_WITH_CLMUL static __m128i cd_edc_fold(__m128i x, __m128i k)
+{
+    return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11));
+}
+
+/**
+ * @brief Calculate the CD-ROM EDC using CLMUL instruction extension.
+ *
+ * The bytes that do not fill a 16 bytes block go first through cd_edc_slicing(), then four
+ * accumulators fold 64 bytes at a time, and are merged in one that folds the last blocks.
+ * The 16 bytes left are the message whose EDC is the result, computed again by
+ * cd_edc_slicing().
+ *
+ * @param edc The previously calculated EDC.
+ * @param data Pointer to the input data buffer.
+ * @param len Length of the input data in bytes.
+ *
+ * @return The calculated EDC.
+ */
+AARU_EXPORT TARGET_WITH_CLMUL uint32_t AARU_CALL cd_edc_clmul(uint32_t edc, const uint8_t *data, long len)
+{
+    uint8_t ALIGNED_(16) tail[16];
+    __m128i x0, x1, x2, x3;
+    long    head = len % 16;
+
+    const __m128i k512 = _mm_load_si128((const __m128i *)cd_edc_k512);
+    const __m128i k384 = _mm_load_si128((const __m128i *)cd_edc_k384);
+    const __m128i k256 = _mm_load_si128((const __m128i *)cd_edc_k256);
+    const __m128i k128 = _mm_load_si128((const __m128i *)cd_edc_k128);
+
+    if(len - head < 64)
+    {
+        cd_edc_slicing(&edc, data, len);
+
+        return edc;
+    }
+
+    cd_edc_slicing(&edc, data, head);
+
+    data += head;
+    len -= head;
+
+    x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)data), _mm_cvtsi32_si128((int)edc));
+    x1 = _mm_loadu_si128((const __m128i *)data + 1);
+    x2 = _mm_loadu_si128((const __m128i *)data + 2);
+    x3 = _mm_loadu_si128((const __m128i *)data + 3);
+
+    data += 64;
+    len -= 64;
+
+    while(len >= 64)
+    {
+        x0 = _mm_xor_si128(cd_edc_fold(x0, k512), _mm_loadu_si128((const __m128i *)data));
+        x1 = _mm_xor_si128(cd_edc_fold(x1, k512), _mm_loadu_si128((const __m128i *)data + 1));
+        x2 = _mm_xor_si128(cd_edc_fold(x2, k512), _mm_loadu_si128((const __m128i *)data + 2));
+        x3 = _mm_xor_si128(cd_edc_fold(x3, k512), _mm_loadu_si128((const __m128i *)data + 3));
+
+        data += 64;
+        len -= 64;
+    }
+
+    x0 = _mm_xor_si128(_mm_xor_si128(cd_edc_fold(x0, k384), cd_edc_fold(x1, k256)),
+                       _mm_xor_si128(cd_edc_fold(x2, k128), x3));
+
+    while(len >= 16)
+    {
+        x0 = _mm_xor_si128(cd_edc_fold(x0, k128), _mm_loadu_si128((const __m128i *)data));
+
+        data += 16;
+        len -= 16;
+    }
+
+    _mm_store_si128((__m128i *)tail, x0);
+
+    edc = 0;
+    cd_edc_slicing(&edc, tail, 16);
+
+    return edc;
+}
+
+#endif
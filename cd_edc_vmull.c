@@ -0,0 +1,113 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+
+#include <arm_neon.h>
+#include <stdint.h>
+
+#include "library.h"
+#include "arm_vmull.h"
+#include "cd_edc.h"
+
+TARGET_WITH_NEON FORCE_INLINE uint64x2_t cd_edc_fold(uint64x2_t x, uint64x2_t k)
+{
+    return veorq_u64(sse2neon_vmull_p64(vget_low_u64(x), vget_low_u64(k)),
+                     sse2neon_vmull_p64(vget_high_u64(x), vget_high_u64(k)));
+}
+
+TARGET_WITH_NEON FORCE_INLINE uint64x2_t cd_edc_load(const uint8_t *data)
+{
+    return vreinterpretq_u64_u8(vld1q_u8(data));
+}
+
+/**
+ * @brief Calculate the CD-ROM EDC using NEON instructions.
+ *
+ * The bytes that do not fill a 16 bytes block go first through cd_edc_slicing(), then four
+ * accumulators fold 64 bytes at a time, and are merged in one that folds the last blocks.
+ * The 16 bytes left are the message whose EDC is the result, computed again by
+ * cd_edc_slicing().
+ *
+ * @param edc The previously calculated EDC.
+ * @param data Pointer to the input data buffer.
+ * @param len Length of the input data in bytes.
+ *
+ * @return The calculated EDC.
+ */
+AARU_EXPORT TARGET_WITH_NEON uint32_t AARU_CALL cd_edc_vmull(uint32_t edc, const uint8_t *data, long len)
+{
+    uint8_t    ALIGNED_(16) tail[16];
+    uint64x2_t x0, x1, x2, x3;
+    long       head = len % 16;
+
+    const uint64x2_t k512 = vld1q_u64(cd_edc_k512);
+    const uint64x2_t k384 = vld1q_u64(cd_edc_k384);
+    const uint64x2_t k256 = vld1q_u64(cd_edc_k256);
+    const uint64x2_t k128 = vld1q_u64(cd_edc_k128);
+
+    if(len - head < 64)
+    {
+        cd_edc_slicing(&edc, data, len);
+
+        return edc;
+    }
+
+    cd_edc_slicing(&edc, data, head);
+
+    data += head;
+    len -= head;
+
+    x0 = veorq_u64(cd_edc_load(data), vreinterpretq_u64_u32(vsetq_lane_u32(edc, vdupq_n_u32(0), 0)));
+    x1 = cd_edc_load(data + 16);
+    x2 = cd_edc_load(data + 32);
+    x3 = cd_edc_load(data + 48);
+
+    data += 64;
+    len -= 64;
+
+    while(len >= 64)
+    {
+        x0 = veorq_u64(cd_edc_fold(x0, k512), cd_edc_load(data));
+        x1 = veorq_u64(cd_edc_fold(x1, k512), cd_edc_load(data + 16));
+        x2 = veorq_u64(cd_edc_fold(x2, k512), cd_edc_load(data + 32));
+        x3 = veorq_u64(cd_edc_fold(x3, k512), cd_edc_load(data + 48));
+
+        data += 64;
+        len -= 64;
+    }
+
+    x0 = veorq_u64(veorq_u64(cd_edc_fold(x0, k384), cd_edc_fold(x1, k256)), veorq_u64(cd_edc_fold(x2, k128), x3));
+
+    while(len >= 16)
+    {
+        x0 = veorq_u64(cd_edc_fold(x0, k128), cd_edc_load(data));
+
+        data += 16;
+        len -= 16;
+    }
+
+    vst1q_u8(tail, vreinterpretq_u8_u64(x0));
+
+    edc = 0;
+    cd_edc_slicing(&edc, tail, 16);
+
+    return edc;
+}
+
+#endif
@@ -0,0 +1,332 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Content-defined chunking on the SpamSum rolling hash.
+ *
+ * A chunk ends after a byte where the rolling hash of the last ROLLING_WINDOW bytes h
+ * satisfies h % SSDEEP_BS(level) == SSDEEP_BS(level) - 1, the same test that triggers a
+ * SpamSum blockhash, so the positions are searched with the SpamSum prescan kernels. As the
+ * boundaries only depend on the bytes around them, inserting or removing data only changes
+ * the chunks next to the edit.
+ *
+ * No boundary is searched in the first min_size bytes of a chunk, and one is forced after
+ * max_size bytes. In between, the distribution of chunk sizes is narrowed around avg_size by
+ * testing a level above the middle one until avg_size bytes, and a level below it after them.
+ * Every position that triggers the upper level also triggers the lower one, so the prescan
+ * only searches for the lower level and its hits are tested again while the chunk is small.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "library.h"
+#include "cdc.h"
+#include "crc64.h"
+#include "simd.h"
+#include "spamsum.h"
+
+/* Positions searched at once by the prescan, small so little is searched past a boundary */
+#define CDC_SCAN_BLOCK 512
+
+typedef void(AARU_CALL *cdc_prescan_fn)(const uint8_t *data, uint32_t len, uint32_t bias, uint32_t level,
+                                        uint64_t *bitmap);
+
+/* Index of the lowest set bit of a non-zero value */
+FORCE_INLINE uint32_t cdc_lowest_bit(uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctzll(bits);
+#else
+    uint32_t index = 0;
+
+    while(!(bits & 1))
+    {
+        bits >>= 1;
+        index++;
+    }
+
+    return index;
+#endif
+}
+
+/* Whether a rolling hash triggers a level, as in spamsum_prescan() */
+FORCE_INLINE int cdc_trigger(uint32_t h, uint32_t level)
+{
+    return h % (uint32_t)SSDEEP_BS(level) == (uint32_t)SSDEEP_BS(level) - 1;
+}
+
+/* Rolling hash of the ROLLING_WINDOW bytes ending at data */
+FORCE_INLINE uint32_t cdc_hash(const uint8_t *data)
+{
+    uint32_t h1 = 0;
+    uint32_t h2 = 0;
+    uint32_t h3 = 0;
+    int      age;
+
+    for(age = 0; age < ROLLING_WINDOW; age++)
+    {
+        h1 += data[-age];
+        h2 += h1;
+        h3 ^= (uint32_t)data[-age] << (5 * age);
+    }
+
+    return h1 + h2 + h3;
+}
+
+/* Rolling hash of the window ending at a position, taking the bytes before the buffer from the context */
+FORCE_INLINE uint32_t cdc_hash_at(const cdc_ctx *ctx, const uint8_t *data, uint32_t pos)
+{
+    uint8_t window[ROLLING_WINDOW];
+    int     i;
+
+    if(pos >= CDC_HISTORY) return cdc_hash(data + pos);
+
+    for(i = 0; i < ROLLING_WINDOW; i++)
+        window[i] = (int)pos + i >= CDC_HISTORY ? data[pos + i - CDC_HISTORY] : ctx->history[pos + i];
+
+    return cdc_hash(window + CDC_HISTORY);
+}
+
+/**
+ * @brief Initializes a content-defined chunking context.
+ *
+ * @param min_size Smallest chunk, at least CDC_MIN_SIZE bytes.
+ * @param avg_size Chunk size to aim for, from min_size to max_size.
+ * @param max_size Largest chunk, up to CDC_MAX_SIZE bytes.
+ * @param flags CDC_CRC64 to compute the CRC-64 of every chunk, or 0.
+ *
+ * @return Pointer to a structure containing the chunking state, or NULL on error.
+ */
+AARU_EXPORT cdc_ctx *AARU_CALL cdc_init(uint32_t min_size, uint32_t avg_size, uint32_t max_size, uint32_t flags)
+{
+    cdc_ctx *ctx;
+
+    if(min_size < CDC_MIN_SIZE || avg_size < min_size || max_size < avg_size || max_size > CDC_MAX_SIZE) return NULL;
+
+    if(flags & ~CDC_CRC64) return NULL;
+
+    ctx = (cdc_ctx *)malloc(sizeof(cdc_ctx));
+
+    if(!ctx) return NULL;
+
+    memset(ctx, 0, sizeof(cdc_ctx));
+
+    ctx->min_size = min_size;
+    ctx->avg_size = avg_size;
+    ctx->max_size = max_size;
+    ctx->flags    = flags;
+    ctx->crc      = CRC64_ECMA_SEED;
+
+    /* Largest level with a block size up to the average, the chunks then average close to it */
+    while((uint32_t)SSDEEP_BS(ctx->level + 1) <= avg_size) ctx->level++;
+
+    return ctx;
+}
+
+/**
+ * @brief Searches for the first boundary in a range of positions of a buffer.
+ *
+ * @param ctx Pointer to the chunking context.
+ * @param data Pointer to the input data buffer.
+ * @param from First position to test.
+ * @param to One past the last position to test.
+ * @param small Positions before it belong to chunks smaller than the average size.
+ * @param prescan Function that computes the bitmap of trigger points.
+ *
+ * @return Position of the last byte of the chunk, or to if there is no boundary.
+ */
+static uint32_t cdc_find(const cdc_ctx *ctx, const uint8_t *data, uint32_t from, uint32_t to, uint32_t small,
+                         cdc_prescan_fn prescan)
+{
+    uint64_t bitmap[CDC_SCAN_BLOCK / 64];
+    uint32_t pos = from;
+    uint32_t block, w, hit;
+
+    while(pos < to)
+    {
+        /* Positions that need the bytes of the previous update, and the last few ones */
+        if(pos < CDC_HISTORY || to - pos < 64)
+        {
+            if(cdc_trigger(cdc_hash_at(ctx, data, pos), pos < small ? ctx->level + 1 : ctx->level - 1)) return pos;
+
+            pos++;
+            continue;
+        }
+
+        block = to - pos < CDC_SCAN_BLOCK ? (to - pos) & ~63U : CDC_SCAN_BLOCK;
+
+        prescan(data + pos, block, 0, ctx->level - 1, bitmap);
+
+        for(w = 0; w < block / 64; w++)
+        {
+            uint64_t bits = bitmap[w];
+
+            while(bits)
+            {
+                hit = pos + w * 64 + cdc_lowest_bit(bits);
+
+                bits &= bits - 1;
+
+                if(hit >= small || cdc_trigger(cdc_hash(data + hit), ctx->level + 1)) return hit;
+            }
+        }
+
+        pos += block;
+    }
+
+    return to;
+}
+
+/* Adds a run of bytes to the CRC-64 of the current chunk */
+FORCE_INLINE void cdc_crc(cdc_ctx *ctx, const uint8_t *data, uint32_t len)
+{
+    crc64_ctx crc;
+
+    if(!(ctx->flags & CDC_CRC64) || !len) return;
+
+    crc.crc         = ctx->crc;
+    crc.buffer      = NULL;
+    crc.buffer_size = 0;
+    crc.buffer_len  = 0;
+
+    crc64_update(&crc, data, len);
+
+    ctx->crc = crc.crc;
+}
+
+/* Ends the current chunk before an offset of the stream */
+FORCE_INLINE void cdc_emit(cdc_ctx *ctx, uint64_t end, cdc_chunk *chunk)
+{
+    chunk->offset = ctx->chunk_offset;
+    chunk->length = (uint32_t)(end - ctx->chunk_offset);
+    chunk->crc64  = ctx->flags & CDC_CRC64 ? ctx->crc ^ CRC64_ECMA_SEED : 0;
+
+    ctx->chunk_offset = end;
+    ctx->crc          = CRC64_ECMA_SEED;
+}
+
+/**
+ * @brief Splits new data in content-defined chunks.
+ *
+ * The data continues the stream of the previous updates. Chunks are returned as soon as
+ * their end is found, and the one still open when the stream ends is returned by cdc_final().
+ * A chunk can span several updates, its CRC-64 being computed as the data goes by, so it
+ * never has to be read again.
+ *
+ * @param ctx Pointer to the chunking context.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ * @param chunks Receives the chunks that end in this data, with room for len / min_size + 1 entries.
+ *
+ * @returns Number of chunks found, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL cdc_update(cdc_ctx *ctx, const uint8_t *data, uint32_t len, cdc_chunk *chunks)
+{
+    cdc_prescan_fn prescan = spamsum_prescan;
+    uint32_t       pos     = 0;
+    uint32_t       from, to, last, small, cut;
+    uint64_t       done;
+    int            found = 0;
+
+    if(!ctx || !data || !chunks) return -1;
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+    if(have_avx2()) prescan = spamsum_prescan_avx2;
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+    if(have_neon()) prescan = spamsum_prescan_neon;
+#endif
+
+    while(pos < len)
+    {
+        /* Bytes of the current chunk before this position, always below max_size */
+        done = ctx->offset + pos - ctx->chunk_offset;
+
+        if(done + 1 < ctx->min_size && ctx->min_size - 1 - done >= len - pos) break;
+
+        from  = done + 1 < ctx->min_size ? pos + (uint32_t)(ctx->min_size - 1 - done) : pos;
+        last  = ctx->max_size - 1 - done >= len - pos ? len : pos + (uint32_t)(ctx->max_size - 1 - done);
+        to    = last < len ? last + 1 : len;
+        small = pos;
+
+        if(done + 1 < ctx->avg_size)
+            small = ctx->avg_size - 1 - done >= len - pos ? len : pos + (uint32_t)(ctx->avg_size - 1 - done);
+
+        cut = cdc_find(ctx, data, from, to, small, prescan);
+
+        /* No boundary, the chunk goes on in the next update unless it reached max_size */
+        if(cut == to)
+        {
+            if(last == len) break;
+
+            cut = last;
+        }
+
+        cdc_crc(ctx, data + pos, cut + 1 - pos);
+        cdc_emit(ctx, ctx->offset + cut + 1, &chunks[found++]);
+
+        pos = cut + 1;
+    }
+
+    cdc_crc(ctx, data + pos, len - pos);
+
+    if(len >= CDC_HISTORY)
+        memcpy(ctx->history, data + len - CDC_HISTORY, CDC_HISTORY);
+    else
+    {
+        memmove(ctx->history, ctx->history + len, CDC_HISTORY - len);
+        memcpy(ctx->history + CDC_HISTORY - len, data, len);
+    }
+
+    ctx->offset += len;
+
+    return found;
+}
+
+/**
+ * @brief Ends the stream, returning the chunk still open.
+ *
+ * @param ctx Pointer to the chunking context.
+ * @param chunk Receives the last chunk, that can be smaller than min_size.
+ *
+ * @returns 1 if there was a chunk open, 0 if the stream ended at a boundary, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL cdc_final(cdc_ctx *ctx, cdc_chunk *chunk)
+{
+    if(!ctx || !chunk) return -1;
+
+    if(ctx->offset == ctx->chunk_offset) return 0;
+
+    cdc_emit(ctx, ctx->offset, chunk);
+
+    return 1;
+}
+
+/**
+ * @brief Frees the resources allocated for the chunking context.
+ *
+ * @param ctx The chunking context structure, to be freed.
+ */
+AARU_EXPORT void AARU_CALL cdc_free(cdc_ctx *ctx)
+{
+    if(ctx) free(ctx);
+}
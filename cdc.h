@@ -0,0 +1,58 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AARU_CHECKSUMS_NATIVE_CDC_H
+#define AARU_CHECKSUMS_NATIVE_CDC_H
+
+/* Bounds of the chunk sizes */
+#define CDC_MIN_SIZE 64
+#define CDC_MAX_SIZE (1 << 30)
+
+/* Bytes before a position that its rolling hash depends on, the SpamSum ROLLING_WINDOW minus one */
+#define CDC_HISTORY 6
+
+/* Flags of cdc_init() */
+#define CDC_CRC64 1 /* Compute the CRC-64 of every chunk */
+
+/* A chunk found by cdc_update() or cdc_final() */
+typedef struct
+{
+    uint64_t offset;
+    uint32_t length;
+    uint64_t crc64;
+} cdc_chunk;
+
+typedef struct
+{
+    uint64_t offset;
+    uint64_t chunk_offset;
+    uint64_t crc;
+    uint32_t min_size;
+    uint32_t avg_size;
+    uint32_t max_size;
+    uint32_t level;
+    uint32_t flags;
+    uint8_t  history[CDC_HISTORY];
+} cdc_ctx;
+
+AARU_EXPORT cdc_ctx *AARU_CALL cdc_init(uint32_t min_size, uint32_t avg_size, uint32_t max_size, uint32_t flags);
+AARU_EXPORT int AARU_CALL      cdc_update(cdc_ctx *ctx, const uint8_t *data, uint32_t len, cdc_chunk *chunks);
+AARU_EXPORT int AARU_CALL      cdc_final(cdc_ctx *ctx, cdc_chunk *chunk);
+AARU_EXPORT void AARU_CALL     cdc_free(cdc_ctx *ctx);
+
+#endif  // AARU_CHECKSUMS_NATIVE_CDC_H
@@ -179,9 +179,16 @@ const uint16_t crc16_table[8][256] = {
      0x110F, 0xDDCE, 0xC88E, 0x044F}
 };
 
+/* Size of an exported state, see crc16_export_state() */
+#define CRC16_STATE_SIZE 14
+
 AARU_EXPORT crc16_ctx *AARU_CALL crc16_init();
 AARU_EXPORT int AARU_CALL        crc16_update(crc16_ctx *ctx, const uint8_t *data, uint32_t len);
+AARU_EXPORT int AARU_CALL        crc16_update64(crc16_ctx *ctx, const uint8_t *data, uint64_t len);
 AARU_EXPORT int AARU_CALL        crc16_final(crc16_ctx *ctx, uint16_t *crc);
+AARU_EXPORT int AARU_CALL        crc16_export_state(crc16_ctx *ctx, uint8_t *buffer, uint32_t len);
+AARU_EXPORT crc16_ctx *AARU_CALL crc16_import_state(const uint8_t *buffer, uint32_t len);
+AARU_EXPORT crc16_ctx *AARU_CALL crc16_clone(const crc16_ctx *ctx);
 AARU_EXPORT void AARU_CALL       crc16_free(crc16_ctx *ctx);
 
 #endif  // AARU_CHECKSUMS_NATIVE_CRC16_H
\ No newline at end of file
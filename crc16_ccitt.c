@@ -18,9 +18,14 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "library.h"
 #include "crc16_ccitt.h"
+#include "state.h"
+
+/* Largest chunk fed to the 32-bit update function at once */
+#define CRC16_CCITT_MAX_CHUNK (1 << 30)
 
 /**
  * @brief Initializes the CRC-16 checksum algorithm with the CCITT polynomial.
@@ -102,6 +107,32 @@ AARU_EXPORT int AARU_CALL crc16_ccitt_update(crc16_ccitt_ctx *ctx, const uint8_t
     return 0;
 }
 
+/**
+ * @brief Updates the CRC-16 (CCITT polynomial) checksum with new data of any length.
+ *
+ * This function updates the CRC-16 (CCITT polynomial) checksum with buffers that can be larger than 4GiB,
+ * splitting them in chunks that fit the 32-bit update function.
+ *
+ * @param ctx Pointer to the CRC-16 (CCITT polynomial) context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL crc16_ccitt_update64(crc16_ccitt_ctx *ctx, const uint8_t *data, uint64_t len)
+{
+    if(!ctx || !data) return -1;
+
+    while(len > CRC16_CCITT_MAX_CHUNK)
+    {
+        crc16_ccitt_update(ctx, data, CRC16_CCITT_MAX_CHUNK);
+        data += CRC16_CCITT_MAX_CHUNK;
+        len -= CRC16_CCITT_MAX_CHUNK;
+    }
+
+    return crc16_ccitt_update(ctx, data, (uint32_t)len);
+}
+
 /**
  * @brief Finalizes the calculation of the CRC-16 checksum.
  *
@@ -133,4 +164,85 @@ AARU_EXPORT int AARU_CALL crc16_ccitt_final(crc16_ccitt_ctx *ctx, uint16_t *crc)
 AARU_EXPORT void AARU_CALL crc16_ccitt_free(crc16_ccitt_ctx *ctx)
 {
     if(ctx) free(ctx);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Exports the state of a CRC-16 CCITT context.
+ *
+ * The state is stored in a versioned and endian independent format, so it can be
+ * passed to crc16_ccitt_import_state() to resume the calculation later, even on a
+ * different machine.
+ *
+ * @param ctx Pointer to the CRC-16 CCITT context structure.
+ * @param buffer Buffer that receives the state, or NULL to query its size.
+ * @param len Size of the buffer.
+ *
+ * @returns Size of the exported state, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL crc16_ccitt_export_state(crc16_ccitt_ctx *ctx, uint8_t *buffer, uint32_t len)
+{
+    uint8_t *p;
+
+    if(!ctx) return -1;
+
+    if(!buffer) return CRC16_CCITT_STATE_SIZE;
+
+    if(len < CRC16_CCITT_STATE_SIZE) return -1;
+
+    p = state_put_header(buffer, STATE_ALGORITHM_CRC16_CCITT, CRC16_CCITT_STATE_SIZE - STATE_HEADER_SIZE);
+    state_put_u16(p, ctx->crc);
+
+    return CRC16_CCITT_STATE_SIZE;
+}
+
+/**
+ * @brief Creates a CRC-16 CCITT context from a state exported by crc16_ccitt_export_state().
+ *
+ * @param buffer Buffer containing the exported state.
+ * @param len Size of the buffer.
+ *
+ * @return Pointer to a structure containing the checksum state, or NULL if the
+ * state is not valid.
+ */
+AARU_EXPORT crc16_ccitt_ctx *AARU_CALL crc16_ccitt_import_state(const uint8_t *buffer, uint32_t len)
+{
+    crc16_ccitt_ctx *ctx;
+    uint32_t         payload;
+    const uint8_t   *p = state_get_header(buffer, len, STATE_ALGORITHM_CRC16_CCITT, &payload);
+
+    if(!p || payload != CRC16_CCITT_STATE_SIZE - STATE_HEADER_SIZE) return NULL;
+
+    ctx = crc16_ccitt_init();
+
+    if(!ctx) return NULL;
+
+    state_get_u16(p, &ctx->crc);
+
+    return ctx;
+}
+
+/**
+ * @brief Creates a copy of a CRC-16 CCITT context.
+ *
+ * The copy continues from the same point as the original, and both can be updated
+ * and finalized independently, allowing to calculate a common prefix only once or to
+ * take intermediate checksums without disturbing the original.
+ *
+ * @param ctx Pointer to the CRC-16 CCITT context structure.
+ *
+ * @return Pointer to a structure containing the copied checksum state, or NULL on error.
+ */
+AARU_EXPORT crc16_ccitt_ctx *AARU_CALL crc16_ccitt_clone(const crc16_ccitt_ctx *ctx)
+{
+    crc16_ccitt_ctx *clone;
+
+    if(!ctx) return NULL;
+
+    clone = (crc16_ccitt_ctx *)malloc(sizeof(crc16_ccitt_ctx));
+
+    if(!clone) return NULL;
+
+    memcpy(clone, ctx, sizeof(crc16_ccitt_ctx));
+
+    return clone;
+}
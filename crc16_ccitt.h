@@ -179,9 +179,16 @@ const uint16_t crc16_ccitt_table[8][256] = {
      0x5C3A, 0x1BE9, 0xD39C, 0x944F}
 };
 
+/* Size of an exported state, see crc16_ccitt_export_state() */
+#define CRC16_CCITT_STATE_SIZE 14
+
 AARU_EXPORT crc16_ccitt_ctx *AARU_CALL crc16_ccitt_init();
 AARU_EXPORT int AARU_CALL              crc16_ccitt_update(crc16_ccitt_ctx *ctx, const uint8_t *data, uint32_t len);
+AARU_EXPORT int AARU_CALL              crc16_ccitt_update64(crc16_ccitt_ctx *ctx, const uint8_t *data, uint64_t len);
 AARU_EXPORT int AARU_CALL              crc16_ccitt_final(crc16_ccitt_ctx *ctx, uint16_t *crc);
+AARU_EXPORT int AARU_CALL              crc16_ccitt_export_state(crc16_ccitt_ctx *ctx, uint8_t *buffer, uint32_t len);
+AARU_EXPORT crc16_ccitt_ctx *AARU_CALL crc16_ccitt_import_state(const uint8_t *buffer, uint32_t len);
+AARU_EXPORT crc16_ccitt_ctx *AARU_CALL crc16_ccitt_clone(const crc16_ccitt_ctx *ctx);
 AARU_EXPORT void AARU_CALL             crc16_ccitt_free(crc16_ccitt_ctx *ctx);
 
 #endif  // AARU_CHECKSUMS_NATIVE_CRC16_H
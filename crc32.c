@@ -18,9 +18,14 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "library.h"
 #include "crc32.h"
+#include "state.h"
+
+/* Largest chunk, multiple of the folding block size, that still fits in a signed 32-bit long */
+#define CRC32_MAX_CHUNK (1 << 30)
 
 /**
  * @brief Initializes the CRC-32 checksum algorithm with the ISO polynomial.
@@ -39,6 +44,10 @@ AARU_EXPORT crc32_ctx *AARU_CALL crc32_init(void)
 
     ctx->crc = CRC32_ISO_SEED;
 
+    ctx->buffer      = NULL;
+    ctx->buffer_size = 0;
+    ctx->buffer_len  = 0;
+
     return ctx;
 }
 
@@ -58,15 +67,25 @@ AARU_EXPORT crc32_ctx *AARU_CALL crc32_init(void)
  */
 AARU_EXPORT int AARU_CALL crc32_update(crc32_ctx *ctx, const uint8_t *data, uint32_t len)
 {
-    if(!ctx || !data) return -1;
+    return crc32_update64(ctx, data, len);
+}
 
+/**
+ * @brief Runs the best available CRC-32 kernel over a chunk of data.
+ *
+ * @param ctx Pointer to the CRC-32 context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer, at most CRC32_MAX_CHUNK.
+ */
+static void crc32_chunk(crc32_ctx *ctx, const uint8_t *data, uint32_t len)
+{
 #if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
     defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
     if(have_clmul())
     {
         ctx->crc = ~crc32_clmul(~ctx->crc, data, (long)len);
 
-        return 0;
+        return;
     }
 #endif
 
@@ -76,17 +95,129 @@ AARU_EXPORT int AARU_CALL crc32_update(crc32_ctx *ctx, const uint8_t *data, uint
     {
         ctx->crc = armv8_crc32_little(ctx->crc, data, len);
 
-        return 0;
+        return;
     }
 #endif
     if(have_neon())
     {
         ctx->crc = ~crc32_vmull(~ctx->crc, data, len);
-        return 0;
+        return;
     }
 #endif
 
     crc32_slicing(&ctx->crc, data, len);
+}
+
+/**
+ * @brief Updates the CRC-32 checksum with new data of any length.
+ *
+ * This function updates the CRC-32 checksum with buffers that can be larger than 4GiB.
+ * The data is fed to the kernels in chunks small enough to never overflow their
+ * length argument.
+ *
+ * @param ctx Pointer to the CRC-32 context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL crc32_update64(crc32_ctx *ctx, const uint8_t *data, uint64_t len)
+{
+    if(!ctx || !data) return -1;
+
+    if(ctx->buffer)
+    {
+        /* Small updates are gathered in the staging buffer and only reach the kernels once it fills up */
+        if(ctx->buffer_len + len < ctx->buffer_size)
+        {
+            memcpy(ctx->buffer + ctx->buffer_len, data, (size_t)len);
+            ctx->buffer_len += (uint32_t)len;
+
+            return 0;
+        }
+
+        if(ctx->buffer_len)
+        {
+            uint32_t fill = ctx->buffer_size - ctx->buffer_len;
+
+            memcpy(ctx->buffer + ctx->buffer_len, data, fill);
+            data += fill;
+            len -= fill;
+
+            crc32_chunk(ctx, ctx->buffer, ctx->buffer_size);
+            ctx->buffer_len = 0;
+
+            if(len < ctx->buffer_size)
+            {
+                memcpy(ctx->buffer, data, (size_t)len);
+                ctx->buffer_len = (uint32_t)len;
+
+                return 0;
+            }
+        }
+    }
+
+    while(len > CRC32_MAX_CHUNK)
+    {
+        crc32_chunk(ctx, data, CRC32_MAX_CHUNK);
+        data += CRC32_MAX_CHUNK;
+        len -= CRC32_MAX_CHUNK;
+    }
+
+    if(len) crc32_chunk(ctx, data, (uint32_t)len);
+
+    return 0;
+}
+
+/**
+ * @brief Processes any data pending in the staging buffer of a buffered CRC-32 context.
+ *
+ * @param ctx Pointer to the CRC-32 context structure.
+ */
+static void crc32_flush(crc32_ctx *ctx)
+{
+    if(!ctx->buffer_len) return;
+
+    crc32_chunk(ctx, ctx->buffer, ctx->buffer_len);
+    ctx->buffer_len = 0;
+}
+
+/**
+ * @brief Enables or disables the buffered update mode of a CRC-32 context.
+ *
+ * In buffered mode, updates smaller than the staging buffer are accumulated and only
+ * processed by the kernels once the buffer fills up, keeping callers that feed a few
+ * bytes at a time on the SIMD paths. The checksum is identical to the unbuffered one,
+ * and any pending data is processed when finalizing or changing the mode.
+ *
+ * @param ctx Pointer to the CRC-32 context structure.
+ * @param size Size of the staging buffer, clamped between AARU_BUFFERED_MIN_SIZE and
+ * AARU_BUFFERED_MAX_SIZE, or 0 to disable buffering.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL crc32_set_buffered(crc32_ctx *ctx, uint32_t size)
+{
+    uint8_t *buffer = NULL;
+
+    if(!ctx) return -1;
+
+    if(size)
+    {
+        if(size < AARU_BUFFERED_MIN_SIZE) size = AARU_BUFFERED_MIN_SIZE;
+        if(size > AARU_BUFFERED_MAX_SIZE) size = AARU_BUFFERED_MAX_SIZE;
+
+        buffer = (uint8_t *)malloc(size);
+
+        if(!buffer) return -1;
+    }
+
+    crc32_flush(ctx);
+    free(ctx->buffer);
+
+    ctx->buffer      = buffer;
+    ctx->buffer_size = size;
+
     return 0;
 }
 
@@ -162,6 +293,8 @@ AARU_EXPORT int AARU_CALL crc32_final(crc32_ctx *ctx, uint32_t *crc)
 {
     if(!ctx) return -1;
 
+    crc32_flush(ctx);
+
     *crc = ctx->crc ^ CRC32_ISO_SEED;
 
     return 0;
@@ -177,5 +310,106 @@ AARU_EXPORT int AARU_CALL crc32_final(crc32_ctx *ctx, uint32_t *crc)
  */
 AARU_EXPORT void AARU_CALL crc32_free(crc32_ctx *ctx)
 {
-    if(ctx) free(ctx);
-}
\ No newline at end of file
+    if(!ctx) return;
+
+    free(ctx->buffer);
+    free(ctx);
+}
+
+/**
+ * @brief Exports the state of a CRC-32 context.
+ *
+ * The state is stored in a versioned and endian independent format, so it can be
+ * passed to crc32_import_state() to resume the calculation later, even on a
+ * different machine. Pending data of a buffered context is processed first, and
+ * the buffering mode itself is not part of the state.
+ *
+ * @param ctx Pointer to the CRC-32 context structure.
+ * @param buffer Buffer that receives the state, or NULL to query its size.
+ * @param len Size of the buffer.
+ *
+ * @returns Size of the exported state, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL crc32_export_state(crc32_ctx *ctx, uint8_t *buffer, uint32_t len)
+{
+    uint8_t *p;
+
+    if(!ctx) return -1;
+
+    if(!buffer) return CRC32_STATE_SIZE;
+
+    if(len < CRC32_STATE_SIZE) return -1;
+
+    crc32_flush(ctx);
+
+    p = state_put_header(buffer, STATE_ALGORITHM_CRC32, CRC32_STATE_SIZE - STATE_HEADER_SIZE);
+    state_put_u32(p, ctx->crc);
+
+    return CRC32_STATE_SIZE;
+}
+
+/**
+ * @brief Creates a CRC-32 context from a state exported by crc32_export_state().
+ *
+ * @param buffer Buffer containing the exported state.
+ * @param len Size of the buffer.
+ *
+ * @return Pointer to a structure containing the checksum state, or NULL if the
+ * state is not valid.
+ */
+AARU_EXPORT crc32_ctx *AARU_CALL crc32_import_state(const uint8_t *buffer, uint32_t len)
+{
+    crc32_ctx     *ctx;
+    uint32_t       payload;
+    const uint8_t *p = state_get_header(buffer, len, STATE_ALGORITHM_CRC32, &payload);
+
+    if(!p || payload != CRC32_STATE_SIZE - STATE_HEADER_SIZE) return NULL;
+
+    ctx = crc32_init();
+
+    if(!ctx) return NULL;
+
+    state_get_u32(p, &ctx->crc);
+
+    return ctx;
+}
+
+/**
+ * @brief Creates a copy of a CRC-32 context.
+ *
+ * The copy continues from the same point as the original, and both can be updated
+ * and finalized independently, allowing to calculate a common prefix only once or to
+ * take intermediate checksums without disturbing the original. Pending data of a
+ * buffered context is copied along with it.
+ *
+ * @param ctx Pointer to the CRC-32 context structure.
+ *
+ * @return Pointer to a structure containing the copied checksum state, or NULL on error.
+ */
+AARU_EXPORT crc32_ctx *AARU_CALL crc32_clone(const crc32_ctx *ctx)
+{
+    crc32_ctx *clone;
+
+    if(!ctx) return NULL;
+
+    clone = (crc32_ctx *)malloc(sizeof(crc32_ctx));
+
+    if(!clone) return NULL;
+
+    memcpy(clone, ctx, sizeof(crc32_ctx));
+
+    if(!ctx->buffer) return clone;
+
+    /* The staging buffer cannot be shared between both contexts */
+    clone->buffer = (uint8_t *)malloc(ctx->buffer_size);
+
+    if(!clone->buffer)
+    {
+        free(clone);
+        return NULL;
+    }
+
+    memcpy(clone->buffer, ctx->buffer, ctx->buffer_len);
+
+    return clone;
+}
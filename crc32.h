@@ -22,6 +22,9 @@
 typedef struct
 {
     uint32_t crc;
+    uint8_t *buffer;
+    uint32_t buffer_size;
+    uint32_t buffer_len;
 } crc32_ctx;
 
 static const uint32_t crc32_table[8][256] = {
@@ -262,9 +265,17 @@ static const uint32_t crc32_table[8][256] = {
 #define CRC32_ISO_POLY 0xEDB88320
 #define CRC32_ISO_SEED 0xFFFFFFFF
 
+/* Size of an exported state, see crc32_export_state() */
+#define CRC32_STATE_SIZE 16
+
 AARU_EXPORT crc32_ctx *AARU_CALL crc32_init();
 AARU_EXPORT int AARU_CALL        crc32_update(crc32_ctx *ctx, const uint8_t *data, uint32_t len);
+AARU_EXPORT int AARU_CALL        crc32_update64(crc32_ctx *ctx, const uint8_t *data, uint64_t len);
+AARU_EXPORT int AARU_CALL        crc32_set_buffered(crc32_ctx *ctx, uint32_t size);
 AARU_EXPORT int AARU_CALL        crc32_final(crc32_ctx *ctx, uint32_t *crc);
+AARU_EXPORT int AARU_CALL        crc32_export_state(crc32_ctx *ctx, uint8_t *buffer, uint32_t len);
+AARU_EXPORT crc32_ctx *AARU_CALL crc32_import_state(const uint8_t *buffer, uint32_t len);
+AARU_EXPORT crc32_ctx *AARU_CALL crc32_clone(const crc32_ctx *ctx);
 AARU_EXPORT void AARU_CALL       crc32_free(crc32_ctx *ctx);
 AARU_EXPORT void AARU_CALL       crc32_slicing(uint32_t *previous_crc, const uint8_t *data, long len);
 
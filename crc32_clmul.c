@@ -275,7 +275,20 @@ AARU_EXPORT TARGET_WITH_CLMUL uint32_t AARU_CALL crc32_clmul(uint32_t previous_c
 
     /* this alignment computation would be wrong for len<16 handled above */
     algn_diff = (0 - (uintptr_t)data) & 0xF;
-    if(algn_diff)
+    if(algn_diff && algn_diff < 4)
+    {
+        /*
+         * the initial crc would not fit in a partial fold this short, so consume the
+         * lead-in with the classic impl. and let the first aligned block take it.
+         */
+        uint32_t crc = ~previous_crc;
+
+        len -= algn_diff;
+        while(algn_diff--) crc = (crc >> 8) ^ crc32_table[0][(crc & 0xFF) ^ *data++];
+
+        xmm_initial = _mm_cvtsi32_si128(~crc);
+    }
+    else if(algn_diff)
     {
         xmm_crc_part = _mm_loadu_si128((__m128i *)data);
         XOR_INITIAL(xmm_crc_part);
@@ -18,11 +18,16 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "library.h"
 #include "crc64.h"
+#include "state.h"
 #include "simd.h"
 
+/* Largest chunk, multiple of the folding block size, that still fits in a signed 32-bit long */
+#define CRC64_MAX_CHUNK (1 << 30)
+
 /**
  * @brief Initializes the CRC-64 checksum algorithm with the ECMA polynomial.
  *
@@ -40,6 +45,10 @@ AARU_EXPORT crc64_ctx *AARU_CALL crc64_init(void)
 
     ctx->crc = CRC64_ECMA_SEED;
 
+    ctx->buffer      = NULL;
+    ctx->buffer_size = 0;
+    ctx->buffer_len  = 0;
+
     return ctx;
 }
 
@@ -59,14 +68,24 @@ AARU_EXPORT crc64_ctx *AARU_CALL crc64_init(void)
  */
 AARU_EXPORT int AARU_CALL crc64_update(crc64_ctx *ctx, const uint8_t *data, uint32_t len)
 {
-    if(!ctx || !data) return -1;
+    return crc64_update64(ctx, data, len);
+}
 
+/**
+ * @brief Runs the best available CRC-64 kernel over a chunk of data.
+ *
+ * @param ctx Pointer to the CRC-64 context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer, at most CRC64_MAX_CHUNK.
+ */
+static void crc64_chunk(crc64_ctx *ctx, const uint8_t *data, uint32_t len)
+{
 #if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
     defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
     if(have_clmul())
     {
         ctx->crc = ~crc64_clmul(~ctx->crc, data, len);
-        return 0;
+        return;
     }
 #endif
 
@@ -74,7 +93,7 @@ AARU_EXPORT int AARU_CALL crc64_update(crc64_ctx *ctx, const uint8_t *data, uint
     if(have_neon())
     {
         ctx->crc = ~crc64_vmull(~ctx->crc, data, len);
-        return 0;
+        return;
     }
 #endif
 
@@ -83,6 +102,117 @@ AARU_EXPORT int AARU_CALL crc64_update(crc64_ctx *ctx, const uint8_t *data, uint
     // http://sourceforge.net/projects/slicing-by-8/
 
     crc64_slicing(&ctx->crc, data, len);
+}
+
+/**
+ * @brief Updates the CRC-64 checksum with new data of any length.
+ *
+ * This function updates the CRC-64 checksum with buffers that can be larger than 4GiB.
+ * The data is fed to the kernels in chunks small enough to never overflow their
+ * length argument.
+ *
+ * @param ctx Pointer to the CRC-64 context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL crc64_update64(crc64_ctx *ctx, const uint8_t *data, uint64_t len)
+{
+    if(!ctx || !data) return -1;
+
+    if(ctx->buffer)
+    {
+        /* Small updates are gathered in the staging buffer and only reach the kernels once it fills up */
+        if(ctx->buffer_len + len < ctx->buffer_size)
+        {
+            memcpy(ctx->buffer + ctx->buffer_len, data, (size_t)len);
+            ctx->buffer_len += (uint32_t)len;
+
+            return 0;
+        }
+
+        if(ctx->buffer_len)
+        {
+            uint32_t fill = ctx->buffer_size - ctx->buffer_len;
+
+            memcpy(ctx->buffer + ctx->buffer_len, data, fill);
+            data += fill;
+            len -= fill;
+
+            crc64_chunk(ctx, ctx->buffer, ctx->buffer_size);
+            ctx->buffer_len = 0;
+
+            if(len < ctx->buffer_size)
+            {
+                memcpy(ctx->buffer, data, (size_t)len);
+                ctx->buffer_len = (uint32_t)len;
+
+                return 0;
+            }
+        }
+    }
+
+    while(len > CRC64_MAX_CHUNK)
+    {
+        crc64_chunk(ctx, data, CRC64_MAX_CHUNK);
+        data += CRC64_MAX_CHUNK;
+        len -= CRC64_MAX_CHUNK;
+    }
+
+    if(len) crc64_chunk(ctx, data, (uint32_t)len);
+
+    return 0;
+}
+
+/**
+ * @brief Processes any data pending in the staging buffer of a buffered CRC-64 context.
+ *
+ * @param ctx Pointer to the CRC-64 context structure.
+ */
+static void crc64_flush(crc64_ctx *ctx)
+{
+    if(!ctx->buffer_len) return;
+
+    crc64_chunk(ctx, ctx->buffer, ctx->buffer_len);
+    ctx->buffer_len = 0;
+}
+
+/**
+ * @brief Enables or disables the buffered update mode of a CRC-64 context.
+ *
+ * In buffered mode, updates smaller than the staging buffer are accumulated and only
+ * processed by the kernels once the buffer fills up, keeping callers that feed a few
+ * bytes at a time on the SIMD paths. The checksum is identical to the unbuffered one,
+ * and any pending data is processed when finalizing or changing the mode.
+ *
+ * @param ctx Pointer to the CRC-64 context structure.
+ * @param size Size of the staging buffer, clamped between AARU_BUFFERED_MIN_SIZE and
+ * AARU_BUFFERED_MAX_SIZE, or 0 to disable buffering.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL crc64_set_buffered(crc64_ctx *ctx, uint32_t size)
+{
+    uint8_t *buffer = NULL;
+
+    if(!ctx) return -1;
+
+    if(size)
+    {
+        if(size < AARU_BUFFERED_MIN_SIZE) size = AARU_BUFFERED_MIN_SIZE;
+        if(size > AARU_BUFFERED_MAX_SIZE) size = AARU_BUFFERED_MAX_SIZE;
+
+        buffer = (uint8_t *)malloc(size);
+
+        if(!buffer) return -1;
+    }
+
+    crc64_flush(ctx);
+    free(ctx->buffer);
+
+    ctx->buffer      = buffer;
+    ctx->buffer_size = size;
 
     return 0;
 }
@@ -134,6 +264,8 @@ AARU_EXPORT int AARU_CALL crc64_final(crc64_ctx *ctx, uint64_t *crc)
 {
     if(!ctx) return -1;
 
+    crc64_flush(ctx);
+
     *crc = ctx->crc ^ CRC64_ECMA_SEED;
 
     return 0;
@@ -149,5 +281,106 @@ AARU_EXPORT int AARU_CALL crc64_final(crc64_ctx *ctx, uint64_t *crc)
  */
 AARU_EXPORT void AARU_CALL crc64_free(crc64_ctx *ctx)
 {
-    if(ctx) free(ctx);
-}
\ No newline at end of file
+    if(!ctx) return;
+
+    free(ctx->buffer);
+    free(ctx);
+}
+
+/**
+ * @brief Exports the state of a CRC-64 context.
+ *
+ * The state is stored in a versioned and endian independent format, so it can be
+ * passed to crc64_import_state() to resume the calculation later, even on a
+ * different machine. Pending data of a buffered context is processed first, and
+ * the buffering mode itself is not part of the state.
+ *
+ * @param ctx Pointer to the CRC-64 context structure.
+ * @param buffer Buffer that receives the state, or NULL to query its size.
+ * @param len Size of the buffer.
+ *
+ * @returns Size of the exported state, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL crc64_export_state(crc64_ctx *ctx, uint8_t *buffer, uint32_t len)
+{
+    uint8_t *p;
+
+    if(!ctx) return -1;
+
+    if(!buffer) return CRC64_STATE_SIZE;
+
+    if(len < CRC64_STATE_SIZE) return -1;
+
+    crc64_flush(ctx);
+
+    p = state_put_header(buffer, STATE_ALGORITHM_CRC64, CRC64_STATE_SIZE - STATE_HEADER_SIZE);
+    state_put_u64(p, ctx->crc);
+
+    return CRC64_STATE_SIZE;
+}
+
+/**
+ * @brief Creates a CRC-64 context from a state exported by crc64_export_state().
+ *
+ * @param buffer Buffer containing the exported state.
+ * @param len Size of the buffer.
+ *
+ * @return Pointer to a structure containing the checksum state, or NULL if the
+ * state is not valid.
+ */
+AARU_EXPORT crc64_ctx *AARU_CALL crc64_import_state(const uint8_t *buffer, uint32_t len)
+{
+    crc64_ctx     *ctx;
+    uint32_t       payload;
+    const uint8_t *p = state_get_header(buffer, len, STATE_ALGORITHM_CRC64, &payload);
+
+    if(!p || payload != CRC64_STATE_SIZE - STATE_HEADER_SIZE) return NULL;
+
+    ctx = crc64_init();
+
+    if(!ctx) return NULL;
+
+    state_get_u64(p, &ctx->crc);
+
+    return ctx;
+}
+
+/**
+ * @brief Creates a copy of a CRC-64 context.
+ *
+ * The copy continues from the same point as the original, and both can be updated
+ * and finalized independently, allowing to calculate a common prefix only once or to
+ * take intermediate checksums without disturbing the original. Pending data of a
+ * buffered context is copied along with it.
+ *
+ * @param ctx Pointer to the CRC-64 context structure.
+ *
+ * @return Pointer to a structure containing the copied checksum state, or NULL on error.
+ */
+AARU_EXPORT crc64_ctx *AARU_CALL crc64_clone(const crc64_ctx *ctx)
+{
+    crc64_ctx *clone;
+
+    if(!ctx) return NULL;
+
+    clone = (crc64_ctx *)malloc(sizeof(crc64_ctx));
+
+    if(!clone) return NULL;
+
+    memcpy(clone, ctx, sizeof(crc64_ctx));
+
+    if(!ctx->buffer) return clone;
+
+    /* The staging buffer cannot be shared between both contexts */
+    clone->buffer = (uint8_t *)malloc(ctx->buffer_size);
+
+    if(!clone->buffer)
+    {
+        free(clone);
+        return NULL;
+    }
+
+    memcpy(clone->buffer, ctx->buffer, ctx->buffer_len);
+
+    return clone;
+}
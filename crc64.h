@@ -22,6 +22,9 @@
 typedef struct
 {
     uint64_t crc;
+    uint8_t *buffer;
+    uint32_t buffer_size;
+    uint32_t buffer_len;
 } crc64_ctx;
 
 const static uint64_t crc64_table[4][256] = {
@@ -238,9 +241,17 @@ const static uint64_t crc64_table[4][256] = {
 #define CRC64_ECMA_POLY 0xC96C5795D7870F42
 #define CRC64_ECMA_SEED 0xFFFFFFFFFFFFFFFF
 
+/* Size of an exported state, see crc64_export_state() */
+#define CRC64_STATE_SIZE 20
+
 AARU_EXPORT crc64_ctx *AARU_CALL crc64_init();
 AARU_EXPORT int AARU_CALL        crc64_update(crc64_ctx *ctx, const uint8_t *data, uint32_t len);
+AARU_EXPORT int AARU_CALL        crc64_update64(crc64_ctx *ctx, const uint8_t *data, uint64_t len);
+AARU_EXPORT int AARU_CALL        crc64_set_buffered(crc64_ctx *ctx, uint32_t size);
 AARU_EXPORT int AARU_CALL        crc64_final(crc64_ctx *ctx, uint64_t *crc);
+AARU_EXPORT int AARU_CALL        crc64_export_state(crc64_ctx *ctx, uint8_t *buffer, uint32_t len);
+AARU_EXPORT crc64_ctx *AARU_CALL crc64_import_state(const uint8_t *buffer, uint32_t len);
+AARU_EXPORT crc64_ctx *AARU_CALL crc64_clone(const crc64_ctx *ctx);
 AARU_EXPORT void AARU_CALL       crc64_free(crc64_ctx *ctx);
 AARU_EXPORT void AARU_CALL       crc64_slicing(uint64_t *previous_crc, const uint8_t *data, uint32_t len);
 
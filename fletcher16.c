@@ -24,9 +24,26 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "library.h"
 #include "fletcher16.h"
+#include "parallel.h"
+#include "runs.h"
+#include "state.h"
+#include "sums.h"
+
+/* Largest multiple of the SIMD reduction block that still fits in a signed 32-bit long */
+#define FLETCHER16_MAX_CHUNK          ((NMAX / 32) * 32 * 65536)
+/* Smallest share of a parallel update given to a thread, below it starting the thread costs more than it saves */
+#define FLETCHER16_PARALLEL_MIN_CHUNK (256 * 1024)
+
+typedef struct
+{
+    const uint8_t *data;
+    uint64_t       len;
+    fletcher16_ctx ctx;
+} fletcher16_job;
 
 /**
  * @brief Initializes the Fletcher-16 checksum algorithm.
@@ -48,6 +65,11 @@ AARU_EXPORT fletcher16_ctx *AARU_CALL fletcher16_init()
     ctx->sum1 = 0xFF;
     ctx->sum2 = 0xFF;
 
+    ctx->buffer      = NULL;
+    ctx->buffer_size = 0;
+    ctx->buffer_len  = 0;
+    ctx->run_min     = 0;
+
     return ctx;
 }
 
@@ -64,37 +86,67 @@ AARU_EXPORT fletcher16_ctx *AARU_CALL fletcher16_init()
  */
 AARU_EXPORT int AARU_CALL fletcher16_update(fletcher16_ctx *ctx, const uint8_t *data, uint32_t len)
 {
-    if(!ctx || !data) return -1;
+    return fletcher16_update64(ctx, data, len);
+}
 
+/**
+ * @brief Runs the best available Fletcher-16 kernel over a chunk of data.
+ *
+ * @param ctx Pointer to the Fletcher-16 context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer, at most FLETCHER16_MAX_CHUNK.
+ */
+static void fletcher16_chunk(fletcher16_ctx *ctx, const uint8_t *data, long len)
+{
 #if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)) && !defined(__MINGW32__))
     if(have_neon())
     {
-        fletcher16_neon(&ctx->sum1, &ctx->sum2, data, len);
+        fletcher16_neon(&ctx->sum1, &ctx->sum2, data, (uint32_t)len);
 
-        return 0;
+        return;
     }
 #endif
 
 #if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
     defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+    if(have_avx512_vnni())
+    {
+        fletcher16_avx512_vnni(&ctx->sum1, &ctx->sum2, data, len);
+
+        return;
+    }
+
+    if(have_avx_vnni())
+    {
+        fletcher16_avx_vnni(&ctx->sum1, &ctx->sum2, data, len);
+
+        return;
+    }
+
     if(have_avx2())
     {
         fletcher16_avx2(&ctx->sum1, &ctx->sum2, data, len);
 
-        return 0;
+        return;
     }
 
     if(have_ssse3())
     {
         fletcher16_ssse3(&ctx->sum1, &ctx->sum2, data, len);
 
-        return 0;
+        return;
     }
 #endif
 
+    if(len >= SUMS_SWAR_MIN)
+    {
+        fletcher16_swar(&ctx->sum1, &ctx->sum2, data, len);
+
+        return;
+    }
+
     uint32_t sum1 = ctx->sum1;
     uint32_t sum2 = ctx->sum2;
-    unsigned n;
 
     /* in case user likes doing a byte at a time, keep it fast */
     if(len == 1)
@@ -106,7 +158,7 @@ AARU_EXPORT int AARU_CALL fletcher16_update(fletcher16_ctx *ctx, const uint8_t *
 
         ctx->sum1 = sum1 & 0xFF;
         ctx->sum2 = sum2 & 0xFF;
-        return 0;
+        return;
     }
 
     /* in case short lengths are provided, keep it somewhat fast */
@@ -121,33 +173,7 @@ AARU_EXPORT int AARU_CALL fletcher16_update(fletcher16_ctx *ctx, const uint8_t *
         sum2 %= FLETCHER16_MODULE; /* only added so many FLETCHER16_MODULE's */
         ctx->sum1 = sum1 & 0xFF;
         ctx->sum2 = sum2 & 0xFF;
-        return 0;
-    }
-
-    /* do length NMAX blocks -- requires just one modulo operation */
-    while(len >= NMAX)
-    {
-        len -= NMAX;
-        n = NMAX / 6; /* NMAX is divisible by 6 */
-        do {
-            sum1 += data[0];
-            sum2 += sum1;
-            sum1 += data[0 + 1];
-            sum2 += sum1;
-            sum1 += data[0 + 2];
-            sum2 += sum1;
-            sum1 += data[0 + 2 + 1];
-            sum2 += sum1;
-            sum1 += data[0 + 4];
-            sum2 += sum1;
-            sum1 += data[0 + 4 + 1];
-            sum2 += sum1;
-
-            /* 6 sums unrolled */
-            data += 6;
-        } while(--n);
-        sum1 %= FLETCHER16_MODULE;
-        sum2 %= FLETCHER16_MODULE;
+        return;
     }
 
     /* do remaining bytes (less than NMAX, still just one modulo) */
@@ -182,6 +208,347 @@ AARU_EXPORT int AARU_CALL fletcher16_update(fletcher16_ctx *ctx, const uint8_t *
 
     ctx->sum1 = sum1 & 0xFF;
     ctx->sum2 = sum2 & 0xFF;
+}
+
+/**
+ * @brief Calculates Fletcher-16 with 64-bit integer arithmetic, for targets without SIMD instructions.
+ *
+ * Blocks of up to SUMS_NMAX bytes are summed 8 bytes at a time by sums_swar(), and then
+ * added to the checksum.
+ *
+ * @param sum1 Pointer to the first sum.
+ * @param sum2 Pointer to the second sum.
+ * @param data Pointer to the data buffer.
+ * @param len Length of the data buffer in bytes.
+ */
+AARU_EXPORT void AARU_CALL fletcher16_swar(uint8_t *sum1, uint8_t *sum2, const uint8_t *data, long len)
+{
+    uint32_t s1 = *sum1;
+    uint32_t s2 = *sum2;
+    uint32_t block, block_sum1, block_sum2;
+
+    while(len > 0)
+    {
+        block = len > SUMS_NMAX ? SUMS_NMAX : (uint32_t)len;
+
+        sums_swar(&block_sum1, &block_sum2, data, block);
+
+        /* Every byte of the block adds the first sum from before the block to the second sum */
+        s2 = (s2 + block * s1 % FLETCHER16_MODULE + block_sum2 % FLETCHER16_MODULE) % FLETCHER16_MODULE;
+        s1 = (s1 + block_sum1) % FLETCHER16_MODULE;
+
+        data += block;
+        len -= block;
+    }
+
+    *sum1 = s1 & 0xFF;
+    *sum2 = s2 & 0xFF;
+}
+
+/**
+ * @brief Applies copies of a single byte value to the Fletcher-16 sums at once.
+ *
+ * @param ctx Pointer to the Fletcher-16 context structure.
+ * @param value Value of the bytes.
+ * @param count Number of bytes, at least 1.
+ */
+static void fletcher16_run(fletcher16_ctx *ctx, uint8_t value, uint64_t count)
+{
+    uint64_t n        = count % FLETCHER16_MODULE;
+    uint64_t triangle = runs_triangle(count, FLETCHER16_MODULE);
+
+    ctx->sum2 = (uint8_t)((ctx->sum2 + n * ctx->sum1 + triangle * value) % FLETCHER16_MODULE);
+    ctx->sum1 = (uint8_t)((ctx->sum1 + n * value) % FLETCHER16_MODULE);
+}
+
+/**
+ * @brief Runs the Fletcher-16 kernels over data of any length.
+ *
+ * When run detection is enabled, runs of a single byte value are applied at once and only
+ * the data between them reaches the kernels.
+ *
+ * @param ctx Pointer to the Fletcher-16 context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ */
+static void fletcher16_process(fletcher16_ctx *ctx, const uint8_t *data, uint64_t len)
+{
+    uint64_t span, run;
+
+    while(len)
+    {
+        span = len;
+        run  = 0;
+
+        if(ctx->run_min) span = runs_find(data, len < RUNS_WINDOW ? len : RUNS_WINDOW, ctx->run_min, &run);
+
+        len -= span + run;
+
+        while(span > FLETCHER16_MAX_CHUNK)
+        {
+            fletcher16_chunk(ctx, data, FLETCHER16_MAX_CHUNK);
+            data += FLETCHER16_MAX_CHUNK;
+            span -= FLETCHER16_MAX_CHUNK;
+        }
+
+        if(span) fletcher16_chunk(ctx, data, (long)span);
+
+        data += span;
+
+        if(run) fletcher16_run(ctx, *data, run);
+
+        data += run;
+    }
+}
+
+/**
+ * @brief Updates the Fletcher-16 checksum with new data of any length.
+ *
+ * This function updates the Fletcher-16 checksum with buffers that can be larger than 4GiB.
+ * The data is fed to the kernels in chunks that are a multiple of their reduction block,
+ * so no additional modulo reductions happen between chunks and lengths never overflow
+ * the kernels' length argument.
+ *
+ * @param ctx Pointer to the Fletcher-16 context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL fletcher16_update64(fletcher16_ctx *ctx, const uint8_t *data, uint64_t len)
+{
+    if(!ctx || !data) return -1;
+
+    if(ctx->buffer)
+    {
+        /* Small updates are gathered in the staging buffer and only reach the kernels once it fills up */
+        if(ctx->buffer_len + len < ctx->buffer_size)
+        {
+            memcpy(ctx->buffer + ctx->buffer_len, data, (size_t)len);
+            ctx->buffer_len += (uint32_t)len;
+
+            return 0;
+        }
+
+        if(ctx->buffer_len)
+        {
+            uint32_t fill = ctx->buffer_size - ctx->buffer_len;
+
+            memcpy(ctx->buffer + ctx->buffer_len, data, fill);
+            data += fill;
+            len -= fill;
+
+            fletcher16_chunk(ctx, ctx->buffer, ctx->buffer_size);
+            ctx->buffer_len = 0;
+
+            if(len < ctx->buffer_size)
+            {
+                memcpy(ctx->buffer, data, (size_t)len);
+                ctx->buffer_len = (uint32_t)len;
+
+                return 0;
+            }
+        }
+    }
+
+    fletcher16_process(ctx, data, len);
+
+    return 0;
+}
+
+/**
+ * @brief Processes any data pending in the staging buffer of a buffered Fletcher-16 context.
+ *
+ * @param ctx Pointer to the Fletcher-16 context structure.
+ */
+static void fletcher16_flush(fletcher16_ctx *ctx)
+{
+    if(!ctx->buffer_len) return;
+
+    fletcher16_chunk(ctx, ctx->buffer, ctx->buffer_len);
+    ctx->buffer_len = 0;
+}
+
+/**
+ * @brief Enables or disables the buffered update mode of a Fletcher-16 context.
+ *
+ * In buffered mode, updates smaller than the staging buffer are accumulated and only
+ * processed by the kernels once the buffer fills up, keeping callers that feed a few
+ * bytes at a time on the SIMD paths. The checksum is identical to the unbuffered one,
+ * and any pending data is processed when finalizing or changing the mode.
+ *
+ * @param ctx Pointer to the Fletcher-16 context structure.
+ * @param size Size of the staging buffer, clamped between AARU_BUFFERED_MIN_SIZE and
+ * AARU_BUFFERED_MAX_SIZE, or 0 to disable buffering.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL fletcher16_set_buffered(fletcher16_ctx *ctx, uint32_t size)
+{
+    uint8_t *buffer = NULL;
+
+    if(!ctx) return -1;
+
+    if(size)
+    {
+        if(size < AARU_BUFFERED_MIN_SIZE) size = AARU_BUFFERED_MIN_SIZE;
+        if(size > AARU_BUFFERED_MAX_SIZE) size = AARU_BUFFERED_MAX_SIZE;
+
+        buffer = (uint8_t *)malloc(size);
+
+        if(!buffer) return -1;
+    }
+
+    fletcher16_flush(ctx);
+    free(ctx->buffer);
+
+    ctx->buffer      = buffer;
+    ctx->buffer_size = size;
+
+    return 0;
+}
+
+/**
+ * @brief Enables or disables the run detection mode of a Fletcher-16 context.
+ *
+ * In run detection mode, updates look for runs of a single byte value, like the filler of
+ * unformatted sectors or erased flash, and apply the ones of at least the given length at
+ * once instead of feeding them to the kernels. The checksum is identical to the one without
+ * run detection, but looking for runs slows down data that has none, so it is disabled by
+ * default.
+ *
+ * @param ctx Pointer to the Fletcher-16 context structure.
+ * @param min_length Shortest run to detect, at least AARU_RUN_MIN_LENGTH, or 0 to disable run
+ * detection.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL fletcher16_set_run_detection(fletcher16_ctx *ctx, uint32_t min_length)
+{
+    if(!ctx) return -1;
+
+    if(min_length && min_length < AARU_RUN_MIN_LENGTH) min_length = AARU_RUN_MIN_LENGTH;
+
+    ctx->run_min = min_length;
+
+    return 0;
+}
+
+/**
+ * @brief Updates the Fletcher-16 checksum with copies of a single byte value.
+ *
+ * Gives the same checksum as fletcher16_update64() with a buffer of count bytes of the given
+ * value, in constant time and without needing such a buffer.
+ *
+ * @param ctx Pointer to the Fletcher-16 context structure.
+ * @param value Value of the bytes.
+ * @param count Number of bytes.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL fletcher16_update_run(fletcher16_ctx *ctx, uint8_t value, uint64_t count)
+{
+    if(!ctx) return -1;
+
+    if(!count) return 0;
+
+    fletcher16_flush(ctx);
+    fletcher16_run(ctx, value, count);
+
+    return 0;
+}
+
+/**
+ * @brief Combines the Fletcher-16 checksums of two consecutive blocks of data.
+ *
+ * Gives the checksum of the concatenation of both blocks, from the checksum of each one
+ * and the length of the second, without going through the data again.
+ *
+ * @param checksum1 Checksum of the first block.
+ * @param checksum2 Checksum of the second block, computed from a new context.
+ * @param len2 Length of the second block.
+ *
+ * @returns Checksum of both blocks.
+ */
+AARU_EXPORT uint16_t AARU_CALL fletcher16_combine(uint16_t checksum1, uint16_t checksum2, uint64_t len2)
+{
+    uint64_t sum1 = checksum1 & 0xFF;
+    uint64_t sum2 = checksum1 >> 8;
+
+    /* The initial sums are congruent to 0, but are kept as they are until any data is added */
+    if(!len2) return checksum1;
+
+    /* Every byte of the second block adds the first sum of the first block to the second sum */
+    sum2 += (checksum2 >> 8) + len2 % FLETCHER16_MODULE * sum1;
+    sum1 += checksum2 & 0xFF;
+
+    return (uint16_t)(sum2 % FLETCHER16_MODULE << 8 | sum1 % FLETCHER16_MODULE);
+}
+
+static void fletcher16_run_job(void *arg)
+{
+    fletcher16_job *job = (fletcher16_job *)arg;
+
+    fletcher16_update64(&job->ctx, job->data, job->len);
+}
+
+/**
+ * @brief Updates the Fletcher-16 checksum with new data, using several threads.
+ *
+ * The data is split in as many consecutive blocks as threads, each one is checksummed from
+ * a new context, and their checksums are then combined in order with fletcher16_combine().
+ * The result is identical to calling fletcher16_update64() with the same data.
+ *
+ * @param ctx Pointer to the Fletcher-16 context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ * @param threads Maximum number of threads to use, or 0 to use one per processor.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL fletcher16_update_parallel(fletcher16_ctx *ctx, const uint8_t *data, uint64_t len,
+                                                     uint32_t threads)
+{
+    fletcher16_job *jobs;
+    uint64_t        chunk;
+    uint32_t        count, i;
+    uint16_t        checksum;
+
+    if(!ctx || !data) return -1;
+
+    if(!threads) threads = parallel_cpu_count();
+
+    count = len / FLETCHER16_PARALLEL_MIN_CHUNK < threads ? (uint32_t)(len / FLETCHER16_PARALLEL_MIN_CHUNK) : threads;
+
+    if(count <= 1 || !(jobs = (fletcher16_job *)calloc(count, sizeof(fletcher16_job))))
+        return fletcher16_update64(ctx, data, len);
+
+    chunk = len / count;
+
+    for(i = 0; i < count; i++)
+    {
+        jobs[i].data        = data + i * chunk;
+        jobs[i].len         = i == count - 1 ? len - i * chunk : chunk;
+        jobs[i].ctx.sum1    = 0xFF;
+        jobs[i].ctx.sum2    = 0xFF;
+        jobs[i].ctx.run_min = ctx->run_min;
+    }
+
+    parallel_run(fletcher16_run_job, jobs, sizeof(fletcher16_job), count, count);
+
+    fletcher16_flush(ctx);
+
+    checksum = (uint16_t)((uint32_t)ctx->sum2 << 8 | ctx->sum1);
+
+    for(i = 0; i < count; i++)
+        checksum = fletcher16_combine(checksum, (uint16_t)((uint32_t)jobs[i].ctx.sum2 << 8 | jobs[i].ctx.sum1),
+                                      jobs[i].len);
+
+    ctx->sum1 = checksum & 0xFF;
+    ctx->sum2 = checksum >> 8;
+
+    free(jobs);
+
     return 0;
 }
 
@@ -200,6 +567,8 @@ AARU_EXPORT int AARU_CALL fletcher16_final(fletcher16_ctx *ctx, uint16_t *checks
 {
     if(!ctx) return -1;
 
+    fletcher16_flush(ctx);
+
     *checksum = (ctx->sum2 << 8) | ctx->sum1;
     return 0;
 }
@@ -216,5 +585,106 @@ AARU_EXPORT void AARU_CALL fletcher16_free(fletcher16_ctx *ctx)
 {
     if(!ctx) return;
 
+    free(ctx->buffer);
     free(ctx);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Exports the state of a Fletcher-16 context.
+ *
+ * The state is stored in a versioned and endian independent format, so it can be
+ * passed to fletcher16_import_state() to resume the calculation later, even on a
+ * different machine. Pending data of a buffered context is processed first, and
+ * the buffering mode itself is not part of the state.
+ *
+ * @param ctx Pointer to the Fletcher-16 context structure.
+ * @param buffer Buffer that receives the state, or NULL to query its size.
+ * @param len Size of the buffer.
+ *
+ * @returns Size of the exported state, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL fletcher16_export_state(fletcher16_ctx *ctx, uint8_t *buffer, uint32_t len)
+{
+    uint8_t *p;
+
+    if(!ctx) return -1;
+
+    if(!buffer) return FLETCHER16_STATE_SIZE;
+
+    if(len < FLETCHER16_STATE_SIZE) return -1;
+
+    fletcher16_flush(ctx);
+
+    p = state_put_header(buffer, STATE_ALGORITHM_FLETCHER16, FLETCHER16_STATE_SIZE - STATE_HEADER_SIZE);
+    p = state_put_u8(p, ctx->sum1);
+    state_put_u8(p, ctx->sum2);
+
+    return FLETCHER16_STATE_SIZE;
+}
+
+/**
+ * @brief Creates a Fletcher-16 context from a state exported by fletcher16_export_state().
+ *
+ * @param buffer Buffer containing the exported state.
+ * @param len Size of the buffer.
+ *
+ * @return Pointer to a structure containing the checksum state, or NULL if the
+ * state is not valid.
+ */
+AARU_EXPORT fletcher16_ctx *AARU_CALL fletcher16_import_state(const uint8_t *buffer, uint32_t len)
+{
+    fletcher16_ctx *ctx;
+    uint32_t        payload;
+    const uint8_t  *p = state_get_header(buffer, len, STATE_ALGORITHM_FLETCHER16, &payload);
+
+    if(!p || payload != FLETCHER16_STATE_SIZE - STATE_HEADER_SIZE) return NULL;
+
+    ctx = fletcher16_init();
+
+    if(!ctx) return NULL;
+
+    p = state_get_u8(p, &ctx->sum1);
+    state_get_u8(p, &ctx->sum2);
+
+    return ctx;
+}
+
+/**
+ * @brief Creates a copy of a Fletcher-16 context.
+ *
+ * The copy continues from the same point as the original, and both can be updated
+ * and finalized independently, allowing to calculate a common prefix only once or to
+ * take intermediate checksums without disturbing the original. Pending data of a
+ * buffered context is copied along with it.
+ *
+ * @param ctx Pointer to the Fletcher-16 context structure.
+ *
+ * @return Pointer to a structure containing the copied checksum state, or NULL on error.
+ */
+AARU_EXPORT fletcher16_ctx *AARU_CALL fletcher16_clone(const fletcher16_ctx *ctx)
+{
+    fletcher16_ctx *clone;
+
+    if(!ctx) return NULL;
+
+    clone = (fletcher16_ctx *)malloc(sizeof(fletcher16_ctx));
+
+    if(!clone) return NULL;
+
+    memcpy(clone, ctx, sizeof(fletcher16_ctx));
+
+    if(!ctx->buffer) return clone;
+
+    /* The staging buffer cannot be shared between both contexts */
+    clone->buffer = (uint8_t *)malloc(ctx->buffer_size);
+
+    if(!clone->buffer)
+    {
+        free(clone);
+        return NULL;
+    }
+
+    memcpy(clone->buffer, ctx->buffer, ctx->buffer_len);
+
+    return clone;
+}
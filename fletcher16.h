@@ -25,14 +25,32 @@
 
 typedef struct
 {
-    uint8_t sum1;
-    uint8_t sum2;
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint8_t *buffer;
+    uint32_t buffer_size;
+    uint32_t buffer_len;
+    uint32_t run_min;
 } fletcher16_ctx;
 
+/* Size of an exported state, see fletcher16_export_state() */
+#define FLETCHER16_STATE_SIZE 14
+
 AARU_EXPORT fletcher16_ctx *AARU_CALL fletcher16_init();
 AARU_EXPORT int AARU_CALL             fletcher16_update(fletcher16_ctx *ctx, const uint8_t *data, uint32_t len);
+AARU_EXPORT int AARU_CALL             fletcher16_update64(fletcher16_ctx *ctx, const uint8_t *data, uint64_t len);
+AARU_EXPORT int AARU_CALL             fletcher16_set_buffered(fletcher16_ctx *ctx, uint32_t size);
+AARU_EXPORT int AARU_CALL             fletcher16_set_run_detection(fletcher16_ctx *ctx, uint32_t min_length);
+AARU_EXPORT int AARU_CALL             fletcher16_update_run(fletcher16_ctx *ctx, uint8_t value, uint64_t count);
+AARU_EXPORT uint16_t AARU_CALL        fletcher16_combine(uint16_t checksum1, uint16_t checksum2, uint64_t len2);
+AARU_EXPORT int AARU_CALL             fletcher16_update_parallel(fletcher16_ctx *ctx, const uint8_t *data, uint64_t len,
+                                                                 uint32_t threads);
 AARU_EXPORT int AARU_CALL             fletcher16_final(fletcher16_ctx *ctx, uint16_t *checksum);
+AARU_EXPORT int AARU_CALL             fletcher16_export_state(fletcher16_ctx *ctx, uint8_t *buffer, uint32_t len);
+AARU_EXPORT fletcher16_ctx *AARU_CALL fletcher16_import_state(const uint8_t *buffer, uint32_t len);
+AARU_EXPORT fletcher16_ctx *AARU_CALL fletcher16_clone(const fletcher16_ctx *ctx);
 AARU_EXPORT void AARU_CALL            fletcher16_free(fletcher16_ctx *ctx);
+AARU_EXPORT void AARU_CALL            fletcher16_swar(uint8_t *sum1, uint8_t *sum2, const uint8_t *data, long len);
 
 #if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
     defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
@@ -41,6 +59,10 @@ AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL  fletcher16_avx2(uint8_t *sum1, uint
                                                              long len);
 AARU_EXPORT TARGET_WITH_SSSE3 void AARU_CALL fletcher16_ssse3(uint8_t *sum1, uint8_t *sum2, const uint8_t *data,
                                                               long len);
+AARU_EXPORT TARGET_WITH_AVX512_VNNI void AARU_CALL fletcher16_avx512_vnni(uint8_t *sum1, uint8_t *sum2,
+                                                                          const uint8_t *data, long len);
+AARU_EXPORT TARGET_WITH_AVX_VNNI void AARU_CALL fletcher16_avx_vnni(uint8_t *sum1, uint8_t *sum2,
+                                                                    const uint8_t *data, long len);
 
 #endif
 
@@ -27,12 +27,30 @@ typedef struct
 {
     uint16_t sum1;
     uint16_t sum2;
+    uint8_t *buffer;
+    uint32_t buffer_size;
+    uint32_t buffer_len;
+    uint32_t run_min;
 } fletcher32_ctx;
 
+/* Size of an exported state, see fletcher32_export_state() */
+#define FLETCHER32_STATE_SIZE 16
+
 AARU_EXPORT fletcher32_ctx *AARU_CALL fletcher32_init();
 AARU_EXPORT int AARU_CALL             fletcher32_update(fletcher32_ctx *ctx, const uint8_t *data, uint32_t len);
+AARU_EXPORT int AARU_CALL             fletcher32_update64(fletcher32_ctx *ctx, const uint8_t *data, uint64_t len);
+AARU_EXPORT int AARU_CALL             fletcher32_set_buffered(fletcher32_ctx *ctx, uint32_t size);
+AARU_EXPORT int AARU_CALL             fletcher32_set_run_detection(fletcher32_ctx *ctx, uint32_t min_length);
+AARU_EXPORT int AARU_CALL             fletcher32_update_run(fletcher32_ctx *ctx, uint8_t value, uint64_t count);
+AARU_EXPORT uint32_t AARU_CALL        fletcher32_combine(uint32_t checksum1, uint32_t checksum2, uint64_t len2);
+AARU_EXPORT int AARU_CALL             fletcher32_update_parallel(fletcher32_ctx *ctx, const uint8_t *data, uint64_t len,
+                                                                 uint32_t threads);
 AARU_EXPORT int AARU_CALL             fletcher32_final(fletcher32_ctx *ctx, uint32_t *checksum);
+AARU_EXPORT int AARU_CALL             fletcher32_export_state(fletcher32_ctx *ctx, uint8_t *buffer, uint32_t len);
+AARU_EXPORT fletcher32_ctx *AARU_CALL fletcher32_import_state(const uint8_t *buffer, uint32_t len);
+AARU_EXPORT fletcher32_ctx *AARU_CALL fletcher32_clone(const fletcher32_ctx *ctx);
 AARU_EXPORT void AARU_CALL            fletcher32_free(fletcher32_ctx *ctx);
+AARU_EXPORT void AARU_CALL            fletcher32_swar(uint16_t *sum1, uint16_t *sum2, const uint8_t *data, long len);
 
 #if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
     defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
@@ -41,6 +59,10 @@ AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL  fletcher32_avx2(uint16_t *sum1, uin
                                                              long len);
 AARU_EXPORT TARGET_WITH_SSSE3 void AARU_CALL fletcher32_ssse3(uint16_t *sum1, uint16_t *sum2, const uint8_t *data,
                                                               long len);
+AARU_EXPORT TARGET_WITH_AVX512_VNNI void AARU_CALL fletcher32_avx512_vnni(uint16_t *sum1, uint16_t *sum2,
+                                                                          const uint8_t *data, long len);
+AARU_EXPORT TARGET_WITH_AVX_VNNI void AARU_CALL fletcher32_avx_vnni(uint16_t *sum1, uint16_t *sum2,
+                                                                    const uint8_t *data, long len);
 
 #endif
 
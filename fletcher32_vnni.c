@@ -0,0 +1,322 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ * Copyright (C) 1995-2011 Mark Adler
+ * Copyright (C) Jean-loup Gailly
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented; you must not
+ *     claim that you wrote the original software. If you use this software
+ *     in a product, an acknowledgment in the product documentation would be
+ *     appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *     misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "library.h"
+#include "fletcher32.h"
+#include "simd.h"
+
+/*
+ * Both kernels work as fletcher32_avx2(), but VPDPBUSD multiplies the bytes by their weights and
+ * adds them to the running sums in a single instruction. It takes a few cycles to complete,
+ * so the weighted sums of four consecutive blocks go to separate accumulators.
+ */
+
+/* Sum of the 32-bit lanes, added as unsigned values */
+TARGET_WITH_AVX512_VNNI static inline uint32_t fletcher32_avx512_reduce(__m512i v)
+{
+    __m256i h = _mm256_add_epi32(_mm512_castsi512_si256(v), _mm512_extracti64x4_epi64(v, 1));
+    __m128i q = _mm_add_epi32(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+
+    q = _mm_add_epi32(q, _mm_shuffle_epi32(q, _MM_SHUFFLE(1, 0, 3, 2)));
+    q = _mm_add_epi32(q, _mm_shuffle_epi32(q, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    return (uint32_t)_mm_cvtsi128_si32(q);
+}
+
+/**
+ * @brief Calculate Fletcher-32 checksum for a given data using AVX-512 VNNI instructions.
+ *
+ * This function calculates the Fletcher-32 checksum for a block of data using 512-bit vectors,
+ * taking 64 bytes at a time.
+ *
+ * @param sum1 Pointer to the variable where the first 16-bit checksum value is stored.
+ * @param sum2 Pointer to the variable where the second 16-bit checksum value is stored.
+ * @param data Pointer to the data buffer.
+ * @param len Length of the data buffer in bytes.
+ */
+AARU_EXPORT TARGET_WITH_AVX512_VNNI void AARU_CALL fletcher32_avx512_vnni(uint16_t *sum1, uint16_t *sum2,
+                                                                          const uint8_t *data, long len)
+{
+    uint32_t s1 = *sum1;
+    uint32_t s2 = *sum2;
+
+    /*
+     * Process the data in blocks.
+     */
+    const unsigned BLOCK_SIZE = 1 << 6;
+    if(len >= BLOCK_SIZE)
+    {
+        long blocks = len / BLOCK_SIZE;
+        len -= blocks * BLOCK_SIZE;
+
+        const __m512i tap  = _mm512_set_epi8(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
+                                             22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+                                             41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59,
+                                             60, 61, 62, 63, 64);
+        const __m512i zero = _mm512_setzero_si512();
+
+        while(blocks)
+        {
+            unsigned n = NMAX / BLOCK_SIZE; /* The NMAX constraint. */
+            __m512i  bytes;
+
+            if(n > blocks) n = (unsigned)blocks;
+            blocks -= n;
+
+            /*
+             * Process n blocks of data. At most NMAX data bytes can be
+             * processed before s2 must be reduced modulo BASE.
+             */
+            __m512i v_ps  = _mm512_maskz_set1_epi32(1, (int)(s1 * n));
+            __m512i v_s2a = _mm512_maskz_set1_epi32(1, (int)s2);
+            __m512i v_s2b = zero;
+            __m512i v_s2c = zero;
+            __m512i v_s2d = zero;
+            __m512i v_s1  = zero;
+
+            /*
+             * Add previous block byte sum to v_ps, horizontally add the bytes
+             * for s1, multiply-add the bytes by [ 64, 63, 62, ... ] for s2.
+             */
+#define FLETCHER32_AVX512_BLOCK(v_s2, offset)                                                                          \
+    bytes = _mm512_loadu_si512((const void *)(data + (offset)));                                                       \
+    v_ps  = _mm512_add_epi32(v_ps, v_s1);                                                                              \
+    v_s1  = _mm512_add_epi32(v_s1, _mm512_sad_epu8(bytes, zero));                                                      \
+    v_s2  = _mm512_dpbusd_epi32(v_s2, bytes, tap)
+
+            for(; n >= 4; n -= 4)
+            {
+                FLETCHER32_AVX512_BLOCK(v_s2a, 0);
+                FLETCHER32_AVX512_BLOCK(v_s2b, BLOCK_SIZE);
+                FLETCHER32_AVX512_BLOCK(v_s2c, 2 * BLOCK_SIZE);
+                FLETCHER32_AVX512_BLOCK(v_s2d, 3 * BLOCK_SIZE);
+
+                data += 4 * BLOCK_SIZE;
+            }
+
+            for(; n; n--)
+            {
+                FLETCHER32_AVX512_BLOCK(v_s2a, 0);
+
+                data += BLOCK_SIZE;
+            }
+
+#undef FLETCHER32_AVX512_BLOCK
+
+            s1 += fletcher32_avx512_reduce(v_s1);
+
+            v_s2a = _mm512_add_epi32(_mm512_add_epi32(v_s2a, v_s2b), _mm512_add_epi32(v_s2c, v_s2d));
+            s2    = fletcher32_avx512_reduce(_mm512_add_epi32(v_s2a, _mm512_slli_epi32(v_ps, 6)));
+
+            /*
+             * Reduce.
+             */
+            s1 %= FLETCHER32_MODULE;
+            s2 %= FLETCHER32_MODULE;
+        }
+    }
+
+    /*
+     * Handle leftover data.
+     */
+    if(len)
+    {
+        while(len >= 16)
+        {
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            len -= 16;
+        }
+        while(len--) { s2 += (s1 += *data++); }
+        if(s1 >= FLETCHER32_MODULE) s1 -= FLETCHER32_MODULE;
+        s2 %= FLETCHER32_MODULE;
+    }
+
+    /*
+     * Return the recombined sums.
+     */
+    *sum1 = s1 & 0xFFFF;
+    *sum2 = s2 & 0xFFFF;
+}
+
+/**
+ * @brief Calculate Fletcher-32 checksum for a given data using AVX-VNNI instructions.
+ *
+ * This function calculates the Fletcher-32 checksum for a block of data using 256-bit vectors,
+ * taking 32 bytes at a time, for processors with VNNI but without AVX-512.
+ *
+ * @param sum1 Pointer to the variable where the first 16-bit checksum value is stored.
+ * @param sum2 Pointer to the variable where the second 16-bit checksum value is stored.
+ * @param data Pointer to the data buffer.
+ * @param len Length of the data buffer in bytes.
+ */
+AARU_EXPORT TARGET_WITH_AVX_VNNI void AARU_CALL fletcher32_avx_vnni(uint16_t *sum1, uint16_t *sum2,
+                                                                    const uint8_t *data, long len)
+{
+    uint32_t s1 = *sum1;
+    uint32_t s2 = *sum2;
+
+    /*
+     * Process the data in blocks.
+     */
+    const unsigned BLOCK_SIZE = 1 << 5;
+    if(len >= BLOCK_SIZE)
+    {
+        long blocks = len / BLOCK_SIZE;
+        len -= blocks * BLOCK_SIZE;
+
+        const __m256i tap  = _mm256_set_epi8(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
+                                             22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32);
+        const __m256i zero = _mm256_setzero_si256();
+
+        while(blocks)
+        {
+            unsigned n = NMAX / BLOCK_SIZE; /* The NMAX constraint. */
+            __m256i  bytes;
+
+            if(n > blocks) n = (unsigned)blocks;
+            blocks -= n;
+
+            /*
+             * Process n blocks of data. At most NMAX data bytes can be
+             * processed before s2 must be reduced modulo BASE.
+             */
+            __m256i v_ps  = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, (int)(s1 * n));
+            __m256i v_s2a = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, (int)s2);
+            __m256i v_s2b = zero;
+            __m256i v_s2c = zero;
+            __m256i v_s2d = zero;
+            __m256i v_s1  = zero;
+
+            /*
+             * Add previous block byte sum to v_ps, horizontally add the bytes
+             * for s1, multiply-add the bytes by [ 32, 31, 30, ... ] for s2.
+             */
+#define FLETCHER32_AVX_VNNI_BLOCK(v_s2, offset)                                                                        \
+    bytes = _mm256_loadu_si256((const __m256i *)(data + (offset)));                                                    \
+    v_ps  = _mm256_add_epi32(v_ps, v_s1);                                                                              \
+    v_s1  = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes, zero));                                                      \
+    v_s2  = _mm256_dpbusd_avx_epi32(v_s2, bytes, tap)
+
+            for(; n >= 4; n -= 4)
+            {
+                FLETCHER32_AVX_VNNI_BLOCK(v_s2a, 0);
+                FLETCHER32_AVX_VNNI_BLOCK(v_s2b, BLOCK_SIZE);
+                FLETCHER32_AVX_VNNI_BLOCK(v_s2c, 2 * BLOCK_SIZE);
+                FLETCHER32_AVX_VNNI_BLOCK(v_s2d, 3 * BLOCK_SIZE);
+
+                data += 4 * BLOCK_SIZE;
+            }
+
+            for(; n; n--)
+            {
+                FLETCHER32_AVX_VNNI_BLOCK(v_s2a, 0);
+
+                data += BLOCK_SIZE;
+            }
+
+#undef FLETCHER32_AVX_VNNI_BLOCK
+
+            __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v_s1), _mm256_extracti128_si256(v_s1, 1));
+            __m128i hi  = _mm_unpackhi_epi64(sum, sum);
+            sum         = _mm_add_epi32(hi, sum);
+            hi          = _mm_shuffle_epi32(sum, 177);
+            sum         = _mm_add_epi32(sum, hi);
+            s1 += _mm_cvtsi128_si32(sum);
+
+            v_s2a = _mm256_add_epi32(_mm256_add_epi32(v_s2a, v_s2b), _mm256_add_epi32(v_s2c, v_s2d));
+            v_s2a = _mm256_add_epi32(v_s2a, _mm256_slli_epi32(v_ps, 5));
+            sum   = _mm_add_epi32(_mm256_castsi256_si128(v_s2a), _mm256_extracti128_si256(v_s2a, 1));
+            hi    = _mm_unpackhi_epi64(sum, sum);
+            sum   = _mm_add_epi32(hi, sum);
+            hi    = _mm_shuffle_epi32(sum, 177);
+            sum   = _mm_add_epi32(sum, hi);
+            s2    = _mm_cvtsi128_si32(sum);
+
+            /*
+             * Reduce.
+             */
+            s1 %= FLETCHER32_MODULE;
+            s2 %= FLETCHER32_MODULE;
+        }
+    }
+
+    /*
+     * Handle leftover data.
+     */
+    if(len)
+    {
+        if(len >= 16)
+        {
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            s2 += (s1 += *data++);
+            len -= 16;
+        }
+        while(len--) { s2 += (s1 += *data++); }
+        if(s1 >= FLETCHER32_MODULE) s1 -= FLETCHER32_MODULE;
+        s2 %= FLETCHER32_MODULE;
+    }
+
+    /*
+     * Return the recombined sums.
+     */
+    *sum1 = s1 & 0xFFFF;
+    *sum2 = s2 & 0xFFFF;
+}
+
+#endif
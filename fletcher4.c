@@ -0,0 +1,300 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Fletcher-4, the checksum ZFS uses for its metadata and optionally its data blocks.
+ *
+ * The data is a sequence of little-endian 32-bit words, and four 64-bit sums are kept, each
+ * one adding up the running values of the previous one: a += w, b += a, c += b, d += c. All
+ * the arithmetic is modulo 2^64, so no reduction is ever needed.
+ *
+ * The SIMD kernels split the words in lanes, lane i taking words i, i + L, i + 2L... and keeping
+ * its own four sums from zero. The sums of the whole block are a fixed linear combination of
+ * the lane sums, computed by fletcher4_lanes(), and are then added to the checksum.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "library.h"
+#include "fletcher4.h"
+#include "simd.h"
+
+/* Largest chunk given to a kernel at once, a multiple of the word size */
+#define FLETCHER4_MAX_CHUNK (1U << 30)
+
+/**
+ * @brief Initializes the Fletcher-4 checksum algorithm.
+ *
+ * @return Pointer to a structure containing the checksum state.
+ */
+AARU_EXPORT fletcher4_ctx *AARU_CALL fletcher4_init()
+{
+    fletcher4_ctx *ctx;
+
+    ctx = (fletcher4_ctx *)malloc(sizeof(fletcher4_ctx));
+
+    if(!ctx) return NULL;
+
+    memset(ctx, 0, sizeof(fletcher4_ctx));
+
+    return ctx;
+}
+
+/**
+ * @brief Adds little-endian 32-bit words to the Fletcher-4 sums one at a time.
+ *
+ * @param sums Pointer to the four sums.
+ * @param data Pointer to the data buffer.
+ * @param words Number of 32-bit words in the data buffer.
+ */
+AARU_LOCAL void fletcher4_words(uint64_t *sums, const uint8_t *data, uint32_t words)
+{
+    uint64_t a = sums[0];
+    uint64_t b = sums[1];
+    uint64_t c = sums[2];
+    uint64_t d = sums[3];
+
+    while(words--)
+    {
+        a += (uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24;
+        b += a;
+        c += b;
+        d += c;
+
+        data += 4;
+    }
+
+    sums[0] = a;
+    sums[1] = b;
+    sums[2] = c;
+    sums[3] = d;
+}
+
+/**
+ * @brief Adds the lane sums of a block computed by a SIMD kernel to the Fletcher-4 sums.
+ *
+ * Lane i summed the words i, i + count, i + 2 * count... of the block starting from zero. A
+ * word that is r words from the end of its lane, counting itself, is count * r - i words from
+ * the end of the block, so it weights 1, x, x(x+1)/2 and x(x+1)(x+2)/6 in the sums of the
+ * block, with x = count * r - i. These are polynomials of degree up to 3 in r, and as the
+ * lane sums weight it 1, r, r(r+1)/2 and r(r+1)(r+2)/6, they are written as a combination of
+ * the lane sums from their values at r = 0 to 3.
+ *
+ * @param sums Pointer to the four sums.
+ * @param lanes Sums of the lanes, the count a sums followed by the b, c and d ones.
+ * @param count Number of lanes.
+ * @param words Number of words in the block, a multiple of count.
+ */
+AARU_LOCAL void fletcher4_lanes(uint64_t *sums, const uint64_t *lanes, uint32_t count, uint32_t words)
+{
+    uint64_t block[FLETCHER4_SUMS] = {0, 0, 0, 0};
+    uint64_t n                     = words;
+    uint64_t t                     = words;
+    uint64_t u                     = words + 1ULL;
+    uint64_t v                     = words + 2ULL;
+    uint64_t triangle, tetrahedron;
+    int64_t  p[4], x;
+    int64_t  d1, d2, d3, alpha, beta, gamma, delta;
+    uint32_t i, s;
+    int      r;
+
+    for(i = 0; i < count; i++)
+    {
+        block[0] += lanes[i];
+
+        for(s = 1; s < FLETCHER4_SUMS; s++)
+        {
+            for(r = 0; r < 4; r++)
+            {
+                x    = (int64_t)count * r - (int64_t)i;
+                p[r] = s == 1 ? x : s == 2 ? x * (x + 1) / 2 : x * (x + 1) * (x + 2) / 6;
+            }
+
+            /* Coefficients of 1, r, r(r+1)/2 and r(r+1)(r+2)/6 matching the values */
+            d1    = p[1] - p[0];
+            d2    = p[2] - p[0];
+            d3    = p[3] - p[0];
+            delta = d3 - 3 * d2 + 3 * d1;
+            gamma = d2 - 2 * d1 - 2 * delta;
+            beta  = d1 - gamma - delta;
+            alpha = p[0];
+
+            block[s] += (uint64_t)alpha * lanes[i] + (uint64_t)beta * lanes[count + i] +
+                        (uint64_t)gamma * lanes[2 * count + i] + (uint64_t)delta * lanes[3 * count + i];
+        }
+    }
+
+    /* n(n+1)/2 and n(n+1)(n+2)/6, dividing the factors first so they do not overflow */
+    if(t % 2 == 0)
+        t /= 2;
+    else
+        u /= 2;
+
+    triangle = t * u;
+
+    if(t % 3 == 0)
+        t /= 3;
+    else if(u % 3 == 0)
+        u /= 3;
+    else
+        v /= 3;
+
+    tetrahedron = t * u * v;
+
+    /* Every word of the block also adds the sums from before it */
+    sums[3] += n * sums[2] + triangle * sums[1] + tetrahedron * sums[0] + block[3];
+    sums[2] += n * sums[1] + triangle * sums[0] + block[2];
+    sums[1] += n * sums[0] + block[1];
+    sums[0] += block[0];
+}
+
+/**
+ * @brief Runs the best available Fletcher-4 kernel over a chunk of words.
+ *
+ * @param ctx Pointer to the Fletcher-4 context structure.
+ * @param data Pointer to the input data buffer.
+ * @param words Number of 32-bit words in the data buffer.
+ */
+static void fletcher4_chunk(fletcher4_ctx *ctx, const uint8_t *data, uint32_t words)
+{
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)) && !defined(__MINGW32__))
+    if(have_neon())
+    {
+        fletcher4_neon(ctx->sums, data, words);
+
+        return;
+    }
+#endif
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+    if(have_avx512f())
+    {
+        fletcher4_avx512(ctx->sums, data, words);
+
+        return;
+    }
+
+    if(have_avx2())
+    {
+        fletcher4_avx2(ctx->sums, data, words);
+
+        return;
+    }
+#endif
+
+    fletcher4_words(ctx->sums, data, words);
+}
+
+/**
+ * @brief Updates the Fletcher-4 checksum with new data.
+ *
+ * @param ctx Pointer to the Fletcher-4 context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL fletcher4_update(fletcher4_ctx *ctx, const uint8_t *data, uint32_t len)
+{
+    return fletcher4_update64(ctx, data, len);
+}
+
+/**
+ * @brief Updates the Fletcher-4 checksum with new data of any length.
+ *
+ * The checksum is defined on 32-bit words, but updates can be of any length: the bytes of a
+ * word split between updates are kept until it is complete.
+ *
+ * @param ctx Pointer to the Fletcher-4 context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL fletcher4_update64(fletcher4_ctx *ctx, const uint8_t *data, uint64_t len)
+{
+    uint32_t fill;
+    uint64_t chunk;
+
+    if(!ctx || !data) return -1;
+
+    if(ctx->pending_len)
+    {
+        fill = 4 - ctx->pending_len;
+
+        if(len < fill)
+        {
+            memcpy(ctx->pending + ctx->pending_len, data, (size_t)len);
+            ctx->pending_len += (uint32_t)len;
+
+            return 0;
+        }
+
+        memcpy(ctx->pending + ctx->pending_len, data, fill);
+        fletcher4_words(ctx->sums, ctx->pending, 1);
+
+        ctx->pending_len = 0;
+        data += fill;
+        len -= fill;
+    }
+
+    while(len >= 4)
+    {
+        chunk = len > FLETCHER4_MAX_CHUNK ? FLETCHER4_MAX_CHUNK : len & ~3ULL;
+
+        fletcher4_chunk(ctx, data, (uint32_t)(chunk / 4));
+
+        data += chunk;
+        len -= chunk;
+    }
+
+    memcpy(ctx->pending, data, (size_t)len);
+    ctx->pending_len = (uint32_t)len;
+
+    return 0;
+}
+
+/**
+ * @brief Returns the Fletcher-4 checksum of the data so far.
+ *
+ * @param ctx Pointer to the Fletcher-4 context structure.
+ * @param checksum Receives the four sums, in the order ZFS stores them.
+ *
+ * @returns 0 on success, -1 on error or if the length of the data is not a multiple of 4 bytes.
+ */
+AARU_EXPORT int AARU_CALL fletcher4_final(fletcher4_ctx *ctx, uint64_t *checksum)
+{
+    if(!ctx || !checksum || ctx->pending_len) return -1;
+
+    memcpy(checksum, ctx->sums, sizeof(ctx->sums));
+
+    return 0;
+}
+
+/**
+ * @brief Frees the resources allocated for the Fletcher-4 checksum context.
+ *
+ * @param ctx The Fletcher-4 checksum context structure, to be freed.
+ */
+AARU_EXPORT void AARU_CALL fletcher4_free(fletcher4_ctx *ctx)
+{
+    if(ctx) free(ctx);
+}
@@ -0,0 +1,55 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AARU_CHECKSUMS_NATIVE_FLETCHER4_H
+#define AARU_CHECKSUMS_NATIVE_FLETCHER4_H
+
+/* Number of 64-bit sums in a Fletcher-4 checksum */
+#define FLETCHER4_SUMS 4
+
+typedef struct
+{
+    uint64_t sums[FLETCHER4_SUMS];
+    uint8_t  pending[4];
+    uint32_t pending_len;
+} fletcher4_ctx;
+
+AARU_EXPORT fletcher4_ctx *AARU_CALL fletcher4_init();
+AARU_EXPORT int AARU_CALL            fletcher4_update(fletcher4_ctx *ctx, const uint8_t *data, uint32_t len);
+AARU_EXPORT int AARU_CALL            fletcher4_update64(fletcher4_ctx *ctx, const uint8_t *data, uint64_t len);
+AARU_EXPORT int AARU_CALL            fletcher4_final(fletcher4_ctx *ctx, uint64_t *checksum);
+AARU_EXPORT void AARU_CALL           fletcher4_free(fletcher4_ctx *ctx);
+
+AARU_LOCAL void fletcher4_words(uint64_t *sums, const uint8_t *data, uint32_t words);
+AARU_LOCAL void fletcher4_lanes(uint64_t *sums, const uint64_t *lanes, uint32_t count, uint32_t words);
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL    fletcher4_avx2(uint64_t *sums, const uint8_t *data, uint32_t words);
+AARU_EXPORT TARGET_WITH_AVX512F void AARU_CALL fletcher4_avx512(uint64_t *sums, const uint8_t *data, uint32_t words);
+
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+
+AARU_EXPORT void AARU_CALL fletcher4_neon(uint64_t *sums, const uint8_t *data, uint32_t words);
+
+#endif
+
+#endif  // AARU_CHECKSUMS_NATIVE_FLETCHER4_H
@@ -0,0 +1,75 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "library.h"
+#include "fletcher4.h"
+#include "simd.h"
+
+/**
+ * @brief Calculate Fletcher-4 checksum for a given data using AVX2 instructions.
+ *
+ * Four lanes of 64-bit sums take one word each out of every 16 bytes, and their sums are
+ * combined into the checksum at the end by fletcher4_lanes().
+ *
+ * @param sums Pointer to the four sums.
+ * @param data Pointer to the data buffer.
+ * @param words Number of 32-bit words in the data buffer.
+ */
+AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL fletcher4_avx2(uint64_t *sums, const uint8_t *data, uint32_t words)
+{
+    uint64_t ALIGNED_(32) lanes[4 * 4];
+    uint32_t blocks = words / 4;
+    uint32_t i;
+
+    if(blocks)
+    {
+        __m256i a = _mm256_setzero_si256();
+        __m256i b = _mm256_setzero_si256();
+        __m256i c = _mm256_setzero_si256();
+        __m256i d = _mm256_setzero_si256();
+
+        for(i = 0; i < blocks; i++)
+        {
+            const __m256i w = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *)data));
+
+            a = _mm256_add_epi64(a, w);
+            b = _mm256_add_epi64(b, a);
+            c = _mm256_add_epi64(c, b);
+            d = _mm256_add_epi64(d, c);
+
+            data += 16;
+        }
+
+        _mm256_store_si256((__m256i *)lanes, a);
+        _mm256_store_si256((__m256i *)(lanes + 4), b);
+        _mm256_store_si256((__m256i *)(lanes + 8), c);
+        _mm256_store_si256((__m256i *)(lanes + 12), d);
+
+        fletcher4_lanes(sums, lanes, 4, blocks * 4);
+    }
+
+    fletcher4_words(sums, data, words % 4);
+}
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)))
+
+#include <arm_neon.h>
+#include <stdint.h>
+
+#include "library.h"
+#include "fletcher4.h"
+#include "simd.h"
+
+/**
+ * @brief Calculate Fletcher-4 checksum for a given data using NEON instructions.
+ *
+ * Four lanes of 64-bit sums, held in pairs of registers, take one word each out of every
+ * 16 bytes, and their sums are combined into the checksum at the end by fletcher4_lanes().
+ *
+ * @param sums Pointer to the four sums.
+ * @param data Pointer to the data buffer.
+ * @param words Number of 32-bit words in the data buffer.
+ */
+AARU_EXPORT TARGET_WITH_NEON void AARU_CALL fletcher4_neon(uint64_t *sums, const uint8_t *data, uint32_t words)
+{
+    uint64_t lanes[4 * 4];
+    uint32_t blocks = words / 4;
+    uint32_t i;
+
+    if(blocks)
+    {
+        uint64x2_t a_lo = vdupq_n_u64(0);
+        uint64x2_t a_hi = vdupq_n_u64(0);
+        uint64x2_t b_lo = vdupq_n_u64(0);
+        uint64x2_t b_hi = vdupq_n_u64(0);
+        uint64x2_t c_lo = vdupq_n_u64(0);
+        uint64x2_t c_hi = vdupq_n_u64(0);
+        uint64x2_t d_lo = vdupq_n_u64(0);
+        uint64x2_t d_hi = vdupq_n_u64(0);
+
+        for(i = 0; i < blocks; i++)
+        {
+            const uint32x4_t w = vreinterpretq_u32_u8(vld1q_u8(data));
+
+            a_lo = vaddw_u32(a_lo, vget_low_u32(w));
+            a_hi = vaddw_u32(a_hi, vget_high_u32(w));
+            b_lo = vaddq_u64(b_lo, a_lo);
+            b_hi = vaddq_u64(b_hi, a_hi);
+            c_lo = vaddq_u64(c_lo, b_lo);
+            c_hi = vaddq_u64(c_hi, b_hi);
+            d_lo = vaddq_u64(d_lo, c_lo);
+            d_hi = vaddq_u64(d_hi, c_hi);
+
+            data += 16;
+        }
+
+        vst1q_u64(lanes, a_lo);
+        vst1q_u64(lanes + 2, a_hi);
+        vst1q_u64(lanes + 4, b_lo);
+        vst1q_u64(lanes + 6, b_hi);
+        vst1q_u64(lanes + 8, c_lo);
+        vst1q_u64(lanes + 10, c_hi);
+        vst1q_u64(lanes + 12, d_lo);
+        vst1q_u64(lanes + 14, d_hi);
+
+        fletcher4_lanes(sums, lanes, 4, blocks * 4);
+    }
+
+    fletcher4_words(sums, data, words % 4);
+}
+
+#endif
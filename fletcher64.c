@@ -0,0 +1,273 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Fletcher-64, the checksum of every APFS object.
+ *
+ * The data is a sequence of little-endian 32-bit words, and two sums are kept modulo 2^32-1,
+ * sum1 of the words and sum2 of the running values of sum1. APFS then turns them into the two
+ * check words that make the sums of the object, checksum included, zero.
+ *
+ * The SIMD kernels split the words in lanes, lane i taking words i, i + L, i + 2L... and keeping
+ * its own two sums from zero in 64 bits. The sums of the whole block are a fixed linear
+ * combination of the lane sums, computed by fletcher64_lanes(), and are then added to the
+ * checksum.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "library.h"
+#include "fletcher64.h"
+#include "simd.h"
+
+/* Largest chunk given to a kernel at once, a multiple of the word size */
+#define FLETCHER64_MAX_CHUNK (1U << 30)
+
+/**
+ * @brief Initializes the Fletcher-64 checksum algorithm.
+ *
+ * @return Pointer to a structure containing the checksum state.
+ */
+AARU_EXPORT fletcher64_ctx *AARU_CALL fletcher64_init()
+{
+    fletcher64_ctx *ctx;
+
+    ctx = (fletcher64_ctx *)malloc(sizeof(fletcher64_ctx));
+
+    if(!ctx) return NULL;
+
+    memset(ctx, 0, sizeof(fletcher64_ctx));
+
+    return ctx;
+}
+
+/**
+ * @brief Adds little-endian 32-bit words to the Fletcher-64 sums one at a time.
+ *
+ * @param sum1 Pointer to the first sum.
+ * @param sum2 Pointer to the second sum.
+ * @param data Pointer to the data buffer.
+ * @param words Number of 32-bit words in the data buffer.
+ */
+AARU_LOCAL void fletcher64_words(uint32_t *sum1, uint32_t *sum2, const uint8_t *data, uint32_t words)
+{
+    uint64_t s1 = *sum1;
+    uint64_t s2 = *sum2;
+    uint32_t n;
+
+    while(words)
+    {
+        n = words > FLETCHER64_NMAX ? FLETCHER64_NMAX : words;
+        words -= n;
+
+        while(n--)
+        {
+            s1 += (uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24;
+            s2 += s1;
+
+            data += 4;
+        }
+
+        s1 %= FLETCHER64_MODULE;
+        s2 %= FLETCHER64_MODULE;
+    }
+
+    *sum1 = (uint32_t)s1;
+    *sum2 = (uint32_t)s2;
+}
+
+/**
+ * @brief Adds the lane sums of a block computed by a SIMD kernel to the Fletcher-64 sums.
+ *
+ * Lane i summed the words i, i + count, i + 2 * count... of the block starting from zero. A
+ * word that is r words from the end of its lane, counting itself, is count * r - i words from
+ * the end of the block, so it adds count times its weight in the second lane sum, minus i
+ * times its value, to the second sum of the block.
+ *
+ * @param sum1 Pointer to the first sum.
+ * @param sum2 Pointer to the second sum.
+ * @param lanes Sums of the lanes, the count first sums followed by the second ones.
+ * @param count Number of lanes.
+ * @param words Number of words in the block, a multiple of count up to FLETCHER64_NMAX.
+ */
+AARU_LOCAL void fletcher64_lanes(uint32_t *sum1, uint32_t *sum2, const uint64_t *lanes, uint32_t count,
+                                 uint32_t words)
+{
+    uint64_t s1 = *sum1;
+    uint64_t s2 = *sum2;
+    uint64_t a;
+    uint32_t i;
+
+    /* Every word of the block adds the first sum from before the block to the second sum */
+    s2 += (uint64_t)words * s1;
+
+    for(i = 0; i < count; i++)
+    {
+        a = lanes[i] % FLETCHER64_MODULE;
+
+        s1 += a;
+        s2 += count * (lanes[count + i] % FLETCHER64_MODULE) + i * (FLETCHER64_MODULE - a);
+    }
+
+    *sum1 = (uint32_t)(s1 % FLETCHER64_MODULE);
+    *sum2 = (uint32_t)(s2 % FLETCHER64_MODULE);
+}
+
+/**
+ * @brief Runs the best available Fletcher-64 kernel over a chunk of words.
+ *
+ * @param ctx Pointer to the Fletcher-64 context structure.
+ * @param data Pointer to the input data buffer.
+ * @param words Number of 32-bit words in the data buffer.
+ */
+static void fletcher64_chunk(fletcher64_ctx *ctx, const uint8_t *data, uint32_t words)
+{
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)) && !defined(__MINGW32__))
+    if(have_neon())
+    {
+        fletcher64_neon(&ctx->sum1, &ctx->sum2, data, words);
+
+        return;
+    }
+#endif
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+    if(have_avx512f())
+    {
+        fletcher64_avx512(&ctx->sum1, &ctx->sum2, data, words);
+
+        return;
+    }
+
+    if(have_avx2())
+    {
+        fletcher64_avx2(&ctx->sum1, &ctx->sum2, data, words);
+
+        return;
+    }
+#endif
+
+    fletcher64_words(&ctx->sum1, &ctx->sum2, data, words);
+}
+
+/**
+ * @brief Updates the Fletcher-64 checksum with new data.
+ *
+ * @param ctx Pointer to the Fletcher-64 context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL fletcher64_update(fletcher64_ctx *ctx, const uint8_t *data, uint32_t len)
+{
+    return fletcher64_update64(ctx, data, len);
+}
+
+/**
+ * @brief Updates the Fletcher-64 checksum with new data of any length.
+ *
+ * The checksum is defined on 32-bit words, but updates can be of any length: the bytes of a
+ * word split between updates are kept until it is complete.
+ *
+ * @param ctx Pointer to the Fletcher-64 context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL fletcher64_update64(fletcher64_ctx *ctx, const uint8_t *data, uint64_t len)
+{
+    uint32_t fill;
+    uint64_t chunk;
+
+    if(!ctx || !data) return -1;
+
+    if(ctx->pending_len)
+    {
+        fill = 4 - ctx->pending_len;
+
+        if(len < fill)
+        {
+            memcpy(ctx->pending + ctx->pending_len, data, (size_t)len);
+            ctx->pending_len += (uint32_t)len;
+
+            return 0;
+        }
+
+        memcpy(ctx->pending + ctx->pending_len, data, fill);
+        fletcher64_words(&ctx->sum1, &ctx->sum2, ctx->pending, 1);
+
+        ctx->pending_len = 0;
+        data += fill;
+        len -= fill;
+    }
+
+    while(len >= 4)
+    {
+        chunk = len > FLETCHER64_MAX_CHUNK ? FLETCHER64_MAX_CHUNK : len & ~3ULL;
+
+        fletcher64_chunk(ctx, data, (uint32_t)(chunk / 4));
+
+        data += chunk;
+        len -= chunk;
+    }
+
+    memcpy(ctx->pending, data, (size_t)len);
+    ctx->pending_len = (uint32_t)len;
+
+    return 0;
+}
+
+/**
+ * @brief Returns the Fletcher-64 checksum of the data so far.
+ *
+ * APFS computes it over an object without its first 8 bytes, where it is then stored as a
+ * little-endian 64-bit value.
+ *
+ * @param ctx Pointer to the Fletcher-64 context structure.
+ * @param checksum Receives the checksum.
+ *
+ * @returns 0 on success, -1 on error or if the length of the data is not a multiple of 4 bytes.
+ */
+AARU_EXPORT int AARU_CALL fletcher64_final(fletcher64_ctx *ctx, uint64_t *checksum)
+{
+    uint64_t c1, c2;
+
+    if(!ctx || !checksum || ctx->pending_len) return -1;
+
+    c1 = FLETCHER64_MODULE - ((uint64_t)ctx->sum1 + ctx->sum2) % FLETCHER64_MODULE;
+    c2 = FLETCHER64_MODULE - ((uint64_t)ctx->sum1 + c1) % FLETCHER64_MODULE;
+
+    *checksum = c2 << 32 | c1;
+
+    return 0;
+}
+
+/**
+ * @brief Frees the resources allocated for the Fletcher-64 checksum context.
+ *
+ * @param ctx The Fletcher-64 checksum context structure, to be freed.
+ */
+AARU_EXPORT void AARU_CALL fletcher64_free(fletcher64_ctx *ctx)
+{
+    if(ctx) free(ctx);
+}
@@ -0,0 +1,74 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "library.h"
+#include "fletcher64.h"
+#include "simd.h"
+
+/**
+ * @brief Calculate Fletcher-64 checksum for a given data using AVX-512 instructions.
+ *
+ * Eight lanes of 64-bit sums take one word each out of every 32 bytes. Blocks of up to
+ * FLETCHER64_NMAX words are summed from zero, and their lane sums combined into the checksum by
+ * fletcher64_lanes().
+ *
+ * @param sum1 Pointer to the first sum.
+ * @param sum2 Pointer to the second sum.
+ * @param data Pointer to the data buffer.
+ * @param words Number of 32-bit words in the data buffer.
+ */
+AARU_EXPORT TARGET_WITH_AVX512F void AARU_CALL fletcher64_avx512(uint32_t *sum1, uint32_t *sum2, const uint8_t *data,
+                                                                 uint32_t words)
+{
+    uint64_t ALIGNED_(64) lanes[2 * 8];
+    uint32_t n, i;
+
+    while(words >= 8)
+    {
+        __m512i a = _mm512_setzero_si512();
+        __m512i b = _mm512_setzero_si512();
+
+        n = words > FLETCHER64_NMAX ? FLETCHER64_NMAX : words & ~7U;
+        words -= n;
+
+        for(i = 0; i < n / 8; i++)
+        {
+            const __m512i w = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i *)data));
+
+            a = _mm512_add_epi64(a, w);
+            b = _mm512_add_epi64(b, a);
+
+            data += 32;
+        }
+
+        _mm512_store_si512((void *)lanes, a);
+        _mm512_store_si512((void *)(lanes + 8), b);
+
+        fletcher64_lanes(sum1, sum2, lanes, 8, n);
+    }
+
+    fletcher64_words(sum1, sum2, data, words);
+}
+
+#endif
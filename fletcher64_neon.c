@@ -0,0 +1,79 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)))
+
+#include <arm_neon.h>
+#include <stdint.h>
+
+#include "library.h"
+#include "fletcher64.h"
+#include "simd.h"
+
+/**
+ * @brief Calculate Fletcher-64 checksum for a given data using NEON instructions.
+ *
+ * Four lanes of 64-bit sums, held in pairs of registers, take one word each out of every
+ * 16 bytes. Blocks of up to FLETCHER64_NMAX words are summed from zero, and their lane sums
+ * combined into the checksum by fletcher64_lanes().
+ *
+ * @param sum1 Pointer to the first sum.
+ * @param sum2 Pointer to the second sum.
+ * @param data Pointer to the data buffer.
+ * @param words Number of 32-bit words in the data buffer.
+ */
+AARU_EXPORT TARGET_WITH_NEON void AARU_CALL fletcher64_neon(uint32_t *sum1, uint32_t *sum2, const uint8_t *data,
+                                                            uint32_t words)
+{
+    uint64_t lanes[2 * 4];
+    uint32_t n, i;
+
+    while(words >= 4)
+    {
+        uint64x2_t a_lo = vdupq_n_u64(0);
+        uint64x2_t a_hi = vdupq_n_u64(0);
+        uint64x2_t b_lo = vdupq_n_u64(0);
+        uint64x2_t b_hi = vdupq_n_u64(0);
+
+        n = words > FLETCHER64_NMAX ? FLETCHER64_NMAX : words & ~3U;
+        words -= n;
+
+        for(i = 0; i < n / 4; i++)
+        {
+            const uint32x4_t w = vreinterpretq_u32_u8(vld1q_u8(data));
+
+            a_lo = vaddw_u32(a_lo, vget_low_u32(w));
+            a_hi = vaddw_u32(a_hi, vget_high_u32(w));
+            b_lo = vaddq_u64(b_lo, a_lo);
+            b_hi = vaddq_u64(b_hi, a_hi);
+
+            data += 16;
+        }
+
+        vst1q_u64(lanes, a_lo);
+        vst1q_u64(lanes + 2, a_hi);
+        vst1q_u64(lanes + 4, b_lo);
+        vst1q_u64(lanes + 6, b_hi);
+
+        fletcher64_lanes(sum1, sum2, lanes, 4, n);
+    }
+
+    fletcher64_words(sum1, sum2, data, words);
+}
+
+#endif
@@ -58,6 +58,13 @@
 
 #define AARU_CHECKUMS_NATIVE_VERSION 0x06000089
 
+// Bounds of the staging buffer used by the buffered update mode
+#define AARU_BUFFERED_MIN_SIZE 256
+#define AARU_BUFFERED_MAX_SIZE 4096
+
+// Shortest run of a single byte value that the run detection mode looks for
+#define AARU_RUN_MIN_LENGTH 64
+
 AARU_EXPORT uint64_t AARU_CALL get_acn_version();
 
 #endif  // AARU_CHECKSUMS_NATIVE_LIBRARY_H
@@ -0,0 +1,156 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include "library.h"
+#include "parallel.h"
+
+typedef struct
+{
+    parallel_job job;
+    uint8_t     *args;
+    size_t       arg_size;
+    uint32_t     first;
+    uint32_t     count;
+    uint32_t     step;
+    int          started;
+#if defined(_WIN32)
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+} parallel_worker;
+
+static void parallel_work(parallel_worker *worker)
+{
+    uint32_t i;
+
+    for(i = worker->first; i < worker->count; i += worker->step) worker->job(worker->args + i * worker->arg_size);
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI parallel_thread(LPVOID arg)
+{
+    parallel_work((parallel_worker *)arg);
+    return 0;
+}
+#else
+static void *parallel_thread(void *arg)
+{
+    parallel_work((parallel_worker *)arg);
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Gets the number of processors available to run threads.
+ *
+ * @return Number of online processors, at least 1.
+ */
+AARU_LOCAL uint32_t parallel_cpu_count(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+
+    return info.dwNumberOfProcessors > 0 ? (uint32_t)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return count > 0 ? (uint32_t)count : 1;
+#endif
+}
+
+/**
+ * @brief Runs a set of independent jobs using several threads.
+ *
+ * Jobs are distributed in a round-robin fashion between the threads, and the calling
+ * thread takes its share too. The function returns once every job has finished. If
+ * a thread cannot be created its jobs are run by the calling thread, so all jobs
+ * always run.
+ *
+ * @param job Function that runs one job.
+ * @param args Array with the argument of each job.
+ * @param arg_size Size of each element of the args array.
+ * @param count Number of jobs.
+ * @param threads Maximum number of threads to use, including the calling one.
+ */
+AARU_LOCAL void parallel_run(parallel_job job, void *args, size_t arg_size, uint32_t count, uint32_t threads)
+{
+    parallel_worker *workers;
+    uint32_t         i;
+
+    if(threads > count) threads = count;
+
+    if(threads <= 1 || !(workers = (parallel_worker *)calloc(threads, sizeof(parallel_worker))))
+    {
+        for(i = 0; i < count; i++) job((uint8_t *)args + i * arg_size);
+
+        return;
+    }
+
+    for(i = 0; i < threads; i++)
+    {
+        workers[i].job      = job;
+        workers[i].args     = (uint8_t *)args;
+        workers[i].arg_size = arg_size;
+        workers[i].first    = i;
+        workers[i].count    = count;
+        workers[i].step     = threads;
+
+        if(i == 0) continue;
+
+#if defined(_WIN32)
+        workers[i].thread  = CreateThread(NULL, 0, parallel_thread, &workers[i], 0, NULL);
+        workers[i].started = workers[i].thread != NULL;
+#else
+        workers[i].started = pthread_create(&workers[i].thread, NULL, parallel_thread, &workers[i]) == 0;
+#endif
+    }
+
+    parallel_work(&workers[0]);
+
+    for(i = 1; i < threads; i++)
+    {
+        if(!workers[i].started)
+        {
+            parallel_work(&workers[i]);
+            continue;
+        }
+
+#if defined(_WIN32)
+        WaitForSingleObject(workers[i].thread, INFINITE);
+        CloseHandle(workers[i].thread);
+#else
+        pthread_join(workers[i].thread, NULL);
+#endif
+    }
+
+    free(workers);
+}
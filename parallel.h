@@ -0,0 +1,29 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AARU_CHECKSUMS_NATIVE_PARALLEL_H
+#define AARU_CHECKSUMS_NATIVE_PARALLEL_H
+
+#include <stddef.h>
+
+typedef void (*parallel_job)(void *arg);
+
+AARU_LOCAL uint32_t parallel_cpu_count(void);
+AARU_LOCAL void     parallel_run(parallel_job job, void *args, size_t arg_size, uint32_t count, uint32_t threads);
+
+#endif  // AARU_CHECKSUMS_NATIVE_PARALLEL_H
@@ -0,0 +1,85 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "library.h"
+#include "runs.h"
+
+/* Longest comparison when extending a run, so its start stays cached */
+#define RUNS_MAX_STEP (16 * 1024)
+
+/**
+ * @brief Finds the first run of a single byte value in a buffer.
+ *
+ * A run of min bytes always covers a whole block of min / 2 bytes aligned to min / 2, so only
+ * those blocks are tested, and most of them are discarded by comparing three of their bytes.
+ * Uniform blocks are then extended backward and forward to the whole run.
+ *
+ * @param data Pointer to the data buffer.
+ * @param len Length of the data buffer.
+ * @param min Minimum length of a run, at least AARU_RUN_MIN_LENGTH.
+ * @param run Receives the length of the run, or 0 if there is none.
+ *
+ * @returns Offset of the run, or len if there is none.
+ */
+AARU_LOCAL uint64_t runs_find(const uint8_t *data, uint64_t len, uint32_t min, uint64_t *run)
+{
+    const uint64_t half = min / 2;
+    uint64_t       pos, start, end, step;
+    uint8_t        value;
+
+    for(pos = 0; pos + half <= len; pos += half)
+    {
+        value = data[pos];
+
+        if(data[pos + half - 1] != value || data[pos + half / 2] != value) continue;
+
+        if(memcmp(data + pos, data + pos + 1, half - 1)) continue;
+
+        start = pos;
+        end   = pos + half;
+
+        /* The previous block was not uniform, so this is less than half a block */
+        while(start && data[start - 1] == value) start--;
+
+        /* Extend in doubling steps while the run lasts, then in halving ones, comparing with its cached start */
+        step = half;
+
+        while(end + step <= len && !memcmp(data + end, data + start, step))
+        {
+            end += step;
+
+            if(step < RUNS_MAX_STEP) step *= 2;
+        }
+
+        for(step /= 2; step >= half; step /= 2)
+            if(end + step <= len && !memcmp(data + end, data + start, step)) end += step;
+
+        while(end < len && data[end] == value) end++;
+
+        if(end - start < min) continue;
+
+        *run = end - start;
+        return start;
+    }
+
+    *run = 0;
+    return len;
+}
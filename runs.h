@@ -0,0 +1,42 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AARU_CHECKSUMS_NATIVE_RUNS_H
+#define AARU_CHECKSUMS_NATIVE_RUNS_H
+
+/*
+ * A run of n copies of a byte b adds n * b to the first sum of Adler-32 and Fletcher, and
+ * n * sum1 + b * n(n+1)/2 to the second one, so a whole run can be applied at once instead
+ * of being fed to the kernels byte by byte.
+ */
+
+/* Most data given to runs_find() at once, so the data it scans is still cached for the kernels */
+#define RUNS_WINDOW (256 * 1024)
+
+/* n(n+1)/2 modulo a checksum modulus, without overflowing for any n */
+FORCE_INLINE uint64_t runs_triangle(uint64_t n, uint32_t module)
+{
+    /* Halving whichever factor is even */
+    if(n & 1) return n % module * ((n / 2 + 1) % module) % module;
+
+    return n / 2 % module * ((n + 1) % module) % module;
+}
+
+AARU_LOCAL uint64_t runs_find(const uint8_t *data, uint64_t len, uint32_t min, uint64_t *run);
+
+#endif  // AARU_CHECKSUMS_NATIVE_RUNS_H
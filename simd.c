@@ -189,6 +189,108 @@ int have_avx2(void)
 
     return ebx & 0x20;
 }
+
+/**
+ * @brief Checks if the operating system saves the given register states on context switches.
+ *
+ * @param mask Bits of the XCR0 register that must be set.
+ *
+ * @return true if all the register states are enabled, false otherwise.
+ */
+static int have_xsave_states(unsigned mask)
+{
+    unsigned eax, ebx, ecx, edx;
+    cpuid(1 /* feature bits */, &eax, &ebx, &ecx, &edx);
+
+    /* OSXSAVE, bit 27, tells that XGETBV can be used */
+    if(!(ecx & 0x8000000)) return 0;
+
+#ifdef _MSC_VER
+    eax = (unsigned)_xgetbv(0);
+#else
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+#endif
+
+    return (eax & mask) == mask;
+}
+
+/**
+ * @brief Checks if the current processor supports AVX-512 Foundation instructions.
+ *
+ * The function detects whether the current processor supports the AVX-512 Foundation
+ * instructions, and that the operating system saves the AVX-512 registers. The result is
+ * cached, as it is checked on every update.
+ *
+ * @return true if the current processor supports AVX-512 Foundation instructions, false otherwise.
+ *
+ * @see https://en.wikipedia.org/wiki/AVX-512
+ */
+int have_avx512f(void)
+{
+    static int cached = -1;
+    unsigned   eax, ebx, ecx, edx;
+
+    if(cached >= 0) return cached;
+
+    cpuidex(7 /* extended feature bits */, 0, &eax, &ebx, &ecx, &edx);
+
+    /* AVX512F is bit 16 of EBX, XCR0 must enable the SSE, AVX, opmask and both halves of the ZMM states */
+    cached = (ebx & 0x10000) && have_xsave_states(0xE6);
+
+    return cached;
+}
+
+/**
+ * @brief Checks if the current processor supports AVX-512 VNNI instructions.
+ *
+ * The function detects whether the current processor supports the AVX-512 Foundation, Byte and
+ * Word, and Vector Neural Network instructions, and that the operating system saves the
+ * AVX-512 registers. The result is cached, as it is checked on every update.
+ *
+ * @return true if the current processor supports AVX-512 VNNI instructions, false otherwise.
+ *
+ * @see https://en.wikipedia.org/wiki/AVX-512
+ */
+int have_avx512_vnni(void)
+{
+    static int cached = -1;
+    unsigned   eax, ebx, ecx, edx;
+
+    if(cached >= 0) return cached;
+
+    cpuidex(7 /* extended feature bits */, 0, &eax, &ebx, &ecx, &edx);
+
+    /* AVX512F is bit 16 and AVX512BW bit 30 of EBX, AVX512_VNNI is bit 11 of ECX.
+     * XCR0 must enable the SSE, AVX, opmask and both halves of the ZMM states. */
+    cached = (ebx & 0x10000) && (ebx & 0x40000000) && (ecx & 0x800) && have_xsave_states(0xE6);
+
+    return cached;
+}
+
+/**
+ * @brief Checks if the current processor supports AVX-VNNI instructions.
+ *
+ * AVX-VNNI gives the Vector Neural Network instructions on 256-bit registers to processors
+ * without AVX-512, like Alder Lake. The result is cached, as it is checked on every update.
+ *
+ * @return true if the current processor supports AVX-VNNI instructions, false otherwise.
+ *
+ * @see https://en.wikipedia.org/wiki/AVX-512#VNNI
+ */
+int have_avx_vnni(void)
+{
+    static int cached = -1;
+    unsigned   eax, ebx, ecx, edx;
+
+    if(cached >= 0) return cached;
+
+    cpuidex(7 /* extended feature bits */, 1, &eax, &ebx, &ecx, &edx);
+
+    /* AVX-VNNI is bit 4 of EAX, XCR0 must enable the SSE and AVX states */
+    cached = have_avx2() && (eax & 0x10) && have_xsave_states(0x6);
+
+    return cached;
+}
 #endif
 
 #if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
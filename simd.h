@@ -32,15 +32,24 @@
 #define TARGET_WITH_AVX2
 #define TARGET_WITH_SSSE3
 #define TARGET_WITH_CLMUL
+#define TARGET_WITH_AVX512F
+#define TARGET_WITH_AVX512_VNNI
+#define TARGET_WITH_AVX_VNNI
 #else
-#define TARGET_WITH_AVX2  __attribute__((target("avx2")))
-#define TARGET_WITH_SSSE3 __attribute__((target("ssse3")))
-#define TARGET_WITH_CLMUL __attribute__((target("pclmul,sse4.1")))
+#define TARGET_WITH_AVX2        __attribute__((target("avx2")))
+#define TARGET_WITH_SSSE3       __attribute__((target("ssse3")))
+#define TARGET_WITH_CLMUL       __attribute__((target("pclmul,sse4.1")))
+#define TARGET_WITH_AVX512F     __attribute__((target("avx512f")))
+#define TARGET_WITH_AVX512_VNNI __attribute__((target("avx512f,avx512bw,avx512vnni")))
+#define TARGET_WITH_AVX_VNNI    __attribute__((target("avx2,avxvnni")))
 #endif
 
 AARU_EXPORT int have_clmul(void);
 AARU_EXPORT int have_ssse3(void);
 AARU_EXPORT int have_avx2(void);
+AARU_EXPORT int have_avx512f(void);
+AARU_EXPORT int have_avx512_vnni(void);
+AARU_EXPORT int have_avx_vnni(void);
 #endif
 
 #if(defined(__arm__) || defined(_M_ARM)) && !defined(_WIN32)
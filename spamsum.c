@@ -27,11 +27,11 @@
 
 #include "library.h"
 #include "spamsum.h"
+#include "state.h"
 
-static uint8_t b64[] = {0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F, 0x50,
-                        0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66,
-                        0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76,
-                        0x77, 0x78, 0x79, 0x7A, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x2B, 0x2F};
+/* Exported state sizes, the fixed part and each active blockhash */
+#define SPAMSUM_STATE_FIXED_SIZE     55
+#define SPAMSUM_STATE_BLOCKHASH_SIZE 77
 
 /**
  * @brief Initializes the SpamSum checksum algorithm.
@@ -50,8 +50,44 @@ AARU_EXPORT spamsum_ctx *AARU_CALL spamsum_init(void)
     memset(ctx, 0, sizeof(spamsum_ctx));
 
     ctx->bh_end       = 1;
-    ctx->bh[0].h      = HASH_INIT;
-    ctx->bh[0].half_h = HASH_INIT;
+    BH_H(ctx, 0)      = HASH_INIT;
+    BH_HALF_H(ctx, 0) = HASH_INIT;
+    ctx->bh_end_limit = NUM_BLOCKHASHES;
+
+    return ctx;
+}
+
+/**
+ * @brief Initializes the SpamSum checksum algorithm for data of a known size.
+ *
+ * Knowing the total size in advance, the block size that will be chosen when finalizing
+ * can be guessed. Only that block size and the next one are forked, and smaller ones are
+ * dropped as soon as they cannot be needed as a fallback, saving most of the hashing work
+ * done for block sizes that would never be used. The result is identical to the one of a
+ * context created with spamsum_init().
+ *
+ * @param total_size Total size of the data that will be hashed.
+ *
+ * @return Pointer to a structure containing the checksum state.
+ */
+AARU_EXPORT spamsum_ctx *AARU_CALL spamsum_init_sized(uint64_t total_size)
+{
+    spamsum_ctx *ctx = spamsum_init();
+    uint32_t     bi  = 0;
+
+    if(!ctx) return NULL;
+
+    /* Same initial blocksize guess as spamsum_final() */
+    while((uint64_t)SSDEEP_BS(bi) * SPAMSUM_LENGTH < total_size)
+    {
+        ++bi;
+
+        if(bi == NUM_BLOCKHASHES - 2) break;
+    }
+
+    ctx->flags |= SPAMSUM_SIZE_FIXED;
+    ctx->fixed_size   = total_size;
+    ctx->bh_end_limit = bi + 2;
 
     return ctx;
 }
@@ -69,16 +105,219 @@ AARU_EXPORT spamsum_ctx *AARU_CALL spamsum_init(void)
  */
 AARU_EXPORT int AARU_CALL spamsum_update(spamsum_ctx *ctx, const uint8_t *data, uint32_t len)
 {
-    int i;
     if(!ctx || !data) return -1;
 
-    for(i = 0; i < len; i++) fuzzy_engine_step(ctx, data[i]);
-
+    /* Accounted beforehand, so blockhashes that are too small for the final size can be dropped early */
     ctx->total_size += len;
 
+    spamsum_engine(ctx, data, len);
+
     return 0;
 }
 
+typedef void(AARU_CALL *spamsum_prescan_fn)(const uint8_t *data, uint32_t len, uint32_t bias, uint32_t level,
+                                            uint64_t *bitmap);
+typedef void(AARU_CALL *spamsum_fnv_fn)(uint32_t *hashes, uint32_t first, uint32_t last, const uint8_t *data,
+                                        uint32_t len);
+
+/* Rolling hash sums of the ROLLING_WINDOW bytes ending at data */
+FORCE_INLINE void roll_get(const uint8_t *data, uint32_t *h1, uint32_t *h2, uint32_t *h3)
+{
+    int age;
+
+    *h1 = 0;
+    *h2 = 0;
+    *h3 = 0;
+
+    /* Accumulating the running sum from the newest byte weighs each byte by ROLLING_WINDOW minus its age */
+    for(age = 0; age < ROLLING_WINDOW; age++)
+    {
+        *h1 += data[-age];
+        *h2 += *h1;
+        *h3 ^= (uint32_t)data[-age] << (5 * age);
+    }
+}
+
+/* Rolling hash of the ROLLING_WINDOW bytes ending at data */
+FORCE_INLINE uint32_t roll_sum_at(const uint8_t *data)
+{
+    uint32_t h1, h2, h3;
+
+    roll_get(data, &h1, &h2, &h3);
+
+    return h1 + h2 + h3;
+}
+
+/* Sets the rolling hash state as if count more bytes, ending at data, had been fed to roll_hash() */
+FORCE_INLINE void roll_set(spamsum_ctx *ctx, const uint8_t *data, uint32_t count, uint32_t bias)
+{
+    int age;
+
+    ctx->roll.n += count;
+
+    roll_get(data, &ctx->roll.h1, &ctx->roll.h2, &ctx->roll.h3);
+    ctx->roll.h2 += bias;
+
+    for(age = 0; age < ROLLING_WINDOW; age++) ctx->roll.window[(ctx->roll.n - 1 - age) % ROLLING_WINDOW] = data[-age];
+}
+
+/* Index of the lowest set bit of a non-zero value */
+FORCE_INLINE uint32_t lowest_bit(uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctzll(bits);
+#else
+    uint32_t index = 0;
+
+    while(!(bits & 1))
+    {
+        bits >>= 1;
+        index++;
+    }
+
+    return index;
+#endif
+}
+
+/**
+ * @brief Runs the SpamSum engine over a buffer, searching for trigger points beforehand.
+ *
+ * The rolling hash of a block of input is computed in one go by the prescan function,
+ * that returns a bitmap of the positions where it triggers the lowest active blockhash.
+ * Between those positions the blockhashes are hashed all at once, and the rolling
+ * hash state is rebuilt at the end of the block from its last bytes.
+ *
+ * The rolling hash is the plain function of its window computed by the prescan plus a
+ * constant bias, except while its window position wraps around, when the bytes are fed
+ * to fuzzy_engine_step() one by one.
+ *
+ * @param ctx Pointer to the SpamSum context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ * @param prescan Function that computes the bitmap of trigger points.
+ * @param fnv Function that hashes the active blockhashes over a run of bytes.
+ *
+ * @return Number of bytes processed, the rest must be fed to fuzzy_engine_step().
+ */
+static uint32_t spamsum_engine_prescan(spamsum_ctx *ctx, const uint8_t *data, uint32_t len, spamsum_prescan_fn prescan,
+                                       spamsum_fnv_fn fnv)
+{
+    uint64_t bitmap[SPAMSUM_PRESCAN_BLOCK / 64];
+    uint8_t  window[ROLLING_WINDOW];
+    uint32_t pos = 0;
+    uint32_t i;
+
+    while(len - pos >= SPAMSUM_PRESCAN_BLOCK)
+    {
+        const uint8_t *block = data + pos;
+        uint32_t       run   = 0;
+        uint32_t       h1, h2, h3, bias, w;
+
+        if(pos < ROLLING_WINDOW - 1 || ctx->roll.n < ROLLING_WINDOW ||
+           ctx->roll.n > UINT32_MAX - SPAMSUM_PRESCAN_BLOCK)
+        {
+            fuzzy_engine_step(ctx, data[pos++]);
+            continue;
+        }
+
+        /* h1 and h3 match the window, while h2 can carry an error from a wrap of the window position. A state
+         * that does not follow this can only be imported, and is left to the plain engine. */
+        for(i = 0; i < ROLLING_WINDOW; i++) window[i] = ctx->roll.window[(ctx->roll.n + i) % ROLLING_WINDOW];
+
+        roll_get(window + ROLLING_WINDOW - 1, &h1, &h2, &h3);
+
+        if(h1 != ctx->roll.h1 || h3 != ctx->roll.h3) break;
+
+        bias = ctx->roll.h2 - h2;
+
+        prescan(block, SPAMSUM_PRESCAN_BLOCK, bias, ctx->bh_start, bitmap);
+
+        for(w = 0; w < SPAMSUM_PRESCAN_BLOCK / 64; w++)
+        {
+            uint64_t bits = bitmap[w];
+
+            while(bits)
+            {
+                uint32_t trigger = w * 64 + lowest_bit(bits);
+
+                bits &= bits - 1;
+
+                fnv(ctx->hashes, 2 * ctx->bh_start, 2 * ctx->bh_end, block + run, trigger + 1 - run);
+                run = trigger + 1;
+
+                fuzzy_engine_trigger(ctx, (uint32_t)(roll_sum_at(block + trigger) + bias));
+            }
+        }
+
+        fnv(ctx->hashes, 2 * ctx->bh_start, 2 * ctx->bh_end, block + run, SPAMSUM_PRESCAN_BLOCK - run);
+
+        roll_set(ctx, block + SPAMSUM_PRESCAN_BLOCK - 1, SPAMSUM_PRESCAN_BLOCK, bias);
+
+        pos += SPAMSUM_PRESCAN_BLOCK;
+    }
+
+    return pos;
+}
+
+/**
+ * @brief Runs the SpamSum engine over a buffer, without accounting it in the total size.
+ *
+ * @param ctx Pointer to the SpamSum context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ */
+AARU_LOCAL void spamsum_engine(spamsum_ctx *ctx, const uint8_t *data, uint32_t len)
+{
+    spamsum_prescan_fn prescan = spamsum_prescan;
+    spamsum_fnv_fn     fnv     = spamsum_fnv;
+    uint32_t           i;
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+    if(have_avx2())
+    {
+        prescan = spamsum_prescan_avx2;
+        fnv     = spamsum_fnv_avx2;
+    }
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+    if(have_neon())
+    {
+        prescan = spamsum_prescan_neon;
+        fnv     = spamsum_fnv_neon;
+    }
+#endif
+
+    for(i = spamsum_engine_prescan(ctx, data, len, prescan, fnv); i < len; i++) fuzzy_engine_step(ctx, data[i]);
+}
+
+/**
+ * @brief Updates the SpamSum checksum with new data of any length.
+ *
+ * This function updates the SpamSum checksum with buffers that can be larger than 4GiB,
+ * splitting them in chunks that fit the 32-bit update function.
+ *
+ * @param ctx Pointer to the SpamSum context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL spamsum_update64(spamsum_ctx *ctx, const uint8_t *data, uint64_t len)
+{
+    if(!ctx || !data) return -1;
+
+    while(len > SPAMSUM_MAX_CHUNK)
+    {
+        spamsum_update(ctx, data, SPAMSUM_MAX_CHUNK);
+        data += SPAMSUM_MAX_CHUNK;
+        len -= SPAMSUM_MAX_CHUNK;
+    }
+
+    return spamsum_update(ctx, data, (uint32_t)len);
+}
+
 /**
  * @brief Frees the resources allocated for the SpamSum checksum context.
  *
@@ -92,9 +331,76 @@ AARU_EXPORT void AARU_CALL spamsum_free(spamsum_ctx *ctx)
     if(ctx) free(ctx);
 }
 
-#define ROLL_SUM(ctx)    ((ctx)->roll.h1 + (ctx)->roll.h2 + (ctx)->roll.h3)
-#define SUM_HASH(c, h)   (((h) * HASH_PRIME) ^ (c));
-#define SSDEEP_BS(index) (MIN_BLOCKSIZE << (index))
+/**
+ * @brief Searches for the positions where the SpamSum rolling hash triggers a blockhash.
+ *
+ * A rolling hash h triggers blockhash level when h % SSDEEP_BS(level) == SSDEEP_BS(level) - 1.
+ * The rolling hash only depends on the last ROLLING_WINDOW bytes, so it is computed directly
+ * from the input.
+ *
+ * @param data Pointer to the first position to test, the 6 bytes before it must be readable.
+ * @param len Number of positions to test, a multiple of 64.
+ * @param bias Value added to every rolling hash, to match the state of a context.
+ * @param level Blockhash that must be triggered.
+ * @param bitmap Receives one bit per position, set when it triggers the blockhash.
+ */
+AARU_EXPORT void AARU_CALL spamsum_prescan(const uint8_t *data, uint32_t len, uint32_t bias, uint32_t level,
+                                           uint64_t *bitmap)
+{
+    uint32_t h1 = 0;
+    uint32_t h2 = 0;
+    uint32_t h3 = 0;
+    uint32_t i;
+    int      age;
+
+    /* Feed the bytes before the first position, the window is not full yet */
+    for(age = ROLLING_WINDOW - 2; age >= 0; age--)
+    {
+        h2 += ROLLING_WINDOW * data[-age - 1] - h1;
+        h1 += data[-age - 1];
+        h3 = (h3 << 5) ^ data[-age - 1];
+    }
+
+    for(i = 0; i < len; i++)
+    {
+        uint64_t h;
+
+        h2 += ROLLING_WINDOW * data[i] - h1;
+        h1 += data[i] - (i ? data[(long)i - ROLLING_WINDOW] : 0);
+        h3 = (h3 << 5) ^ data[i];
+        h  = (uint32_t)(h1 + h2 + h3 + bias);
+
+        if(i % 64 == 0) bitmap[i / 64] = 0;
+
+        if(h % (uint64_t)SSDEEP_BS(level) == (uint64_t)SSDEEP_BS(level) - 1) bitmap[i / 64] |= (uint64_t)1 << (i % 64);
+    }
+}
+
+/**
+ * @brief Advances blockhash hashes over a run of bytes.
+ *
+ * Every hash in the range is updated with each byte of the run, in order.
+ *
+ * @param hashes Interleaved blockhash hashes, with SPAMSUM_HASHES entries.
+ * @param first First hash to update.
+ * @param last One past the last hash to update.
+ * @param data Pointer to the run of bytes.
+ * @param len Length of the run.
+ */
+AARU_EXPORT void AARU_CALL spamsum_fnv(uint32_t *hashes, uint32_t first, uint32_t last, const uint8_t *data,
+                                       uint32_t len)
+{
+    uint32_t i, j;
+
+    for(i = first; i < last; i++)
+    {
+        uint32_t h = hashes[i];
+
+        for(j = 0; j < len; j++) h = SUM_HASH(data[j], h);
+
+        hashes[i] = h;
+    }
+}
 
 FORCE_INLINE void fuzzy_engine_step(spamsum_ctx *ctx, uint8_t c)
 {
@@ -107,10 +413,17 @@ FORCE_INLINE void fuzzy_engine_step(spamsum_ctx *ctx, uint8_t c)
 
     for(i = ctx->bh_start; i < ctx->bh_end; ++i)
     {
-        ctx->bh[i].h      = SUM_HASH(c, ctx->bh[i].h);
-        ctx->bh[i].half_h = SUM_HASH(c, ctx->bh[i].half_h);
+        BH_H(ctx, i)      = SUM_HASH(c, BH_H(ctx, i));
+        BH_HALF_H(ctx, i) = SUM_HASH(c, BH_HALF_H(ctx, i));
     }
 
+    fuzzy_engine_trigger(ctx, h);
+}
+
+FORCE_INLINE void fuzzy_engine_trigger(spamsum_ctx *ctx, uint64_t h)
+{
+    uint32_t i;
+
     for(i = ctx->bh_start; i < ctx->bh_end; ++i)
     {
         /* With growing blocksize almost no runs fail the next test. */
@@ -125,8 +438,8 @@ FORCE_INLINE void fuzzy_engine_step(spamsum_ctx *ctx, uint8_t c)
          * the last reset point and this one */
         if(0 == ctx->bh[i].d_len) fuzzy_try_fork_blockhash(ctx);
 
-        ctx->bh[i].digest[ctx->bh[i].d_len] = b64[ctx->bh[i].h % 64];
-        ctx->bh[i].half_digest              = b64[ctx->bh[i].half_h % 64];
+        ctx->bh[i].digest[ctx->bh[i].d_len] = b64[BH_H(ctx, i) % 64];
+        ctx->bh[i].half_digest              = b64[BH_HALF_H(ctx, i) % 64];
 
         if(ctx->bh[i].d_len < SPAMSUM_LENGTH - 1)
         {
@@ -137,11 +450,11 @@ FORCE_INLINE void fuzzy_engine_step(spamsum_ctx *ctx, uint8_t c)
              * last few pieces of the message into a single piece
              * */
             ctx->bh[i].digest[++ctx->bh[i].d_len] = 0;
-            ctx->bh[i].h                          = HASH_INIT;
+            BH_H(ctx, i)                          = HASH_INIT;
 
             if(ctx->bh[i].d_len >= SPAMSUM_LENGTH / 2) continue;
 
-            ctx->bh[i].half_h      = HASH_INIT;
+            BH_HALF_H(ctx, i)      = HASH_INIT;
             ctx->bh[i].half_digest = 0;
         }
         else
@@ -174,7 +487,8 @@ FORCE_INLINE void fuzzy_try_reduce_blockhash(spamsum_ctx *ctx)
     if(ctx->bh_end - ctx->bh_start < 2) /* Need at least two working hashes. */
         return;
 
-    if((uint64_t)SSDEEP_BS(ctx->bh_start) * SPAMSUM_LENGTH >= ctx->total_size)
+    if((uint64_t)SSDEEP_BS(ctx->bh_start) * SPAMSUM_LENGTH >=
+       (ctx->flags & SPAMSUM_SIZE_FIXED ? ctx->fixed_size : ctx->total_size))
         /* Initial blocksize estimate would select this or a smaller
          * blocksize. */
         return;
@@ -189,14 +503,14 @@ FORCE_INLINE void fuzzy_try_reduce_blockhash(spamsum_ctx *ctx)
 
 FORCE_INLINE void fuzzy_try_fork_blockhash(spamsum_ctx *ctx)
 {
-    if(ctx->bh_end >= NUM_BLOCKHASHES) return;
+    if(ctx->bh_end >= ctx->bh_end_limit) return;
 
     // assert(ctx->bh_end != 0);
 
     uint32_t obh             = ctx->bh_end - 1;
     uint32_t nbh             = ctx->bh_end;
-    ctx->bh[nbh].h           = ctx->bh[obh].h;
-    ctx->bh[nbh].half_h      = ctx->bh[obh].half_h;
+    BH_H(ctx, nbh)           = BH_H(ctx, obh);
+    BH_HALF_H(ctx, nbh)      = BH_HALF_H(ctx, obh);
     ctx->bh[nbh].digest[0]   = 0;
     ctx->bh[nbh].half_digest = 0;
     ctx->bh[nbh].d_len       = 0;
@@ -222,6 +536,12 @@ AARU_EXPORT int AARU_CALL spamsum_final(spamsum_ctx *ctx, uint8_t *result)
 
     if(!result) return -1;
 
+    if(ctx->flags & SPAMSUM_SIZE_FIXED && ctx->fixed_size != ctx->total_size)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
     /* Verify that our elimination was not overeager. */
     // assert(bi == 0 || (uint64_t)SSDEEP_BS(bi) / 2 * SPAMSUM_LENGTH < ctx->total_size);
 
@@ -266,7 +586,7 @@ AARU_EXPORT int AARU_CALL spamsum_final(spamsum_ctx *ctx, uint8_t *result)
     {
         // assert(remain > 0);
 
-        *result = b64[ctx->bh[bi].h % 64];
+        *result = b64[BH_H(ctx, bi) % 64];
 
         if(i < 3 || *result != result[-1] || *result != result[-2] || *result != result[-3])
         {
@@ -308,7 +628,7 @@ AARU_EXPORT int AARU_CALL spamsum_final(spamsum_ctx *ctx, uint8_t *result)
         {
             // assert(remain > 0);
 
-            h       = ctx->bh[bi].half_h;
+            h       = BH_HALF_H(ctx, bi);
             *result = b64[h % 64];
 
             if(i < 3 || *result != result[-1] || *result != result[-2] || *result != result[-3])
@@ -341,7 +661,7 @@ AARU_EXPORT int AARU_CALL spamsum_final(spamsum_ctx *ctx, uint8_t *result)
 
         // assert(remain > 0);
 
-        *result++ = b64[ctx->bh[bi].h % 64];
+        *result++ = b64[BH_H(ctx, bi) % 64];
         /* No need to bother with FUZZY_FLAG_ELIMSEQ, because this
          * digest has length 1. */
         --remain;
@@ -351,3 +671,160 @@ AARU_EXPORT int AARU_CALL spamsum_final(spamsum_ctx *ctx, uint8_t *result)
 
     return 0;
 }
+
+/**
+ * @brief Exports the state of a SpamSum context.
+ *
+ * The rolling hash window and the active blockhashes are stored in a versioned and
+ * endian independent format, so it can be passed to spamsum_import_state() to resume
+ * the calculation later, even on a different machine. The size of the state depends
+ * on the number of active blockhashes, up to SPAMSUM_STATE_MAX_SIZE.
+ *
+ * @param ctx Pointer to the SpamSum context structure.
+ * @param buffer Buffer that receives the state, or NULL to query its size.
+ * @param len Size of the buffer.
+ *
+ * @returns Size of the exported state, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL spamsum_export_state(spamsum_ctx *ctx, uint8_t *buffer, uint32_t len)
+{
+    uint8_t *p;
+    uint32_t payload;
+    uint32_t i;
+
+    if(!ctx) return -1;
+
+    payload = SPAMSUM_STATE_FIXED_SIZE + (ctx->bh_end - ctx->bh_start) * SPAMSUM_STATE_BLOCKHASH_SIZE;
+
+    if(!buffer) return (int)(STATE_HEADER_SIZE + payload);
+
+    if(len < STATE_HEADER_SIZE + payload) return -1;
+
+    p = state_put_header(buffer, STATE_ALGORITHM_SPAMSUM, payload);
+    p = state_put_u32(p, ctx->bh_start);
+    p = state_put_u32(p, ctx->bh_end);
+    p = state_put_u64(p, ctx->total_size);
+
+    memcpy(p, ctx->roll.window, ROLLING_WINDOW);
+    p += ROLLING_WINDOW;
+
+    p = state_put_u32(p, ctx->roll.h1);
+    p = state_put_u32(p, ctx->roll.h2);
+    p = state_put_u32(p, ctx->roll.h3);
+    p = state_put_u32(p, ctx->roll.n);
+    p = state_put_u32(p, ctx->flags);
+    p = state_put_u32(p, ctx->bh_end_limit);
+    p = state_put_u64(p, ctx->fixed_size);
+
+    for(i = ctx->bh_start; i < ctx->bh_end; i++)
+    {
+        p = state_put_u32(p, BH_H(ctx, i));
+        p = state_put_u32(p, BH_HALF_H(ctx, i));
+        p = state_put_u32(p, ctx->bh[i].d_len);
+        p = state_put_u8(p, ctx->bh[i].half_digest);
+
+        memcpy(p, ctx->bh[i].digest, SPAMSUM_LENGTH);
+        p += SPAMSUM_LENGTH;
+    }
+
+    return (int)(STATE_HEADER_SIZE + payload);
+}
+
+/**
+ * @brief Creates a SpamSum context from a state exported by spamsum_export_state().
+ *
+ * @param buffer Buffer containing the exported state.
+ * @param len Size of the buffer.
+ *
+ * @return Pointer to a structure containing the checksum state, or NULL if the
+ * state is not valid.
+ */
+AARU_EXPORT spamsum_ctx *AARU_CALL spamsum_import_state(const uint8_t *buffer, uint32_t len)
+{
+    spamsum_ctx   *ctx;
+    uint32_t       payload;
+    uint32_t       bh_start;
+    uint32_t       bh_end;
+    uint32_t       i;
+    const uint8_t *p = state_get_header(buffer, len, STATE_ALGORITHM_SPAMSUM, &payload);
+
+    if(!p || payload < SPAMSUM_STATE_FIXED_SIZE) return NULL;
+
+    p = state_get_u32(p, &bh_start);
+    p = state_get_u32(p, &bh_end);
+
+    if(bh_start >= bh_end || bh_end > NUM_BLOCKHASHES) return NULL;
+
+    if(payload != SPAMSUM_STATE_FIXED_SIZE + (bh_end - bh_start) * SPAMSUM_STATE_BLOCKHASH_SIZE) return NULL;
+
+    ctx = spamsum_init();
+
+    if(!ctx) return NULL;
+
+    ctx->bh_start = bh_start;
+    ctx->bh_end   = bh_end;
+
+    p = state_get_u64(p, &ctx->total_size);
+
+    memcpy(ctx->roll.window, p, ROLLING_WINDOW);
+    p += ROLLING_WINDOW;
+
+    p = state_get_u32(p, &ctx->roll.h1);
+    p = state_get_u32(p, &ctx->roll.h2);
+    p = state_get_u32(p, &ctx->roll.h3);
+    p = state_get_u32(p, &ctx->roll.n);
+    p = state_get_u32(p, &ctx->flags);
+    p = state_get_u32(p, &ctx->bh_end_limit);
+    p = state_get_u64(p, &ctx->fixed_size);
+
+    if(ctx->bh_end_limit > NUM_BLOCKHASHES || ctx->bh_end > ctx->bh_end_limit)
+    {
+        spamsum_free(ctx);
+        return NULL;
+    }
+
+    for(i = bh_start; i < bh_end; i++)
+    {
+        p = state_get_u32(p, &BH_H(ctx, i));
+        p = state_get_u32(p, &BH_HALF_H(ctx, i));
+        p = state_get_u32(p, &ctx->bh[i].d_len);
+        p = state_get_u8(p, &ctx->bh[i].half_digest);
+
+        memcpy(ctx->bh[i].digest, p, SPAMSUM_LENGTH);
+        p += SPAMSUM_LENGTH;
+
+        if(ctx->bh[i].d_len >= SPAMSUM_LENGTH)
+        {
+            spamsum_free(ctx);
+            return NULL;
+        }
+    }
+
+    return ctx;
+}
+
+/**
+ * @brief Creates a copy of a SpamSum context.
+ *
+ * The copy continues from the same point as the original, and both can be updated
+ * and finalized independently, allowing to calculate a common prefix only once or to
+ * take intermediate checksums without disturbing the original.
+ *
+ * @param ctx Pointer to the SpamSum context structure.
+ *
+ * @return Pointer to a structure containing the copied checksum state, or NULL on error.
+ */
+AARU_EXPORT spamsum_ctx *AARU_CALL spamsum_clone(const spamsum_ctx *ctx)
+{
+    spamsum_ctx *clone;
+
+    if(!ctx) return NULL;
+
+    clone = (spamsum_ctx *)malloc(sizeof(spamsum_ctx));
+
+    if(!clone) return NULL;
+
+    memcpy(clone, ctx, sizeof(spamsum_ctx));
+
+    return clone;
+}
@@ -27,10 +27,39 @@
 #define MIN_BLOCKSIZE    3
 #define FUZZY_MAX_RESULT ((2 * SPAMSUM_LENGTH) + 20)
 
+/* The total size was given in advance, see spamsum_init_sized() */
+#define SPAMSUM_SIZE_FIXED 1
+
+/* Largest chunk fed to the 32-bit update function at once */
+#define SPAMSUM_MAX_CHUNK (1 << 30)
+
+/* Input scanned at once for trigger points before hashing it, a multiple of 64 */
+#define SPAMSUM_PRESCAN_BLOCK 4096
+
+/* Largest packed digest: block size exponent, part lengths and two parts of 6-bit symbols, see spamsum_pack() */
+#define SPAMSUM_PACKED_MAX_SIZE (3 + 2 * (SPAMSUM_LENGTH * 6 / 8))
+
+/* Size of an exported state with all blockhashes active, see spamsum_export_state() */
+#define SPAMSUM_STATE_MAX_SIZE (12 + 55 + (NUM_BLOCKHASHES * 77))
+
+#define ROLL_SUM(ctx)    ((ctx)->roll.h1 + (ctx)->roll.h2 + (ctx)->roll.h3)
+#define SUM_HASH(c, h)   (((h) * HASH_PRIME) ^ (c));
+#define SSDEEP_BS(index) (MIN_BLOCKSIZE << (index))
+
+static const uint8_t b64[] = {0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F,
+                              0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x61, 0x62, 0x63, 0x64,
+                              0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F, 0x70, 0x71, 0x72, 0x73,
+                              0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+                              0x38, 0x39, 0x2B, 0x2F};
+
+/* The hashes of each blockhash are kept apart from the rest of its state, interleaved in one
+ * array so the hashes of all active blockhashes can be updated at once */
+#define SPAMSUM_HASHES    (2 * (NUM_BLOCKHASHES + 1))
+#define BH_H(ctx, i)      ((ctx)->hashes[2 * (i)])
+#define BH_HALF_H(ctx, i) ((ctx)->hashes[2 * (i) + 1])
+
 typedef struct
 {
-    uint32_t h;
-    uint32_t half_h;
     uint8_t  digest[SPAMSUM_LENGTH];
     uint8_t  half_digest;
     uint32_t d_len;
@@ -47,20 +76,89 @@ typedef struct
 
 typedef struct
 {
+    uint32_t      hashes[SPAMSUM_HASHES];
     uint32_t      bh_start;
     uint32_t      bh_end;
     blockhash_ctx bh[NUM_BLOCKHASHES];
     uint64_t      total_size;
     roll_state    roll;
+    uint32_t      flags;
+    uint32_t      bh_end_limit;
+    uint64_t      fixed_size;
 } spamsum_ctx;
 
+/* A digest split in its parts, to compare it without parsing it again */
+typedef struct
+{
+    uint64_t block_size;
+    uint32_t len1;
+    uint32_t len2;
+    uint8_t  part1[SPAMSUM_LENGTH];
+    uint8_t  part2[SPAMSUM_LENGTH];
+} spamsum_digest;
+
+/* Two similar digests found by spamsum_cluster(), by their position in the digest array */
+typedef struct
+{
+    uint32_t first;
+    uint32_t second;
+    uint32_t score;
+} spamsum_edge;
+
 AARU_EXPORT spamsum_ctx *AARU_CALL spamsum_init(void);
+AARU_EXPORT spamsum_ctx *AARU_CALL spamsum_init_sized(uint64_t total_size);
 AARU_EXPORT int AARU_CALL          spamsum_update(spamsum_ctx *ctx, const uint8_t *data, uint32_t len);
+AARU_EXPORT int AARU_CALL          spamsum_update64(spamsum_ctx *ctx, const uint8_t *data, uint64_t len);
+AARU_EXPORT int AARU_CALL          spamsum_update_parallel(spamsum_ctx *ctx, const uint8_t *data, uint64_t len,
+                                                           uint32_t threads);
 AARU_EXPORT int AARU_CALL          spamsum_final(spamsum_ctx *ctx, uint8_t *result);
+AARU_EXPORT int AARU_CALL          spamsum_export_state(spamsum_ctx *ctx, uint8_t *buffer, uint32_t len);
+AARU_EXPORT spamsum_ctx *AARU_CALL spamsum_import_state(const uint8_t *buffer, uint32_t len);
+AARU_EXPORT spamsum_ctx *AARU_CALL spamsum_clone(const spamsum_ctx *ctx);
+AARU_EXPORT int AARU_CALL          spamsum_compare(const uint8_t *digest1, const uint8_t *digest2);
+AARU_EXPORT int AARU_CALL          spamsum_cluster(const uint8_t *const *digests, uint32_t count, int min_score,
+                                                   uint32_t threads, spamsum_edge **edges, uint64_t *edge_count);
+AARU_EXPORT void AARU_CALL         spamsum_cluster_free(spamsum_edge *edges);
+AARU_EXPORT int AARU_CALL          spamsum_pack(const uint8_t *digest, uint8_t *packed);
+AARU_EXPORT int AARU_CALL          spamsum_unpack(const uint8_t *packed, uint32_t len, uint8_t *digest);
+AARU_EXPORT int AARU_CALL          spamsum_compare_packed(const uint8_t *packed1, uint32_t len1, const uint8_t *packed2,
+                                                          uint32_t len2);
+AARU_EXPORT int AARU_CALL          spamsum_packed_grams(const uint8_t *packed, uint32_t len, uint32_t part,
+                                                        uint64_t *grams);
+
+AARU_LOCAL void     spamsum_engine(spamsum_ctx *ctx, const uint8_t *data, uint32_t len);
+AARU_LOCAL int      spamsum_compare_copy(const uint8_t **in, uint8_t end, uint8_t *out);
+AARU_LOCAL int      spamsum_compare_parse(const uint8_t *digest, spamsum_digest *parsed);
+AARU_LOCAL uint32_t spamsum_compare_digests(const spamsum_digest *d1, const spamsum_digest *d2);
 AARU_EXPORT void AARU_CALL         spamsum_free(spamsum_ctx *ctx);
+AARU_EXPORT void AARU_CALL         spamsum_prescan(const uint8_t *data, uint32_t len, uint32_t bias, uint32_t level,
+                                                   uint64_t *bitmap);
+AARU_EXPORT void AARU_CALL         spamsum_fnv(uint32_t *hashes, uint32_t first, uint32_t last, const uint8_t *data,
+                                               uint32_t len);
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL spamsum_prescan_avx2(const uint8_t *data, uint32_t len, uint32_t bias,
+                                                                 uint32_t level, uint64_t *bitmap);
+AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL spamsum_fnv_avx2(uint32_t *hashes, uint32_t first, uint32_t last,
+                                                             const uint8_t *data, uint32_t len);
+
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+
+AARU_EXPORT void AARU_CALL spamsum_prescan_neon(const uint8_t *data, uint32_t len, uint32_t bias, uint32_t level,
+                                                uint64_t *bitmap);
+AARU_EXPORT void AARU_CALL spamsum_fnv_neon(uint32_t *hashes, uint32_t first, uint32_t last, const uint8_t *data,
+                                            uint32_t len);
+
+#endif
 
 FORCE_INLINE void fuzzy_engine_step(spamsum_ctx *ctx, uint8_t c);
 
+FORCE_INLINE void fuzzy_engine_trigger(spamsum_ctx *ctx, uint64_t h);
+
 FORCE_INLINE void roll_hash(spamsum_ctx *ctx, uint8_t c);
 
 FORCE_INLINE void fuzzy_try_reduce_blockhash(spamsum_ctx *ctx);
@@ -0,0 +1,176 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "library.h"
+#include "spamsum.h"
+#include "simd.h"
+
+/**
+ * @brief Computes the rolling hash of 8 consecutive positions and tests them for triggers.
+ *
+ * @param data Pointer to the first of the 8 positions, the 6 bytes before it must be readable.
+ * @param bias Value added to every rolling hash.
+ * @param mask Lowest bits of h + 1 that must be zero.
+ * @param level Number of lowest bits of h + 1 that are skipped before testing the multiple of 3.
+ *
+ * @return Bitmap of the positions that trigger.
+ */
+TARGET_WITH_AVX2 static inline uint32_t spamsum_prescan_avx2_8(const uint8_t *data, __m256i bias, __m256i mask,
+                                                               __m128i level)
+{
+    const __m256i one     = _mm256_set1_epi32(1);
+    const __m256i inverse = _mm256_set1_epi32((int)0xAAAAAAAB);
+    const __m256i third   = _mm256_set1_epi32(0x55555555);
+    __m256i       sum     = _mm256_setzero_si256();
+    __m256i       weight  = _mm256_setzero_si256();
+    __m256i       h3      = _mm256_setzero_si256();
+    __m256i       x, h, q, ok;
+
+    /* Walk the window from the newest byte to the oldest one, so that accumulating the
+     * running sum into weight multiplies each byte by ROLLING_WINDOW minus its age. */
+#define SPAMSUM_AVX2_BYTE(age)                                                                                         \
+    x      = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(data - (age))));                                  \
+    sum    = _mm256_add_epi32(sum, x);                                                                                 \
+    weight = _mm256_add_epi32(weight, sum);                                                                            \
+    h3     = _mm256_xor_si256(h3, _mm256_slli_epi32(x, 5 * (age)))
+
+    SPAMSUM_AVX2_BYTE(0);
+    SPAMSUM_AVX2_BYTE(1);
+    SPAMSUM_AVX2_BYTE(2);
+    SPAMSUM_AVX2_BYTE(3);
+    SPAMSUM_AVX2_BYTE(4);
+    SPAMSUM_AVX2_BYTE(5);
+    SPAMSUM_AVX2_BYTE(6);
+
+#undef SPAMSUM_AVX2_BYTE
+
+    /* h1 is the plain sum and h2 the weighted one */
+    h = _mm256_add_epi32(_mm256_add_epi32(weight, sum), _mm256_add_epi32(h3, bias));
+    h = _mm256_add_epi32(h, one);
+
+    /* h + 1 must be a multiple of 3 << level, and must not have overflowed */
+    q  = _mm256_mullo_epi32(_mm256_srl_epi32(h, level), inverse);
+    ok = _mm256_cmpeq_epi32(_mm256_max_epu32(q, third), third);
+    ok = _mm256_and_si256(ok, _mm256_cmpeq_epi32(_mm256_and_si256(h, mask), _mm256_setzero_si256()));
+    ok = _mm256_andnot_si256(_mm256_cmpeq_epi32(h, _mm256_setzero_si256()), ok);
+
+    return (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(ok));
+}
+
+/**
+ * @brief Searches for the positions where the SpamSum rolling hash triggers a blockhash, using AVX2 instructions.
+ *
+ * The rolling hash only depends on the last ROLLING_WINDOW bytes, so it is computed for 8
+ * positions at once, directly from the input.
+ *
+ * @param data Pointer to the first position to test, the 6 bytes before it must be readable.
+ * @param len Number of positions to test, a multiple of 64.
+ * @param bias Value added to every rolling hash, to match the state of a context.
+ * @param level Blockhash that must be triggered.
+ * @param bitmap Receives one bit per position, set when it triggers the blockhash.
+ */
+AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL spamsum_prescan_avx2(const uint8_t *data, uint32_t len, uint32_t bias,
+                                                                 uint32_t level, uint64_t *bitmap)
+{
+    const __m256i vbias  = _mm256_set1_epi32((int)bias);
+    const __m256i vmask  = _mm256_set1_epi32((int)((1u << level) - 1));
+    const __m128i vlevel = _mm_cvtsi32_si128((int)level);
+    uint32_t      i;
+
+    for(i = 0; i < len; i += 64)
+    {
+        uint64_t lo = spamsum_prescan_avx2_8(data + i, vbias, vmask, vlevel) |
+                      spamsum_prescan_avx2_8(data + i + 8, vbias, vmask, vlevel) << 8 |
+                      spamsum_prescan_avx2_8(data + i + 16, vbias, vmask, vlevel) << 16 |
+                      spamsum_prescan_avx2_8(data + i + 24, vbias, vmask, vlevel) << 24;
+        uint64_t hi = spamsum_prescan_avx2_8(data + i + 32, vbias, vmask, vlevel) |
+                      spamsum_prescan_avx2_8(data + i + 40, vbias, vmask, vlevel) << 8 |
+                      spamsum_prescan_avx2_8(data + i + 48, vbias, vmask, vlevel) << 16 |
+                      spamsum_prescan_avx2_8(data + i + 56, vbias, vmask, vlevel) << 24;
+
+        *bitmap++ = lo | hi << 32;
+    }
+}
+
+
+/**
+ * @brief Advances blockhash hashes over a run of bytes, using AVX2 instructions.
+ *
+ * Up to 32 hashes, 4 vectors, are kept in registers and updated with a single multiplication
+ * each per byte. Only the hashes in the range are stored back.
+ *
+ * @param hashes Interleaved blockhash hashes, with SPAMSUM_HASHES entries.
+ * @param first First hash to update.
+ * @param last One past the last hash to update.
+ * @param data Pointer to the run of bytes.
+ * @param len Length of the run.
+ */
+AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL spamsum_fnv_avx2(uint32_t *hashes, uint32_t first, uint32_t last,
+                                                             const uint8_t *data, uint32_t len)
+{
+    const __m256i prime = _mm256_set1_epi32(HASH_PRIME);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    while(first < last)
+    {
+        /* Move the group back when needed, so the 4 vectors stay inside the array */
+        uint32_t  group = first / 8 > SPAMSUM_HASHES / 8 - 4 ? SPAMSUM_HASHES - 32 : first / 8 * 8;
+        uint32_t  end   = last < group + 32 ? last : group + 32;
+        uint32_t *p     = hashes + group;
+        __m256i   v0    = _mm256_loadu_si256((const __m256i *)p);
+        __m256i   v1    = _mm256_loadu_si256((const __m256i *)(p + 8));
+        __m256i   v2    = _mm256_loadu_si256((const __m256i *)(p + 16));
+        __m256i   v3    = _mm256_loadu_si256((const __m256i *)(p + 24));
+        __m256i   lo    = _mm256_set1_epi32((int)first);
+        __m256i   hi    = _mm256_set1_epi32((int)end);
+        __m256i   c, index;
+        uint32_t  j;
+
+        for(j = 0; j < len; j++)
+        {
+            c  = _mm256_set1_epi32(data[j]);
+            v0 = _mm256_xor_si256(_mm256_mullo_epi32(v0, prime), c);
+            v1 = _mm256_xor_si256(_mm256_mullo_epi32(v1, prime), c);
+            v2 = _mm256_xor_si256(_mm256_mullo_epi32(v2, prime), c);
+            v3 = _mm256_xor_si256(_mm256_mullo_epi32(v3, prime), c);
+        }
+
+        /* Store the hashes that are in range, first <= index < end */
+#define SPAMSUM_AVX2_STORE(v, offset)                                                                                  \
+    index = _mm256_add_epi32(lanes, _mm256_set1_epi32((int)(group + (offset))));                                       \
+    _mm256_maskstore_epi32((int *)(p + (offset)),                                                                      \
+                           _mm256_andnot_si256(_mm256_cmpgt_epi32(lo, index), _mm256_cmpgt_epi32(hi, index)), v)
+
+        SPAMSUM_AVX2_STORE(v0, 0);
+        SPAMSUM_AVX2_STORE(v1, 8);
+        SPAMSUM_AVX2_STORE(v2, 16);
+        SPAMSUM_AVX2_STORE(v3, 24);
+
+#undef SPAMSUM_AVX2_STORE
+
+        first = end;
+    }
+}
+
+#endif
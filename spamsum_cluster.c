@@ -0,0 +1,494 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * All-pairs SpamSum comparison.
+ *
+ * Digests are parsed once into a packed array, and grouped by block size. Only digests with
+ * the same block size, or double it, can be similar, and only when they share a substring of
+ * ROLLING_WINDOW characters in the parts of the same block size. So each group is compared
+ * against itself, looking up the substrings of both parts, and against the group with double
+ * its block size, looking up the substrings of the second part in the first part of the other
+ * group. Lookups go through a sorted list of the substrings of the group, built for each pass,
+ * and the compares of each pass are split between several threads.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "library.h"
+#include "spamsum.h"
+#include "parallel.h"
+
+/* Digests looked up by each job of a pass */
+#define SPAMSUM_CLUSTER_JOB 256
+
+/* Most keys a digest can have: the whole digest, and each substring of ROLLING_WINDOW characters of each part */
+#define SPAMSUM_CLUSTER_MAX_KEYS (1 + 2 * (SPAMSUM_LENGTH - ROLLING_WINDOW + 1))
+
+/* Keys used by a digest in a pass */
+#define SPAMSUM_CLUSTER_BOTH   0
+#define SPAMSUM_CLUSTER_FIRST  1
+#define SPAMSUM_CLUSTER_SECOND 2
+
+typedef struct
+{
+    uint32_t key;
+    uint32_t entry;
+} cluster_posting;
+
+typedef struct
+{
+    uint64_t block_size;
+    uint32_t entry;
+} cluster_order;
+
+typedef struct
+{
+    const spamsum_digest  *digests;
+    const cluster_order   *sources;
+    const cluster_posting *postings;
+    uint32_t               posting_count;
+    const uint32_t        *directory;
+    uint32_t               shift;
+    int                    keys;
+    int                    same;
+    uint32_t               min_score;
+} cluster_pass;
+
+typedef struct
+{
+    const cluster_pass *pass;
+    uint32_t            first;
+    uint32_t            last;
+    uint32_t           *candidates;
+    uint32_t            candidate_capacity;
+    spamsum_edge       *edges;
+    uint32_t            count;
+    uint32_t            capacity;
+    int                 failed;
+} cluster_job;
+
+/**
+ * @brief Gets the keys of a digest.
+ *
+ * Keys are hashes of a substring and the part it comes from, so different substrings can
+ * share a key, and a digest can repeat a key, which only adds candidates that are scored once
+ * anyway.
+ *
+ * @param d Digest.
+ * @param which Parts to get the keys of, SPAMSUM_CLUSTER_BOTH also adds the whole digest.
+ * @param keys Receives the keys, with room for SPAMSUM_CLUSTER_MAX_KEYS.
+ *
+ * @return Number of keys.
+ */
+static uint32_t cluster_keys(const spamsum_digest *d, int which, uint32_t *keys)
+{
+    const uint8_t *part;
+    uint32_t       len, hash, n = 0, p, i, j;
+
+    /* Identical digests score 100 even when their parts are too short to share a substring */
+    if(which == SPAMSUM_CLUSTER_BOTH)
+    {
+        hash = 0x811C9DC5;
+
+        for(i = 0; i < d->len1; i++) hash = (hash ^ d->part1[i]) * 0x01000193;
+
+        hash = (hash ^ ':') * 0x01000193;
+
+        for(i = 0; i < d->len2; i++) hash = (hash ^ d->part2[i]) * 0x01000193;
+
+        keys[n++] = hash;
+    }
+
+    for(p = 1; p <= 2; p++)
+    {
+        if(which != SPAMSUM_CLUSTER_BOTH && which != (int)p) continue;
+
+        part = p == 1 ? d->part1 : d->part2;
+        len  = p == 1 ? d->len1 : d->len2;
+
+        for(i = 0; i + ROLLING_WINDOW <= len; i++)
+        {
+            /* Substrings of the other group in a pass between groups always come from their first part */
+            hash = 0x811C9DC5 ^ (which == SPAMSUM_CLUSTER_BOTH ? p : 0);
+
+            for(j = 0; j < ROLLING_WINDOW; j++) hash = (hash ^ part[i + j]) * 0x01000193;
+
+            keys[n++] = hash;
+        }
+    }
+
+    return n;
+}
+
+static int cluster_order_compare(const void *a, const void *b)
+{
+    const cluster_order *oa = (const cluster_order *)a;
+    const cluster_order *ob = (const cluster_order *)b;
+
+    if(oa->block_size != ob->block_size) return oa->block_size < ob->block_size ? -1 : 1;
+
+    return oa->entry < ob->entry ? -1 : oa->entry > ob->entry;
+}
+
+static int cluster_entry_compare(const void *a, const void *b)
+{
+    uint32_t ea = *(const uint32_t *)a;
+    uint32_t eb = *(const uint32_t *)b;
+
+    return ea < eb ? -1 : ea > eb;
+}
+
+static int cluster_edge_compare(const void *a, const void *b)
+{
+    const spamsum_edge *ea = (const spamsum_edge *)a;
+    const spamsum_edge *eb = (const spamsum_edge *)b;
+
+    if(ea->first != eb->first) return ea->first < eb->first ? -1 : 1;
+
+    return ea->second < eb->second ? -1 : ea->second > eb->second;
+}
+
+/**
+ * @brief Scores a range of digests of a pass against the candidates that share a key with them.
+ *
+ * @param arg Pointer to the cluster_job describing the range.
+ */
+static void cluster_search(void *arg)
+{
+    cluster_job        *job  = (cluster_job *)arg;
+    const cluster_pass *pass = job->pass;
+    uint32_t            keys[SPAMSUM_CLUSTER_MAX_KEYS];
+    uint32_t            key_count, count, entry, low, high, score, s, k, i;
+
+    for(s = job->first; s < job->last; s++)
+    {
+        entry     = pass->sources[s].entry;
+        key_count = cluster_keys(&pass->digests[entry], pass->keys, keys);
+        count     = 0;
+
+        for(k = 0; k < key_count; k++)
+        {
+            low  = pass->directory[keys[k] >> pass->shift];
+            high = pass->directory[(keys[k] >> pass->shift) + 1];
+
+            for(; low < high; low++)
+            {
+                /* Within a group every pair is found from both sides, keep only one */
+                if(pass->postings[low].key != keys[k] || (pass->same && pass->postings[low].entry <= entry)) continue;
+
+                if(count == job->candidate_capacity)
+                {
+                    uint32_t  capacity   = job->candidate_capacity ? job->candidate_capacity * 2 : 1024;
+                    uint32_t *candidates = (uint32_t *)realloc(job->candidates, capacity * sizeof(uint32_t));
+
+                    if(!candidates)
+                    {
+                        job->failed = 1;
+                        return;
+                    }
+
+                    job->candidates         = candidates;
+                    job->candidate_capacity = capacity;
+                }
+
+                job->candidates[count++] = pass->postings[low].entry;
+            }
+        }
+
+        if(count > 1) qsort(job->candidates, count, sizeof(uint32_t), cluster_entry_compare);
+
+        for(i = 0; i < count; i++)
+        {
+            if(i > 0 && job->candidates[i] == job->candidates[i - 1]) continue;
+
+            score = spamsum_compare_digests(&pass->digests[entry], &pass->digests[job->candidates[i]]);
+
+            if(score < pass->min_score) continue;
+
+            if(job->count == job->capacity)
+            {
+                uint32_t      capacity = job->capacity ? job->capacity * 2 : 1024;
+                spamsum_edge *edges    = (spamsum_edge *)realloc(job->edges, capacity * sizeof(spamsum_edge));
+
+                if(!edges)
+                {
+                    job->failed = 1;
+                    return;
+                }
+
+                job->edges    = edges;
+                job->capacity = capacity;
+            }
+
+            job->edges[job->count].first  = entry < job->candidates[i] ? entry : job->candidates[i];
+            job->edges[job->count].second = entry < job->candidates[i] ? job->candidates[i] : entry;
+            job->edges[job->count].score  = score;
+            job->count++;
+        }
+    }
+}
+
+/**
+ * @brief Runs a pass, comparing a group of digests against the postings of a group.
+ *
+ * @param pass Pass to run, its postings are built from the target group.
+ * @param sources Number of digests in pass->sources.
+ * @param targets Digests of the target group.
+ * @param target_count Number of digests in the target group.
+ * @param target_keys Keys of the target group to build the postings from.
+ * @param threads Maximum number of threads to use.
+ * @param edges Pointer to the found edges, grown with the ones found in this pass.
+ * @param edge_count Pointer to the number of found edges.
+ *
+ * @return 0 on success, -1 if there is not enough memory.
+ */
+static int cluster_run(cluster_pass *pass, uint32_t sources, const cluster_order *targets, uint32_t target_count,
+                       int target_keys, uint32_t threads, spamsum_edge **edges, uint64_t *edge_count)
+{
+    cluster_posting *postings;
+    uint32_t        *directory;
+    cluster_job     *jobs;
+    spamsum_edge    *grown;
+    uint32_t         keys[SPAMSUM_CLUSTER_MAX_KEYS];
+    uint64_t         posting_count = 0, found = 0;
+    uint32_t         job_count, key_count, position, bits, i, k;
+    int              failed = 0;
+
+    for(i = 0; i < target_count; i++)
+        posting_count += cluster_keys(&pass->digests[targets[i].entry], target_keys, keys);
+
+    if(posting_count >= UINT32_MAX || posting_count > SIZE_MAX / sizeof(cluster_posting)) return -1;
+
+    /* Keys are hashes, so their highest bits spread the postings evenly over the directory */
+    bits = 1;
+
+    while(bits < 31 && (1ULL << bits) < posting_count) bits++;
+
+    postings  = (cluster_posting *)malloc((size_t)posting_count * sizeof(cluster_posting) + 1);
+    directory = (uint32_t *)calloc(((size_t)1 << bits) + 1, sizeof(uint32_t));
+
+    if(!postings || !directory)
+    {
+        free(postings);
+        free(directory);
+        return -1;
+    }
+
+    pass->postings      = postings;
+    pass->posting_count = (uint32_t)posting_count;
+    pass->directory     = directory;
+    pass->shift         = 32 - bits;
+
+    /* Counting sort of the postings by the highest bits of their keys, so each directory entry
+     * tells where its postings start */
+    for(i = 0; i < target_count; i++)
+    {
+        key_count = cluster_keys(&pass->digests[targets[i].entry], target_keys, keys);
+
+        for(k = 0; k < key_count; k++) directory[(keys[k] >> pass->shift) + 1]++;
+    }
+
+    for(i = 1; i <= 1U << bits; i++) directory[i] += directory[i - 1];
+
+    for(i = 0; i < target_count; i++)
+    {
+        key_count = cluster_keys(&pass->digests[targets[i].entry], target_keys, keys);
+
+        for(k = 0; k < key_count; k++)
+        {
+            position                 = directory[keys[k] >> pass->shift]++;
+            postings[position].key   = keys[k];
+            postings[position].entry = targets[i].entry;
+        }
+    }
+
+    /* Filling moved every entry to where the next one starts */
+    for(i = 1U << bits; i > 0; i--) directory[i] = directory[i - 1];
+
+    directory[0] = 0;
+
+    job_count = (sources + SPAMSUM_CLUSTER_JOB - 1) / SPAMSUM_CLUSTER_JOB;
+    jobs      = (cluster_job *)calloc(job_count, sizeof(cluster_job));
+
+    if(!jobs)
+    {
+        free(directory);
+        free(postings);
+        return -1;
+    }
+
+    for(i = 0; i < job_count; i++)
+    {
+        jobs[i].pass  = pass;
+        jobs[i].first = i * SPAMSUM_CLUSTER_JOB;
+        jobs[i].last  = i == job_count - 1 ? sources : (i + 1) * SPAMSUM_CLUSTER_JOB;
+    }
+
+    parallel_run(cluster_search, jobs, sizeof(cluster_job), job_count, threads);
+
+    for(i = 0; i < job_count; i++)
+    {
+        failed |= jobs[i].failed;
+        found += jobs[i].count;
+    }
+
+    if(!failed && found > 0)
+    {
+        if(*edge_count + found > SIZE_MAX / sizeof(spamsum_edge)) failed = 1;
+
+        grown = failed ? NULL : (spamsum_edge *)realloc(*edges, (size_t)(*edge_count + found) * sizeof(spamsum_edge));
+
+        if(!grown)
+            failed = 1;
+        else
+        {
+            *edges = grown;
+
+            for(i = 0; i < job_count; i++)
+            {
+                memcpy(*edges + *edge_count, jobs[i].edges, jobs[i].count * sizeof(spamsum_edge));
+                *edge_count += jobs[i].count;
+            }
+        }
+    }
+
+    for(i = 0; i < job_count; i++)
+    {
+        free(jobs[i].candidates);
+        free(jobs[i].edges);
+    }
+
+    free(jobs);
+    free(directory);
+    free(postings);
+
+    return failed ? -1 : 0;
+}
+
+/**
+ * @brief Finds the pairs of similar digests in a set of SpamSum digests.
+ *
+ * Every pair of digests that spamsum_compare() scores at least min_score is returned as an
+ * edge, without comparing every pair. The work is split between several threads.
+ *
+ * @param digests Array of digests, as produced by spamsum_final().
+ * @param count Number of digests.
+ * @param min_score Lowest score of the returned edges, at least 1.
+ * @param threads Maximum number of threads to use, or 0 to use one per processor.
+ * @param edges Receives an array with the edges, sorted by their first and second digest, that
+ *              must be freed with spamsum_cluster_free(), or NULL if there are none.
+ * @param edge_count Receives the number of edges.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL spamsum_cluster(const uint8_t *const *digests, uint32_t count, int min_score,
+                                          uint32_t threads, spamsum_edge **edges, uint64_t *edge_count)
+{
+    spamsum_digest *parsed;
+    cluster_order  *order;
+    cluster_pass    pass;
+    uint32_t        start, end, next, i;
+    int             error = 0;
+
+    if((!digests && count) || !edges || !edge_count) return -1;
+
+    *edges      = NULL;
+    *edge_count = 0;
+
+    if(!threads) threads = parallel_cpu_count();
+
+    parsed = (spamsum_digest *)malloc((size_t)count * sizeof(spamsum_digest) + 1);
+    order  = (cluster_order *)malloc((size_t)count * sizeof(cluster_order) + 1);
+
+    if(!parsed || !order)
+    {
+        free(parsed);
+        free(order);
+        return -1;
+    }
+
+    for(i = 0; i < count && !error; i++)
+    {
+        error = !digests[i] || spamsum_compare_parse(digests[i], &parsed[i]);
+
+        order[i].block_size = parsed[i].block_size;
+        order[i].entry      = i;
+    }
+
+    qsort(order, count, sizeof(cluster_order), cluster_order_compare);
+
+    memset(&pass, 0, sizeof(cluster_pass));
+    pass.digests   = parsed;
+    pass.min_score = min_score < 1 ? 1 : (uint32_t)min_score;
+
+    for(start = 0; start < count && !error; start = end)
+    {
+        end = start + 1;
+
+        while(end < count && order[end].block_size == order[start].block_size) end++;
+
+        /* Digests with the same block size */
+        pass.sources = order + start;
+        pass.keys    = SPAMSUM_CLUSTER_BOTH;
+        pass.same    = 1;
+
+        error = cluster_run(&pass, end - start, order + start, end - start, SPAMSUM_CLUSTER_BOTH, threads, edges,
+                            edge_count);
+
+        if(error || end == count || order[start].block_size > UINT64_MAX / 2 ||
+           order[end].block_size != order[start].block_size * 2)
+            continue;
+
+        /* Digests with double the block size, their first part against the second part of this group */
+        next = end + 1;
+
+        while(next < count && order[next].block_size == order[end].block_size) next++;
+
+        pass.keys = SPAMSUM_CLUSTER_SECOND;
+        pass.same = 0;
+
+        error = cluster_run(&pass, end - start, order + end, next - end, SPAMSUM_CLUSTER_FIRST, threads, edges,
+                            edge_count);
+    }
+
+    free(order);
+    free(parsed);
+
+    if(error)
+    {
+        free(*edges);
+        *edges      = NULL;
+        *edge_count = 0;
+
+        return -1;
+    }
+
+    if(*edge_count) qsort(*edges, (size_t)*edge_count, sizeof(spamsum_edge), cluster_edge_compare);
+
+    return 0;
+}
+
+/**
+ * @brief Frees the edges returned by spamsum_cluster().
+ *
+ * @param edges Array of edges.
+ */
+AARU_EXPORT void AARU_CALL spamsum_cluster_free(spamsum_edge *edges) { free(edges); }
@@ -0,0 +1,250 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * SpamSum digest comparison, giving the same scores as ssdeep.
+ *
+ * The edit distance used by ssdeep weighs insertions and deletions as 1 and replacements
+ * as 2, so it is the length of both strings minus twice their longest common subsequence.
+ * As digest parts are at most SPAMSUM_LENGTH characters long, the longest common
+ * subsequence is computed with the bit-parallel algorithm by Hyyrö, over a single 64-bit
+ * word, and the same character match masks are used to search for common substrings.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "library.h"
+#include "spamsum.h"
+
+/* Characters repeated more than this in a row are ignored when comparing */
+#define SPAMSUM_COMPARE_MAX_SEQUENCE 3
+
+/* Number of bits set in a 64-bit value */
+FORCE_INLINE uint32_t spamsum_popcount(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (uint32_t)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/**
+ * @brief Copies a part of a digest, dropping characters repeated more than SPAMSUM_COMPARE_MAX_SEQUENCE times in a row.
+ *
+ * Long sequences of the same character carry very little information, and would make
+ * unrelated digests look similar.
+ *
+ * @param in Pointer to the part, advanced to the character that ends it.
+ * @param end Character that ends the part, besides the end of the string.
+ * @param out Receives the part, with room for SPAMSUM_LENGTH characters.
+ *
+ * @return Length of the copied part, or -1 if it is longer than SPAMSUM_LENGTH characters.
+ */
+AARU_LOCAL int spamsum_compare_copy(const uint8_t **in, uint8_t end, uint8_t *out)
+{
+    const uint8_t *p        = *in;
+    uint8_t        previous = 0;
+    int            sequence = 0;
+    int            len      = 0;
+
+    for(; *p && *p != end; p++)
+    {
+        if(*p != previous)
+        {
+            previous = *p;
+            sequence = 0;
+        }
+        else if(++sequence >= SPAMSUM_COMPARE_MAX_SEQUENCE)
+            continue;
+
+        if(len == SPAMSUM_LENGTH) return -1;
+
+        out[len++] = *p;
+    }
+
+    *in = p;
+
+    return len;
+}
+
+/**
+ * @brief Scores the similarity of two digest parts of the same block size.
+ *
+ * @param s1 First part.
+ * @param len1 Length of the first part.
+ * @param s2 Second part.
+ * @param len2 Length of the second part.
+ * @param block_size Block size of both parts.
+ *
+ * @return Score from 0, no similarity, to 100, identical.
+ */
+static uint32_t spamsum_compare_parts(const uint8_t *s1, uint32_t len1, const uint8_t *s2, uint32_t len2,
+                                      uint64_t block_size)
+{
+    uint64_t masks[256];
+    uint64_t match[SPAMSUM_LENGTH];
+    uint64_t v = ~0ULL;
+    uint64_t u, common;
+    uint32_t lcs, score, i;
+
+    /* Parts must share a substring of ROLLING_WINDOW characters to be considered related */
+    if(len1 < ROLLING_WINDOW || len2 < ROLLING_WINDOW) return 0;
+
+    for(i = 0; i < len2; i++) masks[s2[i]] = 0;
+    for(i = 0; i < len1; i++) masks[s1[i]] = 0;
+    for(i = 0; i < len1; i++) masks[s1[i]] |= 1ULL << i;
+
+    /* Bit j of match[i] tells if the substrings at s1 + j and s2 + i are the same, growing
+     * the substrings from 1 to 2, 4 and finally ROLLING_WINDOW characters */
+    for(i = 0; i < len2; i++) match[i] = masks[s2[i]];
+    for(i = 0; i + 2 <= len2; i++) match[i] &= match[i + 1] >> 1;
+    for(i = 0; i + 4 <= len2; i++) match[i] &= match[i + 2] >> 2;
+
+    for(common = 0, i = 0; i + ROLLING_WINDOW <= len2; i++) common |= match[i] & match[i + 3] >> 3;
+
+    if(!common) return 0;
+
+    /* Each zero bit in the lowest len1 bits of v is a character of the longest common subsequence */
+    for(i = 0; i < len2; i++)
+    {
+        u = v & masks[s2[i]];
+        v = (v + u) | (v - u);
+    }
+
+    lcs = len1 - spamsum_popcount(len1 == 64 ? v : v & ((1ULL << len1) - 1));
+
+    /* Edit distance scaled to the length of the parts, then to a 0 to 100 range */
+    score = (len1 + len2 - 2 * lcs) * SPAMSUM_LENGTH / (len1 + len2);
+    score = 100 * score / SPAMSUM_LENGTH;
+
+    if(score >= 100) return 0;
+
+    score = 100 - score;
+
+    /* Small block sizes should not exaggerate the match */
+    if(block_size >= (99 + ROLLING_WINDOW) / MIN_BLOCKSIZE * MIN_BLOCKSIZE) return score;
+
+    if(score > block_size / MIN_BLOCKSIZE * (len1 < len2 ? len1 : len2))
+        score = (uint32_t)(block_size / MIN_BLOCKSIZE * (len1 < len2 ? len1 : len2));
+
+    return score;
+}
+
+/**
+ * @brief Parses the block size and both parts of a digest.
+ *
+ * @param digest Digest, as produced by spamsum_final().
+ * @param parsed Receives the block size and both parts, with sequences eliminated.
+ *
+ * @returns 0 on success, -1 if the digest is not valid.
+ */
+AARU_LOCAL int spamsum_compare_parse(const uint8_t *digest, spamsum_digest *parsed)
+{
+    int len;
+
+    parsed->block_size = 0;
+
+    if(*digest < '0' || *digest > '9') return -1;
+
+    for(; *digest >= '0' && *digest <= '9'; digest++)
+    {
+        if(parsed->block_size > (UINT64_MAX - 9) / 10) return -1;
+
+        parsed->block_size = parsed->block_size * 10 + (*digest - '0');
+    }
+
+    if(*digest++ != ':') return -1;
+
+    len = spamsum_compare_copy(&digest, ':', parsed->part1);
+
+    if(len < 0 || *digest++ != ':') return -1;
+
+    parsed->len1 = (uint32_t)len;
+
+    /* ssdeep can append the file name after a comma */
+    len = spamsum_compare_copy(&digest, ',', parsed->part2);
+
+    if(len < 0) return -1;
+
+    parsed->len2 = (uint32_t)len;
+
+    return 0;
+}
+
+/**
+ * @brief Compares two parsed SpamSum digests.
+ *
+ * @param d1 First digest, parsed by spamsum_compare_parse().
+ * @param d2 Second digest, parsed by spamsum_compare_parse().
+ *
+ * @returns Score from 0, no similarity, to 100, identical.
+ */
+AARU_LOCAL uint32_t spamsum_compare_digests(const spamsum_digest *d1, const spamsum_digest *d2)
+{
+    uint32_t score1, score2;
+
+    if(d1->block_size == d2->block_size)
+    {
+        if(d1->len1 == d2->len1 && d1->len2 == d2->len2 && !memcmp(d1->part1, d2->part1, d1->len1) &&
+           !memcmp(d1->part2, d2->part2, d1->len2))
+            return 100;
+
+        score1 = spamsum_compare_parts(d1->part1, d1->len1, d2->part1, d2->len1, d1->block_size);
+
+        /* The second part of both digests has double the block size */
+        if(d1->block_size > UINT64_MAX / 2) return score1;
+
+        score2 = spamsum_compare_parts(d1->part2, d1->len2, d2->part2, d2->len2, d1->block_size * 2);
+
+        return score1 > score2 ? score1 : score2;
+    }
+
+    if(d1->block_size <= UINT64_MAX / 2 && d1->block_size * 2 == d2->block_size)
+        return spamsum_compare_parts(d1->part2, d1->len2, d2->part1, d2->len1, d2->block_size);
+
+    if(d2->block_size <= UINT64_MAX / 2 && d2->block_size * 2 == d1->block_size)
+        return spamsum_compare_parts(d1->part1, d1->len1, d2->part2, d2->len2, d1->block_size);
+
+    return 0;
+}
+
+/**
+ * @brief Compares two SpamSum digests.
+ *
+ * Digests can only be compared when their block sizes are the same or one is double the
+ * other, otherwise they are considered unrelated. The score is the same that ssdeep gives.
+ *
+ * @param digest1 First digest, as produced by spamsum_final().
+ * @param digest2 Second digest, as produced by spamsum_final().
+ *
+ * @returns Score from 0, no similarity, to 100, identical, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL spamsum_compare(const uint8_t *digest1, const uint8_t *digest2)
+{
+    spamsum_digest d1, d2;
+
+    if(!digest1 || !digest2 || spamsum_compare_parse(digest1, &d1) || spamsum_compare_parse(digest2, &d2))
+        return -1;
+
+    return (int)spamsum_compare_digests(&d1, &d2);
+}
@@ -0,0 +1,714 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Index to search SpamSum digests similar to a given one without comparing against all of them.
+ *
+ * Two digest parts only get a non-zero score when they have the same block size and share a
+ * substring of ROLLING_WINDOW characters, so every such substring of each part is a key of the
+ * index, together with the block size of the part. A query looks up the keys of its digest,
+ * which covers both parts of digests with the same block size and the matching part of digests
+ * with half or double the block size, and only scores the entries found.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "library.h"
+#include "spamsum.h"
+#include "spamsum_index.h"
+#include "state.h"
+
+/**
+ * @brief Gets the code of a block size, stored in the highest byte of the keys.
+ *
+ * @param block_size Block size.
+ *
+ * @return Code of the block size, never zero.
+ */
+static uint64_t spamsum_index_block_code(uint64_t block_size)
+{
+    uint32_t i;
+
+    for(i = 0; ((uint64_t)MIN_BLOCKSIZE << i) >> i == MIN_BLOCKSIZE; i++)
+        if(block_size == (uint64_t)MIN_BLOCKSIZE << i) return (uint64_t)(i + 1) << 56;
+
+    /* Block sizes not produced by spamsum_final() share codes, candidates are scored anyway */
+    return (uint64_t)(0x80 | block_size % 127) << 56;
+}
+
+/**
+ * @brief Gets the keys of a digest part, one for each substring of ROLLING_WINDOW characters.
+ *
+ * @param part Digest part, with sequences eliminated.
+ * @param len Length of the part.
+ * @param code Code of the block size of the part.
+ * @param keys Receives the keys.
+ *
+ * @return Number of keys.
+ */
+static uint32_t spamsum_index_part_keys(const uint8_t *part, uint32_t len, uint64_t code, uint64_t *keys)
+{
+    uint64_t gram = 0;
+    uint32_t n    = 0, i;
+
+    for(i = 0; i < len; i++)
+    {
+        gram = (gram << 8 | part[i]) & 0x00FFFFFFFFFFFFFFULL;
+
+        if(i >= ROLLING_WINDOW - 1) keys[n++] = code | gram;
+    }
+
+    return n;
+}
+
+/**
+ * @brief Gets the keys of a digest, sorted and without duplicates.
+ *
+ * @param digest Digest, as produced by spamsum_final().
+ * @param keys Receives the keys, with room for SPAMSUM_INDEX_MAX_KEYS.
+ *
+ * @return Number of keys, or -1 if the digest is not valid.
+ */
+static int spamsum_index_keys(const uint8_t *digest, uint64_t *keys)
+{
+    spamsum_digest d;
+    uint64_t       key, hash = 0xCBF29CE484222325ULL;
+    uint32_t       i, j, n;
+
+    if(spamsum_compare_parse(digest, &d)) return -1;
+
+    /* Identical digests score 100 even when their parts are too short to share a substring,
+     * so the whole digest is a key too, with a zero block size code */
+    for(i = 0; i < 8; i++) hash = (hash ^ (uint8_t)(d.block_size >> (i * 8))) * 0x100000001B3ULL;
+    for(i = 0; i < d.len1; i++) hash = (hash ^ d.part1[i]) * 0x100000001B3ULL;
+    hash = (hash ^ ':') * 0x100000001B3ULL;
+    for(i = 0; i < d.len2; i++) hash = (hash ^ d.part2[i]) * 0x100000001B3ULL;
+
+    keys[0] = hash >> 8;
+    n       = 1;
+    n += spamsum_index_part_keys(d.part1, d.len1, spamsum_index_block_code(d.block_size), keys + n);
+
+    if(d.block_size <= UINT64_MAX / 2)
+        n += spamsum_index_part_keys(d.part2, d.len2, spamsum_index_block_code(d.block_size * 2), keys + n);
+
+    for(i = 1; i < n; i++)
+    {
+        key = keys[i];
+
+        for(j = i; j > 0 && keys[j - 1] > key; j--) keys[j] = keys[j - 1];
+
+        keys[j] = key;
+    }
+
+    for(i = 0, j = 0; i < n; i++)
+        if(j == 0 || keys[j - 1] != keys[i]) keys[j++] = keys[i];
+
+    return (int)j;
+}
+
+static int spamsum_index_posting_compare(const void *a, const void *b)
+{
+    const spamsum_index_posting *pa = (const spamsum_index_posting *)a;
+    const spamsum_index_posting *pb = (const spamsum_index_posting *)b;
+
+    if(pa->key != pb->key) return pa->key < pb->key ? -1 : 1;
+
+    return pa->entry < pb->entry ? -1 : pa->entry > pb->entry;
+}
+
+static int spamsum_index_entry_compare(const void *a, const void *b)
+{
+    uint32_t ea = *(const uint32_t *)a;
+    uint32_t eb = *(const uint32_t *)b;
+
+    return ea < eb ? -1 : ea > eb;
+}
+
+/**
+ * @brief Makes room in a growing array.
+ *
+ * @param array Pointer to the array, updated when it is reallocated.
+ * @param capacity Pointer to the number of elements that fit in the array.
+ * @param needed Number of elements that must fit.
+ * @param size Size of each element.
+ *
+ * @return 0 on success, -1 if there is not enough memory.
+ */
+static int spamsum_index_grow(void **array, uint32_t *capacity, uint32_t needed, size_t size)
+{
+    uint32_t new_capacity = *capacity ? *capacity : 64;
+    void    *new_array;
+
+    if(needed <= *capacity) return 0;
+
+    while(new_capacity < needed) new_capacity = new_capacity > UINT32_MAX / 2 ? UINT32_MAX : new_capacity * 2;
+
+    if(new_capacity > SIZE_MAX / size) return -1;
+
+    new_array = realloc(*array, new_capacity * size);
+
+    if(!new_array) return -1;
+
+    *array    = new_array;
+    *capacity = new_capacity;
+
+    return 0;
+}
+
+/**
+ * @brief Sorts the postings added since the last query or save, merging them with the already sorted ones.
+ *
+ * @param index Index.
+ *
+ * @return 0 on success, -1 if there is not enough memory.
+ */
+static int spamsum_index_sort(spamsum_index *index)
+{
+    spamsum_index_posting *merged;
+    uint32_t               i, j, k;
+
+    if(index->posting_sorted == index->posting_count) return 0;
+
+    qsort(index->postings + index->posting_sorted, index->posting_count - index->posting_sorted,
+          sizeof(spamsum_index_posting), spamsum_index_posting_compare);
+
+    if(index->posting_sorted > 0)
+    {
+        merged = (spamsum_index_posting *)malloc(index->posting_count * sizeof(spamsum_index_posting));
+
+        if(!merged) return -1;
+
+        for(i = 0, j = index->posting_sorted, k = 0; k < index->posting_count; k++)
+        {
+            if(j == index->posting_count ||
+               (i < index->posting_sorted &&
+                spamsum_index_posting_compare(&index->postings[i], &index->postings[j]) <= 0))
+                merged[k] = index->postings[i++];
+            else
+                merged[k] = index->postings[j++];
+        }
+
+        free(index->postings);
+        index->postings         = merged;
+        index->posting_capacity = index->posting_count;
+    }
+
+    index->posting_sorted = index->posting_count;
+
+    return 0;
+}
+
+/**
+ * @brief Gets the record of an entry, its identifier followed by its digest.
+ *
+ * @param index Index.
+ * @param entry Entry number.
+ *
+ * @return Pointer to the record.
+ */
+static const uint8_t *spamsum_index_entry(const spamsum_index *index, uint32_t entry)
+{
+    if(entry < index->map_entries) return index->map_entry_data + (size_t)entry * SPAMSUM_INDEX_ENTRY_SIZE;
+
+    return index->entries + (size_t)(entry - index->map_entries) * SPAMSUM_INDEX_ENTRY_SIZE;
+}
+
+/**
+ * @brief Searches a key in the loaded file.
+ *
+ * @param index Index.
+ * @param key Key to search.
+ * @param first Receives the number of the first posting of the key.
+ *
+ * @return Number of postings of the key, zero if it is not found.
+ */
+static uint32_t spamsum_index_map_search(const spamsum_index *index, uint64_t key, uint32_t *first)
+{
+    const uint8_t *p;
+    uint64_t       found;
+    uint32_t       low = 0, high = index->map_keys, middle, count;
+
+    while(low < high)
+    {
+        middle = low + (high - low) / 2;
+        p      = state_get_u64(index->map_key_data + (size_t)middle * SPAMSUM_INDEX_KEY_SIZE, &found);
+
+        if(found == key)
+        {
+            p = state_get_u32(p, first);
+            state_get_u32(p, &count);
+
+            return count;
+        }
+
+        if(found < key)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Searches the first added posting of a key.
+ *
+ * @param index Index, with its postings sorted.
+ * @param key Key to search.
+ *
+ * @return Position of the first posting with a key equal or greater than the searched one.
+ */
+static uint32_t spamsum_index_search(const spamsum_index *index, uint64_t key)
+{
+    uint32_t low = 0, high = index->posting_count, middle;
+
+    while(low < high)
+    {
+        middle = low + (high - low) / 2;
+
+        if(index->postings[middle].key < key)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+/**
+ * @brief Validates the file an index was loaded from, and finds where each of its parts is.
+ *
+ * @param index Index, with the file mapped.
+ *
+ * @return 0 if the file is valid, -1 otherwise.
+ */
+static int spamsum_index_map_check(spamsum_index *index)
+{
+    const uint8_t *p = index->map;
+    spamsum_digest parsed;
+    uint64_t       key, previous = 0;
+    uint32_t       magic, first, count, total = 0, i;
+    uint16_t       version;
+
+    if(index->map_size < SPAMSUM_INDEX_HEADER_SIZE) return -1;
+
+    p = state_get_u32(p, &magic);
+    p = state_get_u16(p, &version);
+    p += 2;
+    p = state_get_u32(p, &index->map_entries);
+    p = state_get_u32(p, &index->map_keys);
+    state_get_u32(p, &index->map_postings);
+
+    if(magic != SPAMSUM_INDEX_MAGIC || version != SPAMSUM_INDEX_VERSION) return -1;
+
+    if(index->map_size != SPAMSUM_INDEX_HEADER_SIZE + (uint64_t)index->map_entries * SPAMSUM_INDEX_ENTRY_SIZE +
+                              (uint64_t)index->map_keys * SPAMSUM_INDEX_KEY_SIZE + (uint64_t)index->map_postings * 4)
+        return -1;
+
+    index->map_entry_data   = index->map + SPAMSUM_INDEX_HEADER_SIZE;
+    index->map_key_data     = index->map_entry_data + (size_t)index->map_entries * SPAMSUM_INDEX_ENTRY_SIZE;
+    index->map_posting_data = index->map_key_data + (size_t)index->map_keys * SPAMSUM_INDEX_KEY_SIZE;
+
+    /* Digests are compared straight from the file, so each one must be whole and within its entry */
+    for(i = 0, p = index->map_entry_data; i < index->map_entries; i++, p += SPAMSUM_INDEX_ENTRY_SIZE)
+        if(!memchr(p + 8, 0, FUZZY_MAX_RESULT) || spamsum_compare_parse(p + 8, &parsed)) return -1;
+
+    /* Keys must be sorted for the binary search, and their postings consecutive */
+    for(i = 0, p = index->map_key_data; i < index->map_keys; i++)
+    {
+        p = state_get_u64(p, &key);
+        p = state_get_u32(p, &first);
+        p = state_get_u32(p, &count);
+
+        if((i > 0 && key <= previous) || first != total || count > index->map_postings - total) return -1;
+
+        previous = key;
+        total += count;
+    }
+
+    return total == index->map_postings ? 0 : -1;
+}
+
+/**
+ * @brief Writes the keys or the postings of an index to a file, merging the loaded and the added ones.
+ *
+ * @param index Index, with its postings sorted.
+ * @param file File to write to, or NULL to only count the keys.
+ * @param postings Write the postings instead of the keys.
+ * @param keys Receives the number of keys.
+ *
+ * @return 0 on success, -1 if the file cannot be written.
+ */
+static int spamsum_index_merge(const spamsum_index *index, FILE *file, int postings, uint32_t *keys)
+{
+    const uint8_t *p;
+    uint8_t        record[SPAMSUM_INDEX_KEY_SIZE];
+    uint64_t       map_key = 0, key;
+    uint32_t       map_first = 0, map_count = 0, count, first = 0, i = 0, j = 0, k;
+
+    *keys = 0;
+
+    while(i < index->map_keys || j < index->posting_count)
+    {
+        if(i < index->map_keys)
+        {
+            p = state_get_u64(index->map_key_data + (size_t)i * SPAMSUM_INDEX_KEY_SIZE, &map_key);
+            p = state_get_u32(p, &map_first);
+            state_get_u32(p, &map_count);
+        }
+
+        if(j == index->posting_count || (i < index->map_keys && map_key <= index->postings[j].key))
+            key = map_key;
+        else
+            key = index->postings[j].key;
+
+        count = 0;
+
+        if(i < index->map_keys && map_key == key)
+        {
+            count = map_count;
+
+            if(file && postings &&
+               fwrite(index->map_posting_data + (size_t)map_first * 4, 4, map_count, file) != map_count)
+                return -1;
+
+            i++;
+        }
+
+        for(k = j; j < index->posting_count && index->postings[j].key == key; j++)
+        {
+            if(!file || !postings) continue;
+
+            state_put_u32(record, index->postings[j].entry);
+
+            if(fwrite(record, 4, 1, file) != 1) return -1;
+        }
+
+        count += j - k;
+
+        if(file && !postings)
+        {
+            state_put_u32(state_put_u32(state_put_u64(record, key), first), count);
+
+            if(fwrite(record, SPAMSUM_INDEX_KEY_SIZE, 1, file) != 1) return -1;
+        }
+
+        first += count;
+        (*keys)++;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Initializes an empty SpamSum digest index.
+ *
+ * @return Pointer to the index, or NULL if there is not enough memory.
+ */
+AARU_EXPORT spamsum_index *AARU_CALL spamsum_index_init(void)
+{
+    return (spamsum_index *)calloc(1, sizeof(spamsum_index));
+}
+
+/**
+ * @brief Loads a SpamSum digest index from a file written by spamsum_index_save().
+ *
+ * The file is mapped in memory and used in place, so loading does not depend on the size of
+ * the index. The file must not be modified while the index is in use. New digests can be added
+ * to a loaded index, they are kept in memory until the index is saved.
+ *
+ * @param path Path to the file.
+ *
+ * @return Pointer to the index, or NULL if the file cannot be mapped or is not valid.
+ */
+AARU_EXPORT spamsum_index *AARU_CALL spamsum_index_load(const char *path)
+{
+    spamsum_index *index;
+#if defined(_WIN32)
+    LARGE_INTEGER size;
+#else
+    struct stat st;
+    void       *map;
+    int         fd;
+#endif
+
+    if(!path) return NULL;
+
+    index = spamsum_index_init();
+
+    if(!index) return NULL;
+
+#if defined(_WIN32)
+    index->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if(index->file == INVALID_HANDLE_VALUE)
+    {
+        free(index);
+        return NULL;
+    }
+
+    if(GetFileSizeEx(index->file, &size) && size.QuadPart >= SPAMSUM_INDEX_HEADER_SIZE &&
+       (uint64_t)size.QuadPart <= SIZE_MAX)
+        index->mapping = CreateFileMappingA(index->file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if(index->mapping) index->map = (const uint8_t *)MapViewOfFile(index->mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if(index->map) index->map_size = (uint64_t)size.QuadPart;
+#else
+    fd = open(path, O_RDONLY);
+
+    if(fd < 0)
+    {
+        free(index);
+        return NULL;
+    }
+
+    if(!fstat(fd, &st) && st.st_size >= SPAMSUM_INDEX_HEADER_SIZE && (uint64_t)st.st_size <= SIZE_MAX)
+    {
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+        if(map != MAP_FAILED)
+        {
+            index->map      = (const uint8_t *)map;
+            index->map_size = (uint64_t)st.st_size;
+        }
+    }
+
+    close(fd);
+#endif
+
+    if(!index->map || spamsum_index_map_check(index))
+    {
+        spamsum_index_free(index);
+        return NULL;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Adds a SpamSum digest to an index.
+ *
+ * @param index Pointer to the index.
+ * @param digest Digest, as produced by spamsum_final().
+ * @param id Identifier returned by queries that find the digest.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL spamsum_index_add(spamsum_index *index, const uint8_t *digest, uint64_t id)
+{
+    uint64_t keys[SPAMSUM_INDEX_MAX_KEYS];
+    uint8_t *record;
+    size_t   len;
+    uint32_t entry;
+    int      n, i;
+
+    if(!index || !digest) return -1;
+
+    len = strlen((const char *)digest);
+
+    if(len >= FUZZY_MAX_RESULT) return -1;
+
+    n = spamsum_index_keys(digest, keys);
+
+    if(n < 0) return -1;
+
+    if((uint64_t)index->map_entries + index->entry_count >= UINT32_MAX ||
+       (uint64_t)index->map_postings + index->posting_count + n > UINT32_MAX)
+        return -1;
+
+    if(spamsum_index_grow((void **)&index->entries, &index->entry_capacity, index->entry_count + 1,
+                          SPAMSUM_INDEX_ENTRY_SIZE) ||
+       spamsum_index_grow((void **)&index->postings, &index->posting_capacity, index->posting_count + n,
+                          sizeof(spamsum_index_posting)))
+        return -1;
+
+    entry  = index->map_entries + index->entry_count;
+    record = index->entries + (size_t)index->entry_count * SPAMSUM_INDEX_ENTRY_SIZE;
+
+    memset(record, 0, SPAMSUM_INDEX_ENTRY_SIZE);
+    memcpy(state_put_u64(record, id), digest, len);
+
+    for(i = 0; i < n; i++)
+    {
+        index->postings[index->posting_count].key   = keys[i];
+        index->postings[index->posting_count].entry = entry;
+        index->posting_count++;
+    }
+
+    index->entry_count++;
+
+    return 0;
+}
+
+/**
+ * @brief Searches an index for the digests most similar to a given one.
+ *
+ * Only digests that can get a non-zero score are compared, so the result is the same as
+ * comparing against every digest in the index with spamsum_compare(). The index is not safe
+ * to use from several threads at once, as queries sort the digests added since the last one.
+ *
+ * @param index Pointer to the index.
+ * @param digest Digest to search, as produced by spamsum_final().
+ * @param min_score Lowest score of the returned matches, at least 1.
+ * @param matches Receives the matches, from highest to lowest score.
+ * @param max_matches Number of matches that fit in the matches array.
+ *
+ * @returns Number of matches stored, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL spamsum_index_query(spamsum_index *index, const uint8_t *digest, int min_score,
+                                              spamsum_index_match *matches, uint32_t max_matches)
+{
+    uint64_t       keys[SPAMSUM_INDEX_MAX_KEYS];
+    uint32_t      *candidates = NULL;
+    uint32_t       capacity   = 0, count = 0, found = 0, first = 0, n, i, j;
+    const uint8_t *record;
+    int            key_count, k, score;
+
+    if(!index || !digest || (!matches && max_matches)) return -1;
+
+    key_count = spamsum_index_keys(digest, keys);
+
+    if(key_count < 0 || spamsum_index_sort(index)) return -1;
+
+    if(min_score < 1) min_score = 1;
+
+    for(k = 0; k < key_count; k++)
+    {
+        n = spamsum_index_map_search(index, keys[k], &first);
+        j = spamsum_index_search(index, keys[k]);
+
+        i = j;
+
+        while(i < index->posting_count && index->postings[i].key == keys[k]) i++;
+
+        if(spamsum_index_grow((void **)&candidates, &capacity, count + n + (i - j), sizeof(uint32_t)))
+        {
+            free(candidates);
+            return -1;
+        }
+
+        for(; j < i; j++) candidates[count++] = index->postings[j].entry;
+
+        /* Entry numbers in the file are checked here, instead of when loading it */
+        for(j = 0; j < n; j++)
+        {
+            state_get_u32(index->map_posting_data + ((size_t)first + j) * 4, &candidates[count]);
+
+            if(candidates[count] < index->map_entries) count++;
+        }
+    }
+
+    qsort(candidates, count, sizeof(uint32_t), spamsum_index_entry_compare);
+
+    for(i = 0; i < count; i++)
+    {
+        if(i > 0 && candidates[i] == candidates[i - 1]) continue;
+
+        record = spamsum_index_entry(index, candidates[i]);
+        score  = spamsum_compare(digest, record + 8);
+
+        if(score < min_score || (found == max_matches && (!found || matches[found - 1].score >= score))) continue;
+
+        if(found < max_matches) found++;
+
+        for(j = found - 1; j > 0 && matches[j - 1].score < score; j--) matches[j] = matches[j - 1];
+
+        state_get_u64(record, &matches[j].id);
+        matches[j].score = score;
+    }
+
+    free(candidates);
+
+    return (int)found;
+}
+
+/**
+ * @brief Saves a SpamSum digest index to a file, that can be loaded with spamsum_index_load().
+ *
+ * @param index Pointer to the index.
+ * @param path Path to the file, which must not be the one the index was loaded from.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL spamsum_index_save(spamsum_index *index, const char *path)
+{
+    uint8_t  header[SPAMSUM_INDEX_HEADER_SIZE];
+    uint8_t *p;
+    uint32_t keys;
+    FILE    *file;
+    int      error;
+
+    if(!index || !path || spamsum_index_sort(index)) return -1;
+
+    spamsum_index_merge(index, NULL, 0, &keys);
+
+    memset(header, 0, SPAMSUM_INDEX_HEADER_SIZE);
+    p = state_put_u32(header, SPAMSUM_INDEX_MAGIC);
+    p = state_put_u16(p, SPAMSUM_INDEX_VERSION);
+    p = state_put_u32(p + 2, index->map_entries + index->entry_count);
+    p = state_put_u32(p, keys);
+    state_put_u32(p, index->map_postings + index->posting_count);
+
+    file = fopen(path, "wb");
+
+    if(!file) return -1;
+
+    error = fwrite(header, SPAMSUM_INDEX_HEADER_SIZE, 1, file) != 1 ||
+            (index->map_entries &&
+             fwrite(index->map_entry_data, SPAMSUM_INDEX_ENTRY_SIZE, index->map_entries, file) != index->map_entries) ||
+            (index->entry_count &&
+             fwrite(index->entries, SPAMSUM_INDEX_ENTRY_SIZE, index->entry_count, file) != index->entry_count) ||
+            spamsum_index_merge(index, file, 0, &keys) || spamsum_index_merge(index, file, 1, &keys);
+
+    if(fclose(file)) error = 1;
+
+    return error ? -1 : 0;
+}
+
+/**
+ * @brief Frees a SpamSum digest index.
+ *
+ * @param index Pointer to the index.
+ */
+AARU_EXPORT void AARU_CALL spamsum_index_free(spamsum_index *index)
+{
+    if(!index) return;
+
+#if defined(_WIN32)
+    if(index->map) UnmapViewOfFile(index->map);
+    if(index->mapping) CloseHandle(index->mapping);
+    if(index->file && index->file != INVALID_HANDLE_VALUE) CloseHandle(index->file);
+#else
+    if(index->map) munmap((void *)index->map, (size_t)index->map_size);
+#endif
+
+    free(index->entries);
+    free(index->postings);
+    free(index);
+}
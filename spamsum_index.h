@@ -0,0 +1,95 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AARU_CHECKSUMS_NATIVE_SPAMSUM_INDEX_H
+#define AARU_CHECKSUMS_NATIVE_SPAMSUM_INDEX_H
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+/*
+ * Index files are stored in little-endian order, and can be used in place once mapped in memory.
+ *
+ * Offset  Size  Field
+ * 0       4     Magic, "ASIX"
+ * 4       2     Format version
+ * 6       2     Reserved, zero
+ * 8       4     Number of entries
+ * 12      4     Number of keys
+ * 16      4     Number of postings
+ * 20      4     Reserved, zero
+ * 24            Entries, SPAMSUM_INDEX_ENTRY_SIZE bytes each: identifier (8) and digest, padded with zeroes
+ *               Keys, SPAMSUM_INDEX_KEY_SIZE bytes each, in ascending order: key (8), first posting (4), count (4)
+ *               Postings, 4 bytes each: entry number
+ */
+#define SPAMSUM_INDEX_MAGIC       0x58495341
+#define SPAMSUM_INDEX_VERSION     1
+#define SPAMSUM_INDEX_HEADER_SIZE 24
+#define SPAMSUM_INDEX_ENTRY_SIZE  (8 + FUZZY_MAX_RESULT)
+#define SPAMSUM_INDEX_KEY_SIZE    16
+
+/* Most keys a digest can have: one per substring of ROLLING_WINDOW characters of each part, and the whole digest */
+#define SPAMSUM_INDEX_MAX_KEYS (1 + 2 * (SPAMSUM_LENGTH - ROLLING_WINDOW + 1))
+
+typedef struct
+{
+    uint64_t key;
+    uint32_t entry;
+} spamsum_index_posting;
+
+typedef struct
+{
+    uint64_t id;
+    int      score;
+} spamsum_index_match;
+
+typedef struct
+{
+    /* Entries loaded from a file, used in place */
+    const uint8_t *map;
+    uint64_t       map_size;
+    uint32_t       map_entries;
+    uint32_t       map_keys;
+    uint32_t       map_postings;
+    const uint8_t *map_entry_data;
+    const uint8_t *map_key_data;
+    const uint8_t *map_posting_data;
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#endif
+    /* Entries added since, numbered after the loaded ones */
+    uint8_t               *entries;
+    uint32_t               entry_count;
+    uint32_t               entry_capacity;
+    spamsum_index_posting *postings;
+    uint32_t               posting_count;
+    uint32_t               posting_capacity;
+    uint32_t               posting_sorted;
+} spamsum_index;
+
+AARU_EXPORT spamsum_index *AARU_CALL spamsum_index_init(void);
+AARU_EXPORT spamsum_index *AARU_CALL spamsum_index_load(const char *path);
+AARU_EXPORT int AARU_CALL            spamsum_index_add(spamsum_index *index, const uint8_t *digest, uint64_t id);
+AARU_EXPORT int AARU_CALL            spamsum_index_query(spamsum_index *index, const uint8_t *digest, int min_score,
+                                                         spamsum_index_match *matches, uint32_t max_matches);
+AARU_EXPORT int AARU_CALL            spamsum_index_save(spamsum_index *index, const char *path);
+AARU_EXPORT void AARU_CALL           spamsum_index_free(spamsum_index *index);
+
+#endif  // AARU_CHECKSUMS_NATIVE_SPAMSUM_INDEX_H
@@ -0,0 +1,210 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)))
+
+#include <arm_neon.h>
+#include <stdint.h>
+
+#include "library.h"
+#include "spamsum.h"
+#include "simd.h"
+
+/**
+ * @brief Tests the rolling hash plus one of 4 positions for triggers.
+ *
+ * @param h Rolling hash plus one of each position.
+ * @param mask Lowest bits of h + 1 that must be zero.
+ * @param level Negated number of lowest bits of h + 1 that are skipped before testing the multiple of 3.
+ *
+ * @return Bitmap of the positions that trigger.
+ */
+TARGET_WITH_NEON static inline uint32_t spamsum_prescan_neon_test(uint32x4_t h, uint32x4_t mask, int32x4_t level)
+{
+    static const uint32_t bits[4] = {1, 2, 4, 8};
+    uint32x4_t            q       = vmulq_u32(vshlq_u32(h, level), vdupq_n_u32(0xAAAAAAAB));
+    uint32x4_t            ok      = vcleq_u32(q, vdupq_n_u32(0x55555555));
+    uint32x2_t            sum;
+
+    /* h + 1 must be a multiple of 3 << level, and must not have overflowed */
+    ok  = vbicq_u32(ok, vtstq_u32(h, mask));
+    ok  = vbicq_u32(ok, vceqq_u32(h, vdupq_n_u32(0)));
+    ok  = vandq_u32(ok, vld1q_u32(bits));
+    sum = vpadd_u32(vget_low_u32(ok), vget_high_u32(ok));
+    sum = vpadd_u32(sum, sum);
+
+    return vget_lane_u32(sum, 0);
+}
+
+/**
+ * @brief Computes the rolling hash of 8 consecutive positions and tests them for triggers.
+ *
+ * @param data Pointer to the first of the 8 positions, the 6 bytes before it must be readable.
+ * @param bias Value added to every rolling hash.
+ * @param mask Lowest bits of h + 1 that must be zero.
+ * @param level Negated number of lowest bits of h + 1 that are skipped before testing the multiple of 3.
+ *
+ * @return Bitmap of the positions that trigger.
+ */
+TARGET_WITH_NEON static inline uint32_t spamsum_prescan_neon_8(const uint8_t *data, uint32x4_t bias, uint32x4_t mask,
+                                                               int32x4_t level)
+{
+    uint32x4_t sum_lo    = vdupq_n_u32(0);
+    uint32x4_t sum_hi    = vdupq_n_u32(0);
+    uint32x4_t weight_lo = vdupq_n_u32(0);
+    uint32x4_t weight_hi = vdupq_n_u32(0);
+    uint32x4_t h3_lo     = vdupq_n_u32(0);
+    uint32x4_t h3_hi     = vdupq_n_u32(0);
+    uint16x8_t x;
+    uint32x4_t x_lo, x_hi, h_lo, h_hi;
+
+    /* Walk the window from the newest byte to the oldest one, so that accumulating the
+     * running sum into weight multiplies each byte by ROLLING_WINDOW minus its age. */
+#define SPAMSUM_NEON_BYTE(age)                                                                                         \
+    x         = vmovl_u8(vld1_u8(data - (age)));                                                                       \
+    x_lo      = vmovl_u16(vget_low_u16(x));                                                                            \
+    x_hi      = vmovl_u16(vget_high_u16(x));                                                                           \
+    sum_lo    = vaddq_u32(sum_lo, x_lo);                                                                               \
+    sum_hi    = vaddq_u32(sum_hi, x_hi);                                                                               \
+    weight_lo = vaddq_u32(weight_lo, sum_lo);                                                                          \
+    weight_hi = vaddq_u32(weight_hi, sum_hi);                                                                          \
+    h3_lo     = veorq_u32(h3_lo, vshlq_n_u32(x_lo, 5 * (age)));                                                        \
+    h3_hi     = veorq_u32(h3_hi, vshlq_n_u32(x_hi, 5 * (age)))
+
+    SPAMSUM_NEON_BYTE(0);
+    SPAMSUM_NEON_BYTE(1);
+    SPAMSUM_NEON_BYTE(2);
+    SPAMSUM_NEON_BYTE(3);
+    SPAMSUM_NEON_BYTE(4);
+    SPAMSUM_NEON_BYTE(5);
+    SPAMSUM_NEON_BYTE(6);
+
+#undef SPAMSUM_NEON_BYTE
+
+    /* h1 is the plain sum and h2 the weighted one */
+    h_lo = vaddq_u32(vaddq_u32(weight_lo, sum_lo), vaddq_u32(h3_lo, bias));
+    h_hi = vaddq_u32(vaddq_u32(weight_hi, sum_hi), vaddq_u32(h3_hi, bias));
+    h_lo = vaddq_u32(h_lo, vdupq_n_u32(1));
+    h_hi = vaddq_u32(h_hi, vdupq_n_u32(1));
+
+    return spamsum_prescan_neon_test(h_lo, mask, level) | spamsum_prescan_neon_test(h_hi, mask, level) << 4;
+}
+
+/**
+ * @brief Searches for the positions where the SpamSum rolling hash triggers a blockhash, using NEON instructions.
+ *
+ * The rolling hash only depends on the last ROLLING_WINDOW bytes, so it is computed for 8
+ * positions at once, directly from the input.
+ *
+ * @param data Pointer to the first position to test, the 6 bytes before it must be readable.
+ * @param len Number of positions to test, a multiple of 64.
+ * @param bias Value added to every rolling hash, to match the state of a context.
+ * @param level Blockhash that must be triggered.
+ * @param bitmap Receives one bit per position, set when it triggers the blockhash.
+ */
+AARU_EXPORT TARGET_WITH_NEON void AARU_CALL spamsum_prescan_neon(const uint8_t *data, uint32_t len, uint32_t bias,
+                                                                 uint32_t level, uint64_t *bitmap)
+{
+    const uint32x4_t vbias  = vdupq_n_u32(bias);
+    const uint32x4_t vmask  = vdupq_n_u32((1u << level) - 1);
+    const int32x4_t  vlevel = vdupq_n_s32(-(int32_t)level);
+    uint32_t         i, j;
+
+    for(i = 0; i < len; i += 64)
+    {
+        uint64_t bits = 0;
+
+        for(j = 0; j < 64; j += 8) bits |= (uint64_t)spamsum_prescan_neon_8(data + i + j, vbias, vmask, vlevel) << j;
+
+        *bitmap++ = bits;
+    }
+}
+
+
+/**
+ * @brief Advances blockhash hashes over a run of bytes, using NEON instructions.
+ *
+ * Up to 32 hashes, 8 vectors, are kept in registers and updated with a single multiplication
+ * each per byte. Only the hashes in the range are stored back.
+ *
+ * @param hashes Interleaved blockhash hashes, with SPAMSUM_HASHES entries.
+ * @param first First hash to update.
+ * @param last One past the last hash to update.
+ * @param data Pointer to the run of bytes.
+ * @param len Length of the run.
+ */
+AARU_EXPORT TARGET_WITH_NEON void AARU_CALL spamsum_fnv_neon(uint32_t *hashes, uint32_t first, uint32_t last,
+                                                             const uint8_t *data, uint32_t len)
+{
+    static const uint32_t lanes[4] = {0, 1, 2, 3};
+    const uint32x4_t      prime    = vdupq_n_u32(HASH_PRIME);
+
+    while(first < last)
+    {
+        /* Move the group back when needed, so the 8 vectors stay inside the array */
+        uint32_t   group = first / 4 > SPAMSUM_HASHES / 4 - 8 ? SPAMSUM_HASHES - 32 : first / 4 * 4;
+        uint32_t   end   = last < group + 32 ? last : group + 32;
+        uint32_t  *p     = hashes + group;
+        uint32x4_t v0    = vld1q_u32(p);
+        uint32x4_t v1    = vld1q_u32(p + 4);
+        uint32x4_t v2    = vld1q_u32(p + 8);
+        uint32x4_t v3    = vld1q_u32(p + 12);
+        uint32x4_t v4    = vld1q_u32(p + 16);
+        uint32x4_t v5    = vld1q_u32(p + 20);
+        uint32x4_t v6    = vld1q_u32(p + 24);
+        uint32x4_t v7    = vld1q_u32(p + 28);
+        uint32x4_t lo    = vdupq_n_u32(first);
+        uint32x4_t hi    = vdupq_n_u32(end);
+        uint32x4_t c, index;
+        uint32_t   j;
+
+        for(j = 0; j < len; j++)
+        {
+            c  = vdupq_n_u32(data[j]);
+            v0 = veorq_u32(vmulq_u32(v0, prime), c);
+            v1 = veorq_u32(vmulq_u32(v1, prime), c);
+            v2 = veorq_u32(vmulq_u32(v2, prime), c);
+            v3 = veorq_u32(vmulq_u32(v3, prime), c);
+            v4 = veorq_u32(vmulq_u32(v4, prime), c);
+            v5 = veorq_u32(vmulq_u32(v5, prime), c);
+            v6 = veorq_u32(vmulq_u32(v6, prime), c);
+            v7 = veorq_u32(vmulq_u32(v7, prime), c);
+        }
+
+        /* Store the hashes that are in range, first <= index < end */
+#define SPAMSUM_NEON_STORE(v, offset)                                                                                  \
+    index = vaddq_u32(vld1q_u32(lanes), vdupq_n_u32(group + (offset)));                                               \
+    vst1q_u32(p + (offset),                                                                                            \
+              vbslq_u32(vandq_u32(vcgeq_u32(index, lo), vcltq_u32(index, hi)), v, vld1q_u32(p + (offset))))
+
+        SPAMSUM_NEON_STORE(v0, 0);
+        SPAMSUM_NEON_STORE(v1, 4);
+        SPAMSUM_NEON_STORE(v2, 8);
+        SPAMSUM_NEON_STORE(v3, 12);
+        SPAMSUM_NEON_STORE(v4, 16);
+        SPAMSUM_NEON_STORE(v5, 20);
+        SPAMSUM_NEON_STORE(v6, 24);
+        SPAMSUM_NEON_STORE(v7, 28);
+
+#undef SPAMSUM_NEON_STORE
+
+        first = end;
+    }
+}
+
+#endif
@@ -0,0 +1,313 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Packed binary SpamSum digests.
+ *
+ * Offset  Size  Field
+ * 0       1     Block size exponent, the block size being SSDEEP_BS(exponent)
+ * 1       1     Length of the first part, in symbols
+ * 2       1     Length of the second part, in symbols
+ * 3             First part, then second part, each padded to a whole byte
+ *
+ * Each part stores its base64 symbols as 6-bit values, the first symbol in the lowest bits of
+ * the first byte. A substring of ROLLING_WINDOW symbols is then a 42-bit field, so it can be
+ * extracted with a single 64-bit load and compared as an integer. Packing keeps the digest
+ * exactly as spamsum_final() produced it, so unpacking gives the same text back.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "library.h"
+#include "spamsum.h"
+#include "state.h"
+
+#define SPAMSUM_PACKED_HEADER_SIZE 3
+#define SPAMSUM_PACKED_PART_SIZE   (SPAMSUM_LENGTH * 6 / 8)
+#define SPAMSUM_PACKED_GRAM_MASK   ((1ULL << (ROLLING_WINDOW * 6)) - 1)
+
+/* Bytes used by a packed part of the given number of symbols */
+#define SPAMSUM_PACKED_BYTES(symbols) (((uint32_t)(symbols) * 6 + 7) / 8)
+
+/* Value of a base64 character, or -1 if it is not one */
+FORCE_INLINE int spamsum_packed_symbol(uint8_t c)
+{
+    if(c >= 'A' && c <= 'Z') return c - 'A';
+    if(c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if(c >= '0' && c <= '9') return c - '0' + 52;
+    if(c == '+') return 62;
+    if(c == '/') return 63;
+
+    return -1;
+}
+
+/**
+ * @brief Packs a digest part.
+ *
+ * @param in Pointer to the part, advanced to the character that ends it.
+ * @param end Character that ends the part, besides the end of the string.
+ * @param out Receives the packed part.
+ * @param len Receives the number of symbols of the part.
+ *
+ * @return Pointer to the byte after the packed part, or NULL if the part is not valid.
+ */
+static uint8_t *spamsum_pack_part(const uint8_t **in, uint8_t end, uint8_t *out, uint32_t *len)
+{
+    uint32_t bits = 0, pending = 0;
+    int      symbol;
+
+    *len = 0;
+
+    for(; **in && **in != end; (*in)++)
+    {
+        symbol = spamsum_packed_symbol(**in);
+
+        if(symbol < 0 || *len == SPAMSUM_LENGTH) return NULL;
+
+        bits |= (uint32_t)symbol << pending;
+        pending += 6;
+        (*len)++;
+
+        if(pending < 8) continue;
+
+        *out++ = (uint8_t)bits;
+        bits >>= 8;
+        pending -= 8;
+    }
+
+    if(pending) *out++ = (uint8_t)bits;
+
+    return out;
+}
+
+/**
+ * @brief Unpacks a digest part to its base64 characters.
+ *
+ * @param in Packed part.
+ * @param len Number of symbols of the part.
+ * @param out Receives the characters.
+ */
+static void spamsum_unpack_part(const uint8_t *in, uint32_t len, uint8_t *out)
+{
+    uint32_t i, bit, value;
+
+    for(i = 0, bit = 0; i < len; i++, bit += 6)
+    {
+        value = in[bit / 8] >> (bit % 8);
+
+        /* The symbol continues in the next byte */
+        if(bit % 8 > 2) value |= (uint32_t)in[bit / 8 + 1] << (8 - bit % 8);
+
+        out[i] = b64[value & 0x3F];
+    }
+}
+
+/**
+ * @brief Validates the header and size of a packed digest.
+ *
+ * @param packed Packed digest.
+ * @param len Size of the packed digest.
+ *
+ * @return 0 if it is valid, -1 otherwise.
+ */
+static int spamsum_packed_check(const uint8_t *packed, uint32_t len)
+{
+    if(!packed || len < SPAMSUM_PACKED_HEADER_SIZE) return -1;
+
+    if(packed[0] >= NUM_BLOCKHASHES || packed[1] > SPAMSUM_LENGTH || packed[2] > SPAMSUM_LENGTH) return -1;
+
+    if(len != SPAMSUM_PACKED_HEADER_SIZE + SPAMSUM_PACKED_BYTES(packed[1]) + SPAMSUM_PACKED_BYTES(packed[2])) return -1;
+
+    return 0;
+}
+
+/**
+ * @brief Unpacks a packed digest into its block size and parts, with sequences eliminated.
+ *
+ * @param packed Packed digest, already validated.
+ * @param parsed Receives the digest.
+ */
+static void spamsum_packed_parse(const uint8_t *packed, spamsum_digest *parsed)
+{
+    uint8_t        text[SPAMSUM_LENGTH + 1];
+    const uint8_t *p;
+
+    parsed->block_size = (uint64_t)MIN_BLOCKSIZE << packed[0];
+
+    spamsum_unpack_part(packed + SPAMSUM_PACKED_HEADER_SIZE, packed[1], text);
+    text[packed[1]] = 0;
+    p               = text;
+    parsed->len1    = (uint32_t)spamsum_compare_copy(&p, 0, parsed->part1);
+
+    spamsum_unpack_part(packed + SPAMSUM_PACKED_HEADER_SIZE + SPAMSUM_PACKED_BYTES(packed[1]), packed[2], text);
+    text[packed[2]] = 0;
+    p               = text;
+    parsed->len2    = (uint32_t)spamsum_compare_copy(&p, 0, parsed->part2);
+}
+
+/**
+ * @brief Packs a SpamSum digest into its binary form.
+ *
+ * The packed digest takes about three quarters of the text one. Only digests with a block
+ * size that spamsum_final() can produce, SSDEEP_BS() of a blockhash index, can be packed.
+ *
+ * @param digest Digest, as produced by spamsum_final().
+ * @param packed Receives the packed digest, with room for SPAMSUM_PACKED_MAX_SIZE bytes.
+ *
+ * @returns Size of the packed digest, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL spamsum_pack(const uint8_t *digest, uint8_t *packed)
+{
+    uint64_t block_size = 0;
+    uint32_t exponent, len1, len2;
+    uint8_t *p;
+
+    if(!digest || !packed || *digest < '0' || *digest > '9') return -1;
+
+    for(; *digest >= '0' && *digest <= '9'; digest++)
+    {
+        if(block_size > (UINT64_MAX - 9) / 10) return -1;
+
+        block_size = block_size * 10 + (*digest - '0');
+    }
+
+    exponent = 0;
+
+    while(exponent < NUM_BLOCKHASHES && (uint64_t)MIN_BLOCKSIZE << exponent != block_size) exponent++;
+
+    if(exponent == NUM_BLOCKHASHES) return -1;
+
+    if(*digest++ != ':') return -1;
+
+    p = spamsum_pack_part(&digest, ':', packed + SPAMSUM_PACKED_HEADER_SIZE, &len1);
+
+    if(!p || *digest++ != ':') return -1;
+
+    p = spamsum_pack_part(&digest, 0, p, &len2);
+
+    if(!p) return -1;
+
+    packed[0] = (uint8_t)exponent;
+    packed[1] = (uint8_t)len1;
+    packed[2] = (uint8_t)len2;
+
+    return (int)(p - packed);
+}
+
+/**
+ * @brief Unpacks a packed SpamSum digest to its text form.
+ *
+ * @param packed Packed digest, as produced by spamsum_pack().
+ * @param len Size of the packed digest.
+ * @param digest Receives the digest, with room for FUZZY_MAX_RESULT bytes.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL spamsum_unpack(const uint8_t *packed, uint32_t len, uint8_t *digest)
+{
+    uint8_t  digits[10];
+    uint64_t block_size;
+    int      count = 0;
+
+    if(!digest || spamsum_packed_check(packed, len)) return -1;
+
+    block_size = (uint64_t)MIN_BLOCKSIZE << packed[0];
+
+    do {
+        digits[count++] = (uint8_t)('0' + block_size % 10);
+        block_size /= 10;
+    } while(block_size);
+
+    while(count) *digest++ = digits[--count];
+
+    *digest++ = ':';
+    spamsum_unpack_part(packed + SPAMSUM_PACKED_HEADER_SIZE, packed[1], digest);
+    digest += packed[1];
+    *digest++ = ':';
+    spamsum_unpack_part(packed + SPAMSUM_PACKED_HEADER_SIZE + SPAMSUM_PACKED_BYTES(packed[1]), packed[2], digest);
+    digest[packed[2]] = 0;
+
+    return 0;
+}
+
+/**
+ * @brief Compares two packed SpamSum digests.
+ *
+ * Gives the same score as spamsum_compare() on the text form of both digests. Identical
+ * digests are found without unpacking them.
+ *
+ * @param packed1 First packed digest, as produced by spamsum_pack().
+ * @param len1 Size of the first packed digest.
+ * @param packed2 Second packed digest, as produced by spamsum_pack().
+ * @param len2 Size of the second packed digest.
+ *
+ * @returns Score from 0, no similarity, to 100, identical, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL spamsum_compare_packed(const uint8_t *packed1, uint32_t len1, const uint8_t *packed2,
+                                                 uint32_t len2)
+{
+    spamsum_digest d1, d2;
+
+    if(spamsum_packed_check(packed1, len1) || spamsum_packed_check(packed2, len2)) return -1;
+
+    if(len1 == len2 && !memcmp(packed1, packed2, len1)) return 100;
+
+    spamsum_packed_parse(packed1, &d1);
+    spamsum_packed_parse(packed2, &d2);
+
+    return (int)spamsum_compare_digests(&d1, &d2);
+}
+
+/**
+ * @brief Extracts the substrings of ROLLING_WINDOW symbols of a part of a packed digest.
+ *
+ * Each substring is returned as its 42 bits from the packed part, so two substrings are the
+ * same when their values are equal. Sequences are not eliminated, as in the packed digest.
+ *
+ * @param packed Packed digest, as produced by spamsum_pack().
+ * @param len Size of the packed digest.
+ * @param part Part to extract the substrings of, 1 or 2.
+ * @param grams Receives the substrings, with room for SPAMSUM_LENGTH - ROLLING_WINDOW + 1 values.
+ *
+ * @returns Number of substrings, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL spamsum_packed_grams(const uint8_t *packed, uint32_t len, uint32_t part, uint64_t *grams)
+{
+    /* Padded so every substring can be loaded as a whole 64-bit word */
+    uint8_t  buffer[SPAMSUM_PACKED_PART_SIZE + 8];
+    uint64_t word;
+    uint32_t symbols, bit, i;
+
+    if(!grams || (part != 1 && part != 2) || spamsum_packed_check(packed, len)) return -1;
+
+    symbols = packed[part];
+
+    memset(buffer, 0, sizeof(buffer));
+    memcpy(buffer,
+           packed + SPAMSUM_PACKED_HEADER_SIZE + (part == 2 ? SPAMSUM_PACKED_BYTES(packed[1]) : 0),
+           SPAMSUM_PACKED_BYTES(symbols));
+
+    for(i = 0, bit = 0; i + ROLLING_WINDOW <= symbols; i++, bit += 6)
+    {
+        state_get_u64(buffer + bit / 8, &word);
+        grams[i] = (word >> (bit % 8)) & SPAMSUM_PACKED_GRAM_MASK;
+    }
+
+    return (int)i;
+}
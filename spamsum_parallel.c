@@ -0,0 +1,487 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Multi-threaded SpamSum.
+ *
+ * The rolling hash only depends on the last ROLLING_WINDOW bytes, so the points where it
+ * triggers a blockhash can be searched for in parallel over separate chunks of the input.
+ * Knowing those points, the fork and reduce logic can be replayed sequentially, only
+ * touching the trigger list, which tells when each blockhash is created and when it is
+ * no longer needed. Finally every blockhash only depends on the input bytes and its own
+ * trigger points, so they are all hashed in parallel, one per thread.
+ *
+ * The result is identical to feeding the same data to spamsum_update64().
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "library.h"
+#include "spamsum.h"
+#include "parallel.h"
+
+/* Input processed at once, bounded so the trigger positions fit in a packed trigger */
+#define SPAMSUM_PARALLEL_WINDOW    (1 << 24)
+/* Inputs smaller than this are not worth splitting between threads */
+#define SPAMSUM_PARALLEL_MIN       65536
+/* Smallest chunk of a window searched for trigger points by a thread */
+#define SPAMSUM_PARALLEL_MIN_CHUNK 4096
+
+/* Trigger points are stored as their offset in the window and the deepest blockhash they reach */
+#define TRIGGER_LEVEL_BITS     5
+#define TRIGGER(pos, level)    (((pos) << TRIGGER_LEVEL_BITS) | (level))
+#define TRIGGER_POS(trigger)   ((trigger) >> TRIGGER_LEVEL_BITS)
+#define TRIGGER_LEVEL(trigger) ((trigger) & ((1 << TRIGGER_LEVEL_BITS) - 1))
+
+typedef struct
+{
+    const uint8_t *data;
+    uint32_t       start;
+    uint32_t       end;
+    roll_state     roll;
+    uint32_t       lowest;
+    uint32_t      *triggers;
+    uint32_t       count;
+    uint32_t       capacity;
+    int            failed;
+} trigger_job;
+
+typedef struct
+{
+    const uint8_t     *data;
+    uint32_t           len;
+    const trigger_job *chunks;
+    uint32_t           chunk_count;
+    uint32_t           level;
+    blockhash_ctx      bh;
+    uint32_t           h;
+    uint32_t           half_h;
+    int                born;
+    uint32_t           birth;
+    uint32_t           parent_h;
+    uint32_t           parent_half_h;
+    int                dies;
+    uint32_t           death;
+} blockhash_job;
+
+/* Same as roll_hash(), over a standalone rolling hash state */
+FORCE_INLINE uint32_t roll_step(roll_state *roll, uint8_t c)
+{
+    roll->h2 -= roll->h1;
+    roll->h2 += ROLLING_WINDOW * c;
+
+    roll->h1 += c;
+    roll->h1 -= roll->window[roll->n % ROLLING_WINDOW];
+
+    roll->window[roll->n % ROLLING_WINDOW] = c;
+    roll->n++;
+
+    roll->h3 <<= 5;
+    roll->h3 ^= c;
+
+    return roll->h1 + roll->h2 + roll->h3;
+}
+
+/**
+ * @brief Searches a chunk of the input for the points where the rolling hash triggers a blockhash.
+ *
+ * A rolling hash h triggers blockhash i when h % SSDEEP_BS(i) == SSDEEP_BS(i) - 1, that is when
+ * h + 1 is a multiple of 3 * 2^i, so the deepest blockhash reached is given by the trailing
+ * zeros of (h + 1) / 3. Only triggers reaching the lowest active blockhash are stored.
+ *
+ * @param arg Pointer to the trigger_job describing the chunk.
+ */
+static void find_triggers(void *arg)
+{
+    trigger_job   *job  = (trigger_job *)arg;
+    const uint8_t *data = job->data;
+    uint64_t       mask = ((uint64_t)1 << job->lowest) - 1;
+    uint32_t       pos;
+
+    for(pos = job->start; pos < job->end; pos++)
+    {
+        uint64_t x = (uint64_t)roll_step(&job->roll, data[pos]) + 1;
+        uint64_t q;
+        uint32_t level;
+
+        if(x & mask || x % 3) continue;
+
+        q     = (x / 3) >> job->lowest;
+        level = job->lowest;
+
+        while(!(q & 1) && level < NUM_BLOCKHASHES - 1)
+        {
+            q >>= 1;
+            level++;
+        }
+
+        if(job->count == job->capacity)
+        {
+            uint32_t  capacity = job->capacity ? job->capacity * 2 : 4096;
+            uint32_t *triggers = (uint32_t *)realloc(job->triggers, capacity * sizeof(uint32_t));
+
+            if(!triggers)
+            {
+                job->failed = 1;
+                return;
+            }
+
+            job->triggers = triggers;
+            job->capacity = capacity;
+        }
+
+        job->triggers[job->count++] = TRIGGER(pos, level);
+    }
+}
+
+/**
+ * @brief Replays the fork and reduce logic of fuzzy_engine_step() over the trigger points.
+ *
+ * Only the digest lengths are needed to know when blockhashes are forked and reduced, so
+ * this is cheap compared to hashing.
+ *
+ * @param ctx Pointer to the SpamSum context structure, its blockhash range is updated.
+ * @param chunks Trigger points found in each chunk, in order.
+ * @param chunk_count Number of chunks.
+ * @param birth Receives the offset where each new blockhash is forked.
+ * @param death Receives the offset after which each dropped blockhash is no longer used.
+ */
+static void replay_triggers(spamsum_ctx *ctx, const trigger_job *chunks, uint32_t chunk_count, uint32_t *birth,
+                            uint32_t *death)
+{
+    uint32_t d_len[NUM_BLOCKHASHES];
+    uint32_t c, t, i;
+
+    for(i = 0; i < NUM_BLOCKHASHES; i++) d_len[i] = ctx->bh[i].d_len;
+
+    for(c = 0; c < chunk_count; c++)
+        for(t = 0; t < chunks[c].count; t++)
+        {
+            uint32_t pos   = TRIGGER_POS(chunks[c].triggers[t]);
+            uint32_t level = TRIGGER_LEVEL(chunks[c].triggers[t]);
+
+            for(i = ctx->bh_start; i < ctx->bh_end && i <= level; ++i)
+            {
+                if(0 == d_len[i] && ctx->bh_end < ctx->bh_end_limit)
+                {
+                    birth[ctx->bh_end] = pos;
+                    d_len[ctx->bh_end] = 0;
+                    ++ctx->bh_end;
+                }
+
+                if(d_len[i] < SPAMSUM_LENGTH - 1)
+                {
+                    d_len[i]++;
+                    continue;
+                }
+
+                /* Same conditions as fuzzy_try_reduce_blockhash() */
+                if(ctx->bh_end - ctx->bh_start < 2) continue;
+
+                if((uint64_t)SSDEEP_BS(ctx->bh_start) * SPAMSUM_LENGTH >=
+                   (ctx->flags & SPAMSUM_SIZE_FIXED ? ctx->fixed_size : ctx->total_size))
+                    continue;
+
+                if(d_len[ctx->bh_start + 1] < SPAMSUM_LENGTH / 2) continue;
+
+                death[ctx->bh_start] = pos;
+                ++ctx->bh_start;
+            }
+        }
+}
+
+/**
+ * @brief Hashes the window for a single blockhash, emitting a digest character at each of its trigger points.
+ *
+ * @param arg Pointer to the blockhash_job describing the blockhash.
+ */
+static void hash_blockhash(void *arg)
+{
+    blockhash_job *job    = (blockhash_job *)arg;
+    blockhash_ctx *bh     = &job->bh;
+    const uint8_t *data   = job->data;
+    uint32_t       h      = job->h;
+    uint32_t       half_h = job->half_h;
+    uint32_t       pos    = 0;
+    uint32_t       c, t;
+
+    if(job->born)
+    {
+        /* Until forked, it is the same as the top blockhash, which is not reset before that */
+        h      = job->parent_h;
+        half_h = job->parent_half_h;
+
+        for(; pos <= job->birth; pos++)
+        {
+            h      = (h * HASH_PRIME) ^ data[pos];
+            half_h = (half_h * HASH_PRIME) ^ data[pos];
+        }
+
+        bh->digest[0]   = 0;
+        bh->half_digest = 0;
+        bh->d_len       = 0;
+    }
+
+    for(c = 0; c < job->chunk_count; c++)
+        for(t = 0; t < job->chunks[c].count; t++)
+        {
+            uint32_t trigger = job->chunks[c].triggers[t];
+            uint32_t tpos    = TRIGGER_POS(trigger);
+
+            if(TRIGGER_LEVEL(trigger) < job->level || (job->born && tpos < job->birth)) continue;
+
+            for(; pos <= tpos; pos++)
+            {
+                h      = (h * HASH_PRIME) ^ data[pos];
+                half_h = (half_h * HASH_PRIME) ^ data[pos];
+            }
+
+            bh->digest[bh->d_len] = b64[h % 64];
+            bh->half_digest       = b64[half_h % 64];
+
+            if(bh->d_len < SPAMSUM_LENGTH - 1)
+            {
+                bh->digest[++bh->d_len] = 0;
+                h                       = HASH_INIT;
+
+                if(bh->d_len < SPAMSUM_LENGTH / 2)
+                {
+                    half_h          = HASH_INIT;
+                    bh->half_digest = 0;
+                }
+            }
+
+            /* Once dropped, the blockhash is never used again */
+            if(job->dies && tpos == job->death) return;
+        }
+
+    for(; pos < job->len; pos++)
+    {
+        h      = (h * HASH_PRIME) ^ data[pos];
+        half_h = (half_h * HASH_PRIME) ^ data[pos];
+    }
+
+    job->h      = h;
+    job->half_h = half_h;
+}
+
+/**
+ * @brief Runs the SpamSum engine over a window using several threads.
+ *
+ * The rolling position counter must not wrap inside the window, and must have advanced at
+ * least ROLLING_WINDOW bytes since its last wrap.
+ *
+ * @returns 1 on success, 0 if memory could not be allocated, in which case the context is untouched.
+ */
+static int spamsum_parallel_window(spamsum_ctx *ctx, const uint8_t *data, uint32_t len, uint32_t threads,
+                                   trigger_job *chunks, blockhash_job *jobs)
+{
+    uint32_t bh_start = ctx->bh_start;
+    uint32_t bh_end   = ctx->bh_end;
+    uint32_t chunk_count;
+    uint32_t chunk_size;
+    uint32_t birth[NUM_BLOCKHASHES];
+    uint32_t death[NUM_BLOCKHASHES];
+    uint32_t e1 = ctx->roll.h1;
+    uint32_t e2 = ctx->roll.h2;
+    uint32_t i, j;
+
+    /*
+     * When the position counter wraps, the byte leaving the window is taken from the wrong
+     * slot, leaving a constant error in h1 that h2 then accumulates at every step. Starting
+     * a chunk from its preceding bytes alone gives the errorless sums, so the errors found
+     * here are carried to each chunk start.
+     */
+    for(j = 1; j <= ROLLING_WINDOW; j++)
+    {
+        uint8_t c = ctx->roll.window[(ctx->roll.n - j) % ROLLING_WINDOW];
+
+        e1 -= c;
+        e2 -= (ROLLING_WINDOW + 1 - j) * c;
+    }
+
+    chunk_count = len / SPAMSUM_PARALLEL_MIN_CHUNK;
+    if(chunk_count > threads) chunk_count = threads;
+    if(chunk_count < 1) chunk_count = 1;
+
+    chunk_size = len / chunk_count;
+
+    for(i = 0; i < chunk_count; i++)
+    {
+        trigger_job *chunk = &chunks[i];
+
+        chunk->data   = data;
+        chunk->start  = i * chunk_size;
+        chunk->end    = i == chunk_count - 1 ? len : (i + 1) * chunk_size;
+        chunk->lowest = bh_start;
+        chunk->count  = 0;
+        chunk->failed = 0;
+
+        if(i == 0)
+        {
+            chunk->roll = ctx->roll;
+            continue;
+        }
+
+        memset(&chunk->roll, 0, sizeof(roll_state));
+
+        for(j = chunk->start - ROLLING_WINDOW; j < chunk->start; j++) roll_step(&chunk->roll, data[j]);
+
+        chunk->roll.h1 += e1;
+        chunk->roll.h2 += e2 - chunk->start * e1;
+    }
+
+    parallel_run(find_triggers, chunks, sizeof(trigger_job), chunk_count, threads);
+
+    for(i = 0; i < chunk_count; i++)
+        if(chunks[i].failed) return 0;
+
+    replay_triggers(ctx, chunks, chunk_count, birth, death);
+
+    for(i = bh_start; i < ctx->bh_end; i++)
+    {
+        blockhash_job *job = &jobs[i - bh_start];
+
+        job->data          = data;
+        job->len           = len;
+        job->chunks        = chunks;
+        job->chunk_count   = chunk_count;
+        job->level         = i;
+        job->bh            = ctx->bh[i];
+        job->h             = BH_H(ctx, i);
+        job->half_h        = BH_HALF_H(ctx, i);
+        job->born          = i >= bh_end;
+        job->birth         = birth[i];
+        job->parent_h      = BH_H(ctx, bh_end - 1);
+        job->parent_half_h = BH_HALF_H(ctx, bh_end - 1);
+        job->dies          = i < ctx->bh_start;
+        job->death         = death[i];
+    }
+
+    parallel_run(hash_blockhash, jobs, sizeof(blockhash_job), ctx->bh_end - bh_start, threads);
+
+    for(i = bh_start; i < ctx->bh_end; i++)
+    {
+        ctx->bh[i]        = jobs[i - bh_start].bh;
+        BH_H(ctx, i)      = jobs[i - bh_start].h;
+        BH_HALF_H(ctx, i) = jobs[i - bh_start].half_h;
+    }
+
+    /* The last chunk ends with the rolling sums of the window, errors included */
+    ctx->roll.h1 = chunks[chunk_count - 1].roll.h1;
+    ctx->roll.h2 = chunks[chunk_count - 1].roll.h2;
+    ctx->roll.h3 = chunks[chunk_count - 1].roll.h3;
+    ctx->roll.n += len;
+
+    for(j = 1; j <= ROLLING_WINDOW; j++) ctx->roll.window[(ctx->roll.n - j) % ROLLING_WINDOW] = data[len - j];
+
+    return 1;
+}
+
+/**
+ * @brief Runs the SpamSum engine over a chunk of data, using several threads when worth it.
+ *
+ * @param ctx Pointer to the SpamSum context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ * @param threads Maximum number of threads to use.
+ */
+static void spamsum_parallel_chunk(spamsum_ctx *ctx, const uint8_t *data, uint32_t len, uint32_t threads)
+{
+    trigger_job   *chunks;
+    blockhash_job *jobs;
+    uint32_t       window;
+    uint32_t       i;
+
+    if(threads < 2 || len < SPAMSUM_PARALLEL_MIN)
+    {
+        spamsum_engine(ctx, data, len);
+        return;
+    }
+
+    chunks = (trigger_job *)calloc(threads, sizeof(trigger_job));
+    jobs   = (blockhash_job *)calloc(NUM_BLOCKHASHES, sizeof(blockhash_job));
+
+    while(len > 0)
+    {
+        /* Needed to measure the rolling hash errors, see spamsum_parallel_window() */
+        if(ctx->roll.n < ROLLING_WINDOW)
+        {
+            window = ROLLING_WINDOW - ctx->roll.n;
+            if(window > len) window = len;
+        }
+        else
+        {
+            window = len > SPAMSUM_PARALLEL_WINDOW ? SPAMSUM_PARALLEL_WINDOW : len;
+
+            if((uint64_t)ctx->roll.n + window > 0x100000000ULL) window = (uint32_t)(0x100000000ULL - ctx->roll.n);
+        }
+
+        if(window < SPAMSUM_PARALLEL_MIN || !chunks || !jobs ||
+           !spamsum_parallel_window(ctx, data, window, threads, chunks, jobs))
+            spamsum_engine(ctx, data, window);
+
+        data += window;
+        len -= window;
+    }
+
+    if(chunks)
+        for(i = 0; i < threads; i++) free(chunks[i].triggers);
+
+    free(chunks);
+    free(jobs);
+}
+
+/**
+ * @brief Updates the SpamSum checksum with new data, using several threads.
+ *
+ * This function updates the SpamSum checksum, splitting the work between several threads.
+ * The result is identical to calling spamsum_update64() with the same data.
+ *
+ * @param ctx Pointer to the SpamSum context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ * @param threads Maximum number of threads to use, or 0 to use one per processor.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL spamsum_update_parallel(spamsum_ctx *ctx, const uint8_t *data, uint64_t len,
+                                                  uint32_t threads)
+{
+    uint32_t chunk;
+
+    if(!ctx || !data) return -1;
+
+    if(!threads) threads = parallel_cpu_count();
+
+    while(len > 0)
+    {
+        chunk = len > SPAMSUM_MAX_CHUNK ? SPAMSUM_MAX_CHUNK : (uint32_t)len;
+
+        ctx->total_size += chunk;
+
+        spamsum_parallel_chunk(ctx, data, chunk, threads);
+
+        data += chunk;
+        len -= chunk;
+    }
+
+    return 0;
+}
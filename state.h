@@ -0,0 +1,150 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AARU_CHECKSUMS_NATIVE_STATE_H
+#define AARU_CHECKSUMS_NATIVE_STATE_H
+
+/*
+ * Exported context states start with a fixed header, followed by the algorithm
+ * specific payload. Every multi-byte value is stored in little-endian order, so
+ * a state can be resumed on a machine of different endianness.
+ *
+ * Offset  Size  Field
+ * 0       4     Magic, "ACST"
+ * 4       2     Format version
+ * 6       2     Algorithm identifier
+ * 8       4     Payload length
+ */
+#define STATE_MAGIC       0x54534341
+#define STATE_VERSION     1
+#define STATE_HEADER_SIZE 12
+
+#define STATE_ALGORITHM_ADLER32     1
+#define STATE_ALGORITHM_CRC16       2
+#define STATE_ALGORITHM_CRC16_CCITT 3
+#define STATE_ALGORITHM_CRC32       4
+#define STATE_ALGORITHM_CRC64       5
+#define STATE_ALGORITHM_FLETCHER16  6
+#define STATE_ALGORITHM_FLETCHER32  7
+#define STATE_ALGORITHM_SPAMSUM     8
+
+FORCE_INLINE uint8_t *state_put_u8(uint8_t *p, uint8_t v)
+{
+    p[0] = v;
+    return p + 1;
+}
+
+FORCE_INLINE uint8_t *state_put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+FORCE_INLINE uint8_t *state_put_u32(uint8_t *p, uint32_t v)
+{
+    p = state_put_u16(p, (uint16_t)v);
+    return state_put_u16(p, (uint16_t)(v >> 16));
+}
+
+FORCE_INLINE uint8_t *state_put_u64(uint8_t *p, uint64_t v)
+{
+    p = state_put_u32(p, (uint32_t)v);
+    return state_put_u32(p, (uint32_t)(v >> 32));
+}
+
+FORCE_INLINE const uint8_t *state_get_u8(const uint8_t *p, uint8_t *v)
+{
+    *v = p[0];
+    return p + 1;
+}
+
+FORCE_INLINE const uint8_t *state_get_u16(const uint8_t *p, uint16_t *v)
+{
+    *v = (uint16_t)(p[0] | (p[1] << 8));
+    return p + 2;
+}
+
+FORCE_INLINE const uint8_t *state_get_u32(const uint8_t *p, uint32_t *v)
+{
+    uint16_t lo, hi;
+
+    p  = state_get_u16(p, &lo);
+    p  = state_get_u16(p, &hi);
+    *v = (uint32_t)lo | ((uint32_t)hi << 16);
+    return p;
+}
+
+FORCE_INLINE const uint8_t *state_get_u64(const uint8_t *p, uint64_t *v)
+{
+    uint32_t lo, hi;
+
+    p  = state_get_u32(p, &lo);
+    p  = state_get_u32(p, &hi);
+    *v = (uint64_t)lo | ((uint64_t)hi << 32);
+    return p;
+}
+
+/**
+ * @brief Writes the common header of an exported state.
+ *
+ * @param p Pointer to the output buffer, with room for at least STATE_HEADER_SIZE bytes.
+ * @param algorithm Algorithm identifier.
+ * @param payload Length of the payload that follows the header.
+ *
+ * @return Pointer to where the payload starts.
+ */
+FORCE_INLINE uint8_t *state_put_header(uint8_t *p, uint16_t algorithm, uint32_t payload)
+{
+    p = state_put_u32(p, STATE_MAGIC);
+    p = state_put_u16(p, STATE_VERSION);
+    p = state_put_u16(p, algorithm);
+    return state_put_u32(p, payload);
+}
+
+/**
+ * @brief Validates the common header of an exported state.
+ *
+ * @param p Pointer to the exported state.
+ * @param len Length of the exported state.
+ * @param algorithm Algorithm identifier the state must belong to.
+ * @param payload Receives the payload length, which is guaranteed to fit in the buffer.
+ *
+ * @return Pointer to where the payload starts, or NULL if the header is not valid.
+ */
+FORCE_INLINE const uint8_t *state_get_header(const uint8_t *p, uint32_t len, uint16_t algorithm, uint32_t *payload)
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t id;
+
+    if(!p || len < STATE_HEADER_SIZE) return NULL;
+
+    p = state_get_u32(p, &magic);
+    p = state_get_u16(p, &version);
+    p = state_get_u16(p, &id);
+    p = state_get_u32(p, payload);
+
+    if(magic != STATE_MAGIC || version != STATE_VERSION || id != algorithm) return NULL;
+
+    if(*payload > len - STATE_HEADER_SIZE) return NULL;
+
+    return p;
+}
+
+#endif  // AARU_CHECKSUMS_NATIVE_STATE_H
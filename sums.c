@@ -0,0 +1,436 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "library.h"
+/* Each checksum defines its own NMAX, only their modulus is used here */
+#include "adler32.h"
+#undef NMAX
+#include "fletcher16.h"
+#undef NMAX
+#include "fletcher32.h"
+#include "simd.h"
+#include "sums.h"
+
+typedef void(AARU_CALL *sums_kernel)(uint32_t *sum1, uint32_t *sum2, const uint8_t *data, uint32_t len);
+typedef void(AARU_CALL *sums_batch_kernel)(uint32_t *sum1, uint32_t *sum2, const uint8_t *const *data, uint32_t len);
+
+/* Sets the initial values of the three checksums */
+static void sums_reset(sums_ctx *ctx)
+{
+    ctx->adler32_sum1    = 1;
+    ctx->adler32_sum2    = 0;
+    ctx->fletcher16_sum1 = 0xFF;
+    ctx->fletcher16_sum2 = 0xFF;
+    ctx->fletcher32_sum1 = 0xFFFF;
+    ctx->fletcher32_sum2 = 0xFFFF;
+}
+
+/**
+ * @brief Initializes the combined Adler-32, Fletcher-16 and Fletcher-32 checksums.
+ *
+ * The three checksums are calculated in a single pass over the data, for callers that need
+ * all of them.
+ *
+ * @return Pointer to a structure containing the checksum state.
+ */
+AARU_EXPORT sums_ctx *AARU_CALL sums_init()
+{
+    sums_ctx *ctx;
+
+    ctx = (sums_ctx *)malloc(sizeof(sums_ctx));
+
+    if(!ctx) return NULL;
+
+    sums_reset(ctx);
+
+    return ctx;
+}
+
+/**
+ * @brief Updates the combined checksums with new data.
+ *
+ * @param ctx Pointer to the combined checksums context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL sums_update(sums_ctx *ctx, const uint8_t *data, uint32_t len)
+{
+    return sums_update64(ctx, data, len);
+}
+
+/**
+ * @brief Chooses the best available kernel for the combined checksums.
+ *
+ * @return Kernel to use.
+ */
+static sums_kernel sums_select(void)
+{
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)) && !defined(__MINGW32__))
+    if(have_neon()) return sums_neon;
+#endif
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+    if(have_avx2()) return sums_avx2;
+
+    if(have_ssse3()) return sums_ssse3;
+#endif
+
+    return sums_swar;
+}
+
+/**
+ * @brief Chooses the best available batch kernel for the combined checksums.
+ *
+ * @return Kernel to use, or NULL if there is none.
+ */
+static sums_batch_kernel sums_select_batch(void)
+{
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)) && !defined(__MINGW32__))
+    if(have_neon()) return sums_batch_neon;
+#endif
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+    if(have_avx2()) return sums_batch_avx2;
+
+    if(have_ssse3()) return sums_batch_ssse3;
+#endif
+
+    return NULL;
+}
+
+/* Bytes of a word whose sums are gathered in a 16-bit lane, in packed 16-bit lanes */
+#define SUMS_SWAR_BYTES 0x00FF00FF00FF00FFULL
+/* Even 16-bit lanes of a word, as 32-bit lanes */
+#define SUMS_SWAR_WORDS 0x0000FFFF0000FFFFULL
+/* Words summed in 16-bit lanes before they are widened, so the weighted sums stay below 2^16 */
+#define SUMS_SWAR_BLOCK 16
+
+/* Offset in memory of the byte found in bits 8 * lane to 8 * lane + 7 of a loaded word */
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define SUMS_SWAR_OFFSET(lane) (7 - (lane))
+#else
+#define SUMS_SWAR_OFFSET(lane) (lane)
+#endif
+
+/* Second sum of a checksum after a block, from the sums of the block computed from zero */
+FORCE_INLINE uint32_t sums_second(uint32_t sum1, uint32_t sum2, uint32_t block_sum2, uint32_t len, uint32_t module)
+{
+    /* Every byte of the block adds the first sum from before the block to the second sum */
+    return (sum2 + len * sum1 % module + block_sum2 % module) % module;
+}
+
+/**
+ * @brief Adds the sums of a block, computed from zero by a kernel, to the three checksums.
+ *
+ * @param ctx Pointer to the combined checksums context structure.
+ * @param sum1 Sum of the bytes of the block.
+ * @param sum2 Sum of the running values of sum1 after each byte of the block.
+ * @param len Length of the block, at most SUMS_NMAX.
+ */
+static void sums_add(sums_ctx *ctx, uint32_t sum1, uint32_t sum2, uint32_t len)
+{
+    ctx->adler32_sum2 = (uint16_t)sums_second(ctx->adler32_sum1, ctx->adler32_sum2, sum2, len, ADLER_MODULE);
+    ctx->adler32_sum1 = (uint16_t)((ctx->adler32_sum1 + sum1) % ADLER_MODULE);
+
+    ctx->fletcher16_sum2 =
+        (uint8_t)sums_second(ctx->fletcher16_sum1, ctx->fletcher16_sum2, sum2, len, FLETCHER16_MODULE);
+    ctx->fletcher16_sum1 = (uint8_t)((ctx->fletcher16_sum1 + sum1) % FLETCHER16_MODULE);
+
+    ctx->fletcher32_sum2 =
+        (uint16_t)sums_second(ctx->fletcher32_sum1, ctx->fletcher32_sum2, sum2, len, FLETCHER32_MODULE);
+    ctx->fletcher32_sum1 = (uint16_t)((ctx->fletcher32_sum1 + sum1) % FLETCHER32_MODULE);
+}
+
+/**
+ * @brief Runs a kernel over data of any length, in blocks it can take.
+ *
+ * @param ctx Pointer to the combined checksums context structure.
+ * @param kernel Kernel to use.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ */
+static void sums_process(sums_ctx *ctx, sums_kernel kernel, const uint8_t *data, uint64_t len)
+{
+    uint32_t block, sum1, sum2;
+
+    while(len > 0)
+    {
+        block = len > SUMS_NMAX ? SUMS_NMAX : (uint32_t)len;
+
+        kernel(&sum1, &sum2, data, block);
+        sums_add(ctx, sum1, sum2, block);
+
+        data += block;
+        len -= block;
+    }
+}
+
+/**
+ * @brief Updates the combined checksums with new data of any length.
+ *
+ * The kernel computes the sums of each block once, and they are then reduced by the
+ * modulus of each checksum. The checksums are identical to the ones of adler32_update64(),
+ * fletcher16_update64() and fletcher32_update64() with the same data.
+ *
+ * @param ctx Pointer to the combined checksums context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL sums_update64(sums_ctx *ctx, const uint8_t *data, uint64_t len)
+{
+    if(!ctx || !data) return -1;
+
+    sums_process(ctx, sums_select(), data, len);
+
+    return 0;
+}
+
+/**
+ * @brief Returns the combined checksums.
+ *
+ * @param ctx Pointer to the combined checksums context structure.
+ * @param adler32 Receives the Adler-32 checksum, or NULL if not needed.
+ * @param fletcher16 Receives the Fletcher-16 checksum, or NULL if not needed.
+ * @param fletcher32 Receives the Fletcher-32 checksum, or NULL if not needed.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL sums_final(sums_ctx *ctx, uint32_t *adler32, uint16_t *fletcher16, uint32_t *fletcher32)
+{
+    if(!ctx) return -1;
+
+    if(adler32) *adler32 = (uint32_t)ctx->adler32_sum2 << 16 | ctx->adler32_sum1;
+    if(fletcher16) *fletcher16 = (uint16_t)(ctx->fletcher16_sum2 << 8 | ctx->fletcher16_sum1);
+    if(fletcher32) *fletcher32 = (uint32_t)ctx->fletcher32_sum2 << 16 | ctx->fletcher32_sum1;
+
+    return 0;
+}
+
+/**
+ * @brief Frees the resources allocated for the combined checksums context.
+ *
+ * @param ctx The combined checksums context structure, to be freed.
+ */
+AARU_EXPORT void AARU_CALL sums_free(sums_ctx *ctx)
+{
+    if(!ctx) return;
+
+    free(ctx);
+}
+
+/**
+ * @brief Calculates the combined checksums of many independent buffers.
+ *
+ * Short buffers spend much of their time setting up and reducing the vector sums. The
+ * buffers are taken SUMS_BATCH at a time instead, each one in its own accumulators, so a
+ * single pass and a single reduction serve all of them. The part of a group longer than
+ * its shortest buffer, and any buffers left over, go through the single buffer kernel.
+ *
+ * @param data Pointers to the buffers.
+ * @param len Lengths of the buffers.
+ * @param count Number of buffers.
+ * @param adler32 Receives the Adler-32 checksum of each buffer, or NULL if not needed.
+ * @param fletcher16 Receives the Fletcher-16 checksum of each buffer, or NULL if not needed.
+ * @param fletcher32 Receives the Fletcher-32 checksum of each buffer, or NULL if not needed.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL sums_batch(const uint8_t *const *data, const uint32_t *len, uint32_t count,
+                                     uint32_t *adler32, uint16_t *fletcher16, uint32_t *fletcher32)
+{
+    sums_kernel       kernel;
+    sums_batch_kernel batch;
+    sums_ctx          ctx[SUMS_BATCH];
+    const uint8_t    *blocks[SUMS_BATCH];
+    uint32_t          sum1[SUMS_BATCH], sum2[SUMS_BATCH];
+    uint32_t          i, j, group, common, done, block;
+
+    if(!data || !len) return -1;
+
+    for(i = 0; i < count; i++)
+        if(!data[i]) return -1;
+
+    kernel = sums_select();
+    batch  = sums_select_batch();
+
+    for(i = 0; i < count; i += group)
+    {
+        group  = count - i < SUMS_BATCH ? count - i : SUMS_BATCH;
+        common = 0;
+
+        /* All of them, not only the group, or LTO inlining raises a false -Wstringop-overflow */
+        for(j = 0; j < SUMS_BATCH; j++) sums_reset(&ctx[j]);
+
+        if(batch && group == SUMS_BATCH)
+        {
+            common = len[i];
+
+            for(j = 1; j < group; j++)
+                if(len[i + j] < common) common = len[i + j];
+        }
+
+        for(done = 0; done < common; done += block)
+        {
+            block = common - done > SUMS_NMAX ? SUMS_NMAX : common - done;
+
+            for(j = 0; j < group; j++) blocks[j] = data[i + j] + done;
+
+            batch(sum1, sum2, blocks, block);
+
+            for(j = 0; j < group; j++) sums_add(&ctx[j], sum1[j], sum2[j], block);
+        }
+
+        for(j = 0; j < group; j++)
+        {
+            sums_process(&ctx[j], kernel, data[i + j] + common, len[i + j] - common);
+            sums_final(&ctx[j], adler32 ? adler32 + i + j : NULL, fletcher16 ? fletcher16 + i + j : NULL,
+                       fletcher32 ? fletcher32 + i + j : NULL);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Calculates the sums of a block of data, starting from zero, without SIMD instructions.
+ *
+ * @param sum1 Receives the sum of the bytes.
+ * @param sum2 Receives the sum of the running values of sum1 after each byte.
+ * @param data Pointer to the data buffer.
+ * @param len Length of the data buffer in bytes, at most SUMS_NMAX.
+ */
+AARU_EXPORT void AARU_CALL sums_scalar(uint32_t *sum1, uint32_t *sum2, const uint8_t *data, uint32_t len)
+{
+    uint32_t s1 = 0;
+    uint32_t s2 = 0;
+
+    while(len >= 16)
+    {
+        s2 += (s1 += *data++);
+        s2 += (s1 += *data++);
+        s2 += (s1 += *data++);
+        s2 += (s1 += *data++);
+        s2 += (s1 += *data++);
+        s2 += (s1 += *data++);
+        s2 += (s1 += *data++);
+        s2 += (s1 += *data++);
+        s2 += (s1 += *data++);
+        s2 += (s1 += *data++);
+        s2 += (s1 += *data++);
+        s2 += (s1 += *data++);
+        s2 += (s1 += *data++);
+        s2 += (s1 += *data++);
+        s2 += (s1 += *data++);
+        s2 += (s1 += *data++);
+        len -= 16;
+    }
+
+    while(len--) s2 += (s1 += *data++);
+
+    *sum1 = s1;
+    *sum2 = s2;
+}
+
+/* Adds words of a block to the 32-bit lane sums of sums_swar(), see there */
+FORCE_INLINE void sums_swar_block(uint64_t *a, uint64_t *b, const uint8_t *data, uint32_t words)
+{
+    uint64_t even = 0, odd = 0, even_weighted = 0, odd_weighted = 0;
+    uint64_t word;
+    uint32_t i;
+
+    for(i = 0; i < words; i++)
+    {
+        memcpy(&word, data + i * 8, 8);
+
+        even += word & SUMS_SWAR_BYTES;
+        odd += word >> 8 & SUMS_SWAR_BYTES;
+        even_weighted += even;
+        odd_weighted += odd;
+    }
+
+    /* Every word of the block adds the sums from before it once more */
+    b[0] += a[0] * words + (even_weighted & SUMS_SWAR_WORDS);
+    b[1] += a[1] * words + (even_weighted >> 16 & SUMS_SWAR_WORDS);
+    b[2] += a[2] * words + (odd_weighted & SUMS_SWAR_WORDS);
+    b[3] += a[3] * words + (odd_weighted >> 16 & SUMS_SWAR_WORDS);
+    a[0] += even & SUMS_SWAR_WORDS;
+    a[1] += even >> 16 & SUMS_SWAR_WORDS;
+    a[2] += odd & SUMS_SWAR_WORDS;
+    a[3] += odd >> 16 & SUMS_SWAR_WORDS;
+}
+
+/**
+ * @brief Calculates the sums of a block of data, starting from zero, with 64-bit integer arithmetic.
+ *
+ * For targets without SIMD instructions. Each byte position of a 64-bit word is summed in its
+ * own lane, 8 bytes per addition, together with the sum of the running lane sums after each
+ * word. A byte at position k of word j, out of n words, adds 8 * (n - j) - k times itself to
+ * sum2, so sum2 is 8 times the weighted lane sums minus k times each lane sum. The lanes start
+ * as packed 16-bit ones and are widened to 32 bits every SUMS_SWAR_BLOCK words.
+ *
+ * @param sum1 Receives the sum of the bytes.
+ * @param sum2 Receives the sum of the running values of sum1 after each byte.
+ * @param data Pointer to the data buffer.
+ * @param len Length of the data buffer in bytes, at most SUMS_NMAX.
+ */
+AARU_EXPORT void AARU_CALL sums_swar(uint32_t *sum1, uint32_t *sum2, const uint8_t *data, uint32_t len)
+{
+    /* Lanes of bytes 0 and 4, 2 and 6, 1 and 5, and 3 and 7 of the words, as loaded */
+    uint64_t a[4] = {0, 0, 0, 0};
+    uint64_t b[4] = {0, 0, 0, 0};
+    uint32_t words = len / 8;
+    uint32_t s1    = 0;
+    uint32_t s2    = 0;
+    uint32_t lane, sum, weighted;
+
+    for(; words >= SUMS_SWAR_BLOCK; words -= SUMS_SWAR_BLOCK)
+    {
+        sums_swar_block(a, b, data, SUMS_SWAR_BLOCK);
+        data += SUMS_SWAR_BLOCK * 8;
+    }
+
+    if(words)
+    {
+        sums_swar_block(a, b, data, words);
+        data += words * 8;
+    }
+
+    for(lane = 0; lane < 8; lane++)
+    {
+        sum      = (uint32_t)(a[(lane & 1) * 2 + (lane >> 1 & 1)] >> (lane & 4) * 8);
+        weighted = (uint32_t)(b[(lane & 1) * 2 + (lane >> 1 & 1)] >> (lane & 4) * 8);
+
+        s1 += sum;
+        s2 += 8 * weighted - SUMS_SWAR_OFFSET(lane) * sum;
+    }
+
+    for(len %= 8; len; len--) s2 += (s1 += *data++);
+
+    *sum1 = s1;
+    *sum2 = s2;
+}
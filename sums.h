@@ -0,0 +1,77 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AARU_CHECKSUMS_NATIVE_SUMS_H
+#define AARU_CHECKSUMS_NATIVE_SUMS_H
+
+/*
+ * Adler-32, Fletcher-16 and Fletcher-32 all keep a sum of the bytes and a sum of the running
+ * first sums, and only differ in their modulus and initial values. The kernels compute both
+ * sums of a block once, starting from zero, and they are then added to each checksum.
+ */
+
+/* Largest multiple of 32 such that 255n(n+1)/2 <= 2^32-1, the most bytes a kernel can take */
+#define SUMS_NMAX  5792
+/* Number of buffers the batch kernels take at once */
+#define SUMS_BATCH 4
+/* Shortest input sums_swar() is faster than a byte at a time for */
+#define SUMS_SWAR_MIN 64
+
+typedef struct
+{
+    uint16_t adler32_sum1;
+    uint16_t adler32_sum2;
+    uint16_t fletcher32_sum1;
+    uint16_t fletcher32_sum2;
+    uint8_t  fletcher16_sum1;
+    uint8_t  fletcher16_sum2;
+} sums_ctx;
+
+AARU_EXPORT sums_ctx *AARU_CALL sums_init();
+AARU_EXPORT int AARU_CALL       sums_update(sums_ctx *ctx, const uint8_t *data, uint32_t len);
+AARU_EXPORT int AARU_CALL       sums_update64(sums_ctx *ctx, const uint8_t *data, uint64_t len);
+AARU_EXPORT int AARU_CALL       sums_final(sums_ctx *ctx, uint32_t *adler32, uint16_t *fletcher16,
+                                           uint32_t *fletcher32);
+AARU_EXPORT void AARU_CALL      sums_free(sums_ctx *ctx);
+AARU_EXPORT int AARU_CALL       sums_batch(const uint8_t *const *data, const uint32_t *len, uint32_t count,
+                                           uint32_t *adler32, uint16_t *fletcher16, uint32_t *fletcher32);
+AARU_EXPORT void AARU_CALL      sums_scalar(uint32_t *sum1, uint32_t *sum2, const uint8_t *data, uint32_t len);
+AARU_EXPORT void AARU_CALL      sums_swar(uint32_t *sum1, uint32_t *sum2, const uint8_t *data, uint32_t len);
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+AARU_EXPORT TARGET_WITH_SSSE3 void AARU_CALL sums_ssse3(uint32_t *sum1, uint32_t *sum2, const uint8_t *data,
+                                                        uint32_t len);
+AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL sums_avx2(uint32_t *sum1, uint32_t *sum2, const uint8_t *data,
+                                                      uint32_t len);
+AARU_EXPORT TARGET_WITH_SSSE3 void AARU_CALL sums_batch_ssse3(uint32_t *sum1, uint32_t *sum2,
+                                                              const uint8_t *const *data, uint32_t len);
+AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL sums_batch_avx2(uint32_t *sum1, uint32_t *sum2, const uint8_t *const *data,
+                                                            uint32_t len);
+
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+
+AARU_EXPORT void AARU_CALL sums_neon(uint32_t *sum1, uint32_t *sum2, const uint8_t *data, uint32_t len);
+AARU_EXPORT void AARU_CALL sums_batch_neon(uint32_t *sum1, uint32_t *sum2, const uint8_t *const *data, uint32_t len);
+
+#endif
+
+#endif  // AARU_CHECKSUMS_NATIVE_SUMS_H
@@ -0,0 +1,196 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ * Copyright (C) 1995-2011 Mark Adler
+ * Copyright (C) Jean-loup Gailly
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented; you must not
+ *     claim that you wrote the original software. If you use this software
+ *     in a product, an acknowledgment in the product documentation would be
+ *     appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such, and must not be
+ *     misrepresented as being the original software.
+ *  3. This notice may not be removed or altered from any source distribution.
+ */
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "library.h"
+#include "sums.h"
+#include "simd.h"
+
+/**
+ * @brief Calculates the sums of a block of data, starting from zero, using AVX2 instructions.
+ *
+ * This is the loop of adler32_avx2() without its modulo reductions, which are done per checksum
+ * by the caller.
+ *
+ * @param sum1 Receives the sum of the bytes.
+ * @param sum2 Receives the sum of the running values of sum1 after each byte.
+ * @param data Pointer to the data buffer.
+ * @param len Length of the data buffer in bytes, at most SUMS_NMAX.
+ */
+AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL sums_avx2(uint32_t *sum1, uint32_t *sum2, const uint8_t *data, uint32_t len)
+{
+    uint32_t s1 = 0;
+    uint32_t s2 = 0;
+
+    /*
+     * Process the data in blocks.
+     */
+    const unsigned BLOCK_SIZE = 1 << 5;
+    if(len >= BLOCK_SIZE)
+    {
+        unsigned n = len / BLOCK_SIZE;
+        len -= n * BLOCK_SIZE;
+
+        const __m256i tap  = _mm256_set_epi8(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
+                                             22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i ones = _mm256_set1_epi16(1);
+
+        __m256i v_ps = _mm256_setzero_si256();
+        __m256i v_s2 = _mm256_setzero_si256();
+        __m256i v_s1 = _mm256_setzero_si256();
+        do {
+            /*
+             * Load 32 input bytes.
+             */
+            const __m256i bytes = _mm256_lddqu_si256((__m256i *)(data));
+
+            /*
+             * Add previous block byte sum to v_ps.
+             */
+            v_ps              = _mm256_add_epi32(v_ps, v_s1);
+            /*
+             * Horizontally add the bytes for s1, multiply-adds the
+             * bytes by [ 32, 31, 30, ... ] for s2.
+             */
+            v_s1              = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes, zero));
+            const __m256i mad = _mm256_maddubs_epi16(bytes, tap);
+            v_s2              = _mm256_add_epi32(v_s2, _mm256_madd_epi16(mad, ones));
+
+            data += BLOCK_SIZE;
+        } while(--n);
+
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v_s1), _mm256_extracti128_si256(v_s1, 1));
+        __m128i hi  = _mm_unpackhi_epi64(sum, sum);
+        sum         = _mm_add_epi32(hi, sum);
+        hi          = _mm_shuffle_epi32(sum, 177);
+        sum         = _mm_add_epi32(sum, hi);
+        s1          = _mm_cvtsi128_si32(sum);
+
+        v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(v_ps, 5));
+        sum  = _mm_add_epi32(_mm256_castsi256_si128(v_s2), _mm256_extracti128_si256(v_s2, 1));
+        hi   = _mm_unpackhi_epi64(sum, sum);
+        sum  = _mm_add_epi32(hi, sum);
+        hi   = _mm_shuffle_epi32(sum, 177);
+        sum  = _mm_add_epi32(sum, hi);
+        s2   = _mm_cvtsi128_si32(sum);
+    }
+
+    /*
+     * Handle leftover data.
+     */
+    while(len--) s2 += (s1 += *data++);
+
+    *sum1 = s1;
+    *sum2 = s2;
+}
+
+/* Adds 32 bytes of a buffer to its accumulators */
+#define SUMS_BATCH_AVX2_STEP(p, v_s1, v_s2, v_ps)                                                                \
+    {                                                                                                            \
+        const __m256i bytes = _mm256_loadu_si256((const __m256i *)(p));                                          \
+        v_ps                = _mm256_add_epi32(v_ps, v_s1);                                                      \
+        v_s1                = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes, zero));                              \
+        v_s2                = _mm256_add_epi32(v_s2, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, tap), ones)); \
+        p += BLOCK_SIZE;                                                                                         \
+    }
+
+/* Sums the lanes of four vectors, giving one sum per vector */
+TARGET_WITH_AVX2 static inline __m128i sums_batch_avx2_reduce(__m256i v0, __m256i v1, __m256i v2, __m256i v3)
+{
+    const __m256i v = _mm256_hadd_epi32(_mm256_hadd_epi32(v0, v1), _mm256_hadd_epi32(v2, v3));
+
+    return _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+
+/**
+ * @brief Calculates the sums of SUMS_BATCH blocks of data, starting from zero, using AVX2 instructions.
+ *
+ * Each block has its own accumulators, and they are all reduced together at the end.
+ *
+ * @param sum1 Receives the sum of the bytes of each block.
+ * @param sum2 Receives the sum of the running values of sum1 after each byte of each block.
+ * @param data Pointers to the blocks.
+ * @param len Length of every block in bytes, at most SUMS_NMAX.
+ */
+AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL sums_batch_avx2(uint32_t *sum1, uint32_t *sum2, const uint8_t *const *data,
+                                                            uint32_t len)
+{
+    const unsigned BLOCK_SIZE = 1 << 5;
+    const uint8_t *p0         = data[0];
+    const uint8_t *p1         = data[1];
+    const uint8_t *p2         = data[2];
+    const uint8_t *p3         = data[3];
+    unsigned       n          = len / BLOCK_SIZE;
+    unsigned       i, j;
+
+    if(n)
+    {
+        const __m256i tap  = _mm256_set_epi8(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
+                                             22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i ones = _mm256_set1_epi16(1);
+
+        __m256i v_s1_0 = zero, v_s2_0 = zero, v_ps_0 = zero;
+        __m256i v_s1_1 = zero, v_s2_1 = zero, v_ps_1 = zero;
+        __m256i v_s1_2 = zero, v_s2_2 = zero, v_ps_2 = zero;
+        __m256i v_s1_3 = zero, v_s2_3 = zero, v_ps_3 = zero;
+
+        do {
+            SUMS_BATCH_AVX2_STEP(p0, v_s1_0, v_s2_0, v_ps_0);
+            SUMS_BATCH_AVX2_STEP(p1, v_s1_1, v_s2_1, v_ps_1);
+            SUMS_BATCH_AVX2_STEP(p2, v_s1_2, v_s2_2, v_ps_2);
+            SUMS_BATCH_AVX2_STEP(p3, v_s1_3, v_s2_3, v_ps_3);
+        } while(--n);
+
+        v_s2_0 = _mm256_add_epi32(v_s2_0, _mm256_slli_epi32(v_ps_0, 5));
+        v_s2_1 = _mm256_add_epi32(v_s2_1, _mm256_slli_epi32(v_ps_1, 5));
+        v_s2_2 = _mm256_add_epi32(v_s2_2, _mm256_slli_epi32(v_ps_2, 5));
+        v_s2_3 = _mm256_add_epi32(v_s2_3, _mm256_slli_epi32(v_ps_3, 5));
+
+        _mm_storeu_si128((__m128i *)sum1, sums_batch_avx2_reduce(v_s1_0, v_s1_1, v_s1_2, v_s1_3));
+        _mm_storeu_si128((__m128i *)sum2, sums_batch_avx2_reduce(v_s2_0, v_s2_1, v_s2_2, v_s2_3));
+    }
+    else
+        for(j = 0; j < SUMS_BATCH; j++) sum1[j] = sum2[j] = 0;
+
+    /*
+     * Handle leftover data.
+     */
+    for(j = 0; j < SUMS_BATCH; j++)
+    {
+        const uint8_t *p = data[j] + (len & ~(BLOCK_SIZE - 1));
+
+        for(i = len & (BLOCK_SIZE - 1); i; i--) sum2[j] += (sum1[j] += *p++);
+    }
+}
+
+#undef SUMS_BATCH_AVX2_STEP
+
+#endif
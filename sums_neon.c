@@ -0,0 +1,264 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ * Copyright 2017 The Chromium Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *    * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)))
+
+#include <arm_neon.h>
+
+#include "library.h"
+#include "sums.h"
+#include "simd.h"
+
+/**
+ * @brief Calculates the sums of a block of data, starting from zero, using NEON instructions.
+ *
+ * This is the loop of adler32_neon() without its modulo reductions, which are done per checksum
+ * by the caller.
+ *
+ * @param sum1 Receives the sum of the bytes.
+ * @param sum2 Receives the sum of the running values of sum1 after each byte.
+ * @param data Pointer to the data buffer.
+ * @param len Length of the data buffer in bytes, at most SUMS_NMAX.
+ */
+TARGET_WITH_NEON void sums_neon(uint32_t *sum1, uint32_t *sum2, const uint8_t *data, uint32_t len)
+{
+    uint32_t s1 = 0;
+    uint32_t s2 = 0;
+
+    /*
+     * Process the data in blocks.
+     */
+    const unsigned BLOCK_SIZE = 1 << 5;
+    if(len >= BLOCK_SIZE)
+    {
+        unsigned n = len / BLOCK_SIZE;
+        len -= n * BLOCK_SIZE;
+
+        uint32x4_t v_s2           = vdupq_n_u32(0);
+        uint32x4_t v_s1           = vdupq_n_u32(0);
+        uint16x8_t v_column_sum_1 = vdupq_n_u16(0);
+        uint16x8_t v_column_sum_2 = vdupq_n_u16(0);
+        uint16x8_t v_column_sum_3 = vdupq_n_u16(0);
+        uint16x8_t v_column_sum_4 = vdupq_n_u16(0);
+        do {
+            /*
+             * Load 32 input bytes.
+             */
+            const uint8x16_t bytes1 = vld1q_u8((uint8_t *)(data));
+            const uint8x16_t bytes2 = vld1q_u8((uint8_t *)(data + 16));
+            /*
+             * Add previous block byte sum to v_s2.
+             */
+            v_s2                    = vaddq_u32(v_s2, v_s1);
+            /*
+             * Horizontally add the bytes for s1.
+             */
+            v_s1                    = vpadalq_u16(v_s1, vpadalq_u8(vpaddlq_u8(bytes1), bytes2));
+            /*
+             * Vertically add the bytes for s2.
+             */
+            v_column_sum_1          = vaddw_u8(v_column_sum_1, vget_low_u8(bytes1));
+            v_column_sum_2          = vaddw_u8(v_column_sum_2, vget_high_u8(bytes1));
+            v_column_sum_3          = vaddw_u8(v_column_sum_3, vget_low_u8(bytes2));
+            v_column_sum_4          = vaddw_u8(v_column_sum_4, vget_high_u8(bytes2));
+            data += BLOCK_SIZE;
+        } while(--n);
+        v_s2 = vshlq_n_u32(v_s2, 5);
+        /*
+         * Multiply-add bytes by [ 32, 31, 30, ... ] for s2.
+         */
+#ifdef _MSC_VER
+#ifdef _M_ARM64
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_column_sum_1), neon_ld1m_16((uint16_t[]){32, 31, 30, 29}));
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_column_sum_1), neon_ld1m_16((uint16_t[]){28, 27, 26, 25}));
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_column_sum_2), neon_ld1m_16((uint16_t[]){24, 23, 22, 21}));
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_column_sum_2), neon_ld1m_16((uint16_t[]){20, 19, 18, 17}));
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_column_sum_3), neon_ld1m_16((uint16_t[]){16, 15, 14, 13}));
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_column_sum_3), neon_ld1m_16((uint16_t[]){12, 11, 10, 9}));
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_column_sum_4), neon_ld1m_16((uint16_t[]){8, 7, 6, 5}));
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_column_sum_4), neon_ld1m_16((uint16_t[]){4, 3, 2, 1}));
+#else
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_column_sum_1), vld1_u16(((uint16_t[]){32, 31, 30, 29})));
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_column_sum_1), vld1_u16(((uint16_t[]){28, 27, 26, 25})));
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_column_sum_2), vld1_u16(((uint16_t[]){24, 23, 22, 21})));
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_column_sum_2), vld1_u16(((uint16_t[]){20, 19, 18, 17})));
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_column_sum_3), vld1_u16(((uint16_t[]){16, 15, 14, 13})));
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_column_sum_3), vld1_u16(((uint16_t[]){12, 11, 10, 9})));
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_column_sum_4), vld1_u16(((uint16_t[]){8, 7, 6, 5})));
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_column_sum_4), vld1_u16(((uint16_t[]){4, 3, 2, 1})));
+#endif
+#else
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_column_sum_1), (uint16x4_t){32, 31, 30, 29});
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_column_sum_1), (uint16x4_t){28, 27, 26, 25});
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_column_sum_2), (uint16x4_t){24, 23, 22, 21});
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_column_sum_2), (uint16x4_t){20, 19, 18, 17});
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_column_sum_3), (uint16x4_t){16, 15, 14, 13});
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_column_sum_3), (uint16x4_t){12, 11, 10, 9});
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_column_sum_4), (uint16x4_t){8, 7, 6, 5});
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_column_sum_4), (uint16x4_t){4, 3, 2, 1});
+#endif
+        /*
+         * Sum epi32 ints v_s1(s2) and accumulate in s1(s2).
+         */
+        uint32x2_t t_s1 = vpadd_u32(vget_low_u32(v_s1), vget_high_u32(v_s1));
+        uint32x2_t t_s2 = vpadd_u32(vget_low_u32(v_s2), vget_high_u32(v_s2));
+        uint32x2_t s1s2 = vpadd_u32(t_s1, t_s2);
+        s1              = vget_lane_u32(s1s2, 0);
+        s2              = vget_lane_u32(s1s2, 1);
+    }
+
+    /*
+     * Handle leftover data.
+     */
+    while(len--) s2 += (s1 += *data++);
+
+    *sum1 = s1;
+    *sum2 = s2;
+}
+
+/* Weights of the bytes of a 32 byte step in the second sum */
+static const uint16_t sums_neon_taps[32] = {32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+                                            16, 15, 14, 13, 12, 11, 10, 9,  8,  7,  6,  5,  4,  3,  2,  1};
+
+/* Adds 32 bytes of a buffer to its accumulators */
+#define SUMS_BATCH_NEON_STEP(p, v_s1, v_s2, v_c1, v_c2, v_c3, v_c4)                          \
+    {                                                                                        \
+        const uint8x16_t bytes1 = vld1q_u8(p);                                               \
+        const uint8x16_t bytes2 = vld1q_u8(p + 16);                                          \
+        v_s2                    = vaddq_u32(v_s2, v_s1);                                     \
+        v_s1                    = vpadalq_u16(v_s1, vpadalq_u8(vpaddlq_u8(bytes1), bytes2)); \
+        v_c1                    = vaddw_u8(v_c1, vget_low_u8(bytes1));                       \
+        v_c2                    = vaddw_u8(v_c2, vget_high_u8(bytes1));                      \
+        v_c3                    = vaddw_u8(v_c3, vget_low_u8(bytes2));                       \
+        v_c4                    = vaddw_u8(v_c4, vget_high_u8(bytes2));                      \
+        p += BLOCK_SIZE;                                                                     \
+    }
+
+/* Multiply-adds the column sums of a buffer by [ 32, 31, 30, ... ] for s2 */
+#define SUMS_BATCH_NEON_FINISH(v_s2, v_c1, v_c2, v_c3, v_c4) \
+    {                                                        \
+        v_s2 = vshlq_n_u32(v_s2, 5);                         \
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_c1), tap1);    \
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_c1), tap2);   \
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_c2), tap3);    \
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_c2), tap4);   \
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_c3), tap5);    \
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_c3), tap6);   \
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(v_c4), tap7);    \
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(v_c4), tap8);   \
+    }
+
+/* Sums the lanes of four vectors, giving one sum per vector */
+TARGET_WITH_NEON static inline uint32x4_t sums_batch_neon_reduce(uint32x4_t v0, uint32x4_t v1, uint32x4_t v2,
+                                                                 uint32x4_t v3)
+{
+    const uint32x2_t r01 = vpadd_u32(vpadd_u32(vget_low_u32(v0), vget_high_u32(v0)),
+                                     vpadd_u32(vget_low_u32(v1), vget_high_u32(v1)));
+    const uint32x2_t r23 = vpadd_u32(vpadd_u32(vget_low_u32(v2), vget_high_u32(v2)),
+                                     vpadd_u32(vget_low_u32(v3), vget_high_u32(v3)));
+
+    return vcombine_u32(r01, r23);
+}
+
+/**
+ * @brief Calculates the sums of SUMS_BATCH blocks of data, starting from zero, using NEON instructions.
+ *
+ * Each block has its own accumulators, and they are all reduced together at the end.
+ *
+ * @param sum1 Receives the sum of the bytes of each block.
+ * @param sum2 Receives the sum of the running values of sum1 after each byte of each block.
+ * @param data Pointers to the blocks.
+ * @param len Length of every block in bytes, at most SUMS_NMAX.
+ */
+TARGET_WITH_NEON void sums_batch_neon(uint32_t *sum1, uint32_t *sum2, const uint8_t *const *data, uint32_t len)
+{
+    const unsigned BLOCK_SIZE = 1 << 5;
+    const uint8_t *p0         = data[0];
+    const uint8_t *p1         = data[1];
+    const uint8_t *p2         = data[2];
+    const uint8_t *p3         = data[3];
+    unsigned       n          = len / BLOCK_SIZE;
+    unsigned       i, j;
+
+    if(n)
+    {
+        uint32x4_t v_s1_0 = vdupq_n_u32(0), v_s2_0 = vdupq_n_u32(0);
+        uint32x4_t v_s1_1 = vdupq_n_u32(0), v_s2_1 = vdupq_n_u32(0);
+        uint32x4_t v_s1_2 = vdupq_n_u32(0), v_s2_2 = vdupq_n_u32(0);
+        uint32x4_t v_s1_3 = vdupq_n_u32(0), v_s2_3 = vdupq_n_u32(0);
+        uint16x8_t v_c1_0 = vdupq_n_u16(0), v_c2_0 = vdupq_n_u16(0), v_c3_0 = vdupq_n_u16(0), v_c4_0 = vdupq_n_u16(0);
+        uint16x8_t v_c1_1 = vdupq_n_u16(0), v_c2_1 = vdupq_n_u16(0), v_c3_1 = vdupq_n_u16(0), v_c4_1 = vdupq_n_u16(0);
+        uint16x8_t v_c1_2 = vdupq_n_u16(0), v_c2_2 = vdupq_n_u16(0), v_c3_2 = vdupq_n_u16(0), v_c4_2 = vdupq_n_u16(0);
+        uint16x8_t v_c1_3 = vdupq_n_u16(0), v_c2_3 = vdupq_n_u16(0), v_c3_3 = vdupq_n_u16(0), v_c4_3 = vdupq_n_u16(0);
+
+        do {
+            SUMS_BATCH_NEON_STEP(p0, v_s1_0, v_s2_0, v_c1_0, v_c2_0, v_c3_0, v_c4_0);
+            SUMS_BATCH_NEON_STEP(p1, v_s1_1, v_s2_1, v_c1_1, v_c2_1, v_c3_1, v_c4_1);
+            SUMS_BATCH_NEON_STEP(p2, v_s1_2, v_s2_2, v_c1_2, v_c2_2, v_c3_2, v_c4_2);
+            SUMS_BATCH_NEON_STEP(p3, v_s1_3, v_s2_3, v_c1_3, v_c2_3, v_c3_3, v_c4_3);
+        } while(--n);
+
+        const uint16x4_t tap1 = vld1_u16(sums_neon_taps);
+        const uint16x4_t tap2 = vld1_u16(sums_neon_taps + 4);
+        const uint16x4_t tap3 = vld1_u16(sums_neon_taps + 8);
+        const uint16x4_t tap4 = vld1_u16(sums_neon_taps + 12);
+        const uint16x4_t tap5 = vld1_u16(sums_neon_taps + 16);
+        const uint16x4_t tap6 = vld1_u16(sums_neon_taps + 20);
+        const uint16x4_t tap7 = vld1_u16(sums_neon_taps + 24);
+        const uint16x4_t tap8 = vld1_u16(sums_neon_taps + 28);
+
+        SUMS_BATCH_NEON_FINISH(v_s2_0, v_c1_0, v_c2_0, v_c3_0, v_c4_0);
+        SUMS_BATCH_NEON_FINISH(v_s2_1, v_c1_1, v_c2_1, v_c3_1, v_c4_1);
+        SUMS_BATCH_NEON_FINISH(v_s2_2, v_c1_2, v_c2_2, v_c3_2, v_c4_2);
+        SUMS_BATCH_NEON_FINISH(v_s2_3, v_c1_3, v_c2_3, v_c3_3, v_c4_3);
+
+        vst1q_u32(sum1, sums_batch_neon_reduce(v_s1_0, v_s1_1, v_s1_2, v_s1_3));
+        vst1q_u32(sum2, sums_batch_neon_reduce(v_s2_0, v_s2_1, v_s2_2, v_s2_3));
+    }
+    else
+        for(j = 0; j < SUMS_BATCH; j++) sum1[j] = sum2[j] = 0;
+
+    /*
+     * Handle leftover data.
+     */
+    for(j = 0; j < SUMS_BATCH; j++)
+    {
+        const uint8_t *p = data[j] + (len & ~(BLOCK_SIZE - 1));
+
+        for(i = len & (BLOCK_SIZE - 1); i; i--) sum2[j] += (sum1[j] += *p++);
+    }
+}
+
+#undef SUMS_BATCH_NEON_STEP
+#undef SUMS_BATCH_NEON_FINISH
+
+#endif
@@ -0,0 +1,202 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ * Copyright 2017 The Chromium Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *    * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+#include <stdint.h>
+#include <tmmintrin.h>
+
+#include "library.h"
+#include "sums.h"
+
+/**
+ * @brief Calculates the sums of a block of data, starting from zero, using SSSE3 instructions.
+ *
+ * This is the loop of adler32_ssse3() without its modulo reductions, which are done per checksum
+ * by the caller.
+ *
+ * @param sum1 Receives the sum of the bytes.
+ * @param sum2 Receives the sum of the running values of sum1 after each byte.
+ * @param data Pointer to the data buffer.
+ * @param len Length of the data buffer in bytes, at most SUMS_NMAX.
+ */
+AARU_EXPORT TARGET_WITH_SSSE3 void AARU_CALL sums_ssse3(uint32_t *sum1, uint32_t *sum2, const uint8_t *data,
+                                                        uint32_t len)
+{
+    uint32_t s1 = 0;
+    uint32_t s2 = 0;
+
+    /*
+     * Process the data in blocks.
+     */
+    const unsigned BLOCK_SIZE = 1 << 5;
+    if(len >= BLOCK_SIZE)
+    {
+        unsigned n = len / BLOCK_SIZE;
+        len -= n * BLOCK_SIZE;
+
+        const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+        const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+        const __m128i zero = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+        const __m128i ones = _mm_set_epi16(1, 1, 1, 1, 1, 1, 1, 1);
+
+        __m128i v_ps = _mm_set_epi32(0, 0, 0, 0);
+        __m128i v_s2 = _mm_set_epi32(0, 0, 0, 0);
+        __m128i v_s1 = _mm_set_epi32(0, 0, 0, 0);
+        do {
+            /*
+             * Load 32 input bytes.
+             */
+            const __m128i bytes1 = _mm_loadu_si128((__m128i *)(data));
+            const __m128i bytes2 = _mm_loadu_si128((__m128i *)(data + 16));
+            /*
+             * Add previous block byte sum to v_ps.
+             */
+            v_ps                 = _mm_add_epi32(v_ps, v_s1);
+            /*
+             * Horizontally add the bytes for s1, multiply-adds the
+             * bytes by [ 32, 31, 30, ... ] for s2.
+             */
+            v_s1                 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+            const __m128i mad1   = _mm_maddubs_epi16(bytes1, tap1);
+            v_s2                 = _mm_add_epi32(v_s2, _mm_madd_epi16(mad1, ones));
+            v_s1                 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+            const __m128i mad2   = _mm_maddubs_epi16(bytes2, tap2);
+            v_s2                 = _mm_add_epi32(v_s2, _mm_madd_epi16(mad2, ones));
+            data += BLOCK_SIZE;
+        } while(--n);
+        v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+        /*
+         * Sum epi32 ints v_s1(s2) and accumulate in s1(s2).
+         */
+#define S23O1 _MM_SHUFFLE(2, 3, 0, 1) /* A B C D -> B A D C */
+#define S1O32 _MM_SHUFFLE(1, 0, 3, 2) /* A B C D -> C D A B */
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, S23O1));
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, S1O32));
+        s1   = _mm_cvtsi128_si32(v_s1);
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, S23O1));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, S1O32));
+        s2   = _mm_cvtsi128_si32(v_s2);
+#undef S23O1
+#undef S1O32
+    }
+
+    /*
+     * Handle leftover data.
+     */
+    while(len--) s2 += (s1 += *data++);
+
+    *sum1 = s1;
+    *sum2 = s2;
+}
+
+/* Adds 16 bytes of a buffer to its accumulators */
+#define SUMS_BATCH_SSSE3_STEP(p, v_s1, v_s2, v_ps)                                                      \
+    {                                                                                                   \
+        const __m128i bytes = _mm_loadu_si128((const __m128i *)(p));                                    \
+        v_ps                = _mm_add_epi32(v_ps, v_s1);                                                \
+        v_s1                = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes, zero));                           \
+        v_s2                = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes, tap), ones)); \
+        p += BLOCK_SIZE;                                                                                \
+    }
+
+/* Sums the lanes of four vectors, giving one sum per vector */
+TARGET_WITH_SSSE3 static inline __m128i sums_batch_ssse3_reduce(__m128i v0, __m128i v1, __m128i v2, __m128i v3)
+{
+    return _mm_hadd_epi32(_mm_hadd_epi32(v0, v1), _mm_hadd_epi32(v2, v3));
+}
+
+/**
+ * @brief Calculates the sums of SUMS_BATCH blocks of data, starting from zero, using SSSE3 instructions.
+ *
+ * Each block has its own accumulators, and they are all reduced together at the end.
+ *
+ * @param sum1 Receives the sum of the bytes of each block.
+ * @param sum2 Receives the sum of the running values of sum1 after each byte of each block.
+ * @param data Pointers to the blocks.
+ * @param len Length of every block in bytes, at most SUMS_NMAX.
+ */
+AARU_EXPORT TARGET_WITH_SSSE3 void AARU_CALL sums_batch_ssse3(uint32_t *sum1, uint32_t *sum2,
+                                                              const uint8_t *const *data, uint32_t len)
+{
+    const unsigned BLOCK_SIZE = 1 << 4;
+    const uint8_t *p0         = data[0];
+    const uint8_t *p1         = data[1];
+    const uint8_t *p2         = data[2];
+    const uint8_t *p3         = data[3];
+    unsigned       n          = len / BLOCK_SIZE;
+    unsigned       i, j;
+
+    if(n)
+    {
+        const __m128i tap  = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i ones = _mm_set1_epi16(1);
+
+        __m128i v_s1_0 = zero, v_s2_0 = zero, v_ps_0 = zero;
+        __m128i v_s1_1 = zero, v_s2_1 = zero, v_ps_1 = zero;
+        __m128i v_s1_2 = zero, v_s2_2 = zero, v_ps_2 = zero;
+        __m128i v_s1_3 = zero, v_s2_3 = zero, v_ps_3 = zero;
+
+        do {
+            SUMS_BATCH_SSSE3_STEP(p0, v_s1_0, v_s2_0, v_ps_0);
+            SUMS_BATCH_SSSE3_STEP(p1, v_s1_1, v_s2_1, v_ps_1);
+            SUMS_BATCH_SSSE3_STEP(p2, v_s1_2, v_s2_2, v_ps_2);
+            SUMS_BATCH_SSSE3_STEP(p3, v_s1_3, v_s2_3, v_ps_3);
+        } while(--n);
+
+        v_s2_0 = _mm_add_epi32(v_s2_0, _mm_slli_epi32(v_ps_0, 4));
+        v_s2_1 = _mm_add_epi32(v_s2_1, _mm_slli_epi32(v_ps_1, 4));
+        v_s2_2 = _mm_add_epi32(v_s2_2, _mm_slli_epi32(v_ps_2, 4));
+        v_s2_3 = _mm_add_epi32(v_s2_3, _mm_slli_epi32(v_ps_3, 4));
+
+        _mm_storeu_si128((__m128i *)sum1, sums_batch_ssse3_reduce(v_s1_0, v_s1_1, v_s1_2, v_s1_3));
+        _mm_storeu_si128((__m128i *)sum2, sums_batch_ssse3_reduce(v_s2_0, v_s2_1, v_s2_2, v_s2_3));
+    }
+    else
+        for(j = 0; j < SUMS_BATCH; j++) sum1[j] = sum2[j] = 0;
+
+    /*
+     * Handle leftover data.
+     */
+    for(j = 0; j < SUMS_BATCH; j++)
+    {
+        const uint8_t *p = data[j] + (len & ~(BLOCK_SIZE - 1));
+
+        for(i = len & (BLOCK_SIZE - 1); i; i--) sum2[j] += (sum1[j] += *p++);
+    }
+}
+
+#undef SUMS_BATCH_SSSE3_STEP
+
+#endif
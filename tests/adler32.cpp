@@ -2,6 +2,7 @@
 // Created by claunia on 5/10/21.
 //
 
+#include <algorithm>
 #include <climits>
 #include <cstdint>
 #include <cstring>
@@ -73,6 +74,325 @@ TEST_F(adler32Fixture, adler32_auto)
     EXPECT_EQ(adler32, EXPECTED_ADLER32);
 }
 
+TEST_F(adler32Fixture, adler32_update64)
+{
+    adler32_ctx *ctx = adler32_init();
+    uint32_t     adler32;
+
+    EXPECT_NE(ctx, nullptr);
+
+    adler32_update64(ctx, buffer, 1048576);
+    adler32_final(ctx, &adler32);
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+}
+
+TEST_F(adler32Fixture, adler32_buffered)
+{
+    adler32_ctx *ctx = adler32_init();
+    uint32_t     adler32;
+    uint32_t     pos;
+    uint32_t     slice;
+    uint32_t     len;
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_EQ(adler32_set_buffered(ctx, 512), 0);
+
+    // Feed the data in small, uneven slices so partial buffers, fills and direct passes all happen
+    pos = 0;
+    for(slice = 1; pos < 1048576; slice = slice % 1031 + 7)
+    {
+        len = 1048576 - pos < slice ? 1048576 - pos : slice;
+        adler32_update(ctx, buffer + pos, len);
+        pos += len;
+    }
+
+    adler32_final(ctx, &adler32);
+    adler32_free(ctx);
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+}
+
+TEST_F(adler32Fixture, adler32_export_state)
+{
+    adler32_ctx *ctx = adler32_init();
+    uint32_t     adler32;
+    uint8_t      state[ADLER32_STATE_SIZE];
+
+    EXPECT_NE(ctx, nullptr);
+
+    adler32_update(ctx, buffer, 524288);
+
+    EXPECT_EQ(adler32_export_state(ctx, nullptr, 0), ADLER32_STATE_SIZE);
+    EXPECT_EQ(adler32_export_state(ctx, state, sizeof(state)), ADLER32_STATE_SIZE);
+    adler32_free(ctx);
+
+    // Resume from the checkpoint as a new context
+    ctx = adler32_import_state(state, sizeof(state));
+
+    EXPECT_NE(ctx, nullptr);
+
+    adler32_update(ctx, buffer + 524288, 524288);
+    adler32_final(ctx, &adler32);
+    adler32_free(ctx);
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+
+    state[4]++;
+    EXPECT_EQ(adler32_import_state(state, sizeof(state)), nullptr);
+}
+
+TEST_F(adler32Fixture, adler32_clone)
+{
+    adler32_ctx *ctx = adler32_init();
+    adler32_ctx *clone;
+    uint32_t     adler32;
+
+    EXPECT_NE(ctx, nullptr);
+
+    adler32_update(ctx, buffer, 524288);
+
+    clone = adler32_clone(ctx);
+
+    EXPECT_NE(clone, nullptr);
+
+    // Both branches must continue independently from the shared prefix
+    adler32_update(clone, buffer + 524288, 524288);
+    adler32_final(clone, &adler32);
+    adler32_free(clone);
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+
+    adler32_update(ctx, buffer + 524288, 524288);
+    adler32_final(ctx, &adler32);
+    adler32_free(ctx);
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+}
+
+TEST_F(adler32Fixture, adler32_combine)
+{
+    static const uint32_t splits[] = {0, 1, 15, 5552, 524288, 1048575, 1048576};
+    adler32_ctx *ctx;
+    uint32_t     first;
+    uint32_t     second;
+    size_t       i;
+
+    // Split points at both ends of the buffer and inside and at the edges of the kernels' blocks
+    for(i = 0; i < sizeof(splits) / sizeof(splits[0]); i++)
+    {
+        ctx = adler32_init();
+        adler32_update(ctx, buffer, splits[i]);
+        adler32_final(ctx, &first);
+        adler32_free(ctx);
+
+        ctx = adler32_init();
+        adler32_update(ctx, buffer + splits[i], 1048576 - splits[i]);
+        adler32_final(ctx, &second);
+        adler32_free(ctx);
+
+        EXPECT_EQ(adler32_combine(first, second, 1048576 - splits[i]), EXPECTED_ADLER32);
+    }
+}
+
+TEST_F(adler32Fixture, adler32_update_parallel)
+{
+    adler32_ctx *ctx = adler32_init();
+    uint32_t     adler32;
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_EQ(adler32_set_buffered(ctx, 512), 0);
+
+    // Leave some data pending in the staging buffer, it must be checksummed before the parallel blocks
+    adler32_update(ctx, buffer, 100);
+
+    EXPECT_EQ(adler32_update_parallel(ctx, buffer + 100, 1048476, 4), 0);
+    adler32_final(ctx, &adler32);
+    adler32_free(ctx);
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+}
+
+TEST_F(adler32Fixture, adler32_update_run)
+{
+    static const uint64_t counts[] = {1, 63, 5552, 65521, 1048576, 0x100000001ULL};
+    uint8_t              *data     = (uint8_t *)malloc(2352 + 1048576);
+    adler32_ctx          *ctx;
+    uint32_t              expected;
+    uint32_t              adler32;
+    size_t                i;
+
+    // Sector data followed by a filler run, checked against the same bytes fed to the kernels
+    memcpy(data, buffer, 2352);
+    memset(data + 2352, 0xF6, 1048576);
+
+    for(i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+    {
+        ctx = adler32_init();
+        adler32_update(ctx, buffer, 2352);
+        EXPECT_EQ(adler32_update_run(ctx, 0xF6, counts[i]), 0);
+        adler32_final(ctx, &adler32);
+        adler32_free(ctx);
+
+        if(counts[i] > 1048576) continue;
+
+        ctx = adler32_init();
+        adler32_update(ctx, data, 2352 + (uint32_t)counts[i]);
+        adler32_final(ctx, &expected);
+        adler32_free(ctx);
+
+        EXPECT_EQ(adler32, expected);
+    }
+
+    // A run longer than 4GiB, split in pieces that the closed form must add up to the same value
+    ctx = adler32_init();
+    adler32_update(ctx, buffer, 2352);
+    adler32_update_run(ctx, 0xF6, 0x80000000ULL);
+    adler32_update_run(ctx, 0xF6, 0x80000000ULL);
+    adler32_update_run(ctx, 0xF6, 1);
+    adler32_final(ctx, &expected);
+    adler32_free(ctx);
+
+    EXPECT_EQ(adler32, expected);
+
+    free(data);
+}
+
+TEST_F(adler32Fixture, adler32_run_detection)
+{
+    uint8_t     *image = (uint8_t *)malloc(1048576);
+    adler32_ctx *ctx;
+    uint32_t     expected;
+    uint32_t     adler32;
+
+    // Runs at the start, in the middle, too short to detect and at the end of the data
+    memcpy(image, buffer, 1048576);
+    memset(image, 0x00, 4096);
+    memset(image + 100001, 0xF6, 200000);
+    memset(image + 600000, 0xE5, 511);
+    memset(image + 700000, 0xFF, 63);
+    memset(image + 1043576, 0xFF, 5000);
+
+    ctx = adler32_init();
+    adler32_update(ctx, image, 1048576);
+    adler32_final(ctx, &expected);
+    adler32_free(ctx);
+
+    ctx = adler32_init();
+    EXPECT_EQ(adler32_set_run_detection(ctx, 256), 0);
+    adler32_update(ctx, image, 1048576);
+    adler32_final(ctx, &adler32);
+    adler32_free(ctx);
+
+    EXPECT_EQ(adler32, expected);
+
+    // Without any run in the data
+    ctx = adler32_init();
+    EXPECT_EQ(adler32_set_run_detection(ctx, 1), 0);
+    adler32_update(ctx, buffer, 1048576);
+    adler32_final(ctx, &adler32);
+    adler32_free(ctx);
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+
+    free(image);
+}
+
+TEST_F(adler32Fixture, adler32_rolling)
+{
+    adler32_rolling_ctx *ctx;
+    adler32_ctx         *expected_ctx;
+    uint32_t             expected;
+    uint32_t             adler32;
+    int                  i;
+
+    ctx = adler32_rolling_init(buffer, 2352);
+    EXPECT_NE(ctx, nullptr);
+
+    adler32_rolling_checksum(ctx, &adler32);
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32_2352BYTES);
+
+    for(i = 0; i < 3000; i++) EXPECT_EQ(adler32_rolling_roll(ctx, buffer[i], buffer[i + 2352]), 0);
+
+    adler32_rolling_checksum(ctx, &adler32);
+    adler32_rolling_free(ctx);
+
+    expected_ctx = adler32_init();
+    adler32_update(expected_ctx, buffer + 3000, 2352);
+    adler32_final(expected_ctx, &expected);
+    adler32_free(expected_ctx);
+
+    EXPECT_EQ(adler32, expected);
+
+    EXPECT_EQ(adler32_rolling_init(buffer, 0), nullptr);
+    EXPECT_EQ(adler32_rolling_init(buffer, ADLER32_ROLLING_MAX_WINDOW + 1), nullptr);
+}
+
+TEST_F(adler32Fixture, adler32_rolling_values)
+{
+    uint32_t    *values = (uint32_t *)malloc(65536 * sizeof(uint32_t));
+    adler32_ctx *ctx;
+    uint32_t     expected;
+    int          offsets[] = {0, 1, 7, 8, 1023, 1024, 40000, 65535};
+    int          i;
+
+    EXPECT_EQ(adler32_rolling_values(buffer, 65535 + 2352, 2352, values), 0);
+
+    EXPECT_EQ(values[0], EXPECTED_ADLER32_2352BYTES);
+
+    for(i = 0; i < (int)(sizeof(offsets) / sizeof(offsets[0])); i++)
+    {
+        ctx = adler32_init();
+        adler32_update(ctx, buffer + offsets[i], 2352);
+        adler32_final(ctx, &expected);
+        adler32_free(ctx);
+
+        EXPECT_EQ(values[offsets[i]], expected);
+    }
+
+    EXPECT_EQ(adler32_rolling_values(buffer, 2351, 2352, values), -1);
+
+    free(values);
+}
+
+TEST_F(adler32Fixture, adler32_rolling_scan)
+{
+    uint8_t     *image = (uint8_t *)malloc(16 * 2352 + 7);
+    uint32_t     signatures[16];
+    uint64_t     offsets[16];
+    adler32_ctx *ctx;
+    int          i;
+
+    // Signatures of the blocks of the reference, found again after 7 new bytes
+    for(i = 0; i < 16; i++)
+    {
+        ctx = adler32_init();
+        adler32_update(ctx, buffer + i * 2352, 2352);
+        adler32_final(ctx, &signatures[i]);
+        adler32_free(ctx);
+    }
+
+    std::sort(signatures, signatures + 16);
+
+    memset(image, 0xAA, 7);
+    memcpy(image + 7, buffer, 16 * 2352);
+
+    EXPECT_EQ(adler32_rolling_scan(image, 16 * 2352 + 7, 2352, signatures, 16, offsets, 16), 16);
+
+    for(i = 0; i < 16; i++) EXPECT_EQ(offsets[i], (uint64_t)(7 + i * 2352));
+
+    // Resuming after the maximum is reached
+    EXPECT_EQ(adler32_rolling_scan(image, 16 * 2352 + 7, 2352, signatures, 16, offsets, 3), 3);
+    EXPECT_EQ(offsets[2], (uint64_t)(7 + 2 * 2352));
+
+    std::swap(signatures[0], signatures[1]);
+
+    EXPECT_EQ(adler32_rolling_scan(image, 16 * 2352 + 7, 2352, signatures, 16, offsets, 16), -1);
+
+    free(image);
+}
+
 TEST_F(adler32Fixture, adler32_slicing)
 {
     uint16_t sum1;
@@ -234,6 +554,70 @@ TEST_F(adler32Fixture, adler32_slicing_2352bytes)
     EXPECT_EQ(adler32, EXPECTED_ADLER32_2352BYTES);
 }
 
+TEST_F(adler32Fixture, adler32_swar)
+{
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_swar(&sum1, &sum2, buffer, 1048576);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+}
+
+TEST_F(adler32Fixture, adler32_swar_misaligned)
+{
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_swar(&sum1, &sum2, buffer_misaligned + 1, 1048576);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+}
+
+TEST_F(adler32Fixture, adler32_swar_63bytes)
+{
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_swar(&sum1, &sum2, buffer, 63);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32_63BYTES);
+}
+
+TEST_F(adler32Fixture, adler32_swar_2352bytes)
+{
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_swar(&sum1, &sum2, buffer, 2352);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32_2352BYTES);
+}
+
 #if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)) && !defined(_WIN32))
 TEST_F(adler32Fixture, adler32_neon)
 {
@@ -343,6 +727,33 @@ TEST_F(adler32Fixture, adler32_neon_2352bytes)
     EXPECT_EQ(adler32, EXPECTED_ADLER32_2352BYTES);
 }
 
+TEST_F(adler32Fixture, adler32_rolling_neon)
+{
+    if(!have_neon()) return;
+
+    uint32_t *expected = (uint32_t *)malloc(10000 * sizeof(uint32_t));
+    uint32_t *values   = (uint32_t *)malloc(10000 * sizeof(uint32_t));
+    uint32_t  sum1     = 0;
+    uint32_t  sum2     = 0;
+    uint32_t  expected_sum1, expected_sum2;
+    int       i;
+
+    for(i = 0; i < 2352; i++) sum2 += sum1 += buffer[i];
+
+    expected_sum1 = sum1;
+    expected_sum2 = sum2;
+
+    adler32_rolling_scalar(&expected_sum1, &expected_sum2, buffer, 2352, expected, 9999);
+    adler32_rolling_neon(&sum1, &sum2, buffer, 2352, values, 9999);
+
+    EXPECT_EQ(sum1, expected_sum1);
+    EXPECT_EQ(sum2, expected_sum2);
+    EXPECT_EQ(memcmp(values, expected, 9999 * sizeof(uint32_t)), 0);
+
+    free(expected);
+    free(values);
+}
+
 #endif
 
 #if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
@@ -564,4 +975,276 @@ TEST_F(adler32Fixture, adler32_ssse3_2352bytes)
     EXPECT_EQ(adler32, EXPECTED_ADLER32_2352BYTES);
 }
 
+TEST_F(adler32Fixture, adler32_avx512_vnni)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_avx512_vnni(&sum1, &sum2, buffer, 1048576);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+}
+
+TEST_F(adler32Fixture, adler32_avx512_vnni_misaligned)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_avx512_vnni(&sum1, &sum2, buffer_misaligned + 1, 1048576);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+}
+
+TEST_F(adler32Fixture, adler32_avx512_vnni_15bytes)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_avx512_vnni(&sum1, &sum2, buffer, 15);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32_15BYTES);
+}
+
+TEST_F(adler32Fixture, adler32_avx512_vnni_31bytes)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_avx512_vnni(&sum1, &sum2, buffer, 31);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32_31BYTES);
+}
+
+TEST_F(adler32Fixture, adler32_avx512_vnni_63bytes)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_avx512_vnni(&sum1, &sum2, buffer, 63);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32_63BYTES);
+}
+
+TEST_F(adler32Fixture, adler32_avx512_vnni_2352bytes)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_avx512_vnni(&sum1, &sum2, buffer, 2352);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32_2352BYTES);
+}
+
+TEST_F(adler32Fixture, adler32_avx_vnni)
+{
+    if(!have_avx_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_avx_vnni(&sum1, &sum2, buffer, 1048576);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+}
+
+TEST_F(adler32Fixture, adler32_avx_vnni_misaligned)
+{
+    if(!have_avx_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_avx_vnni(&sum1, &sum2, buffer_misaligned + 1, 1048576);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+}
+
+TEST_F(adler32Fixture, adler32_avx_vnni_15bytes)
+{
+    if(!have_avx_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_avx_vnni(&sum1, &sum2, buffer, 15);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32_15BYTES);
+}
+
+TEST_F(adler32Fixture, adler32_avx_vnni_31bytes)
+{
+    if(!have_avx_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_avx_vnni(&sum1, &sum2, buffer, 31);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32_31BYTES);
+}
+
+TEST_F(adler32Fixture, adler32_avx_vnni_63bytes)
+{
+    if(!have_avx_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_avx_vnni(&sum1, &sum2, buffer, 63);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32_63BYTES);
+}
+
+TEST_F(adler32Fixture, adler32_avx_vnni_2352bytes)
+{
+    if(!have_avx_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t adler32;
+
+    sum1 = 1;
+    sum2 = 0;
+
+    adler32_avx_vnni(&sum1, &sum2, buffer, 2352);
+
+    adler32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32_2352BYTES);
+}
+
+TEST_F(adler32Fixture, adler32_rolling_avx2)
+{
+    if(!have_avx2()) return;
+
+    uint32_t *expected = (uint32_t *)malloc(10000 * sizeof(uint32_t));
+    uint32_t *values   = (uint32_t *)malloc(10000 * sizeof(uint32_t));
+    uint32_t  sum1     = 0;
+    uint32_t  sum2     = 0;
+    uint32_t  expected_sum1, expected_sum2;
+    int       i;
+
+    for(i = 0; i < 2352; i++) sum2 += sum1 += buffer[i];
+
+    expected_sum1 = sum1;
+    expected_sum2 = sum2;
+
+    adler32_rolling_scalar(&expected_sum1, &expected_sum2, buffer, 2352, expected, 9999);
+    adler32_rolling_avx2(&sum1, &sum2, buffer, 2352, values, 9999);
+
+    EXPECT_EQ(sum1, expected_sum1);
+    EXPECT_EQ(sum2, expected_sum2);
+    EXPECT_EQ(memcmp(values, expected, 9999 * sizeof(uint32_t)), 0);
+
+    free(expected);
+    free(values);
+}
+
+TEST_F(adler32Fixture, adler32_rolling_filter_avx2)
+{
+    if(!have_avx2()) return;
+
+    uint32_t *filter = (uint32_t *)calloc(1 << 16 >> 5, sizeof(uint32_t));
+    uint32_t  values[1001];
+    uint32_t  expected[1001];
+    uint32_t  candidates[1001];
+    uint32_t  count;
+    int       i;
+
+    memcpy(values, buffer, sizeof(values));
+
+    // Every tenth checksum and some others by chance
+    for(i = 0; i < 1001; i += 10)
+    {
+        uint32_t hash = values[i] * ADLER32_ROLLING_HASH >> 16;
+        filter[hash >> 5] |= 1U << (hash & 31);
+    }
+
+    count = adler32_rolling_filter_scalar(values, 1001, filter, 16, expected);
+
+    EXPECT_GE(count, 101U);
+    EXPECT_EQ(adler32_rolling_filter_avx2(values, 1001, filter, 16, candidates), count);
+    EXPECT_EQ(memcmp(candidates, expected, count * sizeof(uint32_t)), 0);
+
+    free(filter);
+}
+
 #endif
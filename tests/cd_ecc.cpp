@@ -0,0 +1,343 @@
+//
+// Created by claunia on 5/10/21.
+//
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+#include "../library.h"
+#include "../cd_ecc.h"
+#include "../cd_edc.h"
+#include "gtest/gtest.h"
+
+// EDC of the sectors after computing their parity, that changes if any parity byte does
+#define EXPECTED_CD_ECC_MODE1       0x0E93E6E3
+#define EXPECTED_CD_ECC_MODE2_FORM1 0x0FF5157B
+
+#define SECTORS 70
+
+static const uint8_t *buffer;
+
+class cdEccFixture : public ::testing::Test
+{
+public:
+    cdEccFixture()
+    {
+        // initialization;
+        // can also be done in SetUp()
+    }
+
+protected:
+    void SetUp()
+    {
+        char path[PATH_MAX];
+        char filename[PATH_MAX];
+
+        getcwd(path, PATH_MAX);
+        snprintf(filename, PATH_MAX, "%s/data/random", path);
+
+        FILE *file = fopen(filename, "rb");
+        buffer     = (const uint8_t *)malloc(1048576);
+        fread((void *)buffer, 1, 1048576, file);
+        fclose(file);
+    }
+
+    void TearDown() { free((void *)buffer); }
+
+    ~cdEccFixture()
+    {
+        // resources cleanup, no exceptions allowed
+    }
+
+    // shared user data
+};
+
+static bool passed(const uint64_t *bitmap, uint32_t i) { return (bitmap[i / 64] >> (i % 64)) & 1; }
+
+TEST_F(cdEccFixture, cd_ecc_generate_mode1)
+{
+    uint8_t *sectors = (uint8_t *)malloc(SECTORS * CD_SECTOR_SIZE);
+
+    memcpy(sectors, buffer, SECTORS * CD_SECTOR_SIZE);
+
+    EXPECT_EQ(cd_ecc_generate_many(sectors, SECTORS, CD_EDC_MODE1), 0);
+    EXPECT_EQ(cd_edc_compute(0, sectors, SECTORS * CD_SECTOR_SIZE), EXPECTED_CD_ECC_MODE1);
+
+    free(sectors);
+}
+
+TEST_F(cdEccFixture, cd_ecc_generate_mode2_form1)
+{
+    uint8_t *sectors = (uint8_t *)malloc(SECTORS * CD_SECTOR_SIZE);
+
+    memcpy(sectors, buffer, SECTORS * CD_SECTOR_SIZE);
+
+    EXPECT_EQ(cd_ecc_generate_many(sectors, SECTORS, CD_EDC_MODE2_FORM1), 0);
+    EXPECT_EQ(cd_edc_compute(0, sectors, SECTORS * CD_SECTOR_SIZE), EXPECTED_CD_ECC_MODE2_FORM1);
+
+    free(sectors);
+}
+
+TEST_F(cdEccFixture, cd_ecc_generate_one_by_one)
+{
+    uint8_t *sectors = (uint8_t *)malloc(SECTORS * CD_SECTOR_SIZE);
+    uint32_t i;
+
+    memcpy(sectors, buffer, SECTORS * CD_SECTOR_SIZE);
+
+    // Single sectors never reach the SIMD kernels
+    for(i = 0; i < SECTORS; i++) EXPECT_EQ(cd_ecc_generate_many(sectors + i * CD_SECTOR_SIZE, 1, CD_EDC_MODE1), 0);
+
+    EXPECT_EQ(cd_edc_compute(0, sectors, SECTORS * CD_SECTOR_SIZE), EXPECTED_CD_ECC_MODE1);
+
+    free(sectors);
+}
+
+TEST_F(cdEccFixture, cd_ecc_generate_mode2)
+{
+    uint8_t *sectors = (uint8_t *)malloc(SECTORS * CD_SECTOR_SIZE);
+    uint8_t *form1   = (uint8_t *)malloc(SECTORS * CD_SECTOR_SIZE);
+    uint32_t i;
+
+    memcpy(sectors, buffer, SECTORS * CD_SECTOR_SIZE);
+
+    for(i = 0; i < SECTORS; i++)
+    {
+        if(i % 3)
+            sectors[i * CD_SECTOR_SIZE + CD_SUBMODE_OFFSET] &= ~CD_SUBMODE_FORM2;
+        else
+            sectors[i * CD_SECTOR_SIZE + CD_SUBMODE_OFFSET] |= CD_SUBMODE_FORM2;
+    }
+
+    memcpy(form1, sectors, SECTORS * CD_SECTOR_SIZE);
+
+    EXPECT_EQ(cd_ecc_generate_many(sectors, SECTORS, CD_EDC_MODE2), 0);
+    EXPECT_EQ(cd_ecc_generate_many(form1, SECTORS, CD_EDC_MODE2_FORM1), 0);
+
+    // Form 2 sectors keep their user data where Form 1 has the parity
+    for(i = 0; i < SECTORS; i++)
+    {
+        const uint8_t *sector = sectors + i * CD_SECTOR_SIZE;
+
+        if(i % 3)
+            EXPECT_EQ(memcmp(sector, form1 + i * CD_SECTOR_SIZE, CD_SECTOR_SIZE), 0);
+        else
+            EXPECT_EQ(memcmp(sector + CD_ECC_P_OFFSET, buffer + i * CD_SECTOR_SIZE + CD_ECC_P_OFFSET,
+                             CD_ECC_P_SIZE + CD_ECC_Q_SIZE),
+                      0);
+    }
+
+    free(sectors);
+    free(form1);
+}
+
+TEST_F(cdEccFixture, cd_ecc_verify_mode1)
+{
+    uint8_t *sectors = (uint8_t *)malloc(SECTORS * CD_SECTOR_SIZE);
+    uint64_t bitmap[(SECTORS + 63) / 64];
+    uint32_t i;
+
+    memcpy(sectors, buffer, SECTORS * CD_SECTOR_SIZE);
+
+    EXPECT_EQ(cd_ecc_generate_many(sectors, SECTORS, CD_EDC_MODE1), 0);
+    EXPECT_EQ(cd_ecc_verify_many(sectors, SECTORS, CD_EDC_MODE1, bitmap), 0);
+
+    // Errors in the header, the user data, the P parity and the Q parity
+    sectors[2 * CD_SECTOR_SIZE + 13] ^= 0x01;
+    sectors[17 * CD_SECTOR_SIZE + 1000] ^= 0x80;
+    sectors[40 * CD_SECTOR_SIZE + CD_ECC_P_OFFSET + 100] ^= 0x10;
+    sectors[69 * CD_SECTOR_SIZE + CD_ECC_Q_OFFSET + 103] ^= 0x04;
+
+    EXPECT_EQ(cd_ecc_verify_many(sectors, SECTORS, CD_EDC_MODE1, bitmap), 4);
+
+    for(i = 0; i < SECTORS; i++) EXPECT_EQ(passed(bitmap, i), i != 2 && i != 17 && i != 40 && i != 69);
+
+    // The sync pattern is not covered
+    sectors[2 * CD_SECTOR_SIZE + 13] ^= 0x01;
+    sectors[2 * CD_SECTOR_SIZE + 5] ^= 0x01;
+
+    EXPECT_EQ(cd_ecc_verify_many(sectors, 3, CD_EDC_MODE1, bitmap), 0);
+
+    free(sectors);
+}
+
+TEST_F(cdEccFixture, cd_ecc_verify_mode2)
+{
+    uint8_t *sectors = (uint8_t *)malloc(SECTORS * CD_SECTOR_SIZE);
+    uint64_t bitmap[(SECTORS + 63) / 64];
+    uint32_t i;
+
+    memcpy(sectors, buffer, SECTORS * CD_SECTOR_SIZE);
+
+    for(i = 0; i < SECTORS; i++)
+    {
+        if(i % 2)
+            sectors[i * CD_SECTOR_SIZE + CD_SUBMODE_OFFSET] |= CD_SUBMODE_FORM2;
+        else
+            sectors[i * CD_SECTOR_SIZE + CD_SUBMODE_OFFSET] &= ~CD_SUBMODE_FORM2;
+    }
+
+    EXPECT_EQ(cd_ecc_generate_many(sectors, SECTORS, CD_EDC_MODE2), 0);
+
+    // Mode 2 leaves the header out of the parity
+    for(i = 0; i < SECTORS; i++) sectors[i * CD_SECTOR_SIZE + 14] ^= 0x5A;
+
+    EXPECT_EQ(cd_ecc_verify_many(sectors, SECTORS, CD_EDC_MODE2, bitmap), 0);
+
+    // Form 2 sectors have no parity to fail
+    sectors[10 * CD_SECTOR_SIZE + 500] ^= 0x02;
+    sectors[11 * CD_SECTOR_SIZE + 500] ^= 0x02;
+    sectors[50 * CD_SECTOR_SIZE + CD_ECC_Q_OFFSET] ^= 0x02;
+
+    EXPECT_EQ(cd_ecc_verify_many(sectors, SECTORS, CD_EDC_MODE2, bitmap), 2);
+
+    for(i = 0; i < SECTORS; i++) EXPECT_EQ(passed(bitmap, i), i != 10 && i != 50);
+
+    EXPECT_EQ(cd_ecc_verify_many(sectors, SECTORS, CD_EDC_MODE2_FORM2, bitmap), -1);
+    EXPECT_EQ(cd_ecc_verify_many(sectors, SECTORS, CD_EDC_MODE2, nullptr), -1);
+    EXPECT_EQ(cd_ecc_generate_many(sectors, SECTORS, 0), -1);
+
+    free(sectors);
+}
+
+TEST_F(cdEccFixture, cd_ecc_correct_clean)
+{
+    uint8_t *sectors = (uint8_t *)malloc(SECTORS * CD_SECTOR_SIZE);
+    uint64_t bitmap[(SECTORS + 63) / 64];
+    uint32_t corrected[SECTORS];
+    uint32_t i;
+
+    memcpy(sectors, buffer, SECTORS * CD_SECTOR_SIZE);
+
+    EXPECT_EQ(cd_ecc_generate_many(sectors, SECTORS, CD_EDC_MODE1), 0);
+    EXPECT_EQ(cd_ecc_correct_many(sectors, SECTORS, CD_EDC_MODE1, corrected, bitmap), 0);
+    EXPECT_EQ(cd_edc_compute(0, sectors, SECTORS * CD_SECTOR_SIZE), EXPECTED_CD_ECC_MODE1);
+
+    for(i = 0; i < SECTORS; i++)
+    {
+        EXPECT_TRUE(passed(bitmap, i));
+        EXPECT_EQ(corrected[i], 0);
+    }
+
+    EXPECT_EQ(cd_ecc_correct_many(sectors, SECTORS, CD_EDC_MODE2_FORM2, corrected, bitmap), -1);
+    EXPECT_EQ(cd_ecc_correct_many(sectors, SECTORS, CD_EDC_MODE1, nullptr, bitmap), -1);
+
+    free(sectors);
+}
+
+TEST_F(cdEccFixture, cd_ecc_correct)
+{
+    uint8_t *sectors = (uint8_t *)malloc(SECTORS * CD_SECTOR_SIZE);
+    uint8_t *damaged = (uint8_t *)malloc(CD_SECTOR_SIZE);
+    uint64_t bitmap[(SECTORS + 63) / 64];
+    uint32_t corrected[SECTORS];
+    uint32_t i;
+
+    memcpy(sectors, buffer, SECTORS * CD_SECTOR_SIZE);
+
+    EXPECT_EQ(cd_ecc_generate_many(sectors, SECTORS, CD_EDC_MODE1), 0);
+
+    // A byte in the header, the user data and the parity
+    sectors[1 * CD_SECTOR_SIZE + 15] ^= 0x01;
+    sectors[5 * CD_SECTOR_SIZE + 1000] ^= 0xFF;
+    sectors[9 * CD_SECTOR_SIZE + CD_ECC_Q_OFFSET + 50] ^= 0x42;
+
+    // A burst of 80 bytes, a byte in each P codeword
+    for(i = 0; i < 80; i++) sectors[20 * CD_SECTOR_SIZE + 700 + i] ^= 0xA5;
+
+    // Two bytes in the same P codeword, fixed by the Q codewords
+    sectors[33 * CD_SECTOR_SIZE + 100] ^= 0x10;
+    sectors[33 * CD_SECTOR_SIZE + 100 + CD_ECC_P_COUNT * 2] ^= 0x20;
+
+    // Too many errors in every codeword
+    for(i = 0; i < 600; i++) sectors[50 * CD_SECTOR_SIZE + 200 + i] ^= 0x77;
+
+    memcpy(damaged, sectors + 50 * CD_SECTOR_SIZE, CD_SECTOR_SIZE);
+
+    EXPECT_EQ(cd_ecc_correct_many(sectors, SECTORS, CD_EDC_MODE1, corrected, bitmap), 1);
+
+    for(i = 0; i < SECTORS; i++) EXPECT_EQ(passed(bitmap, i), i != 50);
+
+    EXPECT_EQ(corrected[1], 1);
+    EXPECT_EQ(corrected[5], 1);
+    EXPECT_EQ(corrected[9], 1);
+    EXPECT_EQ(corrected[20], 80);
+    EXPECT_EQ(corrected[33], 2);
+    EXPECT_EQ(corrected[50], 0);
+
+    // Sectors that cannot be corrected are left as they were
+    EXPECT_EQ(memcmp(sectors + 50 * CD_SECTOR_SIZE, damaged, CD_SECTOR_SIZE), 0);
+
+    memcpy(sectors + 50 * CD_SECTOR_SIZE, buffer + 50 * CD_SECTOR_SIZE, CD_SECTOR_SIZE);
+    EXPECT_EQ(cd_ecc_generate_many(sectors + 50 * CD_SECTOR_SIZE, 1, CD_EDC_MODE1), 0);
+    EXPECT_EQ(cd_edc_compute(0, sectors, SECTORS * CD_SECTOR_SIZE), EXPECTED_CD_ECC_MODE1);
+
+    free(sectors);
+    free(damaged);
+}
+
+// Runs a kernel on lanes sectors and compares them with the parity calculated one sector at a time
+static void check_kernel(void (*generate)(uint8_t *, uint32_t, int, uint8_t *),
+                         uint32_t (*verify)(const uint8_t *, int, uint8_t *), uint32_t lanes)
+{
+    uint8_t *sectors  = (uint8_t *)malloc(lanes * CD_SECTOR_SIZE);
+    uint8_t *expected = (uint8_t *)malloc(lanes * CD_SECTOR_SIZE);
+    uint8_t *scratch  = (uint8_t *)malloc(CD_ECC_MAX_LANES * CD_SECTOR_SIZE);
+    uint32_t all      = lanes == 32 ? 0xFFFFFFFF : (1U << lanes) - 1;
+    uint32_t i;
+
+    memcpy(sectors, buffer, lanes * CD_SECTOR_SIZE);
+    memcpy(expected, buffer, lanes * CD_SECTOR_SIZE);
+
+    for(i = 0; i < lanes; i++) cd_ecc_generate_many(expected + i * CD_SECTOR_SIZE, 1, CD_EDC_MODE1);
+
+    // Only the lanes asked for are written
+    generate(sectors, all & 0x55555555, 0, scratch);
+
+    for(i = 0; i < lanes; i++)
+    {
+        const uint8_t *lane = (i % 2 ? buffer : expected) + i * CD_SECTOR_SIZE;
+
+        EXPECT_EQ(memcmp(sectors + i * CD_SECTOR_SIZE, lane, CD_SECTOR_SIZE), 0);
+    }
+
+    generate(sectors, all, 0, scratch);
+
+    EXPECT_EQ(memcmp(sectors, expected, lanes * CD_SECTOR_SIZE), 0);
+    EXPECT_EQ(verify(sectors, 0, scratch), all);
+
+    sectors[3 * CD_SECTOR_SIZE + 300] ^= 0x20;
+
+    EXPECT_EQ(verify(sectors, 0, scratch), all & ~(1U << 3));
+
+    free(sectors);
+    free(expected);
+    free(scratch);
+}
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+TEST_F(cdEccFixture, cd_ecc_ssse3)
+{
+    if(!have_ssse3()) return;
+
+    check_kernel(cd_ecc_generate_ssse3, cd_ecc_verify_ssse3, 16);
+}
+
+TEST_F(cdEccFixture, cd_ecc_avx2)
+{
+    if(!have_avx2()) return;
+
+    check_kernel(cd_ecc_generate_avx2, cd_ecc_verify_avx2, 32);
+}
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+TEST_F(cdEccFixture, cd_ecc_neon)
+{
+    if(!have_neon()) return;
+
+    check_kernel(cd_ecc_generate_neon, cd_ecc_verify_neon, 16);
+}
+#endif
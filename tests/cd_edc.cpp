@@ -0,0 +1,292 @@
+//
+// Created by claunia on 5/10/21.
+//
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+#include "../library.h"
+#include "../cd_edc.h"
+#include "gtest/gtest.h"
+
+#define EXPECTED_CD_EDC           0x60EA2C0B
+#define EXPECTED_CD_EDC_15BYTES   0xF78438AA
+#define EXPECTED_CD_EDC_2064BYTES 0x312866C0
+#define EXPECTED_CD_EDC_2352BYTES 0x8E70CB48
+
+#define SECTORS 70
+
+static const uint8_t *buffer;
+static const uint8_t *buffer_misaligned;
+
+class cdEdcFixture : public ::testing::Test
+{
+public:
+    cdEdcFixture()
+    {
+        // initialization;
+        // can also be done in SetUp()
+    }
+
+protected:
+    void SetUp()
+    {
+        char path[PATH_MAX];
+        char filename[PATH_MAX];
+
+        getcwd(path, PATH_MAX);
+        snprintf(filename, PATH_MAX, "%s/data/random", path);
+
+        FILE *file = fopen(filename, "rb");
+        buffer     = (const uint8_t *)malloc(1048576);
+        fread((void *)buffer, 1, 1048576, file);
+        fclose(file);
+
+        buffer_misaligned = (const uint8_t *)malloc(1048577);
+        memcpy((void *)(buffer_misaligned + 1), buffer, 1048576);
+    }
+
+    void TearDown()
+    {
+        free((void *)buffer);
+        free((void *)buffer_misaligned);
+    }
+
+    ~cdEdcFixture()
+    {
+        // resources cleanup, no exceptions allowed
+    }
+
+    // shared user data
+};
+
+// Stores the EDC of a sector area at its end, as the drive would
+static void stamp(uint8_t *sector, uint32_t offset, uint32_t len)
+{
+    uint32_t edc = cd_edc_compute(0, sector + offset, len);
+
+    sector[offset + len]     = (uint8_t)edc;
+    sector[offset + len + 1] = (uint8_t)(edc >> 8);
+    sector[offset + len + 2] = (uint8_t)(edc >> 16);
+    sector[offset + len + 3] = (uint8_t)(edc >> 24);
+}
+
+static bool passed(const uint64_t *bitmap, uint32_t i) { return (bitmap[i / 64] >> (i % 64)) & 1; }
+
+TEST_F(cdEdcFixture, cd_edc_auto)
+{
+    EXPECT_EQ(cd_edc_compute(0, buffer, 1048576), EXPECTED_CD_EDC);
+}
+
+TEST_F(cdEdcFixture, cd_edc_auto_misaligned)
+{
+    EXPECT_EQ(cd_edc_compute(0, buffer_misaligned + 1, 1048576), EXPECTED_CD_EDC);
+}
+
+TEST_F(cdEdcFixture, cd_edc_auto_15bytes)
+{
+    EXPECT_EQ(cd_edc_compute(0, buffer, 15), EXPECTED_CD_EDC_15BYTES);
+}
+
+TEST_F(cdEdcFixture, cd_edc_auto_2064bytes)
+{
+    EXPECT_EQ(cd_edc_compute(0, buffer, 2064), EXPECTED_CD_EDC_2064BYTES);
+}
+
+TEST_F(cdEdcFixture, cd_edc_auto_2352bytes)
+{
+    EXPECT_EQ(cd_edc_compute(0, buffer, 2352), EXPECTED_CD_EDC_2352BYTES);
+}
+
+TEST_F(cdEdcFixture, cd_edc_auto_slices)
+{
+    uint32_t edc = 0;
+    uint32_t pos;
+
+    // Uneven slices must give the same EDC as the whole buffer
+    for(pos = 0; pos < 1048576; pos += 4097)
+        edc = cd_edc_compute(edc, buffer + pos, pos + 4097 > 1048576 ? 1048576 - pos : 4097);
+
+    EXPECT_EQ(edc, EXPECTED_CD_EDC);
+}
+
+TEST_F(cdEdcFixture, cd_edc_slicing)
+{
+    uint32_t edc = 0;
+
+    cd_edc_slicing(&edc, buffer, 1048576);
+
+    EXPECT_EQ(edc, EXPECTED_CD_EDC);
+}
+
+TEST_F(cdEdcFixture, cd_edc_slicing_2352bytes)
+{
+    uint32_t edc = 0;
+
+    cd_edc_slicing(&edc, buffer, 2352);
+
+    EXPECT_EQ(edc, EXPECTED_CD_EDC_2352BYTES);
+}
+
+TEST_F(cdEdcFixture, cd_edc_verify_mode1)
+{
+    uint8_t *sectors = (uint8_t *)malloc(SECTORS * CD_SECTOR_SIZE);
+    uint64_t bitmap[(SECTORS + 63) / 64];
+    uint32_t i;
+
+    memcpy(sectors, buffer, SECTORS * CD_SECTOR_SIZE);
+
+    for(i = 0; i < SECTORS; i++) stamp(sectors + i * CD_SECTOR_SIZE, 0, 2064);
+
+    sectors[5 * CD_SECTOR_SIZE + 100] ^= 0x01;
+    sectors[66 * CD_SECTOR_SIZE + 2065] ^= 0x80;
+
+    EXPECT_EQ(cd_edc_verify_many(sectors, SECTORS, CD_EDC_MODE1, bitmap), 2);
+
+    for(i = 0; i < SECTORS; i++) EXPECT_EQ(passed(bitmap, i), i != 5 && i != 66);
+
+    free(sectors);
+}
+
+TEST_F(cdEdcFixture, cd_edc_verify_mode2_form1)
+{
+    uint8_t *sectors = (uint8_t *)malloc(SECTORS * CD_SECTOR_SIZE);
+    uint64_t bitmap[(SECTORS + 63) / 64];
+    uint32_t i;
+
+    memcpy(sectors, buffer, SECTORS * CD_SECTOR_SIZE);
+
+    for(i = 0; i < SECTORS; i++) stamp(sectors + i * CD_SECTOR_SIZE, 16, 2056);
+
+    sectors[10 * CD_SECTOR_SIZE + 2071] ^= 0x04;
+
+    EXPECT_EQ(cd_edc_verify_many(sectors, SECTORS, CD_EDC_MODE2_FORM1, bitmap), 1);
+
+    for(i = 0; i < SECTORS; i++) EXPECT_EQ(passed(bitmap, i), i != 10);
+
+    free(sectors);
+}
+
+TEST_F(cdEdcFixture, cd_edc_verify_mode2_form2)
+{
+    uint8_t *sectors = (uint8_t *)malloc(SECTORS * CD_SECTOR_SIZE);
+    uint64_t bitmap[(SECTORS + 63) / 64];
+    uint32_t i;
+
+    memcpy(sectors, buffer, SECTORS * CD_SECTOR_SIZE);
+
+    for(i = 0; i < SECTORS; i++) stamp(sectors + i * CD_SECTOR_SIZE, 16, 2332);
+
+    // A Form 2 sector without EDC always passes
+    memset(sectors + 3 * CD_SECTOR_SIZE + 2348, 0, 4);
+    sectors[3 * CD_SECTOR_SIZE + 200] ^= 0x10;
+    sectors[64 * CD_SECTOR_SIZE + 2000] ^= 0x10;
+
+    EXPECT_EQ(cd_edc_verify_many(sectors, SECTORS, CD_EDC_MODE2_FORM2, bitmap), 1);
+
+    for(i = 0; i < SECTORS; i++) EXPECT_EQ(passed(bitmap, i), i != 64);
+
+    free(sectors);
+}
+
+TEST_F(cdEdcFixture, cd_edc_verify_mode2)
+{
+    uint8_t *sectors = (uint8_t *)malloc(SECTORS * CD_SECTOR_SIZE);
+    uint8_t *sector;
+    uint64_t bitmap[(SECTORS + 63) / 64];
+    uint32_t i;
+
+    memcpy(sectors, buffer, SECTORS * CD_SECTOR_SIZE);
+
+    // Alternate Form 1 and Form 2 sectors, as an XA track does
+    for(i = 0; i < SECTORS; i++)
+    {
+        sector = sectors + i * CD_SECTOR_SIZE;
+
+        if(i % 2)
+        {
+            sector[CD_SUBMODE_OFFSET] |= CD_SUBMODE_FORM2;
+            stamp(sector, 16, 2332);
+        }
+        else
+        {
+            sector[CD_SUBMODE_OFFSET] &= ~CD_SUBMODE_FORM2;
+            stamp(sector, 16, 2056);
+        }
+    }
+
+    sectors[7 * CD_SECTOR_SIZE + 2100] ^= 0x02;
+    sectors[8 * CD_SECTOR_SIZE + 2100] ^= 0x02;
+    sectors[9 * CD_SECTOR_SIZE + 1000] ^= 0x02;
+
+    EXPECT_EQ(cd_edc_verify_many(sectors, SECTORS, CD_EDC_MODE2, bitmap), 2);
+
+    for(i = 0; i < SECTORS; i++) EXPECT_EQ(passed(bitmap, i), i != 7 && i != 9);
+
+    EXPECT_EQ(cd_edc_verify_many(sectors, SECTORS, 0, bitmap), -1);
+    EXPECT_EQ(cd_edc_verify_many(nullptr, SECTORS, CD_EDC_MODE2, bitmap), -1);
+
+    free(sectors);
+}
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+TEST_F(cdEdcFixture, cd_edc_clmul)
+{
+    if(!have_clmul()) return;
+
+    EXPECT_EQ(cd_edc_clmul(0, buffer, 1048576), EXPECTED_CD_EDC);
+}
+
+TEST_F(cdEdcFixture, cd_edc_clmul_misaligned)
+{
+    if(!have_clmul()) return;
+
+    EXPECT_EQ(cd_edc_clmul(0, buffer_misaligned + 1, 1048576), EXPECTED_CD_EDC);
+}
+
+TEST_F(cdEdcFixture, cd_edc_clmul_2064bytes)
+{
+    if(!have_clmul()) return;
+
+    EXPECT_EQ(cd_edc_clmul(0, buffer, 2064), EXPECTED_CD_EDC_2064BYTES);
+}
+
+TEST_F(cdEdcFixture, cd_edc_clmul_2352bytes)
+{
+    if(!have_clmul()) return;
+
+    EXPECT_EQ(cd_edc_clmul(0, buffer, 2352), EXPECTED_CD_EDC_2352BYTES);
+}
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+TEST_F(cdEdcFixture, cd_edc_vmull)
+{
+    if(!have_neon()) return;
+
+    EXPECT_EQ(cd_edc_vmull(0, buffer, 1048576), EXPECTED_CD_EDC);
+}
+
+TEST_F(cdEdcFixture, cd_edc_vmull_misaligned)
+{
+    if(!have_neon()) return;
+
+    EXPECT_EQ(cd_edc_vmull(0, buffer_misaligned + 1, 1048576), EXPECTED_CD_EDC);
+}
+
+TEST_F(cdEdcFixture, cd_edc_vmull_2064bytes)
+{
+    if(!have_neon()) return;
+
+    EXPECT_EQ(cd_edc_vmull(0, buffer, 2064), EXPECTED_CD_EDC_2064BYTES);
+}
+
+TEST_F(cdEdcFixture, cd_edc_vmull_2352bytes)
+{
+    if(!have_neon()) return;
+
+    EXPECT_EQ(cd_edc_vmull(0, buffer, 2352), EXPECTED_CD_EDC_2352BYTES);
+}
+#endif
@@ -0,0 +1,171 @@
+//
+// Created by claunia on 5/10/21.
+//
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+#include "../library.h"
+#include "../cdc.h"
+#include "../crc64.h"
+#include "gtest/gtest.h"
+
+#define CDC_TEST_MIN 2048
+#define CDC_TEST_AVG 8192
+#define CDC_TEST_MAX 65536
+
+#define EXPECTED_CDC_CHUNKS 112
+
+static const uint8_t *buffer;
+
+class cdcFixture : public ::testing::Test
+{
+public:
+    cdcFixture()
+    {
+        // initialization;
+        // can also be done in SetUp()
+    }
+
+protected:
+    void SetUp()
+    {
+        char path[PATH_MAX];
+        char filename[PATH_MAX];
+
+        getcwd(path, PATH_MAX);
+        snprintf(filename, PATH_MAX, "%s/data/random", path);
+
+        FILE *file = fopen(filename, "rb");
+        buffer     = (const uint8_t *)malloc(1048576);
+        fread((void *)buffer, 1, 1048576, file);
+        fclose(file);
+    }
+
+    void TearDown()
+    {
+        free((void *)buffer);
+    }
+
+    ~cdcFixture()
+    {
+        // resources cleanup, no exceptions allowed
+    }
+
+    // shared user data
+};
+
+/* Chunks the whole buffer, feeding it in slices of the given size */
+static int cdc_chunk_buffer(const uint8_t *data, uint32_t len, uint32_t slice, cdc_chunk *chunks)
+{
+    cdc_ctx *ctx   = cdc_init(CDC_TEST_MIN, CDC_TEST_AVG, CDC_TEST_MAX, CDC_CRC64);
+    int      count = 0;
+    uint32_t pos;
+
+    for(pos = 0; pos < len; pos += slice)
+        count += cdc_update(ctx, data + pos, len - pos < slice ? len - pos : slice, chunks + count);
+
+    count += cdc_final(ctx, chunks + count);
+    cdc_free(ctx);
+
+    return count;
+}
+
+TEST_F(cdcFixture, cdc_auto)
+{
+    cdc_chunk *chunks = (cdc_chunk *)malloc((1048576 / CDC_TEST_MIN + 1) * sizeof(cdc_chunk));
+    crc64_ctx *crc;
+    uint64_t   expected;
+    uint64_t   offset = 0;
+    int        count, i;
+
+    count = cdc_chunk_buffer(buffer, 1048576, 1048576, chunks);
+
+    EXPECT_EQ(count, EXPECTED_CDC_CHUNKS);
+
+    for(i = 0; i < count; i++)
+    {
+        EXPECT_EQ(chunks[i].offset, offset);
+
+        if(i < count - 1)
+        {
+            EXPECT_GE(chunks[i].length, (uint32_t)CDC_TEST_MIN);
+            EXPECT_LE(chunks[i].length, (uint32_t)CDC_TEST_MAX);
+        }
+
+        crc = crc64_init();
+        crc64_update(crc, buffer + offset, chunks[i].length);
+        crc64_final(crc, &expected);
+        crc64_free(crc);
+
+        EXPECT_EQ(chunks[i].crc64, expected);
+
+        offset += chunks[i].length;
+    }
+
+    EXPECT_EQ(offset, (uint64_t)1048576);
+
+    free(chunks);
+}
+
+TEST_F(cdcFixture, cdc_slices)
+{
+    cdc_chunk *expected = (cdc_chunk *)malloc((1048576 / CDC_TEST_MIN + 1) * sizeof(cdc_chunk));
+    cdc_chunk *chunks   = (cdc_chunk *)malloc((1048576 / CDC_TEST_MIN + 1) * sizeof(cdc_chunk));
+    uint32_t   slices[] = {1, 5, 63, 4096, 100000};
+    int        count, i, j;
+
+    count = cdc_chunk_buffer(buffer, 1048576, 1048576, expected);
+
+    // Boundaries and CRCs must not depend on how the data is split between updates
+    for(i = 0; i < (int)(sizeof(slices) / sizeof(slices[0])); i++)
+    {
+        EXPECT_EQ(cdc_chunk_buffer(buffer, 1048576, slices[i], chunks), count);
+
+        for(j = 0; j < count; j++)
+        {
+            EXPECT_EQ(chunks[j].offset, expected[j].offset);
+            EXPECT_EQ(chunks[j].length, expected[j].length);
+            EXPECT_EQ(chunks[j].crc64, expected[j].crc64);
+        }
+    }
+
+    free(expected);
+    free(chunks);
+}
+
+TEST_F(cdcFixture, cdc_insertion)
+{
+    uint8_t   *image    = (uint8_t *)malloc(1048576 + 100);
+    cdc_chunk *expected = (cdc_chunk *)malloc((1048576 / CDC_TEST_MIN + 1) * sizeof(cdc_chunk));
+    cdc_chunk *chunks   = (cdc_chunk *)malloc((1048576 / CDC_TEST_MIN + 2) * sizeof(cdc_chunk));
+    int        expected_count, count, i, j, same = 0;
+
+    // 100 new bytes in the middle only change the chunks around them
+    memcpy(image, buffer, 500000);
+    memset(image + 500000, 0x5A, 100);
+    memcpy(image + 500100, buffer + 500000, 1048576 - 500000);
+
+    expected_count = cdc_chunk_buffer(buffer, 1048576, 1048576, expected);
+    count          = cdc_chunk_buffer(image, 1048576 + 100, 1048576 + 100, chunks);
+
+    for(i = 0; i < count; i++)
+        for(j = 0; j < expected_count; j++)
+            if(chunks[i].crc64 == expected[j].crc64 && chunks[i].length == expected[j].length) same++;
+
+    EXPECT_GE(same, expected_count - 2);
+
+    free(image);
+    free(expected);
+    free(chunks);
+}
+
+TEST_F(cdcFixture, cdc_invalid)
+{
+    EXPECT_EQ(cdc_init(CDC_MIN_SIZE - 1, 8192, 65536, 0), nullptr);
+    EXPECT_EQ(cdc_init(8192, 4096, 65536, 0), nullptr);
+    EXPECT_EQ(cdc_init(2048, 65536, 8192, 0), nullptr);
+    EXPECT_EQ(cdc_init(2048, 8192, CDC_MAX_SIZE + 1U, 0), nullptr);
+    EXPECT_EQ(cdc_init(2048, 8192, 65536, 0x80), nullptr);
+}
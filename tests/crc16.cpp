@@ -73,6 +73,76 @@ TEST_F(crc16Fixture, crc16_auto)
     EXPECT_EQ(crc, EXPECTED_CRC16);
 }
 
+TEST_F(crc16Fixture, crc16_update64)
+{
+    crc16_ctx *ctx = crc16_init();
+    uint16_t   crc;
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc16_update64(ctx, buffer, 1048576);
+    crc16_final(ctx, &crc);
+
+    EXPECT_EQ(crc, EXPECTED_CRC16);
+}
+
+TEST_F(crc16Fixture, crc16_export_state)
+{
+    crc16_ctx *ctx = crc16_init();
+    uint16_t   crc;
+    uint8_t    state[CRC16_STATE_SIZE];
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc16_update(ctx, buffer, 524288);
+
+    EXPECT_EQ(crc16_export_state(ctx, nullptr, 0), CRC16_STATE_SIZE);
+    EXPECT_EQ(crc16_export_state(ctx, state, sizeof(state)), CRC16_STATE_SIZE);
+    crc16_free(ctx);
+
+    // Resume from the checkpoint as a new context
+    ctx = crc16_import_state(state, sizeof(state));
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc16_update(ctx, buffer + 524288, 524288);
+    crc16_final(ctx, &crc);
+    crc16_free(ctx);
+
+    EXPECT_EQ(crc, EXPECTED_CRC16);
+
+    state[4]++;
+    EXPECT_EQ(crc16_import_state(state, sizeof(state)), nullptr);
+}
+
+TEST_F(crc16Fixture, crc16_clone)
+{
+    crc16_ctx *ctx = crc16_init();
+    crc16_ctx *clone;
+    uint16_t   crc;
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc16_update(ctx, buffer, 524288);
+
+    clone = crc16_clone(ctx);
+
+    EXPECT_NE(clone, nullptr);
+
+    // Both branches must continue independently from the shared prefix
+    crc16_update(clone, buffer + 524288, 524288);
+    crc16_final(clone, &crc);
+    crc16_free(clone);
+
+    EXPECT_EQ(crc, EXPECTED_CRC16);
+
+    crc16_update(ctx, buffer + 524288, 524288);
+    crc16_final(ctx, &crc);
+    crc16_free(ctx);
+
+    EXPECT_EQ(crc, EXPECTED_CRC16);
+}
+
 TEST_F(crc16Fixture, crc16_auto_misaligned)
 {
     crc16_ctx *ctx = crc16_init();
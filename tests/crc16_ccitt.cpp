@@ -73,6 +73,76 @@ TEST_F(crc16_ccittFixture, crc16_ccitt_auto)
     EXPECT_EQ(crc, EXPECTED_CRC16_CCITT);
 }
 
+TEST_F(crc16_ccittFixture, crc16_ccitt_update64)
+{
+    crc16_ccitt_ctx *ctx = crc16_ccitt_init();
+    uint16_t         crc;
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc16_ccitt_update64(ctx, buffer, 1048576);
+    crc16_ccitt_final(ctx, &crc);
+
+    EXPECT_EQ(crc, EXPECTED_CRC16_CCITT);
+}
+
+TEST_F(crc16_ccittFixture, crc16_ccitt_export_state)
+{
+    crc16_ccitt_ctx *ctx = crc16_ccitt_init();
+    uint16_t         crc;
+    uint8_t          state[CRC16_CCITT_STATE_SIZE];
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc16_ccitt_update(ctx, buffer, 524288);
+
+    EXPECT_EQ(crc16_ccitt_export_state(ctx, nullptr, 0), CRC16_CCITT_STATE_SIZE);
+    EXPECT_EQ(crc16_ccitt_export_state(ctx, state, sizeof(state)), CRC16_CCITT_STATE_SIZE);
+    crc16_ccitt_free(ctx);
+
+    // Resume from the checkpoint as a new context
+    ctx = crc16_ccitt_import_state(state, sizeof(state));
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc16_ccitt_update(ctx, buffer + 524288, 524288);
+    crc16_ccitt_final(ctx, &crc);
+    crc16_ccitt_free(ctx);
+
+    EXPECT_EQ(crc, EXPECTED_CRC16_CCITT);
+
+    state[4]++;
+    EXPECT_EQ(crc16_ccitt_import_state(state, sizeof(state)), nullptr);
+}
+
+TEST_F(crc16_ccittFixture, crc16_ccitt_clone)
+{
+    crc16_ccitt_ctx *ctx = crc16_ccitt_init();
+    crc16_ccitt_ctx *clone;
+    uint16_t         crc;
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc16_ccitt_update(ctx, buffer, 524288);
+
+    clone = crc16_ccitt_clone(ctx);
+
+    EXPECT_NE(clone, nullptr);
+
+    // Both branches must continue independently from the shared prefix
+    crc16_ccitt_update(clone, buffer + 524288, 524288);
+    crc16_ccitt_final(clone, &crc);
+    crc16_ccitt_free(clone);
+
+    EXPECT_EQ(crc, EXPECTED_CRC16_CCITT);
+
+    crc16_ccitt_update(ctx, buffer + 524288, 524288);
+    crc16_ccitt_final(ctx, &crc);
+    crc16_ccitt_free(ctx);
+
+    EXPECT_EQ(crc, EXPECTED_CRC16_CCITT);
+}
+
 TEST_F(crc16_ccittFixture, crc16_ccitt_auto_misaligned)
 {
     crc16_ccitt_ctx *ctx = crc16_ccitt_init();
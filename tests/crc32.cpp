@@ -73,6 +73,102 @@ TEST_F(crc32Fixture, crc32_auto)
     EXPECT_EQ(crc, EXPECTED_CRC32);
 }
 
+TEST_F(crc32Fixture, crc32_update64)
+{
+    crc32_ctx *ctx = crc32_init();
+    uint32_t   crc;
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc32_update64(ctx, buffer, 1048576);
+    crc32_final(ctx, &crc);
+
+    EXPECT_EQ(crc, EXPECTED_CRC32);
+}
+
+TEST_F(crc32Fixture, crc32_buffered)
+{
+    crc32_ctx *ctx = crc32_init();
+    uint32_t   crc;
+    uint32_t   pos;
+    uint32_t   slice;
+    uint32_t   len;
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_EQ(crc32_set_buffered(ctx, 512), 0);
+
+    // Feed the data in small, uneven slices so partial buffers, fills and direct passes all happen
+    pos = 0;
+    for(slice = 1; pos < 1048576; slice = slice % 1031 + 7)
+    {
+        len = 1048576 - pos < slice ? 1048576 - pos : slice;
+        crc32_update(ctx, buffer + pos, len);
+        pos += len;
+    }
+
+    crc32_final(ctx, &crc);
+    crc32_free(ctx);
+
+    EXPECT_EQ(crc, EXPECTED_CRC32);
+}
+
+TEST_F(crc32Fixture, crc32_export_state)
+{
+    crc32_ctx *ctx = crc32_init();
+    uint32_t   crc;
+    uint8_t    state[CRC32_STATE_SIZE];
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc32_update(ctx, buffer, 524288);
+
+    EXPECT_EQ(crc32_export_state(ctx, nullptr, 0), CRC32_STATE_SIZE);
+    EXPECT_EQ(crc32_export_state(ctx, state, sizeof(state)), CRC32_STATE_SIZE);
+    crc32_free(ctx);
+
+    // Resume from the checkpoint as a new context
+    ctx = crc32_import_state(state, sizeof(state));
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc32_update(ctx, buffer + 524288, 524288);
+    crc32_final(ctx, &crc);
+    crc32_free(ctx);
+
+    EXPECT_EQ(crc, EXPECTED_CRC32);
+
+    state[4]++;
+    EXPECT_EQ(crc32_import_state(state, sizeof(state)), nullptr);
+}
+
+TEST_F(crc32Fixture, crc32_clone)
+{
+    crc32_ctx *ctx = crc32_init();
+    crc32_ctx *clone;
+    uint32_t   crc;
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc32_update(ctx, buffer, 524288);
+
+    clone = crc32_clone(ctx);
+
+    EXPECT_NE(clone, nullptr);
+
+    // Both branches must continue independently from the shared prefix
+    crc32_update(clone, buffer + 524288, 524288);
+    crc32_final(clone, &crc);
+    crc32_free(clone);
+
+    EXPECT_EQ(crc, EXPECTED_CRC32);
+
+    crc32_update(ctx, buffer + 524288, 524288);
+    crc32_final(ctx, &crc);
+    crc32_free(ctx);
+
+    EXPECT_EQ(crc, EXPECTED_CRC32);
+}
+
 TEST_F(crc32Fixture, crc32_slicing)
 {
     uint32_t crc = CRC32_ISO_SEED;
@@ -73,6 +73,102 @@ TEST_F(crc64Fixture, crc64_auto)
     EXPECT_EQ(crc, EXPECTED_CRC64);
 }
 
+TEST_F(crc64Fixture, crc64_update64)
+{
+    crc64_ctx *ctx = crc64_init();
+    uint64_t   crc;
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc64_update64(ctx, buffer, 1048576);
+    crc64_final(ctx, &crc);
+
+    EXPECT_EQ(crc, EXPECTED_CRC64);
+}
+
+TEST_F(crc64Fixture, crc64_buffered)
+{
+    crc64_ctx *ctx = crc64_init();
+    uint64_t   crc;
+    uint32_t   pos;
+    uint32_t   slice;
+    uint32_t   len;
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_EQ(crc64_set_buffered(ctx, 512), 0);
+
+    // Feed the data in small, uneven slices so partial buffers, fills and direct passes all happen
+    pos = 0;
+    for(slice = 1; pos < 1048576; slice = slice % 1031 + 7)
+    {
+        len = 1048576 - pos < slice ? 1048576 - pos : slice;
+        crc64_update(ctx, buffer + pos, len);
+        pos += len;
+    }
+
+    crc64_final(ctx, &crc);
+    crc64_free(ctx);
+
+    EXPECT_EQ(crc, EXPECTED_CRC64);
+}
+
+TEST_F(crc64Fixture, crc64_export_state)
+{
+    crc64_ctx *ctx = crc64_init();
+    uint64_t   crc;
+    uint8_t    state[CRC64_STATE_SIZE];
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc64_update(ctx, buffer, 524288);
+
+    EXPECT_EQ(crc64_export_state(ctx, nullptr, 0), CRC64_STATE_SIZE);
+    EXPECT_EQ(crc64_export_state(ctx, state, sizeof(state)), CRC64_STATE_SIZE);
+    crc64_free(ctx);
+
+    // Resume from the checkpoint as a new context
+    ctx = crc64_import_state(state, sizeof(state));
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc64_update(ctx, buffer + 524288, 524288);
+    crc64_final(ctx, &crc);
+    crc64_free(ctx);
+
+    EXPECT_EQ(crc, EXPECTED_CRC64);
+
+    state[4]++;
+    EXPECT_EQ(crc64_import_state(state, sizeof(state)), nullptr);
+}
+
+TEST_F(crc64Fixture, crc64_clone)
+{
+    crc64_ctx *ctx = crc64_init();
+    crc64_ctx *clone;
+    uint64_t   crc;
+
+    EXPECT_NE(ctx, nullptr);
+
+    crc64_update(ctx, buffer, 524288);
+
+    clone = crc64_clone(ctx);
+
+    EXPECT_NE(clone, nullptr);
+
+    // Both branches must continue independently from the shared prefix
+    crc64_update(clone, buffer + 524288, 524288);
+    crc64_final(clone, &crc);
+    crc64_free(clone);
+
+    EXPECT_EQ(crc, EXPECTED_CRC64);
+
+    crc64_update(ctx, buffer + 524288, 524288);
+    crc64_final(ctx, &crc);
+    crc64_free(ctx);
+
+    EXPECT_EQ(crc, EXPECTED_CRC64);
+}
+
 TEST_F(crc64Fixture, crc64_slicing)
 {
     uint64_t crc = CRC64_ECMA_SEED;
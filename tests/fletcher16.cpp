@@ -76,6 +76,230 @@ TEST_F(fletcher16Fixture, fletcher16_auto)
     EXPECT_EQ(fletcher, EXPECTED_FLETCHER16);
 }
 
+TEST_F(fletcher16Fixture, fletcher16_update64)
+{
+    fletcher16_ctx *ctx = fletcher16_init();
+    uint16_t        fletcher;
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher16_update64(ctx, buffer, 1048576);
+    fletcher16_final(ctx, &fletcher);
+
+    EXPECT_EQ(fletcher, EXPECTED_FLETCHER16);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_buffered)
+{
+    fletcher16_ctx *ctx = fletcher16_init();
+    uint16_t        fletcher;
+    uint32_t        pos;
+    uint32_t        slice;
+    uint32_t        len;
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_EQ(fletcher16_set_buffered(ctx, 512), 0);
+
+    // Feed the data in small, uneven slices so partial buffers, fills and direct passes all happen
+    pos = 0;
+    for(slice = 1; pos < 1048576; slice = slice % 1031 + 7)
+    {
+        len = 1048576 - pos < slice ? 1048576 - pos : slice;
+        fletcher16_update(ctx, buffer + pos, len);
+        pos += len;
+    }
+
+    fletcher16_final(ctx, &fletcher);
+    fletcher16_free(ctx);
+
+    EXPECT_EQ(fletcher, EXPECTED_FLETCHER16);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_export_state)
+{
+    fletcher16_ctx *ctx = fletcher16_init();
+    uint16_t        fletcher;
+    uint8_t         state[FLETCHER16_STATE_SIZE];
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher16_update(ctx, buffer, 524288);
+
+    EXPECT_EQ(fletcher16_export_state(ctx, nullptr, 0), FLETCHER16_STATE_SIZE);
+    EXPECT_EQ(fletcher16_export_state(ctx, state, sizeof(state)), FLETCHER16_STATE_SIZE);
+    fletcher16_free(ctx);
+
+    // Resume from the checkpoint as a new context
+    ctx = fletcher16_import_state(state, sizeof(state));
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher16_update(ctx, buffer + 524288, 524288);
+    fletcher16_final(ctx, &fletcher);
+    fletcher16_free(ctx);
+
+    EXPECT_EQ(fletcher, EXPECTED_FLETCHER16);
+
+    state[4]++;
+    EXPECT_EQ(fletcher16_import_state(state, sizeof(state)), nullptr);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_clone)
+{
+    fletcher16_ctx *ctx = fletcher16_init();
+    fletcher16_ctx *clone;
+    uint16_t        fletcher;
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher16_update(ctx, buffer, 524288);
+
+    clone = fletcher16_clone(ctx);
+
+    EXPECT_NE(clone, nullptr);
+
+    // Both branches must continue independently from the shared prefix
+    fletcher16_update(clone, buffer + 524288, 524288);
+    fletcher16_final(clone, &fletcher);
+    fletcher16_free(clone);
+
+    EXPECT_EQ(fletcher, EXPECTED_FLETCHER16);
+
+    fletcher16_update(ctx, buffer + 524288, 524288);
+    fletcher16_final(ctx, &fletcher);
+    fletcher16_free(ctx);
+
+    EXPECT_EQ(fletcher, EXPECTED_FLETCHER16);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_combine)
+{
+    static const uint32_t splits[] = {0, 1, 15, 5552, 524288, 1048575, 1048576};
+    fletcher16_ctx *ctx;
+    uint16_t        first;
+    uint16_t        second;
+    size_t          i;
+
+    // Split points at both ends of the buffer and inside and at the edges of the kernels' blocks
+    for(i = 0; i < sizeof(splits) / sizeof(splits[0]); i++)
+    {
+        ctx = fletcher16_init();
+        fletcher16_update(ctx, buffer, splits[i]);
+        fletcher16_final(ctx, &first);
+        fletcher16_free(ctx);
+
+        ctx = fletcher16_init();
+        fletcher16_update(ctx, buffer + splits[i], 1048576 - splits[i]);
+        fletcher16_final(ctx, &second);
+        fletcher16_free(ctx);
+
+        EXPECT_EQ(fletcher16_combine(first, second, 1048576 - splits[i]), EXPECTED_FLETCHER16);
+    }
+}
+
+TEST_F(fletcher16Fixture, fletcher16_update_parallel)
+{
+    fletcher16_ctx *ctx = fletcher16_init();
+    uint16_t        fletcher;
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_EQ(fletcher16_set_buffered(ctx, 512), 0);
+
+    // Leave some data pending in the staging buffer, it must be checksummed before the parallel blocks
+    fletcher16_update(ctx, buffer, 100);
+
+    EXPECT_EQ(fletcher16_update_parallel(ctx, buffer + 100, 1048476, 4), 0);
+    fletcher16_final(ctx, &fletcher);
+    fletcher16_free(ctx);
+
+    EXPECT_EQ(fletcher, EXPECTED_FLETCHER16);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_update_run)
+{
+    static const uint64_t counts[] = {1, 63, 5552, 65521, 1048576, 0x100000001ULL};
+    uint8_t              *data     = (uint8_t *)malloc(2352 + 1048576);
+    fletcher16_ctx       *ctx;
+    uint16_t              expected;
+    uint16_t              fletcher;
+    size_t                i;
+
+    // Sector data followed by a filler run, checked against the same bytes fed to the kernels
+    memcpy(data, buffer, 2352);
+    memset(data + 2352, 0xF6, 1048576);
+
+    for(i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+    {
+        ctx = fletcher16_init();
+        fletcher16_update(ctx, buffer, 2352);
+        EXPECT_EQ(fletcher16_update_run(ctx, 0xF6, counts[i]), 0);
+        fletcher16_final(ctx, &fletcher);
+        fletcher16_free(ctx);
+
+        if(counts[i] > 1048576) continue;
+
+        ctx = fletcher16_init();
+        fletcher16_update(ctx, data, 2352 + (uint32_t)counts[i]);
+        fletcher16_final(ctx, &expected);
+        fletcher16_free(ctx);
+
+        EXPECT_EQ(fletcher, expected);
+    }
+
+    // A run longer than 4GiB, split in pieces that the closed form must add up to the same value
+    ctx = fletcher16_init();
+    fletcher16_update(ctx, buffer, 2352);
+    fletcher16_update_run(ctx, 0xF6, 0x80000000ULL);
+    fletcher16_update_run(ctx, 0xF6, 0x80000000ULL);
+    fletcher16_update_run(ctx, 0xF6, 1);
+    fletcher16_final(ctx, &expected);
+    fletcher16_free(ctx);
+
+    EXPECT_EQ(fletcher, expected);
+
+    free(data);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_run_detection)
+{
+    uint8_t        *image = (uint8_t *)malloc(1048576);
+    fletcher16_ctx *ctx;
+    uint16_t        expected;
+    uint16_t        fletcher;
+
+    // Runs at the start, in the middle, too short to detect and at the end of the data
+    memcpy(image, buffer, 1048576);
+    memset(image, 0x00, 4096);
+    memset(image + 100001, 0xF6, 200000);
+    memset(image + 600000, 0xE5, 511);
+    memset(image + 700000, 0xFF, 63);
+    memset(image + 1043576, 0xFF, 5000);
+
+    ctx = fletcher16_init();
+    fletcher16_update(ctx, image, 1048576);
+    fletcher16_final(ctx, &expected);
+    fletcher16_free(ctx);
+
+    ctx = fletcher16_init();
+    EXPECT_EQ(fletcher16_set_run_detection(ctx, 256), 0);
+    fletcher16_update(ctx, image, 1048576);
+    fletcher16_final(ctx, &fletcher);
+    fletcher16_free(ctx);
+
+    EXPECT_EQ(fletcher, expected);
+
+    // Without any run in the data
+    ctx = fletcher16_init();
+    EXPECT_EQ(fletcher16_set_run_detection(ctx, 1), 0);
+    fletcher16_update(ctx, buffer, 1048576);
+    fletcher16_final(ctx, &fletcher);
+    fletcher16_free(ctx);
+
+    EXPECT_EQ(fletcher, EXPECTED_FLETCHER16);
+
+    free(image);
+}
+
 TEST_F(fletcher16Fixture, fletcher16_auto_misaligned)
 {
     fletcher16_ctx *ctx = fletcher16_init();
@@ -180,6 +404,70 @@ TEST_F(fletcher16Fixture, fletcher16_auto_2352bytes)
     EXPECT_EQ(fletcher, EXPECTED_FLETCHER16_2352BYTES);
 }
 
+TEST_F(fletcher16Fixture, fletcher16_swar)
+{
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_swar(&sum1, &sum2, buffer, 1048576);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_swar_misaligned)
+{
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_swar(&sum1, &sum2, buffer_misaligned + 1, 1048576);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_swar_63bytes)
+{
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_swar(&sum1, &sum2, buffer, 63);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_63BYTES);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_swar_2352bytes)
+{
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_swar(&sum1, &sum2, buffer, 2352);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_2352BYTES);
+}
+
 #if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)) && !defined(_WIN32))
 TEST_F(fletcher16Fixture, fletcher16_neon)
 {
@@ -616,4 +904,292 @@ TEST_F(fletcher16Fixture, fletcher16_ssse3_2352bytes)
 
     EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_2352BYTES);
 }
+
+TEST_F(fletcher16Fixture, fletcher16_avx512_vnni)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx512_vnni(&sum1, &sum2, buffer, 1048576);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_avx512_vnni_misaligned)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx512_vnni(&sum1, &sum2, buffer_misaligned + 1, 1048576);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_avx512_vnni_1byte)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx512_vnni(&sum1, &sum2, buffer, 1);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_1BYTE);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_avx512_vnni_7bytes)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx512_vnni(&sum1, &sum2, buffer, 7);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_7BYTES);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_avx512_vnni_15bytes)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx512_vnni(&sum1, &sum2, buffer, 15);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_15BYTES);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_avx512_vnni_31bytes)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx512_vnni(&sum1, &sum2, buffer, 31);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_31BYTES);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_avx512_vnni_63bytes)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx512_vnni(&sum1, &sum2, buffer, 63);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_63BYTES);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_avx512_vnni_2352bytes)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx512_vnni(&sum1, &sum2, buffer, 2352);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_2352BYTES);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_avx_vnni)
+{
+    if(!have_avx_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx_vnni(&sum1, &sum2, buffer, 1048576);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_avx_vnni_misaligned)
+{
+    if(!have_avx_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx_vnni(&sum1, &sum2, buffer_misaligned + 1, 1048576);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_avx_vnni_1byte)
+{
+    if(!have_avx_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx_vnni(&sum1, &sum2, buffer, 1);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_1BYTE);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_avx_vnni_7bytes)
+{
+    if(!have_avx_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx_vnni(&sum1, &sum2, buffer, 7);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_7BYTES);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_avx_vnni_15bytes)
+{
+    if(!have_avx_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx_vnni(&sum1, &sum2, buffer, 15);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_15BYTES);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_avx_vnni_31bytes)
+{
+    if(!have_avx_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx_vnni(&sum1, &sum2, buffer, 31);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_31BYTES);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_avx_vnni_63bytes)
+{
+    if(!have_avx_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx_vnni(&sum1, &sum2, buffer, 63);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_63BYTES);
+}
+
+TEST_F(fletcher16Fixture, fletcher16_avx_vnni_2352bytes)
+{
+    if(!have_avx_vnni()) return;
+
+    uint8_t  sum1;
+    uint8_t  sum2;
+    uint32_t fletcher16;
+
+    sum1 = 0xFF;
+    sum2 = 0xFF;
+
+    fletcher16_avx_vnni(&sum1, &sum2, buffer, 2352);
+
+    fletcher16 = (sum2 << 8) | sum1;
+
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_2352BYTES);
+}
 #endif
@@ -73,6 +73,230 @@ TEST_F(fletcher32Fixture, fletcher32_auto)
     EXPECT_EQ(fletcher, EXPECTED_FLETCHER32);
 }
 
+TEST_F(fletcher32Fixture, fletcher32_update64)
+{
+    fletcher32_ctx *ctx = fletcher32_init();
+    uint32_t        fletcher;
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher32_update64(ctx, buffer, 1048576);
+    fletcher32_final(ctx, &fletcher);
+
+    EXPECT_EQ(fletcher, EXPECTED_FLETCHER32);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_buffered)
+{
+    fletcher32_ctx *ctx = fletcher32_init();
+    uint32_t        fletcher;
+    uint32_t        pos;
+    uint32_t        slice;
+    uint32_t        len;
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_EQ(fletcher32_set_buffered(ctx, 512), 0);
+
+    // Feed the data in small, uneven slices so partial buffers, fills and direct passes all happen
+    pos = 0;
+    for(slice = 1; pos < 1048576; slice = slice % 1031 + 7)
+    {
+        len = 1048576 - pos < slice ? 1048576 - pos : slice;
+        fletcher32_update(ctx, buffer + pos, len);
+        pos += len;
+    }
+
+    fletcher32_final(ctx, &fletcher);
+    fletcher32_free(ctx);
+
+    EXPECT_EQ(fletcher, EXPECTED_FLETCHER32);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_export_state)
+{
+    fletcher32_ctx *ctx = fletcher32_init();
+    uint32_t        fletcher;
+    uint8_t         state[FLETCHER32_STATE_SIZE];
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher32_update(ctx, buffer, 524288);
+
+    EXPECT_EQ(fletcher32_export_state(ctx, nullptr, 0), FLETCHER32_STATE_SIZE);
+    EXPECT_EQ(fletcher32_export_state(ctx, state, sizeof(state)), FLETCHER32_STATE_SIZE);
+    fletcher32_free(ctx);
+
+    // Resume from the checkpoint as a new context
+    ctx = fletcher32_import_state(state, sizeof(state));
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher32_update(ctx, buffer + 524288, 524288);
+    fletcher32_final(ctx, &fletcher);
+    fletcher32_free(ctx);
+
+    EXPECT_EQ(fletcher, EXPECTED_FLETCHER32);
+
+    state[4]++;
+    EXPECT_EQ(fletcher32_import_state(state, sizeof(state)), nullptr);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_clone)
+{
+    fletcher32_ctx *ctx = fletcher32_init();
+    fletcher32_ctx *clone;
+    uint32_t        fletcher;
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher32_update(ctx, buffer, 524288);
+
+    clone = fletcher32_clone(ctx);
+
+    EXPECT_NE(clone, nullptr);
+
+    // Both branches must continue independently from the shared prefix
+    fletcher32_update(clone, buffer + 524288, 524288);
+    fletcher32_final(clone, &fletcher);
+    fletcher32_free(clone);
+
+    EXPECT_EQ(fletcher, EXPECTED_FLETCHER32);
+
+    fletcher32_update(ctx, buffer + 524288, 524288);
+    fletcher32_final(ctx, &fletcher);
+    fletcher32_free(ctx);
+
+    EXPECT_EQ(fletcher, EXPECTED_FLETCHER32);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_combine)
+{
+    static const uint32_t splits[] = {0, 1, 15, 5552, 524288, 1048575, 1048576};
+    fletcher32_ctx *ctx;
+    uint32_t        first;
+    uint32_t        second;
+    size_t          i;
+
+    // Split points at both ends of the buffer and inside and at the edges of the kernels' blocks
+    for(i = 0; i < sizeof(splits) / sizeof(splits[0]); i++)
+    {
+        ctx = fletcher32_init();
+        fletcher32_update(ctx, buffer, splits[i]);
+        fletcher32_final(ctx, &first);
+        fletcher32_free(ctx);
+
+        ctx = fletcher32_init();
+        fletcher32_update(ctx, buffer + splits[i], 1048576 - splits[i]);
+        fletcher32_final(ctx, &second);
+        fletcher32_free(ctx);
+
+        EXPECT_EQ(fletcher32_combine(first, second, 1048576 - splits[i]), EXPECTED_FLETCHER32);
+    }
+}
+
+TEST_F(fletcher32Fixture, fletcher32_update_parallel)
+{
+    fletcher32_ctx *ctx = fletcher32_init();
+    uint32_t        fletcher;
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_EQ(fletcher32_set_buffered(ctx, 512), 0);
+
+    // Leave some data pending in the staging buffer, it must be checksummed before the parallel blocks
+    fletcher32_update(ctx, buffer, 100);
+
+    EXPECT_EQ(fletcher32_update_parallel(ctx, buffer + 100, 1048476, 4), 0);
+    fletcher32_final(ctx, &fletcher);
+    fletcher32_free(ctx);
+
+    EXPECT_EQ(fletcher, EXPECTED_FLETCHER32);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_update_run)
+{
+    static const uint64_t counts[] = {1, 63, 5552, 65521, 1048576, 0x100000001ULL};
+    uint8_t              *data     = (uint8_t *)malloc(2352 + 1048576);
+    fletcher32_ctx       *ctx;
+    uint32_t              expected;
+    uint32_t              fletcher;
+    size_t                i;
+
+    // Sector data followed by a filler run, checked against the same bytes fed to the kernels
+    memcpy(data, buffer, 2352);
+    memset(data + 2352, 0xF6, 1048576);
+
+    for(i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+    {
+        ctx = fletcher32_init();
+        fletcher32_update(ctx, buffer, 2352);
+        EXPECT_EQ(fletcher32_update_run(ctx, 0xF6, counts[i]), 0);
+        fletcher32_final(ctx, &fletcher);
+        fletcher32_free(ctx);
+
+        if(counts[i] > 1048576) continue;
+
+        ctx = fletcher32_init();
+        fletcher32_update(ctx, data, 2352 + (uint32_t)counts[i]);
+        fletcher32_final(ctx, &expected);
+        fletcher32_free(ctx);
+
+        EXPECT_EQ(fletcher, expected);
+    }
+
+    // A run longer than 4GiB, split in pieces that the closed form must add up to the same value
+    ctx = fletcher32_init();
+    fletcher32_update(ctx, buffer, 2352);
+    fletcher32_update_run(ctx, 0xF6, 0x80000000ULL);
+    fletcher32_update_run(ctx, 0xF6, 0x80000000ULL);
+    fletcher32_update_run(ctx, 0xF6, 1);
+    fletcher32_final(ctx, &expected);
+    fletcher32_free(ctx);
+
+    EXPECT_EQ(fletcher, expected);
+
+    free(data);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_run_detection)
+{
+    uint8_t        *image = (uint8_t *)malloc(1048576);
+    fletcher32_ctx *ctx;
+    uint32_t        expected;
+    uint32_t        fletcher;
+
+    // Runs at the start, in the middle, too short to detect and at the end of the data
+    memcpy(image, buffer, 1048576);
+    memset(image, 0x00, 4096);
+    memset(image + 100001, 0xF6, 200000);
+    memset(image + 600000, 0xE5, 511);
+    memset(image + 700000, 0xFF, 63);
+    memset(image + 1043576, 0xFF, 5000);
+
+    ctx = fletcher32_init();
+    fletcher32_update(ctx, image, 1048576);
+    fletcher32_final(ctx, &expected);
+    fletcher32_free(ctx);
+
+    ctx = fletcher32_init();
+    EXPECT_EQ(fletcher32_set_run_detection(ctx, 256), 0);
+    fletcher32_update(ctx, image, 1048576);
+    fletcher32_final(ctx, &fletcher);
+    fletcher32_free(ctx);
+
+    EXPECT_EQ(fletcher, expected);
+
+    // Without any run in the data
+    ctx = fletcher32_init();
+    EXPECT_EQ(fletcher32_set_run_detection(ctx, 1), 0);
+    fletcher32_update(ctx, buffer, 1048576);
+    fletcher32_final(ctx, &fletcher);
+    fletcher32_free(ctx);
+
+    EXPECT_EQ(fletcher, EXPECTED_FLETCHER32);
+
+    free(image);
+}
+
 TEST_F(fletcher32Fixture, fletcher32_auto_misaligned)
 {
     fletcher32_ctx *ctx = fletcher32_init();
@@ -138,6 +362,70 @@ TEST_F(fletcher32Fixture, fletcher32_auto_2352bytes)
     EXPECT_EQ(fletcher, EXPECTED_FLETCHER32_2352BYTES);
 }
 
+TEST_F(fletcher32Fixture, fletcher32_swar)
+{
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_swar(&sum1, &sum2, buffer, 1048576);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_swar_misaligned)
+{
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_swar(&sum1, &sum2, buffer_misaligned + 1, 1048576);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_swar_63bytes)
+{
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_swar(&sum1, &sum2, buffer, 63);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32_63BYTES);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_swar_2352bytes)
+{
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_swar(&sum1, &sum2, buffer, 2352);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32_2352BYTES);
+}
+
 #if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)) && !defined(_WIN32))
 TEST_F(fletcher32Fixture, fletcher32_neon)
 {
@@ -468,4 +756,220 @@ TEST_F(fletcher32Fixture, fletcher32_ssse3_2352bytes)
     EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32_2352BYTES);
 }
 
+TEST_F(fletcher32Fixture, fletcher32_avx512_vnni)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_avx512_vnni(&sum1, &sum2, buffer, 1048576);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_avx512_vnni_misaligned)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_avx512_vnni(&sum1, &sum2, buffer_misaligned + 1, 1048576);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_avx512_vnni_15bytes)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_avx512_vnni(&sum1, &sum2, buffer, 15);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32_15BYTES);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_avx512_vnni_31bytes)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_avx512_vnni(&sum1, &sum2, buffer, 31);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32_31BYTES);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_avx512_vnni_63bytes)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_avx512_vnni(&sum1, &sum2, buffer, 63);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32_63BYTES);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_avx512_vnni_2352bytes)
+{
+    if(!have_avx512_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_avx512_vnni(&sum1, &sum2, buffer, 2352);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32_2352BYTES);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_avx_vnni)
+{
+    if(!have_avx_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_avx_vnni(&sum1, &sum2, buffer, 1048576);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_avx_vnni_misaligned)
+{
+    if(!have_avx_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_avx_vnni(&sum1, &sum2, buffer_misaligned + 1, 1048576);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_avx_vnni_15bytes)
+{
+    if(!have_avx_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_avx_vnni(&sum1, &sum2, buffer, 15);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32_15BYTES);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_avx_vnni_31bytes)
+{
+    if(!have_avx_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_avx_vnni(&sum1, &sum2, buffer, 31);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32_31BYTES);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_avx_vnni_63bytes)
+{
+    if(!have_avx_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_avx_vnni(&sum1, &sum2, buffer, 63);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32_63BYTES);
+}
+
+TEST_F(fletcher32Fixture, fletcher32_avx_vnni_2352bytes)
+{
+    if(!have_avx_vnni()) return;
+
+    uint16_t sum1;
+    uint16_t sum2;
+    uint32_t fletcher32;
+
+    sum1 = 0xFFFF;
+    sum2 = 0xFFFF;
+
+    fletcher32_avx_vnni(&sum1, &sum2, buffer, 2352);
+
+    fletcher32 = (sum2 << 16) | sum1;
+
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32_2352BYTES);
+}
+
 #endif
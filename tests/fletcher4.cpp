@@ -0,0 +1,320 @@
+//
+// Created by claunia on 5/10/21.
+//
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+#include "../library.h"
+#include "../fletcher4.h"
+#include "gtest/gtest.h"
+
+#define EXPECTED_FLETCHER4_A           0x0002004F4F1D4554ULL
+#define EXPECTED_FLETCHER4_B           0x00803C31790B8D1EULL
+#define EXPECTED_FLETCHER4_C           0x0659B34E39F3150DULL
+#define EXPECTED_FLETCHER4_D           0x11E0D26BED2AF93BULL
+#define EXPECTED_FLETCHER4_2352BYTES_A 0x00000129503BF619ULL
+#define EXPECTED_FLETCHER4_2352BYTES_B 0x00014B625C2DC2EAULL
+#define EXPECTED_FLETCHER4_2352BYTES_C 0x00FC07310107ABD1ULL
+#define EXPECTED_FLETCHER4_2352BYTES_D 0x90FBB4C7A4E3376CULL
+
+static const uint8_t *buffer;
+static const uint8_t *buffer_misaligned;
+
+class fletcher4Fixture : public ::testing::Test
+{
+public:
+    fletcher4Fixture()
+    {
+        // initialization;
+        // can also be done in SetUp()
+    }
+
+protected:
+    void SetUp()
+    {
+        char path[PATH_MAX];
+        char filename[PATH_MAX];
+
+        getcwd(path, PATH_MAX);
+        snprintf(filename, PATH_MAX, "%s/data/random", path);
+
+        FILE *file = fopen(filename, "rb");
+        buffer     = (const uint8_t *)malloc(1048576);
+        fread((void *)buffer, 1, 1048576, file);
+        fclose(file);
+
+        buffer_misaligned = (const uint8_t *)malloc(1048577);
+        memcpy((void *)(buffer_misaligned + 1), buffer, 1048576);
+    }
+
+    void TearDown()
+    {
+        free((void *)buffer);
+        free((void *)buffer_misaligned);
+    }
+
+    ~fletcher4Fixture()
+    {
+        // resources cleanup, no exceptions allowed
+    }
+
+    // shared user data
+};
+
+TEST_F(fletcher4Fixture, fletcher4_auto)
+{
+    fletcher4_ctx *ctx = fletcher4_init();
+    uint64_t       checksum[FLETCHER4_SUMS];
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher4_update(ctx, buffer, 1048576);
+
+    EXPECT_EQ(fletcher4_final(ctx, checksum), 0);
+    fletcher4_free(ctx);
+
+    EXPECT_EQ(checksum[0], EXPECTED_FLETCHER4_A);
+    EXPECT_EQ(checksum[1], EXPECTED_FLETCHER4_B);
+    EXPECT_EQ(checksum[2], EXPECTED_FLETCHER4_C);
+    EXPECT_EQ(checksum[3], EXPECTED_FLETCHER4_D);
+}
+
+TEST_F(fletcher4Fixture, fletcher4_update64)
+{
+    fletcher4_ctx *ctx = fletcher4_init();
+    uint64_t       checksum[FLETCHER4_SUMS];
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher4_update64(ctx, buffer, 1048576);
+
+    EXPECT_EQ(fletcher4_final(ctx, checksum), 0);
+    fletcher4_free(ctx);
+
+    EXPECT_EQ(checksum[0], EXPECTED_FLETCHER4_A);
+    EXPECT_EQ(checksum[1], EXPECTED_FLETCHER4_B);
+    EXPECT_EQ(checksum[2], EXPECTED_FLETCHER4_C);
+    EXPECT_EQ(checksum[3], EXPECTED_FLETCHER4_D);
+}
+
+TEST_F(fletcher4Fixture, fletcher4_slices)
+{
+    fletcher4_ctx *ctx = fletcher4_init();
+    uint64_t       checksum[FLETCHER4_SUMS];
+    uint32_t       pos;
+    uint32_t       slice;
+    uint32_t       len;
+
+    EXPECT_NE(ctx, nullptr);
+
+    // Feed the data in uneven slices so words are split between updates
+    pos = 0;
+    for(slice = 1; pos < 1048576; slice = slice % 1031 + 7)
+    {
+        len = 1048576 - pos < slice ? 1048576 - pos : slice;
+        fletcher4_update(ctx, buffer + pos, len);
+        pos += len;
+    }
+
+    EXPECT_EQ(fletcher4_final(ctx, checksum), 0);
+    fletcher4_free(ctx);
+
+    EXPECT_EQ(checksum[0], EXPECTED_FLETCHER4_A);
+    EXPECT_EQ(checksum[1], EXPECTED_FLETCHER4_B);
+    EXPECT_EQ(checksum[2], EXPECTED_FLETCHER4_C);
+    EXPECT_EQ(checksum[3], EXPECTED_FLETCHER4_D);
+}
+
+TEST_F(fletcher4Fixture, fletcher4_auto_misaligned)
+{
+    fletcher4_ctx *ctx = fletcher4_init();
+    uint64_t       checksum[FLETCHER4_SUMS];
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher4_update(ctx, buffer_misaligned + 1, 1048576);
+
+    EXPECT_EQ(fletcher4_final(ctx, checksum), 0);
+    fletcher4_free(ctx);
+
+    EXPECT_EQ(checksum[0], EXPECTED_FLETCHER4_A);
+    EXPECT_EQ(checksum[1], EXPECTED_FLETCHER4_B);
+    EXPECT_EQ(checksum[2], EXPECTED_FLETCHER4_C);
+    EXPECT_EQ(checksum[3], EXPECTED_FLETCHER4_D);
+}
+
+TEST_F(fletcher4Fixture, fletcher4_auto_2352bytes)
+{
+    fletcher4_ctx *ctx = fletcher4_init();
+    uint64_t       checksum[FLETCHER4_SUMS];
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher4_update(ctx, buffer, 2352);
+
+    EXPECT_EQ(fletcher4_final(ctx, checksum), 0);
+    fletcher4_free(ctx);
+
+    EXPECT_EQ(checksum[0], EXPECTED_FLETCHER4_2352BYTES_A);
+    EXPECT_EQ(checksum[1], EXPECTED_FLETCHER4_2352BYTES_B);
+    EXPECT_EQ(checksum[2], EXPECTED_FLETCHER4_2352BYTES_C);
+    EXPECT_EQ(checksum[3], EXPECTED_FLETCHER4_2352BYTES_D);
+}
+
+TEST_F(fletcher4Fixture, fletcher4_partial_word)
+{
+    fletcher4_ctx *ctx = fletcher4_init();
+    uint64_t       checksum[FLETCHER4_SUMS];
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher4_update(ctx, buffer, 2351);
+
+    EXPECT_EQ(fletcher4_final(ctx, checksum), -1);
+
+    // Completing the word makes the checksum valid again
+    fletcher4_update(ctx, buffer + 2351, 1);
+
+    EXPECT_EQ(fletcher4_final(ctx, checksum), 0);
+    fletcher4_free(ctx);
+
+    EXPECT_EQ(checksum[0], EXPECTED_FLETCHER4_2352BYTES_A);
+    EXPECT_EQ(checksum[1], EXPECTED_FLETCHER4_2352BYTES_B);
+    EXPECT_EQ(checksum[2], EXPECTED_FLETCHER4_2352BYTES_C);
+    EXPECT_EQ(checksum[3], EXPECTED_FLETCHER4_2352BYTES_D);
+}
+
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)) && !defined(_WIN32))
+TEST_F(fletcher4Fixture, fletcher4_neon)
+{
+    if(!have_neon()) return;
+
+    uint64_t sums[FLETCHER4_SUMS] = {0, 0, 0, 0};
+
+    fletcher4_neon(sums, buffer, 1048576 / 4);
+
+    EXPECT_EQ(sums[0], EXPECTED_FLETCHER4_A);
+    EXPECT_EQ(sums[1], EXPECTED_FLETCHER4_B);
+    EXPECT_EQ(sums[2], EXPECTED_FLETCHER4_C);
+    EXPECT_EQ(sums[3], EXPECTED_FLETCHER4_D);
+}
+
+TEST_F(fletcher4Fixture, fletcher4_neon_misaligned)
+{
+    if(!have_neon()) return;
+
+    uint64_t sums[FLETCHER4_SUMS] = {0, 0, 0, 0};
+
+    fletcher4_neon(sums, buffer_misaligned + 1, 1048576 / 4);
+
+    EXPECT_EQ(sums[0], EXPECTED_FLETCHER4_A);
+    EXPECT_EQ(sums[1], EXPECTED_FLETCHER4_B);
+    EXPECT_EQ(sums[2], EXPECTED_FLETCHER4_C);
+    EXPECT_EQ(sums[3], EXPECTED_FLETCHER4_D);
+}
+
+TEST_F(fletcher4Fixture, fletcher4_neon_2352bytes)
+{
+    if(!have_neon()) return;
+
+    uint64_t sums[FLETCHER4_SUMS] = {0, 0, 0, 0};
+
+    fletcher4_neon(sums, buffer, 2352 / 4);
+
+    EXPECT_EQ(sums[0], EXPECTED_FLETCHER4_2352BYTES_A);
+    EXPECT_EQ(sums[1], EXPECTED_FLETCHER4_2352BYTES_B);
+    EXPECT_EQ(sums[2], EXPECTED_FLETCHER4_2352BYTES_C);
+    EXPECT_EQ(sums[3], EXPECTED_FLETCHER4_2352BYTES_D);
+}
+#endif
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+TEST_F(fletcher4Fixture, fletcher4_avx2)
+{
+    if(!have_avx2()) return;
+
+    uint64_t sums[FLETCHER4_SUMS] = {0, 0, 0, 0};
+
+    fletcher4_avx2(sums, buffer, 1048576 / 4);
+
+    EXPECT_EQ(sums[0], EXPECTED_FLETCHER4_A);
+    EXPECT_EQ(sums[1], EXPECTED_FLETCHER4_B);
+    EXPECT_EQ(sums[2], EXPECTED_FLETCHER4_C);
+    EXPECT_EQ(sums[3], EXPECTED_FLETCHER4_D);
+}
+
+TEST_F(fletcher4Fixture, fletcher4_avx2_misaligned)
+{
+    if(!have_avx2()) return;
+
+    uint64_t sums[FLETCHER4_SUMS] = {0, 0, 0, 0};
+
+    fletcher4_avx2(sums, buffer_misaligned + 1, 1048576 / 4);
+
+    EXPECT_EQ(sums[0], EXPECTED_FLETCHER4_A);
+    EXPECT_EQ(sums[1], EXPECTED_FLETCHER4_B);
+    EXPECT_EQ(sums[2], EXPECTED_FLETCHER4_C);
+    EXPECT_EQ(sums[3], EXPECTED_FLETCHER4_D);
+}
+
+TEST_F(fletcher4Fixture, fletcher4_avx2_2352bytes)
+{
+    if(!have_avx2()) return;
+
+    uint64_t sums[FLETCHER4_SUMS] = {0, 0, 0, 0};
+
+    fletcher4_avx2(sums, buffer, 2352 / 4);
+
+    EXPECT_EQ(sums[0], EXPECTED_FLETCHER4_2352BYTES_A);
+    EXPECT_EQ(sums[1], EXPECTED_FLETCHER4_2352BYTES_B);
+    EXPECT_EQ(sums[2], EXPECTED_FLETCHER4_2352BYTES_C);
+    EXPECT_EQ(sums[3], EXPECTED_FLETCHER4_2352BYTES_D);
+}
+
+TEST_F(fletcher4Fixture, fletcher4_avx512)
+{
+    if(!have_avx512f()) return;
+
+    uint64_t sums[FLETCHER4_SUMS] = {0, 0, 0, 0};
+
+    fletcher4_avx512(sums, buffer, 1048576 / 4);
+
+    EXPECT_EQ(sums[0], EXPECTED_FLETCHER4_A);
+    EXPECT_EQ(sums[1], EXPECTED_FLETCHER4_B);
+    EXPECT_EQ(sums[2], EXPECTED_FLETCHER4_C);
+    EXPECT_EQ(sums[3], EXPECTED_FLETCHER4_D);
+}
+
+TEST_F(fletcher4Fixture, fletcher4_avx512_misaligned)
+{
+    if(!have_avx512f()) return;
+
+    uint64_t sums[FLETCHER4_SUMS] = {0, 0, 0, 0};
+
+    fletcher4_avx512(sums, buffer_misaligned + 1, 1048576 / 4);
+
+    EXPECT_EQ(sums[0], EXPECTED_FLETCHER4_A);
+    EXPECT_EQ(sums[1], EXPECTED_FLETCHER4_B);
+    EXPECT_EQ(sums[2], EXPECTED_FLETCHER4_C);
+    EXPECT_EQ(sums[3], EXPECTED_FLETCHER4_D);
+}
+
+TEST_F(fletcher4Fixture, fletcher4_avx512_2352bytes)
+{
+    if(!have_avx512f()) return;
+
+    uint64_t sums[FLETCHER4_SUMS] = {0, 0, 0, 0};
+
+    fletcher4_avx512(sums, buffer, 2352 / 4);
+
+    EXPECT_EQ(sums[0], EXPECTED_FLETCHER4_2352BYTES_A);
+    EXPECT_EQ(sums[1], EXPECTED_FLETCHER4_2352BYTES_B);
+    EXPECT_EQ(sums[2], EXPECTED_FLETCHER4_2352BYTES_C);
+    EXPECT_EQ(sums[3], EXPECTED_FLETCHER4_2352BYTES_D);
+}
+
+#endif
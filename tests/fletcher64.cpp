@@ -0,0 +1,322 @@
+//
+// Created by claunia on 5/10/21.
+//
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+#include "../library.h"
+#include "../fletcher64.h"
+#include "gtest/gtest.h"
+
+#define EXPECTED_FLETCHER64           0x798BC9533754F109ULL
+#define EXPECTED_FLETCHER64_2352BYTES 0x5C2F0E4C5394FA71ULL
+#define EXPECTED_FLETCHER64_OBJECT    0xFDB79EFEE9984AB7ULL
+
+static const uint8_t *buffer;
+static const uint8_t *buffer_misaligned;
+
+class fletcher64Fixture : public ::testing::Test
+{
+public:
+    fletcher64Fixture()
+    {
+        // initialization;
+        // can also be done in SetUp()
+    }
+
+protected:
+    void SetUp()
+    {
+        char path[PATH_MAX];
+        char filename[PATH_MAX];
+
+        getcwd(path, PATH_MAX);
+        snprintf(filename, PATH_MAX, "%s/data/random", path);
+
+        FILE *file = fopen(filename, "rb");
+        buffer     = (const uint8_t *)malloc(1048576);
+        fread((void *)buffer, 1, 1048576, file);
+        fclose(file);
+
+        buffer_misaligned = (const uint8_t *)malloc(1048577);
+        memcpy((void *)(buffer_misaligned + 1), buffer, 1048576);
+    }
+
+    void TearDown()
+    {
+        free((void *)buffer);
+        free((void *)buffer_misaligned);
+    }
+
+    ~fletcher64Fixture()
+    {
+        // resources cleanup, no exceptions allowed
+    }
+
+    // shared user data
+};
+
+TEST_F(fletcher64Fixture, fletcher64_auto)
+{
+    fletcher64_ctx *ctx = fletcher64_init();
+    uint64_t        checksum;
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher64_update(ctx, buffer, 1048576);
+
+    EXPECT_EQ(fletcher64_final(ctx, &checksum), 0);
+    fletcher64_free(ctx);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64);
+}
+
+TEST_F(fletcher64Fixture, fletcher64_update64)
+{
+    fletcher64_ctx *ctx = fletcher64_init();
+    uint64_t        checksum;
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher64_update64(ctx, buffer, 1048576);
+
+    EXPECT_EQ(fletcher64_final(ctx, &checksum), 0);
+    fletcher64_free(ctx);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64);
+}
+
+TEST_F(fletcher64Fixture, fletcher64_slices)
+{
+    fletcher64_ctx *ctx = fletcher64_init();
+    uint64_t        checksum;
+    uint32_t        pos;
+    uint32_t        slice;
+    uint32_t        len;
+
+    EXPECT_NE(ctx, nullptr);
+
+    // Feed the data in uneven slices so words are split between updates
+    pos = 0;
+    for(slice = 1; pos < 1048576; slice = slice % 1031 + 7)
+    {
+        len = 1048576 - pos < slice ? 1048576 - pos : slice;
+        fletcher64_update(ctx, buffer + pos, len);
+        pos += len;
+    }
+
+    EXPECT_EQ(fletcher64_final(ctx, &checksum), 0);
+    fletcher64_free(ctx);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64);
+}
+
+TEST_F(fletcher64Fixture, fletcher64_auto_misaligned)
+{
+    fletcher64_ctx *ctx = fletcher64_init();
+    uint64_t        checksum;
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher64_update(ctx, buffer_misaligned + 1, 1048576);
+
+    EXPECT_EQ(fletcher64_final(ctx, &checksum), 0);
+    fletcher64_free(ctx);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64);
+}
+
+TEST_F(fletcher64Fixture, fletcher64_auto_2352bytes)
+{
+    fletcher64_ctx *ctx = fletcher64_init();
+    uint64_t        checksum;
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher64_update(ctx, buffer, 2352);
+
+    EXPECT_EQ(fletcher64_final(ctx, &checksum), 0);
+    fletcher64_free(ctx);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64_2352BYTES);
+}
+
+TEST_F(fletcher64Fixture, fletcher64_object)
+{
+    fletcher64_ctx *ctx = fletcher64_init();
+    uint64_t        checksum;
+
+    EXPECT_NE(ctx, nullptr);
+
+    // APFS checksums a 4096 bytes object without its first 8 bytes, where the checksum is stored
+    fletcher64_update(ctx, buffer + 8, 4096 - 8);
+
+    EXPECT_EQ(fletcher64_final(ctx, &checksum), 0);
+    fletcher64_free(ctx);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64_OBJECT);
+}
+
+TEST_F(fletcher64Fixture, fletcher64_partial_word)
+{
+    fletcher64_ctx *ctx = fletcher64_init();
+    uint64_t        checksum;
+
+    EXPECT_NE(ctx, nullptr);
+
+    fletcher64_update(ctx, buffer, 2350);
+
+    EXPECT_EQ(fletcher64_final(ctx, &checksum), -1);
+
+    // Completing the word makes the checksum valid again
+    fletcher64_update(ctx, buffer + 2350, 2);
+
+    EXPECT_EQ(fletcher64_final(ctx, &checksum), 0);
+    fletcher64_free(ctx);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64_2352BYTES);
+}
+
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)) && !defined(_WIN32))
+TEST_F(fletcher64Fixture, fletcher64_neon)
+{
+    if(!have_neon()) return;
+
+    fletcher64_ctx ctx;
+    uint64_t       checksum;
+
+    memset(&ctx, 0, sizeof(ctx));
+
+    fletcher64_neon(&ctx.sum1, &ctx.sum2, buffer, 1048576 / 4);
+    fletcher64_final(&ctx, &checksum);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64);
+}
+
+TEST_F(fletcher64Fixture, fletcher64_neon_misaligned)
+{
+    if(!have_neon()) return;
+
+    fletcher64_ctx ctx;
+    uint64_t       checksum;
+
+    memset(&ctx, 0, sizeof(ctx));
+
+    fletcher64_neon(&ctx.sum1, &ctx.sum2, buffer_misaligned + 1, 1048576 / 4);
+    fletcher64_final(&ctx, &checksum);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64);
+}
+
+TEST_F(fletcher64Fixture, fletcher64_neon_2352bytes)
+{
+    if(!have_neon()) return;
+
+    fletcher64_ctx ctx;
+    uint64_t       checksum;
+
+    memset(&ctx, 0, sizeof(ctx));
+
+    fletcher64_neon(&ctx.sum1, &ctx.sum2, buffer, 2352 / 4);
+    fletcher64_final(&ctx, &checksum);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64_2352BYTES);
+}
+#endif
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+TEST_F(fletcher64Fixture, fletcher64_avx2)
+{
+    if(!have_avx2()) return;
+
+    fletcher64_ctx ctx;
+    uint64_t       checksum;
+
+    memset(&ctx, 0, sizeof(ctx));
+
+    fletcher64_avx2(&ctx.sum1, &ctx.sum2, buffer, 1048576 / 4);
+    fletcher64_final(&ctx, &checksum);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64);
+}
+
+TEST_F(fletcher64Fixture, fletcher64_avx2_misaligned)
+{
+    if(!have_avx2()) return;
+
+    fletcher64_ctx ctx;
+    uint64_t       checksum;
+
+    memset(&ctx, 0, sizeof(ctx));
+
+    fletcher64_avx2(&ctx.sum1, &ctx.sum2, buffer_misaligned + 1, 1048576 / 4);
+    fletcher64_final(&ctx, &checksum);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64);
+}
+
+TEST_F(fletcher64Fixture, fletcher64_avx2_2352bytes)
+{
+    if(!have_avx2()) return;
+
+    fletcher64_ctx ctx;
+    uint64_t       checksum;
+
+    memset(&ctx, 0, sizeof(ctx));
+
+    fletcher64_avx2(&ctx.sum1, &ctx.sum2, buffer, 2352 / 4);
+    fletcher64_final(&ctx, &checksum);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64_2352BYTES);
+}
+
+TEST_F(fletcher64Fixture, fletcher64_avx512)
+{
+    if(!have_avx512f()) return;
+
+    fletcher64_ctx ctx;
+    uint64_t       checksum;
+
+    memset(&ctx, 0, sizeof(ctx));
+
+    fletcher64_avx512(&ctx.sum1, &ctx.sum2, buffer, 1048576 / 4);
+    fletcher64_final(&ctx, &checksum);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64);
+}
+
+TEST_F(fletcher64Fixture, fletcher64_avx512_misaligned)
+{
+    if(!have_avx512f()) return;
+
+    fletcher64_ctx ctx;
+    uint64_t       checksum;
+
+    memset(&ctx, 0, sizeof(ctx));
+
+    fletcher64_avx512(&ctx.sum1, &ctx.sum2, buffer_misaligned + 1, 1048576 / 4);
+    fletcher64_final(&ctx, &checksum);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64);
+}
+
+TEST_F(fletcher64Fixture, fletcher64_avx512_2352bytes)
+{
+    if(!have_avx512f()) return;
+
+    fletcher64_ctx ctx;
+    uint64_t       checksum;
+
+    memset(&ctx, 0, sizeof(ctx));
+
+    fletcher64_avx512(&ctx.sum1, &ctx.sum2, buffer, 2352 / 4);
+    fletcher64_final(&ctx, &checksum);
+
+    EXPECT_EQ(checksum, EXPECTED_FLETCHER64_2352BYTES);
+}
+
+#endif
@@ -8,6 +8,7 @@
 
 #include "../library.h"
 #include "../spamsum.h"
+#include "../spamsum_index.h"
 #include "gtest/gtest.h"
 
 #define EXPECTED_SPAMSUM           "24576:3dvzuAsHTQ16pc7O1Q/gS9qze+Swwn9s6IX:8/TQQpaVqze+JN6IX"
@@ -76,6 +77,240 @@ TEST_F(spamsumFixture, spamsum_auto)
     free((void *)spamsum);
 }
 
+TEST_F(spamsumFixture, spamsum_update64)
+{
+    spamsum_ctx *ctx     = spamsum_init();
+    const char  *spamsum = (const char *)malloc(FUZZY_MAX_RESULT);
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(spamsum, nullptr);
+
+    spamsum_update64(ctx, buffer, 1048576);
+    spamsum_final(ctx, (uint8_t *)spamsum);
+
+    EXPECT_STREQ(spamsum, EXPECTED_SPAMSUM);
+
+    free((void *)spamsum);
+}
+
+TEST_F(spamsumFixture, spamsum_init_sized)
+{
+    spamsum_ctx *ctx     = spamsum_init_sized(1048576);
+    const char  *spamsum = (const char *)malloc(FUZZY_MAX_RESULT);
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(spamsum, nullptr);
+
+    spamsum_update(ctx, buffer, 524288);
+    spamsum_update(ctx, buffer + 524288, 524288);
+    EXPECT_EQ(spamsum_final(ctx, (uint8_t *)spamsum), 0);
+    spamsum_free(ctx);
+
+    EXPECT_STREQ(spamsum, EXPECTED_SPAMSUM);
+
+    free((void *)spamsum);
+}
+
+TEST_F(spamsumFixture, spamsum_init_sized_2352bytes)
+{
+    spamsum_ctx *ctx     = spamsum_init_sized(2352);
+    const char  *spamsum = (const char *)malloc(FUZZY_MAX_RESULT);
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(spamsum, nullptr);
+
+    spamsum_update(ctx, buffer, 2352);
+    EXPECT_EQ(spamsum_final(ctx, (uint8_t *)spamsum), 0);
+    spamsum_free(ctx);
+
+    EXPECT_STREQ(spamsum, EXPECTED_SPAMSUM_2352BYTES);
+
+    free((void *)spamsum);
+}
+
+TEST_F(spamsumFixture, spamsum_init_sized_mismatch)
+{
+    spamsum_ctx *ctx     = spamsum_init_sized(1048576);
+    const char  *spamsum = (const char *)malloc(FUZZY_MAX_RESULT);
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(spamsum, nullptr);
+
+    spamsum_update(ctx, buffer, 1048575);
+    EXPECT_EQ(spamsum_final(ctx, (uint8_t *)spamsum), -1);
+    spamsum_free(ctx);
+
+    free((void *)spamsum);
+}
+
+TEST_F(spamsumFixture, spamsum_export_state)
+{
+    spamsum_ctx *ctx     = spamsum_init();
+    const char  *spamsum = (const char *)malloc(FUZZY_MAX_RESULT);
+    uint8_t     *state   = (uint8_t *)malloc(SPAMSUM_STATE_MAX_SIZE);
+    int          len;
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(spamsum, nullptr);
+    EXPECT_NE(state, nullptr);
+
+    spamsum_update(ctx, buffer, 524288);
+
+    len = spamsum_export_state(ctx, nullptr, 0);
+
+    EXPECT_GT(len, 0);
+    EXPECT_LE(len, SPAMSUM_STATE_MAX_SIZE);
+    EXPECT_EQ(spamsum_export_state(ctx, state, len - 1), -1);
+    EXPECT_EQ(spamsum_export_state(ctx, state, SPAMSUM_STATE_MAX_SIZE), len);
+    spamsum_free(ctx);
+
+    // Resume from the checkpoint as a new context
+    ctx = spamsum_import_state(state, len);
+
+    EXPECT_NE(ctx, nullptr);
+
+    spamsum_update(ctx, buffer + 524288, 524288);
+    spamsum_final(ctx, (uint8_t *)spamsum);
+    spamsum_free(ctx);
+
+    EXPECT_STREQ(spamsum, EXPECTED_SPAMSUM);
+    EXPECT_EQ(spamsum_import_state(state, len - 1), nullptr);
+
+    free((void *)spamsum);
+    free(state);
+}
+
+TEST_F(spamsumFixture, spamsum_clone)
+{
+    spamsum_ctx *ctx     = spamsum_init();
+    spamsum_ctx *clone;
+    const char  *spamsum = (const char *)malloc(FUZZY_MAX_RESULT);
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(spamsum, nullptr);
+
+    spamsum_update(ctx, buffer, 524288);
+
+    clone = spamsum_clone(ctx);
+
+    EXPECT_NE(clone, nullptr);
+
+    // Both branches must continue independently from the shared prefix
+    spamsum_update(clone, buffer + 524288, 524288);
+    spamsum_final(clone, (uint8_t *)spamsum);
+    spamsum_free(clone);
+
+    EXPECT_STREQ(spamsum, EXPECTED_SPAMSUM);
+
+    spamsum_update(ctx, buffer + 524288, 524288);
+    spamsum_final(ctx, (uint8_t *)spamsum);
+    spamsum_free(ctx);
+
+    EXPECT_STREQ(spamsum, EXPECTED_SPAMSUM);
+
+    free((void *)spamsum);
+}
+
+TEST_F(spamsumFixture, spamsum_update_parallel)
+{
+    spamsum_ctx *ctx     = spamsum_init();
+    const char  *spamsum = (const char *)malloc(FUZZY_MAX_RESULT);
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(spamsum, nullptr);
+
+    EXPECT_EQ(spamsum_update_parallel(ctx, buffer, 1048576, 4), 0);
+    spamsum_final(ctx, (uint8_t *)spamsum);
+    spamsum_free(ctx);
+
+    EXPECT_STREQ(spamsum, EXPECTED_SPAMSUM);
+
+    free((void *)spamsum);
+}
+
+TEST_F(spamsumFixture, spamsum_update_parallel_split)
+{
+    spamsum_ctx *ctx      = spamsum_init();
+    spamsum_ctx *parallel = spamsum_init();
+    const char  *expected = (const char *)malloc(FUZZY_MAX_RESULT);
+    const char  *spamsum  = (const char *)malloc(FUZZY_MAX_RESULT);
+    uint32_t     pos      = 0;
+    uint32_t     len      = 100000;
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(parallel, nullptr);
+
+    // Several updates, so blockhashes get reduced between them, with varying thread counts
+    while(pos < 1048576)
+    {
+        if(len > 1048576 - pos) len = 1048576 - pos;
+
+        spamsum_update(ctx, buffer + pos, len);
+        spamsum_update_parallel(parallel, buffer + pos, len, 2 + pos % 5);
+
+        pos += len;
+        len += 50000;
+    }
+
+    spamsum_final(ctx, (uint8_t *)expected);
+    spamsum_final(parallel, (uint8_t *)spamsum);
+    spamsum_free(ctx);
+    spamsum_free(parallel);
+
+    EXPECT_STREQ(spamsum, expected);
+
+    free((void *)expected);
+    free((void *)spamsum);
+}
+
+TEST_F(spamsumFixture, spamsum_update_parallel_wrap)
+{
+    spamsum_ctx *ctx      = spamsum_init();
+    spamsum_ctx *parallel;
+    const char  *expected = (const char *)malloc(FUZZY_MAX_RESULT);
+    const char  *spamsum  = (const char *)malloc(FUZZY_MAX_RESULT);
+    uint8_t     *state    = (uint8_t *)malloc(SPAMSUM_STATE_MAX_SIZE);
+    uint32_t     n;
+    int          len;
+
+    EXPECT_NE(ctx, nullptr);
+
+    spamsum_update(ctx, buffer, 1000);
+    len = spamsum_export_state(ctx, state, SPAMSUM_STATE_MAX_SIZE);
+    spamsum_free(ctx);
+
+    // Move the rolling position close to its wrap point, keeping the window slots, and
+    // offset the rolling sums as a previous wrap would
+    n = 0xFFFFFFFF - 300000;
+    n -= (n - 1000) % 7;
+    state[35] += 0x55;
+    state[39] += 0x33;
+    state[47] = n & 0xFF;
+    state[48] = (n >> 8) & 0xFF;
+    state[49] = (n >> 16) & 0xFF;
+    state[50] = n >> 24;
+
+    ctx      = spamsum_import_state(state, len);
+    parallel = spamsum_import_state(state, len);
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(parallel, nullptr);
+
+    spamsum_update(ctx, buffer + 1000, 1047576);
+    spamsum_update_parallel(parallel, buffer + 1000, 1047576, 3);
+
+    spamsum_final(ctx, (uint8_t *)expected);
+    spamsum_final(parallel, (uint8_t *)spamsum);
+    spamsum_free(ctx);
+    spamsum_free(parallel);
+
+    EXPECT_STREQ(spamsum, expected);
+
+    free((void *)expected);
+    free((void *)spamsum);
+    free(state);
+}
+
 TEST_F(spamsumFixture, spamsum_auto_misaligned)
 {
     spamsum_ctx *ctx     = spamsum_init();
@@ -155,3 +390,457 @@ TEST_F(spamsumFixture, spamsum_auto_2352bytes)
 
     free((void *)spamsum);
 }
+
+TEST_F(spamsumFixture, spamsum_compare)
+{
+    spamsum_ctx *ctx      = spamsum_init();
+    uint8_t     *modified = (uint8_t *)malloc(1048576);
+    const char  *spamsum  = (const char *)malloc(FUZZY_MAX_RESULT);
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(modified, nullptr);
+    EXPECT_NE(spamsum, nullptr);
+
+    memcpy(modified, buffer, 1048576);
+    memset(modified + 500000, 0, 8192);
+
+    spamsum_update(ctx, modified, 1048576);
+    spamsum_final(ctx, (uint8_t *)spamsum);
+    spamsum_free(ctx);
+
+    EXPECT_EQ(spamsum_compare((const uint8_t *)EXPECTED_SPAMSUM, (const uint8_t *)EXPECTED_SPAMSUM), 100);
+    EXPECT_EQ(spamsum_compare((const uint8_t *)EXPECTED_SPAMSUM, (const uint8_t *)spamsum), 99);
+    EXPECT_EQ(spamsum_compare((const uint8_t *)spamsum, (const uint8_t *)EXPECTED_SPAMSUM), 99);
+
+    free((void *)spamsum);
+    free(modified);
+}
+
+TEST_F(spamsumFixture, spamsum_compare_block_sizes)
+{
+    spamsum_ctx *ctx     = spamsum_init();
+    const char  *spamsum = (const char *)malloc(FUZZY_MAX_RESULT);
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(spamsum, nullptr);
+
+    // Prefix of the data, its digest has half the block size
+    spamsum_update(ctx, buffer, 700000);
+    spamsum_final(ctx, (uint8_t *)spamsum);
+    spamsum_free(ctx);
+
+    EXPECT_EQ(spamsum_compare((const uint8_t *)EXPECTED_SPAMSUM, (const uint8_t *)spamsum), 85);
+    EXPECT_EQ(spamsum_compare((const uint8_t *)spamsum, (const uint8_t *)EXPECTED_SPAMSUM), 85);
+    EXPECT_EQ(spamsum_compare((const uint8_t *)EXPECTED_SPAMSUM, (const uint8_t *)EXPECTED_SPAMSUM_2352BYTES), 0);
+
+    free((void *)spamsum);
+}
+
+TEST_F(spamsumFixture, spamsum_compare_invalid)
+{
+    EXPECT_EQ(spamsum_compare(nullptr, (const uint8_t *)EXPECTED_SPAMSUM), -1);
+    EXPECT_EQ(spamsum_compare((const uint8_t *)"24576", (const uint8_t *)EXPECTED_SPAMSUM), -1);
+    EXPECT_EQ(spamsum_compare((const uint8_t *)"24576:abc", (const uint8_t *)EXPECTED_SPAMSUM), -1);
+    EXPECT_EQ(spamsum_compare((const uint8_t *)":abc:abc", (const uint8_t *)EXPECTED_SPAMSUM), -1);
+}
+
+TEST_F(spamsumFixture, spamsum_pack)
+{
+    uint8_t packed[SPAMSUM_PACKED_MAX_SIZE];
+    uint8_t spamsum[FUZZY_MAX_RESULT];
+    int     len;
+
+    len = spamsum_pack((const uint8_t *)EXPECTED_SPAMSUM, packed);
+    EXPECT_EQ(len, 43);
+    EXPECT_EQ(spamsum_unpack(packed, len, spamsum), 0);
+    EXPECT_STREQ((const char *)spamsum, EXPECTED_SPAMSUM);
+
+    len = spamsum_pack((const uint8_t *)EXPECTED_SPAMSUM_15BYTES, packed);
+    EXPECT_EQ(len, 13);
+    EXPECT_EQ(spamsum_unpack(packed, len, spamsum), 0);
+    EXPECT_STREQ((const char *)spamsum, EXPECTED_SPAMSUM_15BYTES);
+
+    len = spamsum_pack((const uint8_t *)EXPECTED_SPAMSUM_2352BYTES, packed);
+    EXPECT_EQ(spamsum_unpack(packed, len, spamsum), 0);
+    EXPECT_STREQ((const char *)spamsum, EXPECTED_SPAMSUM_2352BYTES);
+
+    // Block size not produced by spamsum_final()
+    EXPECT_EQ(spamsum_pack((const uint8_t *)"5:abc:abc", packed), -1);
+    EXPECT_EQ(spamsum_pack((const uint8_t *)"3:a-c:abc", packed), -1);
+    EXPECT_EQ(spamsum_unpack(packed, 2, spamsum), -1);
+}
+
+TEST_F(spamsumFixture, spamsum_compare_packed)
+{
+    spamsum_ctx *ctx      = spamsum_init();
+    uint8_t     *modified = (uint8_t *)malloc(1048576);
+    uint8_t      spamsum[FUZZY_MAX_RESULT];
+    uint8_t      packed1[SPAMSUM_PACKED_MAX_SIZE];
+    uint8_t      packed2[SPAMSUM_PACKED_MAX_SIZE];
+    int          len1, len2;
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(modified, nullptr);
+
+    memcpy(modified, buffer, 1048576);
+    memset(modified + 500000, 0, 8192);
+
+    spamsum_update(ctx, modified, 1048576);
+    spamsum_final(ctx, spamsum);
+    spamsum_free(ctx);
+
+    len1 = spamsum_pack((const uint8_t *)EXPECTED_SPAMSUM, packed1);
+    len2 = spamsum_pack(spamsum, packed2);
+
+    EXPECT_EQ(spamsum_compare_packed(packed1, len1, packed1, len1), 100);
+    EXPECT_EQ(spamsum_compare_packed(packed1, len1, packed2, len2), 99);
+    EXPECT_EQ(spamsum_compare_packed(packed2, len2, packed1, len1), 99);
+    EXPECT_EQ(spamsum_compare_packed(packed1, len1 - 1, packed2, len2), -1);
+
+    len2 = spamsum_pack((const uint8_t *)EXPECTED_SPAMSUM_2352BYTES, packed2);
+    EXPECT_EQ(spamsum_compare_packed(packed1, len1, packed2, len2), 0);
+
+    free(modified);
+}
+
+TEST_F(spamsumFixture, spamsum_packed_grams)
+{
+    uint8_t  packed[SPAMSUM_PACKED_MAX_SIZE];
+    uint64_t grams[SPAMSUM_LENGTH];
+    int      len;
+
+    len = spamsum_pack((const uint8_t *)EXPECTED_SPAMSUM, packed);
+
+    // "3dvzuAs" and "8/TQQpa", first symbol in the lowest bits
+    EXPECT_EQ(spamsum_packed_grams(packed, len, 1, grams), 29);
+    EXPECT_EQ(grams[0], 0x2C02ECEF777ULL);
+    EXPECT_EQ(spamsum_packed_grams(packed, len, 2, grams), 11);
+    EXPECT_EQ(grams[0], 0x1AA50413FFCULL);
+
+    len = spamsum_pack((const uint8_t *)EXPECTED_SPAMSUM_15BYTES, packed);
+    EXPECT_EQ(spamsum_packed_grams(packed, len, 1, grams), 0);
+    EXPECT_EQ(spamsum_packed_grams(packed, len, 3, grams), -1);
+}
+
+TEST_F(spamsumFixture, spamsum_cluster)
+{
+    spamsum_ctx   *ctx      = spamsum_init();
+    uint8_t       *modified = (uint8_t *)malloc(1048576);
+    const char    *spamsum1 = (const char *)malloc(FUZZY_MAX_RESULT);
+    const char    *spamsum2 = (const char *)malloc(FUZZY_MAX_RESULT);
+    spamsum_edge  *edges;
+    uint64_t       edge_count;
+    const uint8_t *digests[5];
+    const uint32_t expected[6][3] = {{0, 1, 99}, {0, 3, 85}, {0, 4, 100}, {1, 3, 82}, {1, 4, 99}, {3, 4, 85}};
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(modified, nullptr);
+    EXPECT_NE(spamsum1, nullptr);
+    EXPECT_NE(spamsum2, nullptr);
+
+    memcpy(modified, buffer, 1048576);
+    memset(modified + 500000, 0, 8192);
+
+    spamsum_update(ctx, modified, 1048576);
+    spamsum_final(ctx, (uint8_t *)spamsum1);
+    spamsum_free(ctx);
+
+    // Prefix of the data, its digest has half the block size
+    ctx = spamsum_init();
+    EXPECT_NE(ctx, nullptr);
+    spamsum_update(ctx, buffer, 700000);
+    spamsum_final(ctx, (uint8_t *)spamsum2);
+    spamsum_free(ctx);
+
+    digests[0] = (const uint8_t *)EXPECTED_SPAMSUM;
+    digests[1] = (const uint8_t *)spamsum1;
+    digests[2] = (const uint8_t *)EXPECTED_SPAMSUM_2352BYTES;
+    digests[3] = (const uint8_t *)spamsum2;
+    digests[4] = (const uint8_t *)EXPECTED_SPAMSUM;
+
+    EXPECT_EQ(spamsum_cluster(digests, 5, 1, 4, &edges, &edge_count), 0);
+    EXPECT_EQ(edge_count, 6);
+
+    for(uint64_t i = 0; i < edge_count && i < 6; i++)
+    {
+        EXPECT_EQ(edges[i].first, expected[i][0]);
+        EXPECT_EQ(edges[i].second, expected[i][1]);
+        EXPECT_EQ(edges[i].score, expected[i][2]);
+    }
+
+    spamsum_cluster_free(edges);
+
+    EXPECT_EQ(spamsum_cluster(digests, 5, 90, 1, &edges, &edge_count), 0);
+    EXPECT_EQ(edge_count, 3);
+    spamsum_cluster_free(edges);
+
+    digests[2] = (const uint8_t *)"abc";
+    EXPECT_EQ(spamsum_cluster(digests, 5, 1, 1, &edges, &edge_count), -1);
+    EXPECT_EQ(edges, nullptr);
+
+    free((void *)spamsum1);
+    free((void *)spamsum2);
+    free(modified);
+}
+
+TEST_F(spamsumFixture, spamsum_index)
+{
+    spamsum_index      *index    = spamsum_index_init();
+    spamsum_ctx        *ctx      = spamsum_init();
+    uint8_t            *modified = (uint8_t *)malloc(1048576);
+    const char         *spamsum  = (const char *)malloc(FUZZY_MAX_RESULT);
+    spamsum_index_match matches[4];
+
+    EXPECT_NE(index, nullptr);
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(modified, nullptr);
+    EXPECT_NE(spamsum, nullptr);
+
+    memcpy(modified, buffer, 1048576);
+    memset(modified + 500000, 0, 8192);
+
+    spamsum_update(ctx, modified, 1048576);
+    spamsum_final(ctx, (uint8_t *)spamsum);
+    spamsum_free(ctx);
+
+    EXPECT_EQ(spamsum_index_add(index, (const uint8_t *)EXPECTED_SPAMSUM_15BYTES, 1), 0);
+    EXPECT_EQ(spamsum_index_add(index, (const uint8_t *)spamsum, 2), 0);
+    EXPECT_EQ(spamsum_index_add(index, (const uint8_t *)EXPECTED_SPAMSUM_2352BYTES, 3), 0);
+    EXPECT_EQ(spamsum_index_add(index, (const uint8_t *)EXPECTED_SPAMSUM, 4), 0);
+    EXPECT_EQ(spamsum_index_add(index, (const uint8_t *)"abc", 5), -1);
+
+    EXPECT_EQ(spamsum_index_query(index, (const uint8_t *)EXPECTED_SPAMSUM, 1, matches, 4), 2);
+    EXPECT_EQ(matches[0].id, 4);
+    EXPECT_EQ(matches[0].score, 100);
+    EXPECT_EQ(matches[1].id, 2);
+    EXPECT_EQ(matches[1].score, 99);
+
+    EXPECT_EQ(spamsum_index_query(index, (const uint8_t *)EXPECTED_SPAMSUM, 100, matches, 4), 1);
+    EXPECT_EQ(spamsum_index_query(index, (const uint8_t *)EXPECTED_SPAMSUM, 1, matches, 1), 1);
+    EXPECT_EQ(matches[0].id, 4);
+
+    // Too short to share substrings, found as an identical digest
+    EXPECT_EQ(spamsum_index_query(index, (const uint8_t *)EXPECTED_SPAMSUM_15BYTES, 1, matches, 4), 1);
+    EXPECT_EQ(matches[0].id, 1);
+    EXPECT_EQ(matches[0].score, 100);
+
+    EXPECT_EQ(spamsum_index_query(index, (const uint8_t *)EXPECTED_SPAMSUM_63BYTES, 1, matches, 4), 0);
+    EXPECT_EQ(spamsum_index_query(index, (const uint8_t *)"abc", 1, matches, 4), -1);
+
+    spamsum_index_free(index);
+    free((void *)spamsum);
+    free(modified);
+}
+
+TEST_F(spamsumFixture, spamsum_index_save_load)
+{
+    spamsum_index      *index   = spamsum_index_init();
+    spamsum_ctx        *ctx     = spamsum_init();
+    const char         *spamsum = (const char *)malloc(FUZZY_MAX_RESULT);
+    spamsum_index_match matches[4];
+
+    EXPECT_NE(index, nullptr);
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(spamsum, nullptr);
+
+    // Prefix of the data, its digest has half the block size
+    spamsum_update(ctx, buffer, 700000);
+    spamsum_final(ctx, (uint8_t *)spamsum);
+    spamsum_free(ctx);
+
+    EXPECT_EQ(spamsum_index_add(index, (const uint8_t *)EXPECTED_SPAMSUM, 1), 0);
+    EXPECT_EQ(spamsum_index_add(index, (const uint8_t *)EXPECTED_SPAMSUM_2352BYTES, 2), 0);
+    EXPECT_EQ(spamsum_index_save(index, "spamsum.idx"), 0);
+    spamsum_index_free(index);
+
+    index = spamsum_index_load("spamsum.idx");
+    EXPECT_NE(index, nullptr);
+
+    EXPECT_EQ(spamsum_index_add(index, (const uint8_t *)spamsum, 3), 0);
+
+    EXPECT_EQ(spamsum_index_query(index, (const uint8_t *)EXPECTED_SPAMSUM, 1, matches, 4), 2);
+    EXPECT_EQ(matches[0].id, 1);
+    EXPECT_EQ(matches[0].score, 100);
+    EXPECT_EQ(matches[1].id, 3);
+    EXPECT_EQ(matches[1].score, 85);
+
+    EXPECT_EQ(spamsum_index_query(index, (const uint8_t *)EXPECTED_SPAMSUM_2352BYTES, 1, matches, 4), 1);
+    EXPECT_EQ(matches[0].id, 2);
+
+    EXPECT_EQ(spamsum_index_save(index, "spamsum2.idx"), 0);
+    spamsum_index_free(index);
+
+    index = spamsum_index_load("spamsum2.idx");
+    EXPECT_NE(index, nullptr);
+
+    EXPECT_EQ(spamsum_index_query(index, (const uint8_t *)spamsum, 1, matches, 4), 2);
+    EXPECT_EQ(matches[0].id, 3);
+    EXPECT_EQ(matches[0].score, 100);
+    EXPECT_EQ(matches[1].id, 1);
+    EXPECT_EQ(matches[1].score, 85);
+
+    spamsum_index_free(index);
+
+    // A digest without its terminator, that would run into the next entries
+    uint8_t digest[FUZZY_MAX_RESULT];
+    FILE   *file = fopen("spamsum2.idx", "r+b");
+
+    memset(digest, '1', FUZZY_MAX_RESULT);
+    fseek(file, SPAMSUM_INDEX_HEADER_SIZE + 8, SEEK_SET);
+    fwrite(digest, 1, FUZZY_MAX_RESULT, file);
+    fclose(file);
+
+    EXPECT_EQ(spamsum_index_load("spamsum2.idx"), nullptr);
+
+    remove("spamsum.idx");
+    remove("spamsum2.idx");
+
+    EXPECT_EQ(spamsum_index_load("data/random"), nullptr);
+
+    free((void *)spamsum);
+}
+
+TEST_F(spamsumFixture, spamsum_prescan)
+{
+    uint64_t *bitmap = (uint64_t *)malloc(65536 / 8);
+    uint32_t  h1     = 0;
+    uint32_t  h2     = 0;
+    uint32_t  h3     = 0;
+    uint32_t  i;
+
+    EXPECT_NE(bitmap, nullptr);
+
+    spamsum_prescan(buffer + 6, 65536, 0, 1, bitmap);
+
+    // Rolling hash as fed to a new context, which sees the 6 bytes before the first position too
+    for(i = 0; i < 65536 + 6; i++)
+    {
+        h2 += ROLLING_WINDOW * buffer[i] - h1;
+        h1 += buffer[i] - (i < ROLLING_WINDOW ? 0 : buffer[i - ROLLING_WINDOW]);
+        h3 = (h3 << 5) ^ buffer[i];
+
+        if(i < 6) continue;
+
+        uint64_t h       = (uint32_t)(h1 + h2 + h3);
+        int      trigger = h % SSDEEP_BS(1) == SSDEEP_BS(1) - 1;
+
+        EXPECT_EQ((bitmap[(i - 6) / 64] >> ((i - 6) % 64)) & 1, (uint64_t)trigger);
+    }
+
+    free(bitmap);
+}
+
+TEST_F(spamsumFixture, spamsum_fnv)
+{
+    uint32_t hashes[SPAMSUM_HASHES];
+    uint32_t i, j;
+
+    for(i = 0; i < SPAMSUM_HASHES; i++) hashes[i] = i * 0x9E3779B9;
+
+    spamsum_fnv(hashes, 6, 20, buffer, 1000);
+
+    for(i = 0; i < SPAMSUM_HASHES; i++)
+    {
+        uint32_t h = i * 0x9E3779B9;
+
+        if(i >= 6 && i < 20)
+            for(j = 0; j < 1000; j++) h = (h * HASH_PRIME) ^ buffer[j];
+
+        EXPECT_EQ(hashes[i], h);
+    }
+}
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+TEST_F(spamsumFixture, spamsum_prescan_avx2)
+{
+    if(!have_avx2()) return;
+
+    uint64_t *expected = (uint64_t *)malloc(65536 / 8);
+    uint64_t *bitmap   = (uint64_t *)malloc(65536 / 8);
+    uint32_t  level;
+
+    EXPECT_NE(expected, nullptr);
+    EXPECT_NE(bitmap, nullptr);
+
+    for(level = 0; level < 6; level++)
+    {
+        spamsum_prescan(buffer + 6, 65536, level * 0x9E3779B9, level, expected);
+        spamsum_prescan_avx2(buffer + 6, 65536, level * 0x9E3779B9, level, bitmap);
+
+        EXPECT_EQ(memcmp(bitmap, expected, 65536 / 8), 0);
+    }
+
+    free(expected);
+    free(bitmap);
+}
+
+TEST_F(spamsumFixture, spamsum_fnv_avx2)
+{
+    if(!have_avx2()) return;
+
+    uint32_t expected[SPAMSUM_HASHES];
+    uint32_t hashes[SPAMSUM_HASHES];
+    uint32_t first, last, i;
+
+    for(first = 0; first < SPAMSUM_HASHES - 2; first += 2)
+        for(last = first + 2; last <= SPAMSUM_HASHES - 2; last += 6)
+        {
+            for(i = 0; i < SPAMSUM_HASHES; i++) expected[i] = hashes[i] = i * 0x9E3779B9;
+
+            spamsum_fnv(expected, first, last, buffer + first, 97);
+            spamsum_fnv_avx2(hashes, first, last, buffer + first, 97);
+
+            EXPECT_EQ(memcmp(hashes, expected, sizeof(hashes)), 0);
+        }
+}
+
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)) && !defined(_WIN32))
+
+TEST_F(spamsumFixture, spamsum_prescan_neon)
+{
+    if(!have_neon()) return;
+
+    uint64_t *expected = (uint64_t *)malloc(65536 / 8);
+    uint64_t *bitmap   = (uint64_t *)malloc(65536 / 8);
+    uint32_t  level;
+
+    EXPECT_NE(expected, nullptr);
+    EXPECT_NE(bitmap, nullptr);
+
+    for(level = 0; level < 6; level++)
+    {
+        spamsum_prescan(buffer + 6, 65536, level * 0x9E3779B9, level, expected);
+        spamsum_prescan_neon(buffer + 6, 65536, level * 0x9E3779B9, level, bitmap);
+
+        EXPECT_EQ(memcmp(bitmap, expected, 65536 / 8), 0);
+    }
+
+    free(expected);
+    free(bitmap);
+}
+
+TEST_F(spamsumFixture, spamsum_fnv_neon)
+{
+    if(!have_neon()) return;
+
+    uint32_t expected[SPAMSUM_HASHES];
+    uint32_t hashes[SPAMSUM_HASHES];
+    uint32_t first, last, i;
+
+    for(first = 0; first < SPAMSUM_HASHES - 2; first += 2)
+        for(last = first + 2; last <= SPAMSUM_HASHES - 2; last += 6)
+        {
+            for(i = 0; i < SPAMSUM_HASHES; i++) expected[i] = hashes[i] = i * 0x9E3779B9;
+
+            spamsum_fnv(expected, first, last, buffer + first, 97);
+            spamsum_fnv_neon(hashes, first, last, buffer + first, 97);
+
+            EXPECT_EQ(memcmp(hashes, expected, sizeof(hashes)), 0);
+        }
+}
+
+#endif
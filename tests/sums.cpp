@@ -0,0 +1,398 @@
+//
+// Created by claunia on 5/10/21.
+//
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+#include "../library.h"
+#include "../sums.h"
+#include "gtest/gtest.h"
+
+#define EXPECTED_ADLER32              0x3728d186
+#define EXPECTED_FLETCHER16           0x3357
+#define EXPECTED_FLETCHER32           0x211261f5
+#define EXPECTED_ADLER32_15BYTES      0x34DC067D
+#define EXPECTED_FLETCHER16_15BYTES   0x0282
+#define EXPECTED_FLETCHER32_15BYTES   0x34CD067C
+#define EXPECTED_ADLER32_2352BYTES    0xECD1738B
+#define EXPECTED_FLETCHER16_2352BYTES 0x0AC5
+#define EXPECTED_FLETCHER32_2352BYTES 0xCB3E7352
+#define EXPECTED_SUM1                 0x000B363B
+#define EXPECTED_SUM2                 0x7D3F5FDD
+#define EXPECTED_SUM1_2352BYTES       0x0004734E
+#define EXPECTED_SUM2_2352BYTES       0x1406B738
+
+static const uint8_t *buffer;
+static const uint8_t *buffer_misaligned;
+
+class sumsFixture : public ::testing::Test
+{
+public:
+    sumsFixture()
+    {
+        // initialization;
+        // can also be done in SetUp()
+    }
+
+protected:
+    void SetUp()
+    {
+        char path[PATH_MAX];
+        char filename[PATH_MAX];
+
+        getcwd(path, PATH_MAX);
+        snprintf(filename, PATH_MAX, "%s/data/random", path);
+
+        FILE *file = fopen(filename, "rb");
+        buffer     = (const uint8_t *)malloc(1048576);
+        fread((void *)buffer, 1, 1048576, file);
+        fclose(file);
+
+        buffer_misaligned = (const uint8_t *)malloc(1048577);
+        memcpy((void *)(buffer_misaligned + 1), buffer, 1048576);
+    }
+
+    void TearDown()
+    {
+        free((void *)buffer);
+        free((void *)buffer_misaligned);
+    }
+
+    ~sumsFixture()
+    {
+        // resources cleanup, no exceptions allowed
+    }
+
+    // shared user data
+};
+
+TEST_F(sumsFixture, sums_auto)
+{
+    sums_ctx *ctx = sums_init();
+    uint32_t  adler32;
+    uint16_t  fletcher16;
+    uint32_t  fletcher32;
+
+    EXPECT_NE(ctx, nullptr);
+
+    sums_update(ctx, buffer, 1048576);
+    sums_final(ctx, &adler32, &fletcher16, &fletcher32);
+    sums_free(ctx);
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16);
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32);
+}
+
+TEST_F(sumsFixture, sums_auto_misaligned)
+{
+    sums_ctx *ctx = sums_init();
+    uint32_t  adler32;
+    uint16_t  fletcher16;
+    uint32_t  fletcher32;
+
+    EXPECT_NE(ctx, nullptr);
+
+    sums_update(ctx, buffer_misaligned + 1, 1048576);
+    sums_final(ctx, &adler32, &fletcher16, &fletcher32);
+    sums_free(ctx);
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16);
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32);
+}
+
+TEST_F(sumsFixture, sums_auto_15bytes)
+{
+    sums_ctx *ctx = sums_init();
+    uint32_t  adler32;
+    uint16_t  fletcher16;
+    uint32_t  fletcher32;
+
+    EXPECT_NE(ctx, nullptr);
+
+    sums_update(ctx, buffer, 15);
+    sums_final(ctx, &adler32, &fletcher16, &fletcher32);
+    sums_free(ctx);
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32_15BYTES);
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_15BYTES);
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32_15BYTES);
+}
+
+TEST_F(sumsFixture, sums_auto_2352bytes)
+{
+    sums_ctx *ctx = sums_init();
+    uint32_t  adler32;
+    uint16_t  fletcher16;
+    uint32_t  fletcher32;
+
+    EXPECT_NE(ctx, nullptr);
+
+    sums_update(ctx, buffer, 2352);
+    sums_final(ctx, &adler32, &fletcher16, &fletcher32);
+    sums_free(ctx);
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32_2352BYTES);
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16_2352BYTES);
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32_2352BYTES);
+}
+
+TEST_F(sumsFixture, sums_update_slices)
+{
+    sums_ctx *ctx = sums_init();
+    uint32_t  adler32;
+    uint16_t  fletcher16;
+    uint32_t  fletcher32;
+    uint32_t  pos;
+    uint32_t  slice;
+    uint32_t  len;
+
+    EXPECT_NE(ctx, nullptr);
+
+    // Uneven slices, so the kernels' blocks never line up with the updates
+    pos = 0;
+    for(slice = 1; pos < 1048576; slice = slice % 9973 + 1237)
+    {
+        len = 1048576 - pos < slice ? 1048576 - pos : slice;
+        sums_update(ctx, buffer + pos, len);
+        pos += len;
+    }
+
+    sums_final(ctx, &adler32, &fletcher16, &fletcher32);
+    sums_free(ctx);
+
+    EXPECT_EQ(adler32, EXPECTED_ADLER32);
+    EXPECT_EQ(fletcher16, EXPECTED_FLETCHER16);
+    EXPECT_EQ(fletcher32, EXPECTED_FLETCHER32);
+}
+
+TEST_F(sumsFixture, sums_batch)
+{
+    // Mixed lengths and alignments, so the batch kernel, the single buffer kernel and a partial group all run
+    const uint8_t *data[9] = {buffer,
+                              buffer_misaligned + 1,
+                              buffer,
+                              buffer,
+                              buffer_misaligned + 1,
+                              buffer,
+                              buffer,
+                              buffer_misaligned + 1,
+                              buffer};
+    uint32_t       len[9]  = {2352, 2352, 1048576, 15, 1048576, 2352, 1048576, 15, 2352};
+    uint32_t       adler32[9];
+    uint16_t       fletcher16[9];
+    uint32_t       fletcher32[9];
+    int            i;
+
+    EXPECT_EQ(sums_batch(data, len, 9, adler32, fletcher16, fletcher32), 0);
+
+    for(i = 0; i < 9; i++)
+    {
+        if(len[i] == 15)
+        {
+            EXPECT_EQ(adler32[i], EXPECTED_ADLER32_15BYTES);
+            EXPECT_EQ(fletcher16[i], EXPECTED_FLETCHER16_15BYTES);
+            EXPECT_EQ(fletcher32[i], EXPECTED_FLETCHER32_15BYTES);
+        }
+        else if(len[i] == 2352)
+        {
+            EXPECT_EQ(adler32[i], EXPECTED_ADLER32_2352BYTES);
+            EXPECT_EQ(fletcher16[i], EXPECTED_FLETCHER16_2352BYTES);
+            EXPECT_EQ(fletcher32[i], EXPECTED_FLETCHER32_2352BYTES);
+        }
+        else
+        {
+            EXPECT_EQ(adler32[i], EXPECTED_ADLER32);
+            EXPECT_EQ(fletcher16[i], EXPECTED_FLETCHER16);
+            EXPECT_EQ(fletcher32[i], EXPECTED_FLETCHER32);
+        }
+    }
+}
+
+TEST_F(sumsFixture, sums_scalar)
+{
+    uint32_t sum1;
+    uint32_t sum2;
+
+    sums_scalar(&sum1, &sum2, buffer, SUMS_NMAX);
+
+    EXPECT_EQ(sum1, EXPECTED_SUM1);
+    EXPECT_EQ(sum2, EXPECTED_SUM2);
+}
+
+TEST_F(sumsFixture, sums_scalar_2352bytes)
+{
+    uint32_t sum1;
+    uint32_t sum2;
+
+    sums_scalar(&sum1, &sum2, buffer, 2352);
+
+    EXPECT_EQ(sum1, EXPECTED_SUM1_2352BYTES);
+    EXPECT_EQ(sum2, EXPECTED_SUM2_2352BYTES);
+}
+
+TEST_F(sumsFixture, sums_swar)
+{
+    uint32_t sum1;
+    uint32_t sum2;
+
+    sums_swar(&sum1, &sum2, buffer, SUMS_NMAX);
+
+    EXPECT_EQ(sum1, EXPECTED_SUM1);
+    EXPECT_EQ(sum2, EXPECTED_SUM2);
+}
+
+TEST_F(sumsFixture, sums_swar_2352bytes)
+{
+    uint32_t sum1;
+    uint32_t sum2;
+
+    sums_swar(&sum1, &sum2, buffer_misaligned + 1, 2352);
+
+    EXPECT_EQ(sum1, EXPECTED_SUM1_2352BYTES);
+    EXPECT_EQ(sum2, EXPECTED_SUM2_2352BYTES);
+}
+
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)) && !defined(_WIN32))
+
+TEST_F(sumsFixture, sums_neon)
+{
+    if(!have_neon()) return;
+
+    uint32_t sum1;
+    uint32_t sum2;
+
+    sums_neon(&sum1, &sum2, buffer, SUMS_NMAX);
+
+    EXPECT_EQ(sum1, EXPECTED_SUM1);
+    EXPECT_EQ(sum2, EXPECTED_SUM2);
+}
+
+TEST_F(sumsFixture, sums_neon_2352bytes)
+{
+    if(!have_neon()) return;
+
+    uint32_t sum1;
+    uint32_t sum2;
+
+    sums_neon(&sum1, &sum2, buffer, 2352);
+
+    EXPECT_EQ(sum1, EXPECTED_SUM1_2352BYTES);
+    EXPECT_EQ(sum2, EXPECTED_SUM2_2352BYTES);
+}
+
+TEST_F(sumsFixture, sums_batch_neon)
+{
+    if(!have_neon()) return;
+
+    const uint8_t *data[SUMS_BATCH] = {buffer, buffer_misaligned + 1, buffer, buffer_misaligned + 1};
+    uint32_t       sum1[SUMS_BATCH];
+    uint32_t       sum2[SUMS_BATCH];
+    int            i;
+
+    sums_batch_neon(sum1, sum2, data, 2352);
+
+    for(i = 0; i < SUMS_BATCH; i++)
+    {
+        EXPECT_EQ(sum1[i], EXPECTED_SUM1_2352BYTES);
+        EXPECT_EQ(sum2[i], EXPECTED_SUM2_2352BYTES);
+    }
+}
+
+#endif
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+TEST_F(sumsFixture, sums_avx2)
+{
+    if(!have_avx2()) return;
+
+    uint32_t sum1;
+    uint32_t sum2;
+
+    sums_avx2(&sum1, &sum2, buffer, SUMS_NMAX);
+
+    EXPECT_EQ(sum1, EXPECTED_SUM1);
+    EXPECT_EQ(sum2, EXPECTED_SUM2);
+}
+
+TEST_F(sumsFixture, sums_avx2_2352bytes)
+{
+    if(!have_avx2()) return;
+
+    uint32_t sum1;
+    uint32_t sum2;
+
+    sums_avx2(&sum1, &sum2, buffer, 2352);
+
+    EXPECT_EQ(sum1, EXPECTED_SUM1_2352BYTES);
+    EXPECT_EQ(sum2, EXPECTED_SUM2_2352BYTES);
+}
+
+TEST_F(sumsFixture, sums_ssse3)
+{
+    if(!have_ssse3()) return;
+
+    uint32_t sum1;
+    uint32_t sum2;
+
+    sums_ssse3(&sum1, &sum2, buffer, SUMS_NMAX);
+
+    EXPECT_EQ(sum1, EXPECTED_SUM1);
+    EXPECT_EQ(sum2, EXPECTED_SUM2);
+}
+
+TEST_F(sumsFixture, sums_ssse3_2352bytes)
+{
+    if(!have_ssse3()) return;
+
+    uint32_t sum1;
+    uint32_t sum2;
+
+    sums_ssse3(&sum1, &sum2, buffer, 2352);
+
+    EXPECT_EQ(sum1, EXPECTED_SUM1_2352BYTES);
+    EXPECT_EQ(sum2, EXPECTED_SUM2_2352BYTES);
+}
+
+TEST_F(sumsFixture, sums_batch_avx2)
+{
+    if(!have_avx2()) return;
+
+    const uint8_t *data[SUMS_BATCH] = {buffer, buffer_misaligned + 1, buffer, buffer_misaligned + 1};
+    uint32_t       sum1[SUMS_BATCH];
+    uint32_t       sum2[SUMS_BATCH];
+    int            i;
+
+    sums_batch_avx2(sum1, sum2, data, 2352);
+
+    for(i = 0; i < SUMS_BATCH; i++)
+    {
+        EXPECT_EQ(sum1[i], EXPECTED_SUM1_2352BYTES);
+        EXPECT_EQ(sum2[i], EXPECTED_SUM2_2352BYTES);
+    }
+}
+
+TEST_F(sumsFixture, sums_batch_ssse3)
+{
+    if(!have_ssse3()) return;
+
+    const uint8_t *data[SUMS_BATCH] = {buffer, buffer_misaligned + 1, buffer, buffer_misaligned + 1};
+    uint32_t       sum1[SUMS_BATCH];
+    uint32_t       sum2[SUMS_BATCH];
+    int            i;
+
+    sums_batch_ssse3(sum1, sum2, data, 2352);
+
+    for(i = 0; i < SUMS_BATCH; i++)
+    {
+        EXPECT_EQ(sum1[i], EXPECTED_SUM1_2352BYTES);
+        EXPECT_EQ(sum2[i], EXPECTED_SUM2_2352BYTES);
+    }
+}
+
+#endif
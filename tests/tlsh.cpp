@@ -0,0 +1,254 @@
+//
+// Created by claunia on 5/10/21.
+//
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+#include "../library.h"
+#include "../tlsh.h"
+#include "gtest/gtest.h"
+
+#define EXPECTED_TLSH           "T1252533E1565D9C670ECF8CF1038A86783FAE467456273EAEADC233B4C189E517503B92"
+#define EXPECTED_TLSH_2352BYTES "T107410A1D9E049A1F74CECD3018343BCAD296E17C1C14A4B9CB8FBBB05A8141246629E7"
+/* With 8192 bytes zeroed at offset 500000 */
+#define EXPECTED_TLSH_MODIFIED  "T1A52533E1565C9857CECF8CF1038A867C3FAE463496173EAEADC233B4D189E517503A92"
+
+static const uint8_t *buffer;
+static const uint8_t *buffer_misaligned;
+
+class tlshFixture : public ::testing::Test
+{
+public:
+    tlshFixture()
+    {
+        // initialization;
+        // can also be done in SetUp()
+    }
+
+protected:
+    void SetUp()
+    {
+        char path[PATH_MAX];
+        char filename[PATH_MAX];
+
+        getcwd(path, PATH_MAX);
+        snprintf(filename, PATH_MAX, "%s/data/random", path);
+
+        FILE *file = fopen(filename, "rb");
+        buffer     = (const uint8_t *)malloc(1048576);
+        fread((void *)buffer, 1, 1048576, file);
+        fclose(file);
+
+        buffer_misaligned = (const uint8_t *)malloc(1048577);
+        memcpy((void *)(buffer_misaligned + 1), buffer, 1048576);
+    }
+
+    void TearDown()
+    {
+        free((void *)buffer);
+        free((void *)buffer_misaligned);
+    }
+
+    ~tlshFixture()
+    {
+        // resources cleanup, no exceptions allowed
+    }
+
+    // shared user data
+};
+
+TEST_F(tlshFixture, tlsh_auto)
+{
+    tlsh_ctx *ctx = tlsh_init();
+    uint8_t   tlsh[TLSH_DIGEST_LENGTH + 1];
+
+    EXPECT_NE(ctx, nullptr);
+
+    tlsh_update(ctx, buffer, 1048576);
+    EXPECT_EQ(tlsh_final(ctx, tlsh), 0);
+
+    EXPECT_STREQ((const char *)tlsh, EXPECTED_TLSH);
+
+    tlsh_free(ctx);
+}
+
+TEST_F(tlshFixture, tlsh_auto_misaligned)
+{
+    tlsh_ctx *ctx = tlsh_init();
+    uint8_t   tlsh[TLSH_DIGEST_LENGTH + 1];
+
+    EXPECT_NE(ctx, nullptr);
+
+    tlsh_update(ctx, buffer_misaligned + 1, 1048576);
+    EXPECT_EQ(tlsh_final(ctx, tlsh), 0);
+
+    EXPECT_STREQ((const char *)tlsh, EXPECTED_TLSH);
+
+    tlsh_free(ctx);
+}
+
+TEST_F(tlshFixture, tlsh_auto_2352bytes)
+{
+    tlsh_ctx *ctx = tlsh_init();
+    uint8_t   tlsh[TLSH_DIGEST_LENGTH + 1];
+
+    EXPECT_NE(ctx, nullptr);
+
+    tlsh_update(ctx, buffer, 2352);
+    EXPECT_EQ(tlsh_final(ctx, tlsh), 0);
+
+    EXPECT_STREQ((const char *)tlsh, EXPECTED_TLSH_2352BYTES);
+
+    tlsh_free(ctx);
+}
+
+TEST_F(tlshFixture, tlsh_update_split)
+{
+    tlsh_ctx *ctx = tlsh_init();
+    uint8_t   tlsh[TLSH_DIGEST_LENGTH + 1];
+    uint32_t  pos, len;
+
+    EXPECT_NE(ctx, nullptr);
+
+    /* Chunks shorter than the window, and longer ones, carry the window across updates */
+    for(pos = 0, len = 1; pos < 1048576; pos += len, len = len * 3 % 1021)
+    {
+        if(len > 1048576 - pos) len = 1048576 - pos;
+
+        tlsh_update(ctx, buffer + pos, len);
+    }
+
+    EXPECT_EQ(tlsh_final(ctx, tlsh), 0);
+
+    EXPECT_STREQ((const char *)tlsh, EXPECTED_TLSH);
+
+    tlsh_free(ctx);
+}
+
+TEST_F(tlshFixture, tlsh_too_short)
+{
+    tlsh_ctx *ctx = tlsh_init();
+    uint8_t   tlsh[TLSH_DIGEST_LENGTH + 1];
+    uint8_t  *zeroes;
+
+    EXPECT_NE(ctx, nullptr);
+
+    tlsh_update(ctx, buffer, TLSH_MIN_LENGTH - 1);
+    EXPECT_EQ(tlsh_final(ctx, tlsh), -1);
+
+    tlsh_free(ctx);
+
+    /* Long enough, but filling a single bucket */
+    zeroes = (uint8_t *)calloc(1, 4096);
+    ctx    = tlsh_init();
+
+    tlsh_update(ctx, zeroes, 4096);
+    EXPECT_EQ(tlsh_final(ctx, tlsh), -1);
+
+    tlsh_free(ctx);
+    free(zeroes);
+}
+
+TEST_F(tlshFixture, tlsh_diff)
+{
+    tlsh_ctx *ctx      = tlsh_init();
+    uint8_t  *modified = (uint8_t *)malloc(1048576);
+    uint8_t   tlsh[TLSH_DIGEST_LENGTH + 1];
+
+    EXPECT_NE(ctx, nullptr);
+    EXPECT_NE(modified, nullptr);
+
+    memcpy(modified, buffer, 1048576);
+    memset(modified + 500000, 0, 8192);
+
+    tlsh_update(ctx, modified, 1048576);
+    EXPECT_EQ(tlsh_final(ctx, tlsh), 0);
+
+    EXPECT_STREQ((const char *)tlsh, EXPECTED_TLSH_MODIFIED);
+
+    EXPECT_EQ(tlsh_diff((const uint8_t *)EXPECTED_TLSH, (const uint8_t *)EXPECTED_TLSH), 0);
+    EXPECT_EQ(tlsh_diff((const uint8_t *)EXPECTED_TLSH, tlsh), 16);
+    EXPECT_EQ(tlsh_diff(tlsh, (const uint8_t *)EXPECTED_TLSH), 16);
+    EXPECT_EQ(tlsh_diff((const uint8_t *)EXPECTED_TLSH, (const uint8_t *)EXPECTED_TLSH_2352BYTES), 1028);
+
+    /* Without the version prefix */
+    EXPECT_EQ(tlsh_diff((const uint8_t *)EXPECTED_TLSH + 2, tlsh), 16);
+
+    tlsh_free(ctx);
+    free(modified);
+}
+
+TEST_F(tlshFixture, tlsh_diff_invalid)
+{
+    EXPECT_EQ(tlsh_diff(nullptr, (const uint8_t *)EXPECTED_TLSH), -1);
+    EXPECT_EQ(tlsh_diff((const uint8_t *)"T1252533", (const uint8_t *)EXPECTED_TLSH), -1);
+    EXPECT_EQ(tlsh_diff((const uint8_t *)EXPECTED_TLSH "00", (const uint8_t *)EXPECTED_TLSH), -1);
+    EXPECT_EQ(tlsh_diff((const uint8_t *)"T1G52533E1565D9C670ECF8CF1038A86783FAE467456273EAEADC233B4C189E517503B92",
+                        (const uint8_t *)EXPECTED_TLSH),
+              -1);
+}
+
+TEST_F(tlshFixture, tlsh_buckets)
+{
+    uint32_t buckets[TLSH_BUCKETS];
+    uint32_t total = 0, i;
+
+    memset(buckets, 0, sizeof(buckets));
+
+    tlsh_buckets(buffer + 4, 1000, buckets);
+
+    for(i = 0; i < TLSH_BUCKETS; i++) total += buckets[i];
+
+    EXPECT_EQ(total, 6000);
+}
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+TEST_F(tlshFixture, tlsh_buckets_avx2)
+{
+    if(!have_avx2()) return;
+
+    uint32_t expected[TLSH_BUCKETS];
+    uint32_t buckets[TLSH_BUCKETS];
+    uint32_t len;
+
+    for(len = 0; len < 200; len += 7)
+    {
+        memset(expected, 0, sizeof(expected));
+        memset(buckets, 0, sizeof(buckets));
+
+        tlsh_buckets(buffer + 4 + len, len * 37, expected);
+        tlsh_buckets_avx2(buffer + 4 + len, len * 37, buckets);
+
+        EXPECT_EQ(memcmp(buckets, expected, sizeof(buckets)), 0);
+    }
+}
+
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)) && !defined(_WIN32))
+
+TEST_F(tlshFixture, tlsh_buckets_neon)
+{
+    if(!have_neon()) return;
+
+    uint32_t expected[TLSH_BUCKETS];
+    uint32_t buckets[TLSH_BUCKETS];
+    uint32_t len;
+
+    for(len = 0; len < 200; len += 7)
+    {
+        memset(expected, 0, sizeof(expected));
+        memset(buckets, 0, sizeof(buckets));
+
+        tlsh_buckets(buffer + 4 + len, len * 37, expected);
+        tlsh_buckets_neon(buffer + 4 + len, len * 37, buckets);
+
+        EXPECT_EQ(memcmp(buckets, expected, sizeof(buckets)), 0);
+    }
+}
+
+#endif
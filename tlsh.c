@@ -0,0 +1,375 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Trend Micro Locality Sensitive Hash (TLSH), with 128 buckets and a 1-byte checksum.
+ *
+ * Every position of the data, from the fifth byte on, maps six triplets of the last five bytes
+ * to a bucket with a Pearson hash and counts them. The digest encodes each of the first 128
+ * buckets in 2 bits, by the quartile its count falls in, along with the data length and the
+ * quartile ratios, so similar data gives digests at a small distance, see tlsh_diff().
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "library.h"
+#include "tlsh.h"
+#include "simd.h"
+
+typedef void(AARU_CALL *tlsh_buckets_fn)(const uint8_t *data, uint32_t len, uint32_t *buckets);
+
+/* Pearson hash of a salt and three bytes */
+#define TLSH_MAPPING(salt, i, j, k) tlsh_table[tlsh_table[tlsh_table[tlsh_table[salt] ^ (i)] ^ (j)] ^ (k)]
+
+/**
+ * @brief Initializes the TLSH context.
+ *
+ * @return Pointer to a structure containing the context, or NULL on error.
+ */
+AARU_EXPORT tlsh_ctx *AARU_CALL tlsh_init(void)
+{
+    tlsh_ctx *ctx = (tlsh_ctx *)calloc(1, sizeof(tlsh_ctx));
+
+    return ctx;
+}
+
+/**
+ * @brief Counts the buckets of a run of positions.
+ *
+ * @param data Pointer to the first position, the 4 bytes before it must be readable.
+ * @param len Number of positions.
+ * @param buckets Bucket counts, incremented for each triplet of every position.
+ */
+AARU_EXPORT void AARU_CALL tlsh_buckets(const uint8_t *data, uint32_t len, uint32_t *buckets)
+{
+    const uint8_t *end = data + len;
+
+    for(; data < end; data++)
+    {
+        buckets[TLSH_MAPPING(TLSH_SALT_012, data[0], data[-1], data[-2])]++;
+        buckets[TLSH_MAPPING(TLSH_SALT_013, data[0], data[-1], data[-3])]++;
+        buckets[TLSH_MAPPING(TLSH_SALT_023, data[0], data[-2], data[-3])]++;
+        buckets[TLSH_MAPPING(TLSH_SALT_024, data[0], data[-2], data[-4])]++;
+        buckets[TLSH_MAPPING(TLSH_SALT_014, data[0], data[-1], data[-4])]++;
+        buckets[TLSH_MAPPING(TLSH_SALT_034, data[0], data[-3], data[-4])]++;
+    }
+}
+
+/**
+ * @brief Feeds a single byte, taking the previous ones from the window of the context.
+ *
+ * @param ctx Pointer to the TLSH context structure.
+ * @param c Byte to feed.
+ */
+static void tlsh_step(tlsh_ctx *ctx, uint8_t c)
+{
+    uint8_t window[TLSH_WINDOW];
+
+    memcpy(window, ctx->window, TLSH_WINDOW - 1);
+    window[TLSH_WINDOW - 1] = c;
+
+    if(ctx->data_len >= TLSH_WINDOW - 1)
+    {
+        ctx->checksum = TLSH_MAPPING(0, c, window[3], ctx->checksum);
+        tlsh_buckets(window + TLSH_WINDOW - 1, 1, ctx->buckets);
+    }
+
+    memmove(ctx->window, window + 1, TLSH_WINDOW - 1);
+    ctx->data_len++;
+}
+
+/**
+ * @brief Updates the TLSH context with new data.
+ *
+ * @param ctx Pointer to the TLSH context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL tlsh_update(tlsh_ctx *ctx, const uint8_t *data, uint32_t len)
+{
+    tlsh_buckets_fn buckets = tlsh_buckets;
+    uint8_t         checksum;
+    uint32_t        i;
+
+    if(!ctx || !data) return -1;
+
+    /* The first positions need the bytes kept from the previous update */
+    for(i = 0; i < len && i < TLSH_WINDOW - 1; i++) tlsh_step(ctx, data[i]);
+
+    if(len <= TLSH_WINDOW - 1) return 0;
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+    if(have_avx2()) buckets = tlsh_buckets_avx2;
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+    if(have_neon()) buckets = tlsh_buckets_neon;
+#endif
+
+    buckets(data + TLSH_WINDOW - 1, len - (TLSH_WINDOW - 1), ctx->buckets);
+
+    /* The checksum chains through every position, so it cannot be vectorized */
+    checksum = ctx->checksum;
+
+    for(i = TLSH_WINDOW - 1; i < len; i++) checksum = TLSH_MAPPING(0, data[i], data[i - 1], checksum);
+
+    ctx->checksum = checksum;
+    memcpy(ctx->window, data + len - (TLSH_WINDOW - 1), TLSH_WINDOW - 1);
+    ctx->data_len += len - (TLSH_WINDOW - 1);
+
+    return 0;
+}
+
+/**
+ * @brief Updates the TLSH context with new data of any length.
+ *
+ * @param ctx Pointer to the TLSH context structure.
+ * @param data Pointer to the input data buffer.
+ * @param len The length of the input data buffer.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL tlsh_update64(tlsh_ctx *ctx, const uint8_t *data, uint64_t len)
+{
+    if(!ctx || !data) return -1;
+
+    while(len > UINT32_MAX)
+    {
+        tlsh_update(ctx, data, UINT32_MAX);
+        data += UINT32_MAX;
+        len -= UINT32_MAX;
+    }
+
+    return tlsh_update(ctx, data, (uint32_t)len);
+}
+
+/* Orders bucket counts ascending, for qsort() */
+static int tlsh_compare_counts(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * @brief Encodes the data length in a single byte, on a logarithmic scale.
+ *
+ * @param len Length of the data.
+ *
+ * @return Encoded length.
+ */
+static uint8_t tlsh_length(uint64_t len)
+{
+    int value;
+
+    if(len <= 656)
+        value = (int)floor(log((double)len) / 0.4054651);
+    else if(len <= 3199)
+        value = (int)floor(log((double)len) / 0.26236426 - 8.72777);
+    else
+        value = (int)floor(log((double)len) / 0.095310180 - 62.5472);
+
+    return (uint8_t)(value & 0xFF);
+}
+
+/* Swaps the nibbles of a byte, as the digest stores the header bytes */
+#define TLSH_SWAP(b) ((uint8_t)(((b) << 4) | ((b) >> 4)))
+
+/**
+ * @brief Returns the TLSH digest.
+ *
+ * The digest needs at least TLSH_MIN_LENGTH bytes of data, varied enough to fill more than
+ * half of the buckets.
+ *
+ * @param ctx Pointer to the TLSH context structure.
+ * @param result Receives the digest, with room for TLSH_DIGEST_LENGTH + 1 bytes.
+ *
+ * @returns 0 on success, -1 on error.
+ */
+AARU_EXPORT int AARU_CALL tlsh_final(tlsh_ctx *ctx, uint8_t *result)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    uint32_t          sorted[TLSH_EFF_BUCKETS];
+    uint8_t           hash[TLSH_HASH_SIZE];
+    uint32_t          q1, q2, q3, count, nonzero = 0;
+    uint32_t          i, j;
+
+    if(!ctx || !result) return -1;
+
+    if(ctx->data_len < TLSH_MIN_LENGTH || ctx->data_len > UINT32_MAX) return -1;
+
+    memcpy(sorted, ctx->buckets, sizeof(sorted));
+    qsort(sorted, TLSH_EFF_BUCKETS, sizeof(uint32_t), tlsh_compare_counts);
+
+    q1 = sorted[TLSH_EFF_BUCKETS / 4 - 1];
+    q2 = sorted[TLSH_EFF_BUCKETS / 2 - 1];
+    q3 = sorted[TLSH_EFF_BUCKETS * 3 / 4 - 1];
+
+    for(i = 0; i < TLSH_EFF_BUCKETS; i++)
+        if(ctx->buckets[i]) nonzero++;
+
+    if(nonzero <= TLSH_EFF_BUCKETS / 2 || !q3) return -1;
+
+    hash[0] = TLSH_SWAP(ctx->checksum);
+    hash[1] = TLSH_SWAP(tlsh_length(ctx->data_len));
+    hash[2] = (uint8_t)((q1 * 100ULL / q3 % 16) << 4 | (q2 * 100ULL / q3 % 16));
+
+    /* The code is stored from the last bucket to the first one */
+    for(i = 0; i < TLSH_CODE_SIZE; i++)
+    {
+        uint8_t code = 0;
+
+        for(j = 0; j < 4; j++)
+        {
+            count = ctx->buckets[4 * i + j];
+
+            if(count > q3)
+                code |= 3 << (j * 2);
+            else if(count > q2)
+                code |= 2 << (j * 2);
+            else if(count > q1)
+                code |= 1 << (j * 2);
+        }
+
+        hash[TLSH_HASH_SIZE - 1 - i] = code;
+    }
+
+    *result++ = 'T';
+    *result++ = '1';
+
+    for(i = 0; i < TLSH_HASH_SIZE; i++)
+    {
+        *result++ = hex[hash[i] >> 4];
+        *result++ = hex[hash[i] & 0xF];
+    }
+
+    *result = 0;
+
+    return 0;
+}
+
+/**
+ * @brief Frees the TLSH context.
+ *
+ * @param ctx Pointer to the TLSH context structure, to be freed.
+ */
+AARU_EXPORT void AARU_CALL tlsh_free(tlsh_ctx *ctx)
+{
+    if(ctx) free(ctx);
+}
+
+/**
+ * @brief Decodes the hash of a digest, with or without its "T1" version prefix.
+ *
+ * @param digest Digest, as produced by tlsh_final().
+ * @param hash Receives the hash.
+ *
+ * @return 0 on success, -1 if the digest is not valid.
+ */
+static int tlsh_parse(const uint8_t *digest, uint8_t *hash)
+{
+    uint32_t i;
+    int      nibble;
+    uint8_t  c;
+
+    if(!digest) return -1;
+
+    if(digest[0] == 'T' && digest[1] == '1') digest += 2;
+
+    for(i = 0; i < 2 * TLSH_HASH_SIZE; i++)
+    {
+        c = digest[i];
+
+        if(c >= '0' && c <= '9')
+            nibble = c - '0';
+        else if(c >= 'A' && c <= 'F')
+            nibble = c - 'A' + 10;
+        else if(c >= 'a' && c <= 'f')
+            nibble = c - 'a' + 10;
+        else
+            return -1;
+
+        if(i % 2)
+            hash[i / 2] |= (uint8_t)nibble;
+        else
+            hash[i / 2] = (uint8_t)(nibble << 4);
+    }
+
+    return digest[i] ? -1 : 0;
+}
+
+/* Distance between two values in a circular range */
+FORCE_INLINE uint32_t tlsh_mod_diff(uint32_t x, uint32_t y, uint32_t range)
+{
+    uint32_t d = x > y ? x - y : y - x;
+
+    return d < range - d ? d : range - d;
+}
+
+/**
+ * @brief Computes the distance between two TLSH digests.
+ *
+ * Identical digests are at distance 0, and the distance grows with the differences between
+ * the data, going beyond 100 for unrelated data. Digests are accepted with or without their
+ * "T1" version prefix.
+ *
+ * @param digest1 First digest, as produced by tlsh_final().
+ * @param digest2 Second digest, as produced by tlsh_final().
+ *
+ * @returns Distance between both digests, or -1 on error.
+ */
+AARU_EXPORT int AARU_CALL tlsh_diff(const uint8_t *digest1, const uint8_t *digest2)
+{
+    uint8_t  hash1[TLSH_HASH_SIZE], hash2[TLSH_HASH_SIZE];
+    uint32_t diff, d, x, y, i, j;
+
+    if(tlsh_parse(digest1, hash1) || tlsh_parse(digest2, hash2)) return -1;
+
+    /* Length, with nibbles swapped back */
+    d    = tlsh_mod_diff(TLSH_SWAP(hash1[1]), TLSH_SWAP(hash2[1]), 256);
+    diff = d <= 1 ? d : d * 12;
+
+    /* Quartile ratios */
+    d = tlsh_mod_diff(hash1[2] >> 4, hash2[2] >> 4, 16);
+    diff += d <= 1 ? d : (d - 1) * 12;
+    d = tlsh_mod_diff(hash1[2] & 0xF, hash2[2] & 0xF, 16);
+    diff += d <= 1 ? d : (d - 1) * 12;
+
+    if(hash1[0] != hash2[0]) diff++;
+
+    /* Buckets, each pair of bits apart by the distance between their quartiles, or 6 if opposite */
+    for(i = 3; i < TLSH_HASH_SIZE; i++)
+    {
+        for(j = 0; j < 8; j += 2)
+        {
+            x = (hash1[i] >> j) & 3;
+            y = (hash2[i] >> j) & 3;
+            d = x > y ? x - y : y - x;
+            diff += d == 3 ? 6 : d;
+        }
+    }
+
+    return (int)diff;
+}
@@ -0,0 +1,146 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__x86_64__) || defined(__amd64) || defined(_M_AMD64) || defined(_M_X64) || defined(__I386__) || \
+    defined(__i386__) || defined(__THW_INTEL) || defined(_M_IX86)
+
+#include <immintrin.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "library.h"
+#include "tlsh.h"
+#include "simd.h"
+
+/**
+ * @brief Looks up 32 bytes in the Pearson table at once.
+ *
+ * Each of the 16 rows of the table is looked up with a byte shuffle, and the bits 4 to 7 of
+ * the indexes then select among the rows, halving them at each blend.
+ *
+ * @param rows Rows of 16 entries of the table, each in both lanes.
+ * @param x Indexes.
+ *
+ * @return Table entries.
+ */
+TARGET_WITH_AVX2 static inline __m256i tlsh_lookup_avx2(const __m256i *rows, __m256i x)
+{
+    __m256i low = _mm256_and_si256(x, _mm256_set1_epi8(0x0F));
+    __m256i bit4, bit5, bit6;
+    __m256i r[8];
+    int     k;
+
+    /* Blends only look at the top bit of each byte, so move every selecting bit there */
+    bit4 = _mm256_slli_epi16(x, 3);
+    bit5 = _mm256_slli_epi16(x, 2);
+    bit6 = _mm256_slli_epi16(x, 1);
+
+    for(k = 0; k < 8; k++)
+        r[k] = _mm256_blendv_epi8(_mm256_shuffle_epi8(rows[2 * k], low), _mm256_shuffle_epi8(rows[2 * k + 1], low),
+                                  bit4);
+
+    for(k = 0; k < 4; k++) r[k] = _mm256_blendv_epi8(r[2 * k], r[2 * k + 1], bit5);
+    for(k = 0; k < 2; k++) r[k] = _mm256_blendv_epi8(r[2 * k], r[2 * k + 1], bit6);
+
+    return _mm256_blendv_epi8(r[0], r[1], x);
+}
+
+/**
+ * @brief Maps a triplet of window bytes of 32 positions to their buckets.
+ *
+ * @param rows Rows of 16 entries of the table, each in both lanes.
+ * @param salt Entry of the table the mapping starts from.
+ * @param i Newest byte of each position.
+ * @param j Second byte of the triplet.
+ * @param k Third byte of the triplet.
+ *
+ * @return Buckets.
+ */
+TARGET_WITH_AVX2 static inline __m256i tlsh_mapping_avx2(const __m256i *rows, uint8_t salt, __m256i i, __m256i j,
+                                                         __m256i k)
+{
+    __m256i h = tlsh_lookup_avx2(rows, _mm256_xor_si256(_mm256_set1_epi8((char)tlsh_table[salt]), i));
+
+    h = tlsh_lookup_avx2(rows, _mm256_xor_si256(h, j));
+
+    return tlsh_lookup_avx2(rows, _mm256_xor_si256(h, k));
+}
+
+/**
+ * @brief Counts the buckets of a run of positions using AVX2.
+ *
+ * Maps 32 positions at a time. The increments themselves are done one by one, as positions
+ * can share buckets, into a set of counts per triplet so consecutive ones seldom wait on each
+ * other.
+ *
+ * @param data Pointer to the first position, the 4 bytes before it must be readable.
+ * @param len Number of positions.
+ * @param buckets Bucket counts, incremented for each triplet of every position.
+ */
+AARU_EXPORT TARGET_WITH_AVX2 void AARU_CALL tlsh_buckets_avx2(const uint8_t *data, uint32_t len, uint32_t *buckets)
+{
+    uint32_t counts[6][TLSH_BUCKETS];
+    uint8_t  mapped[6][32];
+    __m256i  rows[16];
+    __m256i  w0, w1, w2, w3, w4;
+    uint32_t i, k;
+
+    if(len < 32)
+    {
+        tlsh_buckets(data, len, buckets);
+        return;
+    }
+
+    for(k = 0; k < 16; k++)
+        rows[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(tlsh_table + 16 * k)));
+
+    memset(counts, 0, sizeof(counts));
+
+    for(i = 0; i + 32 <= len; i += 32)
+    {
+        w0 = _mm256_loadu_si256((const __m256i *)(data + i));
+        w1 = _mm256_loadu_si256((const __m256i *)(data + i - 1));
+        w2 = _mm256_loadu_si256((const __m256i *)(data + i - 2));
+        w3 = _mm256_loadu_si256((const __m256i *)(data + i - 3));
+        w4 = _mm256_loadu_si256((const __m256i *)(data + i - 4));
+
+        _mm256_storeu_si256((__m256i *)mapped[0], tlsh_mapping_avx2(rows, TLSH_SALT_012, w0, w1, w2));
+        _mm256_storeu_si256((__m256i *)mapped[1], tlsh_mapping_avx2(rows, TLSH_SALT_013, w0, w1, w3));
+        _mm256_storeu_si256((__m256i *)mapped[2], tlsh_mapping_avx2(rows, TLSH_SALT_023, w0, w2, w3));
+        _mm256_storeu_si256((__m256i *)mapped[3], tlsh_mapping_avx2(rows, TLSH_SALT_024, w0, w2, w4));
+        _mm256_storeu_si256((__m256i *)mapped[4], tlsh_mapping_avx2(rows, TLSH_SALT_014, w0, w1, w4));
+        _mm256_storeu_si256((__m256i *)mapped[5], tlsh_mapping_avx2(rows, TLSH_SALT_034, w0, w3, w4));
+
+        for(k = 0; k < 32; k++)
+        {
+            counts[0][mapped[0][k]]++;
+            counts[1][mapped[1][k]]++;
+            counts[2][mapped[2][k]]++;
+            counts[3][mapped[3][k]]++;
+            counts[4][mapped[4][k]]++;
+            counts[5][mapped[5][k]]++;
+        }
+    }
+
+    for(k = 0; k < TLSH_BUCKETS; k++)
+        buckets[k] += counts[0][k] + counts[1][k] + counts[2][k] + counts[3][k] + counts[4][k] + counts[5][k];
+
+    tlsh_buckets(data + i, len - i, buckets);
+}
+
+#endif
@@ -0,0 +1,177 @@
+/*
+ * This file is part of the Aaru Data Preservation Suite.
+ * Copyright (c) 2019-2025 Natalia Portillo.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of the
+ * License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__aarch64__) || defined(_M_ARM64) || ((defined(__arm__) || defined(_M_ARM)))
+
+#include <arm_neon.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "library.h"
+#include "tlsh.h"
+#include "simd.h"
+
+/* The Pearson table split in rows that a single table lookup instruction can index */
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define TLSH_NEON_ROWS 4
+typedef uint8x16x4_t tlsh_neon_row;
+#else
+#define TLSH_NEON_ROWS 8
+typedef uint8x8x4_t tlsh_neon_row;
+#endif
+
+#if !defined(__aarch64__) && !defined(_M_ARM64)
+/**
+ * @brief Looks up 8 bytes in the Pearson table at once.
+ *
+ * @param rows Rows of 32 entries of the table.
+ * @param x Indexes.
+ *
+ * @return Table entries.
+ */
+TARGET_WITH_NEON static inline uint8x8_t tlsh_lookup_neon_half(const tlsh_neon_row *rows, uint8x8_t x)
+{
+    uint8x8_t r = vtbl4_u8(rows[0], x);
+    int       k;
+
+    /* Indexes out of the row, wrapped around by the subtraction, keep what was found before */
+    for(k = 1; k < TLSH_NEON_ROWS; k++) r = vtbx4_u8(r, rows[k], vsub_u8(x, vdup_n_u8((uint8_t)(32 * k))));
+
+    return r;
+}
+#endif
+
+/**
+ * @brief Looks up 16 bytes in the Pearson table at once.
+ *
+ * @param rows Rows of the table, see TLSH_NEON_ROWS.
+ * @param x Indexes.
+ *
+ * @return Table entries.
+ */
+TARGET_WITH_NEON static inline uint8x16_t tlsh_lookup_neon(const tlsh_neon_row *rows, uint8x16_t x)
+{
+#if defined(__aarch64__) || defined(_M_ARM64)
+    uint8x16_t r = vqtbl4q_u8(rows[0], x);
+
+    /* Indexes out of the row, wrapped around by the subtraction, keep what was found before */
+    r = vqtbx4q_u8(r, rows[1], vsubq_u8(x, vdupq_n_u8(64)));
+    r = vqtbx4q_u8(r, rows[2], vsubq_u8(x, vdupq_n_u8(128)));
+
+    return vqtbx4q_u8(r, rows[3], vsubq_u8(x, vdupq_n_u8(192)));
+#else
+    return vcombine_u8(tlsh_lookup_neon_half(rows, vget_low_u8(x)), tlsh_lookup_neon_half(rows, vget_high_u8(x)));
+#endif
+}
+
+/**
+ * @brief Maps a triplet of window bytes of 16 positions to their buckets.
+ *
+ * @param rows Rows of the table, see TLSH_NEON_ROWS.
+ * @param salt Entry of the table the mapping starts from.
+ * @param i Newest byte of each position.
+ * @param j Second byte of the triplet.
+ * @param k Third byte of the triplet.
+ *
+ * @return Buckets.
+ */
+TARGET_WITH_NEON static inline uint8x16_t tlsh_mapping_neon(const tlsh_neon_row *rows, uint8_t salt, uint8x16_t i,
+                                                            uint8x16_t j, uint8x16_t k)
+{
+    uint8x16_t h = tlsh_lookup_neon(rows, veorq_u8(vdupq_n_u8(tlsh_table[salt]), i));
+
+    h = tlsh_lookup_neon(rows, veorq_u8(h, j));
+
+    return tlsh_lookup_neon(rows, veorq_u8(h, k));
+}
+
+/**
+ * @brief Counts the buckets of a run of positions using NEON.
+ *
+ * Maps 16 positions at a time with table lookup instructions. The increments themselves are
+ * done one by one, as positions can share buckets, into a set of counts per triplet so
+ * consecutive ones seldom wait on each other.
+ *
+ * @param data Pointer to the first position, the 4 bytes before it must be readable.
+ * @param len Number of positions.
+ * @param buckets Bucket counts, incremented for each triplet of every position.
+ */
+AARU_EXPORT TARGET_WITH_NEON void AARU_CALL tlsh_buckets_neon(const uint8_t *data, uint32_t len, uint32_t *buckets)
+{
+    uint32_t      counts[6][TLSH_BUCKETS];
+    uint8_t       mapped[6][16];
+    tlsh_neon_row rows[TLSH_NEON_ROWS];
+    uint8x16_t    w0, w1, w2, w3, w4;
+    uint32_t      i, k;
+
+    if(len < 16)
+    {
+        tlsh_buckets(data, len, buckets);
+        return;
+    }
+
+    for(k = 0; k < TLSH_NEON_ROWS; k++)
+    {
+#if defined(__aarch64__) || defined(_M_ARM64)
+        rows[k].val[0] = vld1q_u8(tlsh_table + 64 * k);
+        rows[k].val[1] = vld1q_u8(tlsh_table + 64 * k + 16);
+        rows[k].val[2] = vld1q_u8(tlsh_table + 64 * k + 32);
+        rows[k].val[3] = vld1q_u8(tlsh_table + 64 * k + 48);
+#else
+        rows[k].val[0] = vld1_u8(tlsh_table + 32 * k);
+        rows[k].val[1] = vld1_u8(tlsh_table + 32 * k + 8);
+        rows[k].val[2] = vld1_u8(tlsh_table + 32 * k + 16);
+        rows[k].val[3] = vld1_u8(tlsh_table + 32 * k + 24);
+#endif
+    }
+
+    memset(counts, 0, sizeof(counts));
+
+    for(i = 0; i + 16 <= len; i += 16)
+    {
+        w0 = vld1q_u8(data + i);
+        w1 = vld1q_u8(data + i - 1);
+        w2 = vld1q_u8(data + i - 2);
+        w3 = vld1q_u8(data + i - 3);
+        w4 = vld1q_u8(data + i - 4);
+
+        vst1q_u8(mapped[0], tlsh_mapping_neon(rows, TLSH_SALT_012, w0, w1, w2));
+        vst1q_u8(mapped[1], tlsh_mapping_neon(rows, TLSH_SALT_013, w0, w1, w3));
+        vst1q_u8(mapped[2], tlsh_mapping_neon(rows, TLSH_SALT_023, w0, w2, w3));
+        vst1q_u8(mapped[3], tlsh_mapping_neon(rows, TLSH_SALT_024, w0, w2, w4));
+        vst1q_u8(mapped[4], tlsh_mapping_neon(rows, TLSH_SALT_014, w0, w1, w4));
+        vst1q_u8(mapped[5], tlsh_mapping_neon(rows, TLSH_SALT_034, w0, w3, w4));
+
+        for(k = 0; k < 16; k++)
+        {
+            counts[0][mapped[0][k]]++;
+            counts[1][mapped[1][k]]++;
+            counts[2][mapped[2][k]]++;
+            counts[3][mapped[3][k]]++;
+            counts[4][mapped[4][k]]++;
+            counts[5][mapped[5][k]]++;
+        }
+    }
+
+    for(k = 0; k < TLSH_BUCKETS; k++)
+        buckets[k] += counts[0][k] + counts[1][k] + counts[2][k] + counts[3][k] + counts[4][k] + counts[5][k];
+
+    tlsh_buckets(data + i, len - i, buckets);
+}
+
+#endif